@@ -4,14 +4,19 @@
 
 #pragma once
 
+#include "BLI_array.hh"
 #include "BLI_fileops.hh"
 #include "BLI_function_ref.hh"
+#include "BLI_implicit_sharing_ptr.hh"
 #include "BLI_serialize.hh"
+#include "BLI_struct_equality_utils.hh"
 
 #include "BKE_bake_items.hh"
 
 namespace blender::bke::bake {
 
+struct BlobEncoding;
+
 /**
  * Reference to a slice of memory typically stored on disk.
  * A blob is a "binary large object".
@@ -19,11 +24,51 @@ namespace blender::bke::bake {
 struct BlobSlice {
   std::string name;
   IndexRange range;
+  /**
+   * Describes how the stored data has to be decoded. Null if the data is stored as is. Encoded
+   * slices can only be read with #read_blob_slice.
+   */
+  std::shared_ptr<const BlobEncoding> encoding;
+
+  /** Size of the data after it has been decoded. */
+  int64_t decoded_size() const;
 
   std::shared_ptr<io::serialize::DictionaryValue> serialize() const;
   static std::optional<BlobSlice> deserialize(const io::serialize::DictionaryValue &io_slice);
 };
 
+/**
+ * Blobs can be compressed to reduce the size of bakes on disk. The data is split into chunks
+ * that are compressed independently with zstd, so that they can be compressed and decompressed
+ * in parallel.
+ *
+ * Before compression, the data can be combined with the data of a similar blob (typically the
+ * same attribute on a previous frame) with a bitwise xor. For data that changes slowly, most
+ * bytes become zero which compresses much better. Additionally, the bytes of every value are
+ * grouped by their significance, because bytes of the same significance are more likely similar.
+ */
+struct BlobEncoding {
+  /** Size of the data after decoding. */
+  int64_t decoded_size;
+  /** Size of the decoded data of every chunk except for the last one. */
+  int64_t chunk_size;
+  /** Size of the compressed data of every chunk. */
+  Vector<int64_t> compressed_chunk_sizes;
+  /** Size of the values whose bytes are grouped by significance. */
+  int value_size = 1;
+  /**
+   * Blob that the data is combined with. It is never encoded with a delta itself, so that
+   * decoding a blob never has to read more than two blobs.
+   */
+  std::optional<BlobSlice> delta_base;
+  /**
+   * Hash of the decoded data of #delta_base. The base is typically stored in the blob file of
+   * another frame, which may have been deleted or baked again since. Decoding fails instead of
+   * producing wrong data when the base has changed.
+   */
+  uint64_t delta_base_hash = 0;
+};
+
 /**
  * Abstract base class for loading binary data.
  */
@@ -43,8 +88,24 @@ class BlobReader {
    */
   [[nodiscard]] virtual bool read_as_stream(const BlobSlice &slice,
                                             FunctionRef<bool(std::istream &)> fn) const;
+
+  /**
+   * Provides access to the data of the given slice without copying it, if the reader supports
+   * that and the data has the given alignment. Like for other implicitly shared data, it must
+   * only be modified when the returned sharing info is mutable.
+   * \return None if the data has to be copied with #read instead.
+   */
+  [[nodiscard]] virtual std::optional<ImplicitSharingInfoAndData> read_without_copy(
+      const BlobSlice &slice, int64_t alignment) const;
 };
 
+/**
+ * Read the data from the given slice and decode it if necessary.
+ * \param r_data: Buffer with #BlobSlice::decoded_size bytes.
+ * \return True on success, otherwise false.
+ */
+[[nodiscard]] bool read_blob_slice(const BlobReader &reader, const BlobSlice &slice, void *r_data);
+
 /**
  * Abstract base class for writing binary data.
  */
@@ -77,7 +138,8 @@ class BlobWriter {
 };
 
 /**
- * Allows deduplicating data before it's written.
+ * Allows deduplicating data before it's written. It also optionally compresses the data and
+ * encodes it relative to data written for previous states.
  */
 class BlobWriteSharing : NonCopyable, NonMovable {
  private:
@@ -107,9 +169,50 @@ class BlobWriteSharing : NonCopyable, NonMovable {
    */
   Map<uint64_t, BlobSlice> slice_by_content_hash_;
 
+  /** Identifies data that is likely similar to data written for a previous state. */
+  struct DeltaKey {
+    int64_t size_in_bytes;
+    int value_size;
+    /** Number of blobs with the same size that have been written before in the same state. */
+    int occurrence;
+
+    uint64_t hash() const
+    {
+      return get_default_hash(this->size_in_bytes, this->value_size, this->occurrence);
+    }
+
+    BLI_STRUCT_EQUALITY_OPERATORS_3(DeltaKey, size_in_bytes, value_size, occurrence);
+  };
+
+  /** Data that newly written data with the same #DeltaKey is encoded relative to. */
+  struct DeltaBase {
+    BlobSlice slice;
+    Array<std::byte> data;
+    uint64_t data_hash;
+    int state_index;
+  };
+
+  bool use_compression_ = false;
+  /** Index of the state that is currently written, incremented by #start_next_state. */
+  int state_index_ = 0;
+  Map<DeltaKey, DeltaBase> delta_base_by_key_;
+  Map<std::pair<int64_t, int>, int> occurrences_in_state_;
+
  public:
+  BlobWriteSharing() = default;
+  /**
+   * \param use_compression: Compress newly written data. The data may also be encoded relative
+   *   to data that was written for a previous state, which has to be available when reading.
+   */
+  explicit BlobWriteSharing(bool use_compression);
   ~BlobWriteSharing();
 
+  /**
+   * Has to be called before the data of another state (e.g. the next frame) is written. Data is
+   * only encoded relative to data written in previous states.
+   */
+  void start_next_state();
+
   /**
    * Check if the data referenced by `sharing_info` has been written before. If yes, return the
    * identifier for the previously written data. Otherwise, write the data now and store the
@@ -124,9 +227,16 @@ class BlobWriteSharing : NonCopyable, NonMovable {
    * Checks if the given data was written before. If it was, it's not written again, but a
    * reference to the previously written data is returned. If the data is new, it's written now.
    * Its hash is remembered so that the same data won't be written again.
+   * \param value_size: Size of the values in the data, used to make compression more effective.
    */
   [[nodiscard]] std::shared_ptr<io::serialize::DictionaryValue> write_deduplicated(
-      BlobWriter &writer, const void *data, int64_t size_in_bytes);
+      BlobWriter &writer, const void *data, int64_t size_in_bytes, int value_size = 1);
+
+ private:
+  BlobSlice write_compressed(BlobWriter &writer,
+                             Span<std::byte> data,
+                             int value_size,
+                             const DeltaKey &delta_key);
 };
 
 /**
@@ -156,18 +266,32 @@ class BlobReadSharing : NonCopyable, NonMovable {
       FunctionRef<std::optional<ImplicitSharingInfoAndData>()> read_fn) const;
 };
 
+class MappedBlobFile;
+
 /**
  * A specific #BlobReader that reads from disk.
+ *
+ * Blob files are memory-mapped when possible, which allows using the data of suitably aligned
+ * slices directly without reading it into separately allocated arrays. The mapping stays alive as
+ * long as any of that data is used.
  */
 class DiskBlobReader : public BlobReader {
  private:
   const std::string blobs_dir_;
   mutable std::mutex mutex_;
   mutable Map<std::string, std::unique_ptr<fstream>> open_input_streams_;
+  /** Null for files that can't be mapped. */
+  mutable Map<std::string, ImplicitSharingPtr<MappedBlobFile>> mapped_files_;
 
  public:
   DiskBlobReader(std::string blobs_dir);
+  ~DiskBlobReader();
   [[nodiscard]] bool read(const BlobSlice &slice, void *r_data) const override;
+  [[nodiscard]] std::optional<ImplicitSharingInfoAndData> read_without_copy(
+      const BlobSlice &slice, int64_t alignment) const override;
+
+ private:
+  const MappedBlobFile *get_mapped_file(StringRefNull blob_path) const;
 };
 
 /**
@@ -19,6 +19,9 @@
 
 struct BVHCache;
 struct BVHTree;
+namespace blender {
+class WideBVH;
+}
 struct MFace;
 struct Mesh;
 struct PointCloud;
@@ -28,6 +31,11 @@ struct PointCloud;
  */
 struct BVHTreeFromMesh {
   BVHTree *tree = nullptr;
+  /**
+   * Alternative tree that is faster for ray casts and nearest point queries, only built by
+   * #BKE_bvhtree_from_mesh_wide_get. When it is set, #tree is null.
+   */
+  const blender::WideBVH *wide_tree = nullptr;
 
   /** Default callbacks to BVH nearest and ray-cast. */
   BVHTree_NearestPointCallback nearest_callback;
@@ -121,6 +129,62 @@ BVHTree *BKE_bvhtree_from_mesh_get(BVHTreeFromMesh *data,
                                    BVHCacheType bvh_cache_type,
                                    int tree_type);
 
+/**
+ * Builds or queries a cached #blender::WideBVH of the requested type instead of a #BVHTree. It is
+ * built with a surface area heuristic and has a wider node layout, which makes ray casts and
+ * nearest point queries significantly faster on large meshes. The tree can only be queried with
+ * #BKE_bvhtree_from_mesh_ray_cast and #BKE_bvhtree_from_mesh_find_nearest.
+ *
+ * \note #BVHTREE_FROM_FACES is not supported.
+ */
+void BKE_bvhtree_from_mesh_wide_get(BVHTreeFromMesh &data,
+                                    const Mesh &mesh,
+                                    BVHCacheType bvh_cache_type);
+
+/**
+ * Same as #BLI_bvhtree_ray_cast_ex, but uses whichever tree is available in the data.
+ */
+int BKE_bvhtree_from_mesh_ray_cast(const BVHTreeFromMesh &data,
+                                   const float co[3],
+                                   const float dir[3],
+                                   float radius,
+                                   BVHTreeRayHit *hit,
+                                   BVHTree_RayCastCallback callback,
+                                   void *userdata,
+                                   int flag = BVH_RAYCAST_DEFAULT);
+
+/**
+ * Same as #BLI_bvhtree_find_nearest_ex, but uses whichever tree is available in the data. The
+ * wide tree always visits the closest nodes first, so \a flag only affects the #BVHTree.
+ */
+int BKE_bvhtree_from_mesh_find_nearest(const BVHTreeFromMesh &data,
+                                       const float co[3],
+                                       BVHTreeNearest *nearest,
+                                       BVHTree_NearestPointCallback callback,
+                                       void *userdata,
+                                       int flag = 0);
+
+/**
+ * Batched variants of #BKE_bvhtree_from_mesh_ray_cast and #BKE_bvhtree_from_mesh_find_nearest,
+ * see #BLI_bvhtree_ray_cast_batch. The results have to be initialized before the call.
+ */
+void BKE_bvhtree_from_mesh_ray_cast_batch(const BVHTreeFromMesh &data,
+                                          const blender::IndexMask &mask,
+                                          blender::Span<blender::float3> origins,
+                                          blender::Span<blender::float3> directions,
+                                          float radius,
+                                          blender::MutableSpan<BVHTreeRayHit> r_hits,
+                                          BVHTree_RayCastCallback callback,
+                                          void *userdata,
+                                          int flag = BVH_RAYCAST_DEFAULT);
+void BKE_bvhtree_from_mesh_find_nearest_batch(const BVHTreeFromMesh &data,
+                                              const blender::IndexMask &mask,
+                                              blender::Span<blender::float3> positions,
+                                              blender::MutableSpan<BVHTreeNearest> r_nearest,
+                                              BVHTree_NearestPointCallback callback,
+                                              void *userdata,
+                                              int flag = 0);
+
 /**
  * Build a bvh tree from the triangles in the mesh that correspond to the faces in the given mask.
  */
@@ -185,3 +249,9 @@ BVHCache *bvhcache_init();
  * Frees a BVH-cache.
  */
 void bvhcache_free(BVHCache *bvh_cache);
+/**
+ * Invalidate the trees after positions changed. Trees from #BKE_bvhtree_from_mesh_wide_get are
+ * kept and refitted when they are requested again and still contain the same primitives, the
+ * others are freed. This is also used when the cache is moved to a new evaluated mesh.
+ */
+void bvhcache_tag_positions_changed(BVHCache *bvh_cache);
@@ -202,4 +202,20 @@ void BKE_keyblock_curve_data_set_with_mat4(
  */
 void BKE_keyblock_data_set(Key *key, int shape_index, const void *data);
 
+/**
+ * Free the data of the key-block, or release it when it is shared with evaluated copies.
+ */
+void BKE_keyblock_data_free(KeyBlock *kb);
+/**
+ * Replace the data of the key-block with newly allocated \a data (or null), the key-block takes
+ * ownership over it.
+ */
+void BKE_keyblock_data_replace(KeyBlock *kb, void *data);
+/**
+ * Make sure the data of the key-block is not shared with evaluated copies, so that it can be
+ * modified in place. When the data is copied, the old address is kept in
+ * #KeyBlock::data_previous.
+ */
+void *BKE_keyblock_data_for_write(KeyBlock *kb);
+
 /** \} */
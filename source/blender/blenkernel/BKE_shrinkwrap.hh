@@ -79,7 +79,7 @@ const ShrinkwrapBoundaryData &boundary_cache_ensure(const Mesh &mesh);
 struct ShrinkwrapTreeData {
   Mesh *mesh;
 
-  BVHTree *bvh;
+  /** Uses #BVHTreeFromMesh::wide_tree, query with #BKE_bvhtree_from_mesh_ray_cast etc. */
   BVHTreeFromMesh treeData;
 
   blender::OffsetIndices<int> faces;
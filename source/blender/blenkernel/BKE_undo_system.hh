@@ -137,6 +137,13 @@ struct UndoType {
                               UndoTypeForEachIDRefFn foreach_ID_ref_fn,
                               void *user_data);
 
+  /**
+   * Optional, update #UndoStep.data_size before it is used to limit the undo memory, for steps
+   * sharing data with other steps, where the memory they use changes when other steps are added
+   * or removed.
+   */
+  void (*step_data_size_update)(UndoStep *us);
+
   /** Information for the generic undo system to refine handling of this specific undo type. */
   uint flags;
 
@@ -15,8 +15,11 @@
 
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
+#include "BLI_math_base.h"
 #include "BLI_math_matrix_types.hh"
+#include "BLI_mmap.h"
 #include "BLI_path_utils.hh"
+#include "BLI_task.hh"
 
 #include "DNA_material_types.h"
 #include "DNA_modifier_types.h"
@@ -25,9 +28,17 @@
 #include "RNA_access.hh"
 #include "RNA_enum_types.hh"
 
+#include "CLG_log.h"
+
+#include <fcntl.h>
 #include <fmt/format.h>
 #include <sstream>
 #include <xxhash.h>
+#include <zstd.h>
+
+#ifndef WIN32
+#  include <unistd.h>
+#endif
 
 #ifdef WITH_OPENVDB
 #  include <openvdb/io/Stream.h>
@@ -36,17 +47,98 @@
 #  include "BKE_volume_grid.hh"
 #endif
 
+static CLG_LogRef LOG = {"bke.bake"};
+
 namespace blender::bke::bake {
 
 using namespace io::serialize;
 using DictionaryValuePtr = std::shared_ptr<DictionaryValue>;
 
+int64_t BlobSlice::decoded_size() const
+{
+  if (this->encoding) {
+    return this->encoding->decoded_size;
+  }
+  return this->range.size();
+}
+
+static void serialize_blob_encoding(DictionaryValue &io_encoding, const BlobEncoding &encoding)
+{
+  io_encoding.append_str("compression", "zstd");
+  io_encoding.append_int("decoded_size", encoding.decoded_size);
+  io_encoding.append_int("chunk_size", encoding.chunk_size);
+  io_encoding.append_int("value_size", encoding.value_size);
+  auto io_chunks = io_encoding.append_array("chunks");
+  for (const int64_t compressed_size : encoding.compressed_chunk_sizes) {
+    io_chunks->append_int(int(compressed_size));
+  }
+  if (encoding.delta_base) {
+    io_encoding.append("delta_base", encoding.delta_base->serialize());
+    io_encoding.append_int("delta_base_hash", int64_t(encoding.delta_base_hash));
+  }
+}
+
+static std::optional<BlobEncoding> deserialize_blob_encoding(const DictionaryValue &io_encoding)
+{
+  if (io_encoding.lookup_str("compression").value_or("") != "zstd") {
+    return std::nullopt;
+  }
+  const std::optional<int64_t> decoded_size = io_encoding.lookup_int("decoded_size");
+  const std::optional<int64_t> chunk_size = io_encoding.lookup_int("chunk_size");
+  const std::optional<int64_t> value_size = io_encoding.lookup_int("value_size");
+  const ArrayValue *io_chunks = io_encoding.lookup_array("chunks");
+  if (!decoded_size || !chunk_size || !value_size || !io_chunks) {
+    return std::nullopt;
+  }
+  if (*decoded_size < 0 || *chunk_size <= 0 || *value_size <= 0) {
+    return std::nullopt;
+  }
+  BlobEncoding encoding;
+  encoding.decoded_size = *decoded_size;
+  encoding.chunk_size = *chunk_size;
+  encoding.value_size = int(*value_size);
+  for (const std::shared_ptr<Value> &io_chunk : io_chunks->elements()) {
+    const IntValue *io_compressed_size = io_chunk->as_int_value();
+    if (!io_compressed_size) {
+      return std::nullopt;
+    }
+    encoding.compressed_chunk_sizes.append(io_compressed_size->value());
+  }
+  if (encoding.compressed_chunk_sizes.size() !=
+      int64_t(divide_ceil_ul(encoding.decoded_size, encoding.chunk_size)))
+  {
+    return std::nullopt;
+  }
+  if (const DictionaryValue *io_delta_base = io_encoding.lookup_dict("delta_base")) {
+    encoding.delta_base = BlobSlice::deserialize(*io_delta_base);
+    if (!encoding.delta_base) {
+      return std::nullopt;
+    }
+    /* Chains of deltas are not supported. */
+    if (!encoding.delta_base->encoding || encoding.delta_base->encoding->delta_base) {
+      return std::nullopt;
+    }
+    if (encoding.delta_base->decoded_size() != encoding.decoded_size) {
+      return std::nullopt;
+    }
+    const std::optional<int64_t> delta_base_hash = io_encoding.lookup_int("delta_base_hash");
+    if (!delta_base_hash) {
+      return std::nullopt;
+    }
+    encoding.delta_base_hash = uint64_t(*delta_base_hash);
+  }
+  return encoding;
+}
+
 std::shared_ptr<DictionaryValue> BlobSlice::serialize() const
 {
   auto io_slice = std::make_shared<DictionaryValue>();
   io_slice->append_str("name", this->name);
   io_slice->append_int("start", range.start());
   io_slice->append_int("size", range.size());
+  if (this->encoding) {
+    serialize_blob_encoding(*io_slice->append_dict("encoding"), *this->encoding);
+  }
   return io_slice;
 }
 
@@ -59,7 +151,22 @@ std::optional<BlobSlice> BlobSlice::deserialize(const DictionaryValue &io_slice)
     return std::nullopt;
   }
 
-  return BlobSlice{*name, {*start, *size}};
+  BlobSlice slice{*name, {*start, *size}};
+  if (const DictionaryValue *io_encoding = io_slice.lookup_dict("encoding")) {
+    std::optional<BlobEncoding> encoding = deserialize_blob_encoding(*io_encoding);
+    if (!encoding) {
+      return std::nullopt;
+    }
+    int64_t compressed_size = 0;
+    for (const int64_t chunk_size : encoding->compressed_chunk_sizes) {
+      compressed_size += chunk_size;
+    }
+    if (compressed_size != *size) {
+      return std::nullopt;
+    }
+    slice.encoding = std::make_shared<BlobEncoding>(std::move(*encoding));
+  }
+  return slice;
 }
 
 BlobSlice BlobWriter::write_as_stream(const StringRef /*file_extension*/,
@@ -86,8 +193,88 @@ bool BlobReader::read_as_stream(const BlobSlice &slice, FunctionRef<bool(std::is
   return true;
 }
 
+std::optional<ImplicitSharingInfoAndData> BlobReader::read_without_copy(
+    const BlobSlice & /*slice*/, const int64_t /*alignment*/) const
+{
+  return std::nullopt;
+}
+
+/** A memory-mapped blob file. */
+class MappedBlobFile : public ImplicitSharingMixin {
+ public:
+  BLI_mmap_file *file;
+
+  MappedBlobFile(BLI_mmap_file *file) : file(file) {}
+
+  ~MappedBlobFile()
+  {
+    BLI_mmap_free(file);
+  }
+
+  Span<std::byte> data() const
+  {
+    return {static_cast<const std::byte *>(BLI_mmap_get_pointer(file)),
+            int64_t(BLI_mmap_get_length(file))};
+  }
+
+ private:
+  void delete_self() override
+  {
+    MEM_delete(this);
+  }
+};
+
+/**
+ * Owns a single slice of a memory-mapped file. Every slice has its own sharing info, so that they
+ * can be modified independently. The file is mapped copy-on-write, so modifying the data in place
+ * does not change the file.
+ */
+class MappedBlobSliceSharingInfo : public ImplicitSharingInfo {
+ public:
+  ImplicitSharingPtr<MappedBlobFile> mapped_file;
+
+  MappedBlobSliceSharingInfo(ImplicitSharingPtr<MappedBlobFile> mapped_file)
+      : mapped_file(std::move(mapped_file))
+  {
+  }
+
+ private:
+  void delete_self_with_data() override
+  {
+    MEM_delete(this);
+  }
+};
+
 DiskBlobReader::DiskBlobReader(std::string blobs_dir) : blobs_dir_(std::move(blobs_dir)) {}
 
+DiskBlobReader::~DiskBlobReader() = default;
+
+const MappedBlobFile *DiskBlobReader::get_mapped_file(const StringRefNull blob_path) const
+{
+#ifdef WIN32
+  /* Mapped files can't be deleted or overwritten on Windows, which would make it impossible to
+   * bake again while the data is still used. */
+  UNUSED_VARS(blob_path);
+  return nullptr;
+#else
+  const ImplicitSharingPtr<MappedBlobFile> &mapped_file = mapped_files_.lookup_or_add_cb_as(
+      blob_path, [&]() -> ImplicitSharingPtr<MappedBlobFile> {
+        const int fd = BLI_open(blob_path.c_str(), O_BINARY | O_RDONLY, 0);
+        if (fd == -1) {
+          return {};
+        }
+        BLI_mmap_file *file = BLI_mmap_open_copy_on_write(fd);
+        /* The mapping stays valid after the file is closed. */
+        close(fd);
+        if (file == nullptr) {
+          return {};
+        }
+        return ImplicitSharingPtr<MappedBlobFile>(MEM_new<MappedBlobFile>(__func__, file));
+      });
+  return mapped_file.get();
+#endif
+}
+
 [[nodiscard]] bool DiskBlobReader::read(const BlobSlice &slice, void *r_data) const
 {
   if (slice.range.is_empty()) {
@@ -97,7 +284,12 @@ DiskBlobReader::DiskBlobReader(std::string blobs_dir) : blobs_dir_(std::move(blo
   char blob_path[FILE_MAX];
   BLI_path_join(blob_path, sizeof(blob_path), blobs_dir_.c_str(), slice.name.c_str());
 
-  std::lock_guard lock{mutex_};
+  std::unique_lock lock{mutex_};
+  if (const MappedBlobFile *mapped_file = this->get_mapped_file(blob_path)) {
+    /* The mapping is kept alive by the reader, other threads can read at the same time. */
+    lock.unlock();
+    return BLI_mmap_read(mapped_file->file, r_data, slice.range.start(), slice.range.size());
+  }
   std::unique_ptr<fstream> &blob_file = open_input_streams_.lookup_or_add_cb_as(blob_path, [&]() {
     return std::make_unique<fstream>(blob_path, std::ios::in | std::ios::binary);
   });
@@ -109,21 +301,86 @@ DiskBlobReader::DiskBlobReader(std::string blobs_dir) : blobs_dir_(std::move(blo
   return true;
 }
 
+std::optional<ImplicitSharingInfoAndData> DiskBlobReader::read_without_copy(
+    const BlobSlice &slice, const int64_t alignment) const
+{
+  if (slice.range.is_empty() || slice.range.start() % alignment != 0) {
+    return std::nullopt;
+  }
+
+  char blob_path[FILE_MAX];
+  BLI_path_join(blob_path, sizeof(blob_path), blobs_dir_.c_str(), slice.name.c_str());
+
+  std::lock_guard lock{mutex_};
+  const MappedBlobFile *mapped_file = this->get_mapped_file(blob_path);
+  if (mapped_file == nullptr) {
+    return std::nullopt;
+  }
+  const Span<std::byte> file_data = mapped_file->data();
+  if (slice.range.one_after_last() > file_data.size()) {
+    return std::nullopt;
+  }
+  /* Read errors of memory-mapped files are only detected when the memory is accessed. Touch
+   * every page of the slice now, because the data is used without any checks later on. */
+  const Span<std::byte> slice_data = file_data.slice(slice.range);
+  constexpr int64_t page_size = 4096;
+  for (int64_t i = 0; i < slice_data.size(); i += page_size) {
+    const volatile std::byte value = slice_data[i];
+    UNUSED_VARS(value);
+  }
+  if (BLI_mmap_any_io_error(mapped_file->file)) {
+    /* The mapped memory only contains zeros now, reading the data will fail as well. */
+    CLOG_ERROR(&LOG, "Error reading memory-mapped blob file: %s", blob_path);
+    return std::nullopt;
+  }
+  mapped_file->add_user();
+  const ImplicitSharingInfo *sharing_info = MEM_new<MappedBlobSliceSharingInfo>(
+      __func__, ImplicitSharingPtr<MappedBlobFile>(mapped_file));
+  return ImplicitSharingInfoAndData{sharing_info, file_data.data() + slice.range.start()};
+}
+
 DiskBlobWriter::DiskBlobWriter(std::string blob_dir, std::string base_name)
     : blob_dir_(std::move(blob_dir)), base_name_(std::move(base_name))
 {
   blob_name_ = base_name_ + ".blob";
 }
 
+/**
+ * Alignment of data in blob files. It's large enough for all types that are stored, so that
+ * arrays can be used directly from memory-mapped files.
+ */
+static constexpr int64_t blob_alignment = 16;
+
+/**
+ * Files from a previous bake may still be memory-mapped by a #DiskBlobReader. They are removed
+ * instead of being overwritten, so that the mapped data does not change.
+ */
+static void remove_previous_blob_file(const char *path)
+{
+  if (BLI_exists(path)) {
+    BLI_delete(path, false, false);
+  }
+}
+
 BlobSlice DiskBlobWriter::write(const void *data, const int64_t size)
 {
   if (!blob_stream_.is_open()) {
     char blob_path[FILE_MAX];
     BLI_path_join(blob_path, sizeof(blob_path), blob_dir_.c_str(), blob_name_.c_str());
     BLI_file_ensure_parent_dir_exists(blob_path);
+    remove_previous_blob_file(blob_path);
     blob_stream_.open(blob_path, std::ios::out | std::ios::binary);
   }
 
+  /* Align the data so that it can be used without copying when the file is memory-mapped. */
+  const int64_t padding = (blob_alignment - current_offset_ % blob_alignment) % blob_alignment;
+  if (padding > 0) {
+    static const char zeros[blob_alignment] = {};
+    blob_stream_.write(zeros, padding);
+    current_offset_ += padding;
+    total_written_size_ += padding;
+  }
+
   const int64_t old_offset = current_offset_;
   blob_stream_.write(static_cast<const char *>(data), size);
   current_offset_ += size;
@@ -149,6 +406,7 @@ BlobSlice DiskBlobWriter::write_as_stream(const StringRef file_extension,
   char path[FILE_MAX];
   BLI_path_join(path, sizeof(path), blob_dir_.c_str(), file_name.c_str());
   BLI_file_ensure_parent_dir_exists(path);
+  remove_previous_blob_file(path);
   std::fstream stream{path, std::ios::out | std::ios::binary};
   fn(stream);
   const int64_t written_bytes_num = stream.tellg();
@@ -250,15 +508,242 @@ DictionaryValuePtr BlobWriteSharing::write_implicitly_shared(
       });
 }
 
+/**
+ * Blobs are split into chunks of this size that are compressed independently. The chunks have to
+ * be large enough for the compression to be effective, but small enough so that large arrays are
+ * split into many chunks that can be processed in parallel. It is a multiple of all value sizes.
+ */
+static constexpr int64_t blob_chunk_size = 1 << 20;
+/** Smaller blobs are not compressed, because there is not much to gain. */
+static constexpr int64_t min_compressed_blob_size = 256;
+static constexpr int blob_compression_level = 3;
+/** Data is encoded relative to base data at most this many states after the base was written. */
+static constexpr int max_delta_state_distance = 8;
+
+static IndexRange get_blob_chunk_range(const int64_t chunk_index, const int64_t decoded_size)
+{
+  const int64_t start = chunk_index * blob_chunk_size;
+  return IndexRange(start, std::min(blob_chunk_size, decoded_size - start));
+}
+
+/**
+ * Combine the data with the base data and group the bytes of all values by significance. The
+ * bytes that don't form a whole value are kept at the end.
+ */
+static void shuffle_blob_chunk(const Span<std::byte> src,
+                               const std::byte *base,
+                               const int value_size,
+                               MutableSpan<std::byte> dst)
+{
+  const int64_t values_num = src.size() / value_size;
+  for (const int64_t value_i : IndexRange(values_num)) {
+    for (const int byte_i : IndexRange(value_size)) {
+      const int64_t src_i = value_i * value_size + byte_i;
+      dst[byte_i * values_num + value_i] = base ? src[src_i] ^ base[src_i] : src[src_i];
+    }
+  }
+  for (const int64_t i : src.index_range().drop_front(values_num * value_size)) {
+    dst[i] = base ? src[i] ^ base[i] : src[i];
+  }
+}
+
+/** Inverse of #shuffle_blob_chunk. */
+static void unshuffle_blob_chunk(const Span<std::byte> src,
+                                 const std::byte *base,
+                                 const int value_size,
+                                 MutableSpan<std::byte> dst)
+{
+  const int64_t values_num = src.size() / value_size;
+  for (const int64_t value_i : IndexRange(values_num)) {
+    for (const int byte_i : IndexRange(value_size)) {
+      const int64_t dst_i = value_i * value_size + byte_i;
+      const std::byte value = src[byte_i * values_num + value_i];
+      dst[dst_i] = base ? value ^ base[dst_i] : value;
+    }
+  }
+  for (const int64_t i : src.index_range().drop_front(values_num * value_size)) {
+    dst[i] = base ? src[i] ^ base[i] : src[i];
+  }
+}
+
+/**
+ * Compress the data, optionally relative to the base data of the same size.
+ * \return False if the data could not be compressed.
+ */
+[[nodiscard]] static bool encode_blob(const Span<std::byte> data,
+                                      const Span<std::byte> base_data,
+                                      const int value_size,
+                                      BlobEncoding &r_encoding,
+                                      Vector<std::byte> &r_encoded_data)
+{
+  BLI_assert(base_data.is_empty() || base_data.size() == data.size());
+  const int64_t chunks_num = int64_t(divide_ceil_ul(data.size(), blob_chunk_size));
+  Array<Vector<std::byte>> compressed_chunks(chunks_num);
+  std::atomic<bool> success = true;
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    Array<std::byte> shuffled_chunk(blob_chunk_size, NoInitialization());
+    for (const int64_t chunk_i : range) {
+      const IndexRange chunk_range = get_blob_chunk_range(chunk_i, data.size());
+      const Span<std::byte> chunk = data.slice(chunk_range);
+      const std::byte *base = base_data.is_empty() ? nullptr : &base_data[chunk_range.start()];
+      shuffle_blob_chunk(
+          chunk, base, value_size, shuffled_chunk.as_mutable_span().take_front(chunk.size()));
+
+      Vector<std::byte> &compressed_chunk = compressed_chunks[chunk_i];
+      compressed_chunk.resize(ZSTD_compressBound(chunk.size()));
+      const size_t compressed_size = ZSTD_compress(compressed_chunk.data(),
+                                                   compressed_chunk.size(),
+                                                   shuffled_chunk.data(),
+                                                   chunk.size(),
+                                                   blob_compression_level);
+      if (ZSTD_isError(compressed_size)) {
+        success = false;
+        return;
+      }
+      compressed_chunk.resize(compressed_size);
+    }
+  });
+  if (!success) {
+    return false;
+  }
+
+  r_encoding.decoded_size = data.size();
+  r_encoding.chunk_size = blob_chunk_size;
+  r_encoding.value_size = value_size;
+  r_encoding.compressed_chunk_sizes.clear();
+  r_encoded_data.clear();
+  for (const Vector<std::byte> &compressed_chunk : compressed_chunks) {
+    r_encoding.compressed_chunk_sizes.append(compressed_chunk.size());
+    r_encoded_data.extend(compressed_chunk);
+  }
+  return true;
+}
+
+bool read_blob_slice(const BlobReader &reader, const BlobSlice &slice, void *r_data)
+{
+  if (!slice.encoding) {
+    return reader.read(slice, r_data);
+  }
+  const BlobEncoding &encoding = *slice.encoding;
+  if (encoding.chunk_size != blob_chunk_size) {
+    return false;
+  }
+
+  Array<std::byte> base_data;
+  if (encoding.delta_base) {
+    base_data.reinitialize(encoding.decoded_size);
+    if (!read_blob_slice(reader, *encoding.delta_base, base_data.data())) {
+      return false;
+    }
+    if (XXH3_64bits(base_data.data(), base_data.size()) != encoding.delta_base_hash) {
+      /* The base data has been overwritten. */
+      return false;
+    }
+  }
+  Array<std::byte> encoded_data(slice.range.size(), NoInitialization());
+  if (!reader.read(slice, encoded_data.data())) {
+    return false;
+  }
+
+  const int64_t chunks_num = encoding.compressed_chunk_sizes.size();
+  Array<int64_t> chunk_offsets(chunks_num);
+  int64_t offset = 0;
+  for (const int64_t chunk_i : IndexRange(chunks_num)) {
+    chunk_offsets[chunk_i] = offset;
+    offset += encoding.compressed_chunk_sizes[chunk_i];
+  }
+
+  MutableSpan<std::byte> decoded_data(static_cast<std::byte *>(r_data), encoding.decoded_size);
+  std::atomic<bool> success = true;
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    Array<std::byte> shuffled_chunk(blob_chunk_size, NoInitialization());
+    for (const int64_t chunk_i : range) {
+      const IndexRange chunk_range = get_blob_chunk_range(chunk_i, encoding.decoded_size);
+      const size_t decompressed_size = ZSTD_decompress(shuffled_chunk.data(),
+                                                       chunk_range.size(),
+                                                       &encoded_data[chunk_offsets[chunk_i]],
+                                                       encoding.compressed_chunk_sizes[chunk_i]);
+      if (ZSTD_isError(decompressed_size) || decompressed_size != chunk_range.size()) {
+        success = false;
+        return;
+      }
+      const std::byte *base = base_data.is_empty() ? nullptr : &base_data[chunk_range.start()];
+      unshuffle_blob_chunk(shuffled_chunk.as_span().take_front(chunk_range.size()),
+                           base,
+                           encoding.value_size,
+                           decoded_data.slice(chunk_range));
+    }
+  });
+  return success;
+}
+
+BlobWriteSharing::BlobWriteSharing(const bool use_compression) : use_compression_(use_compression)
+{
+}
+
+void BlobWriteSharing::start_next_state()
+{
+  state_index_++;
+  occurrences_in_state_.clear();
+}
+
 std::shared_ptr<io::serialize::DictionaryValue> BlobWriteSharing::write_deduplicated(
-    BlobWriter &writer, const void *data, const int64_t size_in_bytes)
+    BlobWriter &writer, const void *data, const int64_t size_in_bytes, const int value_size)
 {
+  /* Assume that data of the same size written in the same order in different states contains
+   * the same values, e.g. the same attribute on different frames. */
+  const DeltaKey delta_key{
+      size_in_bytes,
+      value_size,
+      occurrences_in_state_.lookup_or_add({size_in_bytes, value_size}, 0)++};
+
   const uint64_t content_hash = XXH3_64bits(data, size_in_bytes);
-  const BlobSlice slice = slice_by_content_hash_.lookup_or_add_cb(
-      content_hash, [&]() { return writer.write(data, size_in_bytes); });
+  const BlobSlice slice = slice_by_content_hash_.lookup_or_add_cb(content_hash, [&]() {
+    if (use_compression_ && size_in_bytes >= min_compressed_blob_size) {
+      return this->write_compressed(writer,
+                                    {static_cast<const std::byte *>(data), size_in_bytes},
+                                    value_size,
+                                    delta_key);
+    }
+    return writer.write(data, size_in_bytes);
+  });
   return slice.serialize();
 }
 
+BlobSlice BlobWriteSharing::write_compressed(BlobWriter &writer,
+                                             const Span<std::byte> data,
+                                             const int value_size,
+                                             const DeltaKey &delta_key)
+{
+  BlobEncoding encoding;
+  Vector<std::byte> encoded_data;
+
+  const DeltaBase *base = delta_base_by_key_.lookup_ptr(delta_key);
+  if (base && state_index_ - base->state_index < max_delta_state_distance) {
+    /* Only use the delta if it is smaller than the base. Otherwise the data changed too much and
+     * it's better to write a new base. */
+    if (encode_blob(data, base->data, value_size, encoding, encoded_data) &&
+        encoded_data.size() < base->slice.range.size())
+    {
+      encoding.delta_base = base->slice;
+      encoding.delta_base_hash = base->data_hash;
+      BlobSlice slice = writer.write(encoded_data.data(), encoded_data.size());
+      slice.encoding = std::make_shared<BlobEncoding>(std::move(encoding));
+      return slice;
+    }
+  }
+
+  if (!encode_blob(data, {}, value_size, encoding, encoded_data)) {
+    return writer.write(data.data(), data.size());
+  }
+  BlobSlice slice = writer.write(encoded_data.data(), encoded_data.size());
+  slice.encoding = std::make_shared<BlobEncoding>(std::move(encoding));
+  delta_base_by_key_.add_overwrite(
+      delta_key,
+      DeltaBase{slice, data, XXH3_64bits(data.data(), data.size()), state_index_});
+  return slice;
+}
+
 std::optional<ImplicitSharingInfoAndData> BlobReadSharing::read_shared(
     const DictionaryValue &io_data,
     FunctionRef<std::optional<ImplicitSharingInfoAndData>()> read_fn) const
@@ -333,9 +818,10 @@ static std::shared_ptr<DictionaryValue> write_blob_raw_data_with_endian(
     BlobWriter &blob_writer,
     BlobWriteSharing &blob_sharing,
     const void *data,
-    const int64_t size_in_bytes)
+    const int64_t size_in_bytes,
+    const int value_size)
 {
-  auto io_data = blob_sharing.write_deduplicated(blob_writer, data, size_in_bytes);
+  auto io_data = blob_sharing.write_deduplicated(blob_writer, data, size_in_bytes, value_size);
   if (ENDIAN_ORDER == B_ENDIAN) {
     io_data->append_str("endian", get_endian_io_name(ENDIAN_ORDER));
   }
@@ -355,10 +841,10 @@ static std::shared_ptr<DictionaryValue> write_blob_raw_data_with_endian(
   if (!slice) {
     return false;
   }
-  if (slice->range.size() != element_size * elements_num) {
+  if (slice->decoded_size() != element_size * elements_num) {
     return false;
   }
-  if (!blob_reader.read(*slice, r_data)) {
+  if (!read_blob_slice(blob_reader, *slice, r_data)) {
     return false;
   }
   const StringRefNull stored_endian = io_data.lookup_str("endian").value_or("little");
@@ -388,9 +874,10 @@ static std::shared_ptr<DictionaryValue> write_blob_raw_data_with_endian(
 static std::shared_ptr<DictionaryValue> write_blob_raw_bytes(BlobWriter &blob_writer,
                                                              BlobWriteSharing &blob_sharing,
                                                              const void *data,
-                                                             const int64_t size_in_bytes)
+                                                             const int64_t size_in_bytes,
+                                                             const int value_size = 1)
 {
-  return blob_sharing.write_deduplicated(blob_writer, data, size_in_bytes);
+  return blob_sharing.write_deduplicated(blob_writer, data, size_in_bytes, value_size);
 }
 
 /** Read bytes ignoring endianness. */
@@ -403,10 +890,22 @@ static std::shared_ptr<DictionaryValue> write_blob_raw_bytes(BlobWriter &blob_wr
   if (!slice) {
     return false;
   }
-  if (slice->range.size() != bytes_num) {
+  if (slice->decoded_size() != bytes_num) {
     return false;
   }
-  return blob_reader.read(*slice, r_data);
+  return read_blob_slice(blob_reader, *slice, r_data);
+}
+
+/**
+ * Size of the values whose bytes are grouped together when compressing data of the given type.
+ * For vector types that is the size of the components.
+ */
+static int get_compression_value_size(const CPPType &type)
+{
+  if (type.is_any<float2, int2, float3, float4x4, ColorGeometry4f, math::Quaternion>()) {
+    return sizeof(float);
+  }
+  return type.size();
 }
 
 static std::shared_ptr<DictionaryValue> write_blob_simple_gspan(BlobWriter &blob_writer,
@@ -415,11 +914,13 @@ static std::shared_ptr<DictionaryValue> write_blob_simple_gspan(BlobWriter &blob
 {
   const CPPType &type = data.type();
   BLI_assert(type.is_trivial());
+  const int value_size = get_compression_value_size(type);
   if (type.size() == 1 || type.is<ColorGeometry4b>()) {
-    return write_blob_raw_bytes(blob_writer, blob_sharing, data.data(), data.size_in_bytes());
+    return write_blob_raw_bytes(
+        blob_writer, blob_sharing, data.data(), data.size_in_bytes(), value_size);
   }
   return write_blob_raw_data_with_endian(
-      blob_writer, blob_sharing, data.data(), data.size_in_bytes());
+      blob_writer, blob_sharing, data.data(), data.size_in_bytes(), value_size);
 }
 
 [[nodiscard]] static bool read_blob_simple_gspan(const BlobReader &blob_reader,
@@ -458,6 +959,33 @@ static std::shared_ptr<DictionaryValue> write_blob_simple_gspan(BlobWriter &blob
   return false;
 }
 
+/**
+ * Use the stored data directly if the blob reader supports that. This is not possible when the
+ * data has to be decoded or converted to a different endianness.
+ */
+[[nodiscard]] static std::optional<ImplicitSharingInfoAndData>
+read_blob_simple_gspan_without_copy(const BlobReader &blob_reader,
+                                    const DictionaryValue &io_data,
+                                    const CPPType &type,
+                                    const int64_t size)
+{
+  const std::optional<BlobSlice> slice = BlobSlice::deserialize(io_data);
+  if (!slice) {
+    return std::nullopt;
+  }
+  if (slice->encoding) {
+    return std::nullopt;
+  }
+  if (slice->range.size() != type.size() * size) {
+    return std::nullopt;
+  }
+  const StringRefNull stored_endian = io_data.lookup_str("endian").value_or("little");
+  if (stored_endian != get_endian_io_name(ENDIAN_ORDER)) {
+    return std::nullopt;
+  }
+  return blob_reader.read_without_copy(*slice, type.alignment());
+}
+
 static std::shared_ptr<DictionaryValue> write_blob_shared_simple_gspan(
     BlobWriter &blob_writer,
     BlobWriteSharing &blob_sharing,
@@ -479,6 +1007,11 @@ static std::shared_ptr<DictionaryValue> write_blob_shared_simple_gspan(
   const char *func = __func__;
   const std::optional<ImplicitSharingInfoAndData> sharing_info_and_data = blob_sharing.read_shared(
       io_data, [&]() -> std::optional<ImplicitSharingInfoAndData> {
+        if (std::optional<ImplicitSharingInfoAndData> data = read_blob_simple_gspan_without_copy(
+                blob_reader, io_data, cpp_type, size))
+        {
+          return data;
+        }
         void *data_mem = MEM_mallocN_aligned(size * cpp_type.size(), cpp_type.alignment(), func);
         if (!read_blob_simple_gspan(blob_reader, io_data, {cpp_type, data_mem, size})) {
           MEM_freeN(data_mem);
@@ -1583,6 +2116,8 @@ void serialize_bake(const BakeState &bake_state,
                     BlobWriteSharing &blob_sharing,
                     std::ostream &r_stream)
 {
+  blob_sharing.start_next_state();
+
   io::serialize::DictionaryValue io_root;
   io_root.append_int("version", bake_file_version);
   io::serialize::DictionaryValue &io_items = *io_root.append_dict("items");
@@ -0,0 +1,218 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_implicit_sharing.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_system.h"
+#include "BLI_tempfile.h"
+#include "BLI_vector.hh"
+
+#include "BKE_bake_items_serialize.hh"
+
+#include <numeric>
+
+#include BLI_SYSTEM_PID_H
+
+namespace blender::bke::bake::tests {
+
+class BakeBlobTest : public testing::Test {
+ public:
+  /* Directory that blob files are written to. Absolute path. */
+  std::string blobs_dir;
+
+  void SetUp() override
+  {
+    char temp_dir[FILE_MAX];
+    BLI_temp_directory_path_get(temp_dir, sizeof(temp_dir));
+    blobs_dir = std::string(temp_dir) + SEP_STR + "blender_bake_blob_test_" +
+                std::to_string(getpid());
+    BLI_dir_create_recursive(blobs_dir.c_str());
+  }
+
+  void TearDown() override
+  {
+    if (BLI_exists(blobs_dir.c_str())) {
+      BLI_delete(blobs_dir.c_str(), true, true);
+    }
+  }
+
+  /** Write the data like it is written for a single frame of a bake. */
+  BlobSlice write_frame(BlobWriteSharing &sharing, const StringRef frame_name, Span<float> data)
+  {
+    sharing.start_next_state();
+    DiskBlobWriter writer(blobs_dir, frame_name);
+    const std::shared_ptr<io::serialize::DictionaryValue> io_slice = sharing.write_deduplicated(
+        writer, data.data(), data.size_in_bytes(), sizeof(float));
+    /* Serialize the slice like it is stored in the meta data. */
+    return *BlobSlice::deserialize(*io_slice);
+  }
+
+  Array<float> read_frame(const BlobSlice &slice)
+  {
+    DiskBlobReader reader(blobs_dir);
+    Array<float> data(slice.decoded_size() / sizeof(float));
+    if (!read_blob_slice(reader, slice, data.data())) {
+      return {};
+    }
+    return data;
+  }
+};
+
+static Array<float> smooth_values(const int size, const float offset)
+{
+  Array<float> values(size);
+  for (const int i : values.index_range()) {
+    values[i] = float(i / 16) * 0.25f + offset;
+  }
+  return values;
+}
+
+TEST_F(BakeBlobTest, round_trip_plain)
+{
+  const Array<float> values = smooth_values(10000, 0.0f);
+  BlobWriteSharing sharing;
+  const BlobSlice slice = this->write_frame(sharing, "frame_1", values);
+  EXPECT_EQ(slice.encoding, nullptr);
+  EXPECT_EQ(slice.range.size(), values.as_span().size_in_bytes());
+  EXPECT_EQ(this->read_frame(slice).as_span(), values.as_span());
+}
+
+TEST_F(BakeBlobTest, round_trip_compressed)
+{
+  /* Use more than one chunk. */
+  const Array<float> values = smooth_values(400000, 0.0f);
+  BlobWriteSharing sharing(true);
+  const BlobSlice slice = this->write_frame(sharing, "frame_1", values);
+  ASSERT_NE(slice.encoding, nullptr);
+  EXPECT_FALSE(slice.encoding->delta_base.has_value());
+  EXPECT_GT(slice.encoding->compressed_chunk_sizes.size(), 1);
+  EXPECT_LT(slice.range.size(), values.as_span().size_in_bytes());
+  EXPECT_EQ(this->read_frame(slice).as_span(), values.as_span());
+}
+
+TEST_F(BakeBlobTest, round_trip_delta)
+{
+  const Array<float> values_1 = smooth_values(10000, 0.0f);
+  Array<float> values_2 = values_1;
+  values_2[100] = 5.0f;
+  values_2[5000] = -1.0f;
+
+  BlobWriteSharing sharing(true);
+  const BlobSlice slice_1 = this->write_frame(sharing, "frame_1", values_1);
+  const BlobSlice slice_2 = this->write_frame(sharing, "frame_2", values_2);
+  ASSERT_NE(slice_2.encoding, nullptr);
+  ASSERT_TRUE(slice_2.encoding->delta_base.has_value());
+  EXPECT_EQ(slice_2.encoding->delta_base->name, slice_1.name);
+  EXPECT_LT(slice_2.range.size(), slice_1.range.size());
+
+  EXPECT_EQ(this->read_frame(slice_1).as_span(), values_1.as_span());
+  EXPECT_EQ(this->read_frame(slice_2).as_span(), values_2.as_span());
+}
+
+TEST_F(BakeBlobTest, delta_base_baked_again)
+{
+  const Array<float> values_1 = smooth_values(10000, 0.0f);
+  Array<float> values_2 = values_1;
+  values_2[100] = 5.0f;
+
+  BlobWriteSharing sharing(true);
+  this->write_frame(sharing, "frame_1", values_1);
+  const BlobSlice slice_2 = this->write_frame(sharing, "frame_2", values_2);
+  ASSERT_TRUE(slice_2.encoding->delta_base.has_value());
+
+  /* Bake the first frame again with different data. The compressed size may be different, so
+   * make the reference point to the new data to get a valid base that has changed. */
+  BlobWriteSharing other_sharing(true);
+  const BlobSlice new_slice_1 = this->write_frame(
+      other_sharing, "frame_1", smooth_values(10000, 1.0f));
+  BlobSlice slice_2_changed_base = slice_2;
+  auto encoding = std::make_shared<BlobEncoding>(*slice_2.encoding);
+  encoding->delta_base = new_slice_1;
+  slice_2_changed_base.encoding = encoding;
+  EXPECT_FALSE(this->read_frame(new_slice_1).is_empty());
+
+  /* Decoding fails instead of returning wrong data. */
+  EXPECT_TRUE(this->read_frame(slice_2_changed_base).is_empty());
+}
+
+#ifndef WIN32
+TEST_F(BakeBlobTest, read_without_copy)
+{
+  Array<int> values(1000);
+  std::iota(values.begin(), values.end(), 0);
+
+  BlobSlice slice;
+  {
+    DiskBlobWriter writer(blobs_dir, "frame");
+    /* Write a few bytes before, so that the data has to be aligned. */
+    const char prefix[3] = {1, 2, 3};
+    writer.write(prefix, sizeof(prefix));
+    slice = writer.write(values.data(), values.as_span().size_in_bytes());
+  }
+  EXPECT_GT(slice.range.start(), 0);
+
+  std::optional<ImplicitSharingInfoAndData> data;
+  {
+    DiskBlobReader reader(blobs_dir);
+    data = reader.read_without_copy(slice, alignof(int));
+    ASSERT_TRUE(data.has_value());
+
+    /* Slices that are not aligned or that are not in the file have to be copied. */
+    EXPECT_FALSE(reader.read_without_copy({slice.name, {1, 4}}, alignof(int)).has_value());
+    EXPECT_FALSE(
+        reader.read_without_copy({slice.name, {slice.range.start(), 1 << 20}}, alignof(int))
+            .has_value());
+    EXPECT_FALSE(reader.read_without_copy({"missing.blob", {0, 4}}, alignof(int)).has_value());
+  }
+
+  /* The data stays valid after the reader has been freed. */
+  const Span<int> read_values(static_cast<const int *>(data->data), values.size());
+  EXPECT_EQ(uintptr_t(read_values.data()) % alignof(int), 0);
+  EXPECT_EQ(read_values, values.as_span());
+
+  /* The file is mapped copy-on-write, so changing the data does not change the file. */
+  ASSERT_TRUE(data->sharing_info->is_mutable());
+  const_cast<int *>(read_values.data())[0] = -1;
+  {
+    DiskBlobReader reader(blobs_dir);
+    Array<int> read_again(values.size());
+    EXPECT_TRUE(reader.read(slice, read_again.data()));
+    EXPECT_EQ(read_again.as_span(), values.as_span());
+  }
+
+  data->sharing_info->remove_user_and_delete_if_last();
+}
+
+TEST_F(BakeBlobTest, read_without_copy_many_files)
+{
+  /* More files than fit into the first chunk of the registry of memory-mapped files. */
+  const int files_num = 5000;
+  Vector<BlobSlice> slices;
+  for (int i = 0; i < files_num; i++) {
+    DiskBlobWriter writer(blobs_dir, "frame_" + std::to_string(i));
+    slices.append(writer.write(&i, sizeof(int)));
+  }
+
+  Vector<ImplicitSharingInfoAndData> data;
+  {
+    DiskBlobReader reader(blobs_dir);
+    for (const BlobSlice &slice : slices) {
+      std::optional<ImplicitSharingInfoAndData> slice_data = reader.read_without_copy(
+          slice, alignof(int));
+      ASSERT_TRUE(slice_data.has_value());
+      data.append(*slice_data);
+    }
+  }
+  for (const int i : data.index_range()) {
+    EXPECT_EQ(*static_cast<const int *>(data[i].data), i);
+    data[i].sharing_info->remove_user_and_delete_if_last();
+  }
+}
+#endif
+
+}  // namespace blender::bke::bake::tests
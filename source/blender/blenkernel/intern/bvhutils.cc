@@ -11,6 +11,8 @@
 
 #include "BLI_math_geom.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_wide_bvh.hh"
 
 #include "BKE_attribute.hh"
 #include "BKE_bvhutils.hh"
@@ -32,6 +34,11 @@ using blender::VArray;
 struct BVHCacheItem {
   bool is_filled;
   BVHTree *tree;
+  /** Filled independently of #tree by #BKE_bvhtree_from_mesh_wide_get. */
+  bool wide_is_filled;
+  /** Positions changed since #wide_tree was built, it has to be refitted before it is used. */
+  bool wide_needs_refit;
+  blender::WideBVH *wide_tree;
 };
 
 struct BVHCache {
@@ -135,11 +142,26 @@ void bvhcache_free(BVHCache *bvh_cache)
     BVHCacheItem *item = &bvh_cache->items[index];
     BLI_bvhtree_free(item->tree);
     item->tree = nullptr;
+    MEM_delete(item->wide_tree);
+    item->wide_tree = nullptr;
   }
   BLI_mutex_end(&bvh_cache->mutex);
   MEM_freeN(bvh_cache);
 }
 
+void bvhcache_tag_positions_changed(BVHCache *bvh_cache)
+{
+  for (int index = 0; index < BVHTREE_MAX_ITEM; index++) {
+    BVHCacheItem *item = &bvh_cache->items[index];
+    BLI_bvhtree_free(item->tree);
+    item->tree = nullptr;
+    item->is_filled = false;
+    /* Empty trees are not kept, because the new positions may belong to a different mesh. */
+    item->wide_is_filled = item->wide_tree != nullptr;
+    item->wide_needs_refit = item->wide_tree != nullptr;
+  }
+}
+
 /**
  * BVH-tree balancing inside a mutex lock must be run in isolation. Balancing
  * is multithreaded, and we do not want the current thread to start another task
@@ -1030,6 +1052,229 @@ BVHTree *BKE_bvhtree_from_mesh_get(BVHTreeFromMesh *data,
   return data->tree;
 }
 
+/** Gather the indices and bounds of the elements that are in the tree of the given type. */
+static void wide_bvh_mesh_primitives_get(
+    const Mesh &mesh,
+    const BVHCacheType bvh_cache_type,
+    blender::Vector<int> &r_indices,
+    blender::Array<blender::Bounds<blender::float3>> &r_bounds)
+{
+  using namespace blender;
+  using namespace blender::bke;
+  const Span<float3> positions = mesh.vert_positions();
+  const Span<int2> edges = mesh.edges();
+  const Span<int> corner_verts = mesh.corner_verts();
+
+  int elems_num = 0;
+  BitVector<> mask;
+  int mask_bits_act_len = -1;
+  switch (bvh_cache_type) {
+    case BVHTREE_FROM_VERTS:
+      elems_num = mesh.verts_num;
+      break;
+    case BVHTREE_FROM_LOOSEVERTS:
+      elems_num = mesh.verts_num;
+      mask = mesh.loose_verts().is_loose_bits;
+      break;
+    case BVHTREE_FROM_LOOSEVERTS_NO_HIDDEN:
+      elems_num = mesh.verts_num;
+      mask = loose_verts_no_hidden_mask_get(mesh, &mask_bits_act_len);
+      break;
+    case BVHTREE_FROM_EDGES:
+      elems_num = mesh.edges_num;
+      break;
+    case BVHTREE_FROM_LOOSEEDGES:
+      elems_num = mesh.edges_num;
+      mask = mesh.loose_edges().is_loose_bits;
+      break;
+    case BVHTREE_FROM_LOOSEEDGES_NO_HIDDEN:
+      elems_num = mesh.edges_num;
+      mask = loose_edges_no_hidden_mask_get(mesh, &mask_bits_act_len);
+      break;
+    case BVHTREE_FROM_CORNER_TRIS:
+      elems_num = mesh.corner_tris().size();
+      break;
+    case BVHTREE_FROM_CORNER_TRIS_NO_HIDDEN: {
+      const AttributeAccessor attributes = mesh.attributes();
+      elems_num = mesh.corner_tris().size();
+      mask = corner_tris_no_hidden_map_get(
+          mesh.faces(),
+          *attributes.lookup_or_default(".hide_poly", AttrDomain::Face, false),
+          elems_num,
+          &mask_bits_act_len);
+      break;
+    }
+    case BVHTREE_FROM_FACES:
+    case BVHTREE_MAX_ITEM:
+      BLI_assert_unreachable();
+      return;
+  }
+
+  Vector<int> &indices = r_indices;
+  indices.reserve(elems_num);
+  for (const int i : IndexRange(elems_num)) {
+    if (mask.is_empty() || mask[i]) {
+      indices.append(i);
+    }
+  }
+
+  r_bounds.reinitialize(indices.size());
+  MutableSpan<Bounds<float3>> bounds = r_bounds;
+  threading::parallel_for(indices.index_range(), 4096, [&](const IndexRange range) {
+    switch (bvh_cache_type) {
+      case BVHTREE_FROM_VERTS:
+      case BVHTREE_FROM_LOOSEVERTS:
+      case BVHTREE_FROM_LOOSEVERTS_NO_HIDDEN:
+        for (const int i : range) {
+          bounds[i] = Bounds<float3>(positions[indices[i]]);
+        }
+        break;
+      case BVHTREE_FROM_EDGES:
+      case BVHTREE_FROM_LOOSEEDGES:
+      case BVHTREE_FROM_LOOSEEDGES_NO_HIDDEN:
+        for (const int i : range) {
+          const int2 &edge = edges[indices[i]];
+          bounds[i] = {math::min(positions[edge[0]], positions[edge[1]]),
+                       math::max(positions[edge[0]], positions[edge[1]])};
+        }
+        break;
+      default: {
+        const Span<int3> corner_tris = mesh.corner_tris();
+        for (const int i : range) {
+          const int3 &tri = corner_tris[indices[i]];
+          const float3 &a = positions[corner_verts[tri[0]]];
+          const float3 &b = positions[corner_verts[tri[1]]];
+          const float3 &c = positions[corner_verts[tri[2]]];
+          bounds[i] = {math::min(math::min(a, b), c), math::max(math::max(a, b), c)};
+        }
+        break;
+      }
+    }
+  });
+}
+
+void BKE_bvhtree_from_mesh_wide_get(BVHTreeFromMesh &data,
+                                    const Mesh &mesh,
+                                    const BVHCacheType bvh_cache_type)
+{
+  using namespace blender;
+  BLI_assert(bvh_cache_type != BVHTREE_FROM_FACES);
+  Span<int3> corner_tris;
+  if (ELEM(bvh_cache_type, BVHTREE_FROM_CORNER_TRIS, BVHTREE_FROM_CORNER_TRIS_NO_HIDDEN)) {
+    corner_tris = mesh.corner_tris();
+  }
+  bvhtree_from_mesh_setup_data(nullptr,
+                               bvh_cache_type,
+                               mesh.vert_positions(),
+                               mesh.edges(),
+                               mesh.corner_verts(),
+                               corner_tris,
+                               nullptr,
+                               &data);
+
+  BVHCache **bvh_cache_p = (BVHCache **)&mesh.runtime->bvh_cache;
+  if (*bvh_cache_p == nullptr) {
+    std::lock_guard lock{mesh.runtime->eval_mutex};
+    if (*bvh_cache_p == nullptr) {
+      *bvh_cache_p = bvhcache_init();
+    }
+  }
+  BVHCache *bvh_cache = *bvh_cache_p;
+  BVHCacheItem &item = bvh_cache->items[bvh_cache_type];
+
+  BLI_mutex_lock(&bvh_cache->mutex);
+  if (!item.wide_is_filled || item.wide_needs_refit) {
+    /* Building is multi-threaded, so it must not start other tasks that wait for the mutex. */
+    threading::isolate_task([&]() {
+      Vector<int> indices;
+      Array<Bounds<float3>> bounds;
+      wide_bvh_mesh_primitives_get(mesh, bvh_cache_type, indices, bounds);
+      /* The primitives can change even when the positions changed only, e.g. when the mesh has
+       * been replaced by a new evaluated mesh or when other elements are hidden. */
+      if (item.wide_needs_refit && item.wide_tree->has_indices(indices)) {
+        /* Only positions changed, so refitting is enough unless the tree degraded too much. */
+        if (item.wide_tree->refit(bounds)) {
+          return;
+        }
+      }
+      MEM_delete(item.wide_tree);
+      item.wide_tree = MEM_new<WideBVH>(__func__, indices, bounds);
+    });
+    item.wide_is_filled = true;
+    item.wide_needs_refit = false;
+  }
+  BLI_mutex_unlock(&bvh_cache->mutex);
+
+  if (item.wide_tree && !item.wide_tree->is_empty()) {
+    data.wide_tree = item.wide_tree;
+  }
+  data.cached = true;
+}
+
+int BKE_bvhtree_from_mesh_ray_cast(const BVHTreeFromMesh &data,
+                                   const float co[3],
+                                   const float dir[3],
+                                   const float radius,
+                                   BVHTreeRayHit *hit,
+                                   BVHTree_RayCastCallback callback,
+                                   void *userdata,
+                                   const int flag)
+{
+  if (data.wide_tree) {
+    return data.wide_tree->ray_cast(
+        blender::float3(co), blender::float3(dir), radius, hit, callback, userdata, flag);
+  }
+  return BLI_bvhtree_ray_cast_ex(data.tree, co, dir, radius, hit, callback, userdata, flag);
+}
+
+int BKE_bvhtree_from_mesh_find_nearest(const BVHTreeFromMesh &data,
+                                       const float co[3],
+                                       BVHTreeNearest *nearest,
+                                       BVHTree_NearestPointCallback callback,
+                                       void *userdata,
+                                       const int flag)
+{
+  if (data.wide_tree) {
+    return data.wide_tree->find_nearest(blender::float3(co), nearest, callback, userdata);
+  }
+  return BLI_bvhtree_find_nearest_ex(data.tree, co, nearest, callback, userdata, flag);
+}
+
+void BKE_bvhtree_from_mesh_ray_cast_batch(const BVHTreeFromMesh &data,
+                                          const blender::IndexMask &mask,
+                                          const blender::Span<blender::float3> origins,
+                                          const blender::Span<blender::float3> directions,
+                                          const float radius,
+                                          blender::MutableSpan<BVHTreeRayHit> r_hits,
+                                          BVHTree_RayCastCallback callback,
+                                          void *userdata,
+                                          const int flag)
+{
+  if (data.wide_tree) {
+    data.wide_tree->ray_cast_batch(
+        mask, origins, directions, radius, r_hits, callback, userdata, flag);
+    return;
+  }
+  blender::BLI_bvhtree_ray_cast_batch(
+      *data.tree, mask, origins, directions, radius, r_hits, callback, userdata, flag);
+}
+
+void BKE_bvhtree_from_mesh_find_nearest_batch(const BVHTreeFromMesh &data,
+                                              const blender::IndexMask &mask,
+                                              const blender::Span<blender::float3> positions,
+                                              blender::MutableSpan<BVHTreeNearest> r_nearest,
+                                              BVHTree_NearestPointCallback callback,
+                                              void *userdata,
+                                              const int flag)
+{
+  if (data.wide_tree) {
+    data.wide_tree->find_nearest_batch(mask, positions, r_nearest, callback, userdata);
+    return;
+  }
+  blender::BLI_bvhtree_find_nearest_batch(
+      *data.tree, mask, positions, r_nearest, callback, userdata, flag);
+}
+
 void BKE_bvhtree_from_mesh_tris_init(const Mesh &mesh,
                                      const blender::IndexMask &faces_mask,
                                      BVHTreeFromMesh &r_data)
@@ -100,6 +100,18 @@ void BKE_callback_remove(bCallbackFuncStore *funcstore, eCbEvent evt)
   }
 }
 
+bool BKE_callback_has_active(eCbEvent evt)
+{
+  ASSERT_CALLBACKS_INITIALIZED();
+  const ListBase *lb = &callback_slots[evt];
+  LISTBASE_FOREACH (const bCallbackFuncStore *, funcstore, lb) {
+    if (funcstore->is_active == nullptr || funcstore->is_active(funcstore->arg)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void BKE_callback_global_init()
 {
   callbacks_initialized = true;
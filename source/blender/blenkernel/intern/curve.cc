@@ -5207,7 +5207,7 @@ void BKE_curve_transform_ex(Curve *cu,
 
   if (do_keys && cu->key) {
     LISTBASE_FOREACH (KeyBlock *, kb, &cu->key->block) {
-      float *fp = (float *)kb->data;
+      float *fp = (float *)BKE_keyblock_data_for_write(kb);
       int n = kb->totelem;
 
       LISTBASE_FOREACH (Nurb *, nu, &cu->nurb) {
@@ -5265,7 +5265,7 @@ void BKE_curve_translate(Curve *cu, const float offset[3], const bool do_keys)
 
   if (do_keys && cu->key) {
     LISTBASE_FOREACH (KeyBlock *, kb, &cu->key->block) {
-      float *fp = (float *)kb->data;
+      float *fp = (float *)BKE_keyblock_data_for_write(kb);
       int n = kb->totelem;
 
       LISTBASE_FOREACH (Nurb *, nu, &cu->nurb) {
@@ -109,11 +109,8 @@ void BKE_editlattice_load(Object *obedit)
     /* active key: vertices */
     tot = editlt->pntsu * editlt->pntsv * editlt->pntsw;
 
-    if (actkey->data) {
-      MEM_freeN(actkey->data);
-    }
-
-    fp = static_cast<float *>(actkey->data = MEM_callocN(lt->key->elemsize * tot, "actkey->data"));
+    fp = static_cast<float *>(MEM_callocN(lt->key->elemsize * tot, "actkey->data"));
+    BKE_keyblock_data_replace(actkey, fp);
     actkey->totelem = tot;
 
     bp = editlt->def;
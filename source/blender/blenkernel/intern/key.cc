@@ -9,12 +9,14 @@
 #include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <mutex>
 #include <optional>
 
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
 #include "BLI_endian_switch.h"
+#include "BLI_implicit_sharing.hh"
 #include "BLI_math_matrix.h"
 #include "BLI_math_vector.h"
 #include "BLI_string_utils.hh"
@@ -55,11 +57,15 @@
 
 #include "BLO_read_write.hh"
 
+/** Protects creation of the sharing info of original key-blocks, which are copied for evaluation
+ * by dependency graphs which might be evaluated from different threads. */
+static std::mutex keyblock_data_sharing_mutex;
+
 static void shapekey_copy_data(Main * /*bmain*/,
                                std::optional<Library *> /*owner_library*/,
                                ID *id_dst,
                                const ID *id_src,
-                               const int /*flag*/)
+                               const int flag)
 {
   Key *key_dst = (Key *)id_dst;
   const Key *key_src = (const Key *)id_src;
@@ -71,8 +77,26 @@ static void shapekey_copy_data(Main * /*bmain*/,
        kb_dst;
        kb_src = kb_src->next, kb_dst = kb_dst->next)
   {
+    kb_dst->data_sharing_info = nullptr;
+    kb_dst->data_previous = nullptr;
     if (kb_dst->data) {
-      kb_dst->data = MEM_dupallocN(kb_dst->data);
+      if (flag & LIB_ID_COPY_SET_COPIED_ON_WRITE) {
+        /* Evaluated copies never modify the shape data, reference the data of the original key
+         * instead of duplicating it. The original key makes it mutable before modifying it. */
+        KeyBlock *kb_src_mutable = const_cast<KeyBlock *>(kb_src);
+        std::scoped_lock lock(keyblock_data_sharing_mutex);
+        if (kb_src_mutable->data_sharing_info == nullptr) {
+          kb_src_mutable->data_sharing_info = blender::implicit_sharing::info_for_mem_free(
+              kb_src_mutable->data);
+        }
+        blender::implicit_sharing::copy_shared_pointer(kb_src_mutable->data,
+                                                       kb_src_mutable->data_sharing_info,
+                                                       &kb_dst->data,
+                                                       &kb_dst->data_sharing_info);
+      }
+      else {
+        kb_dst->data = MEM_dupallocN(kb_dst->data);
+      }
     }
     if (kb_src == key_src->refkey) {
       key_dst->refkey = kb_dst;
@@ -84,9 +108,7 @@ static void shapekey_free_data(ID *id)
 {
   Key *key = (Key *)id;
   while (KeyBlock *kb = static_cast<KeyBlock *>(BLI_pophead(&key->block))) {
-    if (kb->data) {
-      MEM_freeN(kb->data);
-    }
+    BKE_keyblock_data_free(kb);
     MEM_freeN(kb);
   }
 }
@@ -127,6 +149,8 @@ static void shapekey_blend_write(BlendWriter *writer, ID *id, const void *id_add
   /* direct data */
   LISTBASE_FOREACH (KeyBlock *, kb, &key->block) {
     KeyBlock tmp_kb = *kb;
+    tmp_kb.data_sharing_info = nullptr;
+    tmp_kb.data_previous = nullptr;
     /* Do not store actual geometry data in case this is a library override ID. */
     if (ID_IS_OVERRIDE_LIBRARY(key) && !is_undo) {
       tmp_kb.totelem = 0;
@@ -180,6 +204,8 @@ static void shapekey_blend_read_data(BlendDataReader *reader, ID *id)
 
   LISTBASE_FOREACH (KeyBlock *, kb, &key->block) {
     BLO_read_data_address(reader, &kb->data);
+    kb->data_sharing_info = nullptr;
+    kb->data_previous = nullptr;
 
     if (BLO_read_requires_endian_switch(reader)) {
       switch_endian_keyblock(key, kb);
@@ -246,9 +272,7 @@ void BKE_key_free_data(Key *key)
 void BKE_key_free_nolib(Key *key)
 {
   while (KeyBlock *kb = static_cast<KeyBlock *>(BLI_pophead(&key->block))) {
-    if (kb->data) {
-      MEM_freeN(kb->data);
-    }
+    BKE_keyblock_data_free(kb);
     MEM_freeN(kb);
   }
 }
@@ -1719,7 +1743,7 @@ void BKE_keyblock_data_set_with_mat4(Key *key,
   for (KeyBlock *kb = static_cast<KeyBlock *>(key->block.first); kb; kb = kb->next, index++) {
     if (ELEM(shape_index, -1, index)) {
       const int block_elem_len = kb->totelem;
-      float(*block_data)[3] = (float(*)[3])kb->data;
+      float(*block_data)[3] = (float(*)[3])BKE_keyblock_data_for_write(kb);
       for (int data_offset = 0; data_offset < block_elem_len; ++data_offset) {
         const float *src_data = (const float *)(elements + data_offset);
         float *dst_data = (float *)(block_data + data_offset);
@@ -1739,7 +1763,7 @@ void BKE_keyblock_curve_data_set_with_mat4(
   for (KeyBlock *kb = static_cast<KeyBlock *>(key->block.first); kb; kb = kb->next, index++) {
     if (ELEM(shape_index, -1, index)) {
       const int block_elem_size = kb->totelem * key->elemsize;
-      BKE_keyblock_curve_data_transform(nurb, mat, elements, kb->data);
+      BKE_keyblock_curve_data_transform(nurb, mat, elements, BKE_keyblock_data_for_write(kb));
       elements += block_elem_size;
     }
   }
@@ -1752,12 +1776,42 @@ void BKE_keyblock_data_set(Key *key, const int shape_index, const void *data)
   for (KeyBlock *kb = static_cast<KeyBlock *>(key->block.first); kb; kb = kb->next, index++) {
     if (ELEM(shape_index, -1, index)) {
       const int block_elem_size = kb->totelem * key->elemsize;
-      memcpy(kb->data, elements, block_elem_size);
+      memcpy(BKE_keyblock_data_for_write(kb), elements, block_elem_size);
       elements += block_elem_size;
     }
   }
 }
 
+void BKE_keyblock_data_free(KeyBlock *kb)
+{
+  kb->data_previous = nullptr;
+  if (kb->data_sharing_info) {
+    blender::implicit_sharing::free_shared_data(&kb->data, &kb->data_sharing_info);
+  }
+  else {
+    MEM_SAFE_FREE(kb->data);
+  }
+}
+
+void BKE_keyblock_data_replace(KeyBlock *kb, void *data)
+{
+  BKE_keyblock_data_free(kb);
+  kb->data = data;
+}
+
+void *BKE_keyblock_data_for_write(KeyBlock *kb)
+{
+  if (kb->data_sharing_info) {
+    const void *old_data = kb->data;
+    blender::implicit_sharing::make_trivial_data_mutable(
+        reinterpret_cast<char **>(&kb->data), &kb->data_sharing_info, MEM_allocN_len(kb->data));
+    if (kb->data != old_data) {
+      kb->data_previous = old_data;
+    }
+  }
+  return kb->data;
+}
+
 /** \} */
 
 bool BKE_key_idtype_support(const short id_type)
@@ -1983,7 +2037,7 @@ void BKE_keyblock_update_from_lattice(const Lattice *lt, KeyBlock *kb)
   }
 
   bp = lt->def;
-  fp = static_cast<float(*)[3]>(kb->data);
+  fp = static_cast<float(*)[3]>(BKE_keyblock_data_for_write(kb));
   for (a = 0; a < kb->totelem; a++, fp++, bp++) {
     copy_v3_v3(*fp, bp->vec);
   }
@@ -1998,9 +2052,7 @@ void BKE_keyblock_convert_from_lattice(const Lattice *lt, KeyBlock *kb)
     return;
   }
 
-  MEM_SAFE_FREE(kb->data);
-
-  kb->data = MEM_mallocN(lt->key->elemsize * tot, __func__);
+  BKE_keyblock_data_replace(kb, MEM_mallocN(lt->key->elemsize * tot, __func__));
   kb->totelem = tot;
 
   BKE_keyblock_update_from_lattice(lt, kb);
@@ -2060,7 +2112,7 @@ void BKE_keyblock_update_from_curve(const Curve * /*cu*/, KeyBlock *kb, const Li
     return;
   }
 
-  fp = static_cast<float *>(kb->data);
+  fp = static_cast<float *>(BKE_keyblock_data_for_write(kb));
   LISTBASE_FOREACH (Nurb *, nu, nurb) {
     if (nu->bezt) {
       for (a = nu->pntsu, bezt = nu->bezt; a; a--, bezt++) {
@@ -2124,9 +2176,7 @@ void BKE_keyblock_convert_from_curve(const Curve *cu, KeyBlock *kb, const ListBa
     return;
   }
 
-  MEM_SAFE_FREE(kb->data);
-
-  kb->data = MEM_mallocN(cu->key->elemsize * tot, __func__);
+  BKE_keyblock_data_replace(kb, MEM_mallocN(cu->key->elemsize * tot, __func__));
   kb->totelem = tot;
 
   BKE_keyblock_update_from_curve(cu, kb, nurb);
@@ -2180,7 +2230,7 @@ void BKE_keyblock_update_from_mesh(const Mesh *mesh, KeyBlock *kb)
   }
 
   const blender::Span<blender::float3> positions = mesh->vert_positions();
-  memcpy(kb->data, positions.data(), sizeof(float[3]) * tot);
+  memcpy(BKE_keyblock_data_for_write(kb), positions.data(), sizeof(float[3]) * tot);
 }
 
 void BKE_keyblock_convert_from_mesh(const Mesh *mesh, const Key *key, KeyBlock *kb)
@@ -2191,9 +2241,7 @@ void BKE_keyblock_convert_from_mesh(const Mesh *mesh, const Key *key, KeyBlock *
     return;
   }
 
-  MEM_SAFE_FREE(kb->data);
-
-  kb->data = MEM_malloc_arrayN(size_t(len), size_t(key->elemsize), __func__);
+  BKE_keyblock_data_replace(kb, MEM_malloc_arrayN(size_t(len), size_t(key->elemsize), __func__));
   kb->totelem = len;
 
   BKE_keyblock_update_from_mesh(mesh, kb);
@@ -2297,7 +2345,7 @@ void BKE_keyblock_mesh_calc_normals(const KeyBlock *kb,
 void BKE_keyblock_update_from_vertcos(const Object *ob, KeyBlock *kb, const float (*vertCos)[3])
 {
   const float(*co)[3] = vertCos;
-  float *fp = static_cast<float *>(kb->data);
+  float *fp = static_cast<float *>(BKE_keyblock_data_for_write(kb));
   int tot, a;
 
 #ifndef NDEBUG
@@ -2357,7 +2405,7 @@ void BKE_keyblock_convert_from_vertcos(const Object *ob, KeyBlock *kb, const flo
 {
   int tot = 0, elemsize;
 
-  MEM_SAFE_FREE(kb->data);
+  BKE_keyblock_data_free(kb);
 
   /* Count of vertex coords in array */
   if (ob->type == OB_MESH) {
@@ -2380,7 +2428,7 @@ void BKE_keyblock_convert_from_vertcos(const Object *ob, KeyBlock *kb, const flo
     return;
   }
 
-  kb->data = MEM_mallocN(tot * elemsize, __func__);
+  BKE_keyblock_data_replace(kb, MEM_mallocN(tot * elemsize, __func__));
 
   /* Copy coords to key-block. */
   BKE_keyblock_update_from_vertcos(ob, kb, vertCos);
@@ -2447,7 +2495,7 @@ float (*BKE_keyblock_convert_to_vertcos(const Object *ob, const KeyBlock *kb))[3
 void BKE_keyblock_update_from_offset(const Object *ob, KeyBlock *kb, const float (*ofs)[3])
 {
   int a;
-  float *fp = static_cast<float *>(kb->data);
+  float *fp = static_cast<float *>(BKE_keyblock_data_for_write(kb));
 
   if (ELEM(ob->type, OB_MESH, OB_LATTICE)) {
     for (a = 0; a < kb->totelem; a++, fp += 3, ofs++) {
@@ -35,6 +35,7 @@
 #include "BKE_deform.hh"
 #include "BKE_displist.h"
 #include "BKE_idtype.hh"
+#include "BKE_key.hh"
 #include "BKE_lattice.hh"
 #include "BKE_lib_id.hh"
 #include "BKE_lib_query.hh"
@@ -646,7 +647,7 @@ void BKE_lattice_transform(Lattice *lt, const float mat[4][4], bool do_keys)
 
   if (do_keys && lt->key) {
     LISTBASE_FOREACH (KeyBlock *, kb, &lt->key->block) {
-      float *fp = static_cast<float *>(kb->data);
+      float *fp = static_cast<float *>(BKE_keyblock_data_for_write(kb));
       for (i = kb->totelem; i--; fp += 3) {
         mul_m4_v3(mat, fp);
       }
@@ -674,7 +675,7 @@ void BKE_lattice_translate(Lattice *lt, const float offset[3], bool do_keys)
 
   if (do_keys && lt->key) {
     LISTBASE_FOREACH (KeyBlock *, kb, &lt->key->block) {
-      float *fp = static_cast<float *>(kb->data);
+      float *fp = static_cast<float *>(BKE_keyblock_data_for_write(kb));
       for (i = kb->totelem; i--; fp += 3) {
         add_v3_v3(fp, offset);
       }
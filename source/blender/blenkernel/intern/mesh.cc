@@ -1264,7 +1264,7 @@ void BKE_mesh_transform(Mesh *mesh, const float mat[4][4], bool do_keys)
 
   if (do_keys && mesh->key) {
     LISTBASE_FOREACH (KeyBlock *, kb, &mesh->key->block) {
-      float *fp = (float *)kb->data;
+      float *fp = (float *)BKE_keyblock_data_for_write(kb);
       for (int i = kb->totelem; i--; fp += 3) {
         mul_m4_v3(mat, fp);
       }
@@ -1299,7 +1299,8 @@ void BKE_mesh_translate(Mesh *mesh, const float offset[3], const bool do_keys)
   translate_positions(mesh->vert_positions_for_write(), offset);
   if (do_keys && mesh->key) {
     LISTBASE_FOREACH (KeyBlock *, kb, &mesh->key->block) {
-      translate_positions({static_cast<float3 *>(kb->data), kb->totelem}, offset);
+      translate_positions({static_cast<float3 *>(BKE_keyblock_data_for_write(kb)), kb->totelem},
+                          offset);
     }
   }
 
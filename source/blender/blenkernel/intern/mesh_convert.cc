@@ -1029,10 +1029,8 @@ static void move_shapekey_layers_to_keyblocks(const Mesh &mesh,
     const CustomDataLayer &layer = custom_data.layers[layer_index];
 
     KeyBlock *kb = keyblock_ensure_from_uid(key_dst, layer.uid, layer.name);
-    MEM_SAFE_FREE(kb->data);
-
     kb->totelem = mesh.verts_num;
-    kb->data = MEM_malloc_arrayN(kb->totelem, sizeof(float3), __func__);
+    BKE_keyblock_data_replace(kb, MEM_malloc_arrayN(kb->totelem, sizeof(float3), __func__));
     MutableSpan<float3> kb_coords(static_cast<float3 *>(kb->data), kb->totelem);
     if (kb->uid == actshape_uid) {
       mesh.attributes().lookup<float3>("position").varray.materialize(kb_coords);
@@ -1044,9 +1042,8 @@ static void move_shapekey_layers_to_keyblocks(const Mesh &mesh,
 
   LISTBASE_FOREACH (KeyBlock *, kb, &key_dst.block) {
     if (kb->totelem != mesh.verts_num) {
-      MEM_SAFE_FREE(kb->data);
       kb->totelem = mesh.verts_num;
-      kb->data = MEM_cnew_array<float3>(kb->totelem, __func__);
+      BKE_keyblock_data_replace(kb, MEM_cnew_array<float3>(kb->totelem, __func__));
       CLOG_ERROR(&LOG, "Data for shape key '%s' on mesh missing from evaluated mesh ", kb->name);
     }
   }
@@ -1125,10 +1122,8 @@ void BKE_mesh_nomain_to_meshkey(Mesh *mesh_src, Mesh *mesh_dst, KeyBlock *kb)
     return;
   }
 
-  if (kb->data) {
-    MEM_freeN(kb->data);
-  }
-  kb->data = MEM_malloc_arrayN(mesh_dst->key->elemsize, mesh_dst->verts_num, "kb->data");
+  BKE_keyblock_data_replace(
+      kb, MEM_malloc_arrayN(mesh_dst->key->elemsize, mesh_dst->verts_num, "kb->data"));
   kb->totelem = totvert;
   MutableSpan(static_cast<float3 *>(kb->data), kb->totelem).copy_from(mesh_src->vert_positions());
 }
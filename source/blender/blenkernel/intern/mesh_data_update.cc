@@ -1144,6 +1144,39 @@ static void object_get_datamask(const Depsgraph &depsgraph,
   }
 }
 
+/**
+ * Evaluated meshes are created again whenever the object is evaluated, e.g. on every frame when
+ * a deform modifier is animated. The BVH cache of the previous evaluated mesh is moved to the new
+ * one, so that its wide BVH trees can be refitted instead of being built again. The cache checks
+ * that the trees still contain the same primitives before refitting them.
+ */
+static BVHCache *take_previous_bvh_cache(Object &ob)
+{
+  ID *data_eval = ob.runtime->data_eval;
+  if (data_eval == nullptr || !ob.runtime->is_data_eval_owned || GS(data_eval->name) != ID_ME) {
+    return nullptr;
+  }
+  Mesh *mesh_eval = reinterpret_cast<Mesh *>(data_eval);
+  return std::exchange(mesh_eval->runtime->bvh_cache, nullptr);
+}
+
+static void reuse_previous_bvh_cache(Object &ob, BVHCache *bvh_cache)
+{
+  if (bvh_cache == nullptr) {
+    return;
+  }
+  ID *data_eval = ob.runtime->data_eval;
+  if (data_eval && ob.runtime->is_data_eval_owned && GS(data_eval->name) == ID_ME) {
+    Mesh *mesh_eval = reinterpret_cast<Mesh *>(data_eval);
+    if (mesh_eval->runtime->bvh_cache == nullptr) {
+      bvhcache_tag_positions_changed(bvh_cache);
+      mesh_eval->runtime->bvh_cache = bvh_cache;
+      return;
+    }
+  }
+  bvhcache_free(bvh_cache);
+}
+
 void mesh_data_update(Depsgraph &depsgraph,
                       const Scene &scene,
                       Object &ob,
@@ -1155,6 +1188,7 @@ void mesh_data_update(Depsgraph &depsgraph,
    * they aren't cleaned up properly on mode switch, causing crashes, e.g #58150. */
   BLI_assert(ob.id.tag & ID_TAG_COPIED_ON_EVAL);
 
+  BVHCache *previous_bvh_cache = take_previous_bvh_cache(ob);
   BKE_object_free_derived_caches(&ob);
   if (DEG_is_active(&depsgraph)) {
     BKE_sculpt_update_object_before_eval(&ob);
@@ -1176,6 +1210,7 @@ void mesh_data_update(Depsgraph &depsgraph,
   else {
     mesh_build_data(depsgraph, scene, ob, cddata_masks, need_mapping);
   }
+  reuse_previous_bvh_cache(ob, previous_bvh_cache);
 }
 
 Mesh *mesh_get_eval_deform(Depsgraph *depsgraph,
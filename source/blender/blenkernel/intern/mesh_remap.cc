@@ -25,6 +25,7 @@
 #include "BLI_memarena.h"
 #include "BLI_polyfill_2d.h"
 #include "BLI_rand.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "BKE_bvhutils.hh"
@@ -71,6 +72,37 @@ static bool mesh_remap_bvhtree_query_nearest(BVHTreeFromMesh *treedata,
   return false;
 }
 
+/**
+ * Batched variant of #mesh_remap_bvhtree_query_nearest for many positions, which are converted to
+ * tree coordinates first if needed. Items with no hit within \a max_dist_sq get a -1 index.
+ */
+static void mesh_remap_bvhtree_query_nearest_batch(BVHTreeFromMesh *treedata,
+                                                   const float (*positions)[3],
+                                                   const SpaceTransform *space_transform,
+                                                   const float max_dist_sq,
+                                                   blender::MutableSpan<blender::float3> r_co,
+                                                   blender::MutableSpan<BVHTreeNearest> r_nearest)
+{
+  using namespace blender;
+  threading::parallel_for(r_co.index_range(), 2048, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      r_co[i] = positions[i];
+      /* Convert the vertex to tree coordinates, if needed. */
+      if (space_transform) {
+        BLI_space_transform_apply(space_transform, r_co[i]);
+      }
+      r_nearest[i].index = -1;
+      r_nearest[i].dist_sq = max_dist_sq;
+    }
+  });
+  BKE_bvhtree_from_mesh_find_nearest_batch(*treedata,
+                                           IndexMask(r_co.size()),
+                                           r_co,
+                                           r_nearest,
+                                           treedata->nearest_callback,
+                                           treedata);
+}
+
 static bool mesh_remap_bvhtree_query_raycast(BVHTreeFromMesh *treedata,
                                              BVHTreeRayHit *rayhit,
                                              const float co[3],
@@ -479,19 +511,15 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
 
     if (mode == MREMAP_MODE_VERT_NEAREST) {
       BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_VERTS, 2);
-      nearest.index = -1;
+      blender::Array<blender::float3> tree_cos(numverts_dst);
+      blender::Array<BVHTreeNearest> nearests(numverts_dst);
+      mesh_remap_bvhtree_query_nearest_batch(
+          &treedata, vert_positions_dst, space_transform, max_dist_sq, tree_cos, nearests);
 
       for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, vert_positions_dst[i]);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
-
-        if (mesh_remap_bvhtree_query_nearest(&treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
-        {
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearest.index, &full_weight);
+        if (nearests[i].index != -1) {
+          hit_dist = sqrtf(nearests[i].dist_sq);
+          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearests[i].index, &full_weight);
         }
         else {
           /* No source for this dest vertex! */
@@ -504,25 +532,21 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
       const blender::Span<blender::float3> positions_src = me_src->vert_positions();
 
       BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
-      nearest.index = -1;
+      blender::Array<blender::float3> tree_cos(numverts_dst);
+      blender::Array<BVHTreeNearest> nearests(numverts_dst);
+      mesh_remap_bvhtree_query_nearest_batch(
+          &treedata, vert_positions_dst, space_transform, max_dist_sq, tree_cos, nearests);
 
       for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, vert_positions_dst[i]);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
-
-        if (mesh_remap_bvhtree_query_nearest(&treedata, &nearest, tmp_co, max_dist_sq, &hit_dist))
-        {
-          const blender::int2 &edge = edges_src[nearest.index];
+        if (nearests[i].index != -1) {
+          hit_dist = sqrtf(nearests[i].dist_sq);
+          const blender::int2 &edge = edges_src[nearests[i].index];
           const float *v1cos = positions_src[edge[0]];
           const float *v2cos = positions_src[edge[1]];
 
           if (mode == MREMAP_MODE_VERT_EDGE_NEAREST) {
-            const float dist_v1 = len_squared_v3v3(tmp_co, v1cos);
-            const float dist_v2 = len_squared_v3v3(tmp_co, v2cos);
+            const float dist_v1 = len_squared_v3v3(tree_cos[i], v1cos);
+            const float dist_v2 = len_squared_v3v3(tree_cos[i], v2cos);
             const int index = (dist_v1 > dist_v2) ? edge[1] : edge[0];
             mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &index, &full_weight);
           }
@@ -534,7 +558,7 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
             indices[1] = edge[1];
 
             /* Weight is inverse of point factor here... */
-            weights[0] = line_point_factor_v3(tmp_co, v2cos, v1cos);
+            weights[0] = line_point_factor_v3(tree_cos[i], v2cos, v1cos);
             CLAMP(weights[0], 0.0f, 1.0f);
             weights[1] = 1.0f - weights[0];
 
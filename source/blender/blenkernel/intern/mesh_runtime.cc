@@ -49,6 +49,13 @@ static void free_bvh_cache(MeshRuntime &mesh_runtime)
   }
 }
 
+static void tag_bvh_cache_positions_changed(MeshRuntime &mesh_runtime)
+{
+  if (mesh_runtime.bvh_cache) {
+    bvhcache_tag_positions_changed(mesh_runtime.bvh_cache);
+  }
+}
+
 static void free_batch_cache(MeshRuntime &mesh_runtime)
 {
   if (mesh_runtime.batch_cache) {
@@ -392,7 +399,7 @@ void Mesh::tag_positions_changed()
 
 void Mesh::tag_positions_changed_no_normals()
 {
-  free_bvh_cache(*this->runtime);
+  tag_bvh_cache_positions_changed(*this->runtime);
   this->runtime->corner_tris_cache.tag_dirty();
   this->runtime->bounds_cache.tag_dirty();
   this->runtime->shrinkwrap_boundary_cache.tag_dirty();
@@ -401,7 +408,7 @@ void Mesh::tag_positions_changed_no_normals()
 void Mesh::tag_positions_changed_uniformly()
 {
   /* The normals and triangulation didn't change, since all verts moved by the same amount. */
-  free_bvh_cache(*this->runtime);
+  tag_bvh_cache_positions_changed(*this->runtime);
   this->runtime->bounds_cache.tag_dirty();
 }
 
@@ -4529,9 +4529,7 @@ bool BKE_object_shapekey_remove(Main *bmain, Object *ob, KeyBlock *kb)
     }
   }
 
-  if (kb->data) {
-    MEM_freeN(kb->data);
-  }
+  BKE_keyblock_data_free(kb);
   MEM_freeN(kb);
 
   /* Unset active when all are freed. */
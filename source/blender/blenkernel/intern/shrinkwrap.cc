@@ -120,18 +120,18 @@ bool BKE_shrinkwrap_init_tree(
   data->sharp_faces = *attributes.lookup<bool>("sharp_face", AttrDomain::Face);
 
   if (shrinkType == MOD_SHRINKWRAP_NEAREST_VERTEX) {
-    data->bvh = BKE_bvhtree_from_mesh_get(&data->treeData, mesh, BVHTREE_FROM_VERTS, 2);
+    BKE_bvhtree_from_mesh_wide_get(data->treeData, *mesh, BVHTREE_FROM_VERTS);
 
-    return data->bvh != nullptr;
+    return data->treeData.wide_tree != nullptr;
   }
 
   if (mesh->faces_num <= 0) {
     return false;
   }
 
-  data->bvh = BKE_bvhtree_from_mesh_get(&data->treeData, mesh, BVHTREE_FROM_CORNER_TRIS, 4);
+  BKE_bvhtree_from_mesh_wide_get(data->treeData, *mesh, BVHTREE_FROM_CORNER_TRIS);
 
-  if (data->bvh == nullptr) {
+  if (data->treeData.wide_tree == nullptr) {
     return false;
   }
 
@@ -348,7 +348,8 @@ static void shrinkwrap_calc_nearest_vertex_cb_ex(void *__restrict userdata,
     nearest->dist_sq = FLT_MAX;
   }
 
-  BLI_bvhtree_find_nearest(treeData->tree, tmp_co, nearest, treeData->nearest_callback, treeData);
+  BKE_bvhtree_from_mesh_find_nearest(
+      *treeData, tmp_co, nearest, treeData->nearest_callback, treeData);
 
   /* Found the nearest vertex */
   if (nearest->index != -1) {
@@ -428,8 +429,13 @@ bool BKE_shrinkwrap_project_normal(char options,
 
   hit_tmp.index = -1;
 
-  BLI_bvhtree_ray_cast(
-      tree->bvh, co, no, ray_radius, &hit_tmp, tree->treeData.raycast_callback, &tree->treeData);
+  BKE_bvhtree_from_mesh_ray_cast(tree->treeData,
+                                 co,
+                                 no,
+                                 ray_radius,
+                                 &hit_tmp,
+                                 tree->treeData.raycast_callback,
+                                 &tree->treeData);
 
   if (hit_tmp.index != -1) {
     /* invert the normal first so face culling works on rotated objects */
@@ -1058,8 +1064,8 @@ void BKE_shrinkwrap_find_nearest_surface(ShrinkwrapTreeData *tree,
     printf("\n====== TARGET PROJECT START ======\n");
 #endif
 
-    BLI_bvhtree_find_nearest_ex(
-        tree->bvh, co, nearest, mesh_corner_tris_target_project, tree, BVH_NEAREST_OPTIMAL_ORDER);
+    BKE_bvhtree_from_mesh_find_nearest(
+        *treeData, co, nearest, mesh_corner_tris_target_project, tree, BVH_NEAREST_OPTIMAL_ORDER);
 
 #ifdef TRACE_TARGET_PROJECT
     printf("====== TARGET PROJECT END: %d %g ======\n\n", nearest->index, nearest->dist_sq);
@@ -1067,11 +1073,13 @@ void BKE_shrinkwrap_find_nearest_surface(ShrinkwrapTreeData *tree,
 
     if (nearest->index < 0) {
       /* fallback to simple nearest */
-      BLI_bvhtree_find_nearest(tree->bvh, co, nearest, treeData->nearest_callback, treeData);
+      BKE_bvhtree_from_mesh_find_nearest(
+          *treeData, co, nearest, treeData->nearest_callback, treeData);
     }
   }
   else {
-    BLI_bvhtree_find_nearest(tree->bvh, co, nearest, treeData->nearest_callback, treeData);
+    BKE_bvhtree_from_mesh_find_nearest(
+        *treeData, co, nearest, treeData->nearest_callback, treeData);
   }
 }
 
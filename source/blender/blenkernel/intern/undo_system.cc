@@ -419,6 +419,9 @@ void BKE_undosys_stack_limit_steps_and_memory(UndoStack *ustack, int steps, size
   size_t us_count = 0;
   for (us = static_cast<UndoStep *>(ustack->steps.last); us && us->prev; us = us->prev) {
     if (memory_limit) {
+      if (us->type->step_data_size_update) {
+        us->type->step_data_size_update(us);
+      }
       data_size_all += us->data_size;
       if (data_size_all > memory_limit) {
         CLOG_INFO(&LOG,
@@ -59,6 +59,14 @@ FileReader *BLI_filereader_new_memory(const void *data, size_t len) ATTR_WARN_UN
     ATTR_NONNULL();
 /** Create #FileReader from applying `Zstd` decompression on an underlying file. */
 FileReader *BLI_filereader_new_zstd(FileReader *base) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
+/**
+ * Same as #BLI_filereader_new_zstd, but for files with a seek table (as written by Blender) the
+ * frames following the read position are decompressed ahead of time on the task scheduler.
+ * Meant for reading whole files front to back, falls back to regular decompression when only
+ * a single thread is available.
+ */
+FileReader *BLI_filereader_new_zstd_readahead(FileReader *base) ATTR_WARN_UNUSED_RESULT
+    ATTR_NONNULL();
 /** Create #FileReader from applying `Gzip` decompression on an underlying file. */
 FileReader *BLI_filereader_new_gzip(FileReader *base) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 
@@ -308,7 +308,9 @@ extern const float bvhtree_kdop_axes[13][3];
 #ifdef __cplusplus
 
 #  include "BLI_function_ref.hh"
+#  include "BLI_index_mask_fwd.hh"
 #  include "BLI_math_vector.hh"
+#  include "BLI_span.hh"
 
 namespace blender {
 
@@ -353,6 +355,46 @@ inline void BLI_bvhtree_range_query_cpp(const BVHTree &tree,
       &fn);
 }
 
+/**
+ * Compute an order of the queries in \a mask in which consecutive queries are close to each other,
+ * so that they traverse similar parts of a tree. Queries are sorted along a Morton curve through
+ * their positions and, if \a directions is not empty, by the octant of their direction first.
+ * Small batches are kept in their original order.
+ * \param r_order: Receives the indices from \a mask, must have the same size.
+ */
+void BLI_bvhtree_batch_query_order(const IndexMask &mask,
+                                   Span<float3> positions,
+                                   Span<float3> directions,
+                                   MutableSpan<int> r_order);
+
+/**
+ * Cast a ray for every index in \a mask, in parallel and in a cache coherent order.
+ * The hits have to be initialized like for #BLI_bvhtree_ray_cast_ex, so the distance of every hit
+ * is the maximum length of its ray. The callback is called from multiple threads.
+ */
+void BLI_bvhtree_ray_cast_batch(const BVHTree &tree,
+                                const IndexMask &mask,
+                                Span<float3> origins,
+                                Span<float3> directions,
+                                float radius,
+                                MutableSpan<BVHTreeRayHit> r_hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag = BVH_RAYCAST_DEFAULT);
+
+/**
+ * Find the nearest element for every position in \a mask, in parallel and in a cache coherent
+ * order. The results have to be initialized like for #BLI_bvhtree_find_nearest_ex.
+ * The callback is called from multiple threads.
+ */
+void BLI_bvhtree_find_nearest_batch(const BVHTree &tree,
+                                    const IndexMask &mask,
+                                    Span<float3> positions,
+                                    MutableSpan<BVHTreeNearest> r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag = 0);
+
 }  // namespace blender
 
 #endif
@@ -62,6 +62,32 @@ void BLI_kdtree_nd_(range_search_cb)(
     bool (*search_cb)(void *user_data, int index, const float co[KD_DIMS], float dist_sq),
     void *user_data);
 
+/**
+ * Find the nearest points of many coordinates at once, in parallel.
+ * \param r_nearest: Receives the result of #BLI_kdtree_3d_find_nearest_n for every coordinate,
+ * at an offset of `co_index * nearest_len_capacity`.
+ * \param r_nearest_len: Receives the number of points found for every coordinate.
+ */
+void BLI_kdtree_nd_(find_nearest_n_batch)(const KDTree *tree,
+                                          const float (*co)[KD_DIMS],
+                                          uint co_len,
+                                          KDTreeNearest *r_nearest,
+                                          uint nearest_len_capacity,
+                                          uint *r_nearest_len) ATTR_NONNULL(1);
+/**
+ * Run #BLI_kdtree_3d_range_search_cb for many coordinates at once, in parallel.
+ * \param search_cb: Called from multiple threads, \a co_index is the index of the searched
+ * coordinate. A false return value stops the search for that coordinate only.
+ */
+void BLI_kdtree_nd_(range_search_batch_cb)(
+    const KDTree *tree,
+    const float (*co)[KD_DIMS],
+    uint co_len,
+    float range,
+    bool (*search_cb)(
+        void *user_data, int co_index, int index, const float co[KD_DIMS], float dist_sq),
+    void *user_data) ATTR_NONNULL(1);
+
 int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
                                          float range,
                                          bool use_index_order,
@@ -111,6 +137,29 @@ inline void BLI_kdtree_nd_(range_search_cb_cpp)(const KDTree *tree,
       const_cast<Fn *>(&fn));
 }
 
+template<typename Fn>
+inline void BLI_kdtree_nd_(range_search_batch_cb_cpp)(const KDTree *tree,
+                                                      const float (*co)[KD_DIMS],
+                                                      uint co_len,
+                                                      float distance,
+                                                      const Fn &fn)
+{
+  BLI_kdtree_nd_(range_search_batch_cb)(
+      tree,
+      co,
+      co_len,
+      distance,
+      [](void *user_data,
+         const int co_index,
+         const int index,
+         const float *co,
+         const float dist_sq) {
+        const Fn &fn = *static_cast<const Fn *>(user_data);
+        return fn(co_index, index, co, dist_sq);
+      },
+      const_cast<Fn *>(&fn));
+}
+
 template<typename Fn>
 inline int BLI_kdtree_nd_(find_nearest_cb_cpp)(const KDTree *tree,
                                                const float co[KD_DIMS],
@@ -40,6 +40,27 @@ std::shared_ptr<const T> get(const GenericKey &key, FunctionRef<std::unique_ptr<
 std::shared_ptr<CachedValue> get_base(const GenericKey &key,
                                       FunctionRef<std::unique_ptr<CachedValue>()> compute_fn);
 
+/**
+ * Returns the value that corresponds to the given key, or null if it's not cached. This can be
+ * used together with #add when the value can't be computed in a single function call.
+ */
+template<typename T> std::shared_ptr<const T> lookup(const GenericKey &key);
+std::shared_ptr<CachedValue> lookup_base(const GenericKey &key);
+
+/**
+ * Add a value for the given key. If another value has been added for the same key already, that
+ * value is kept and returned instead.
+ *
+ * If the cache is full, older values may be freed.
+ */
+std::shared_ptr<CachedValue> add(const GenericKey &key, std::shared_ptr<CachedValue> value);
+
+/**
+ * Remove the value for the given key from the cache, if it is cached. Users that still reference
+ * the value keep it alive.
+ */
+void remove(const GenericKey &key);
+
 /**
  * Set how much memory the cache is allowed to use. This is only an approximation because counting
  * the memory is not 100% accurate, and for some types the memory usage may even change over time.
@@ -64,6 +85,11 @@ inline std::shared_ptr<const T> get(const GenericKey &key,
   return std::dynamic_pointer_cast<const T>(get_base(key, compute_fn));
 }
 
+template<typename T> inline std::shared_ptr<const T> lookup(const GenericKey &key)
+{
+  return std::dynamic_pointer_cast<const T>(lookup_base(key));
+}
+
 /** \} */
 
 }  // namespace blender::memory_cache
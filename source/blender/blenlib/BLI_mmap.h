@@ -26,12 +26,21 @@ typedef struct BLI_mmap_file BLI_mmap_file;
  * Note that this seeks to the end of the file to determine its length. */
 BLI_mmap_file *BLI_mmap_open(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
 
+/* Same as #BLI_mmap_open, but the mapped memory can be written to as well. Changes are private
+ * to the process (copy-on-write) and are never written back to the file. */
+BLI_mmap_file *BLI_mmap_open_copy_on_write(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
 /* Reads length bytes from file at the given offset into dest.
  * Returns whether the operation was successful (may fail when reading beyond the file
  * end or when IO errors occur). */
 bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
     ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
 
+/* Returns whether an IO error occurred while accessing the mapped memory of the file, either in
+ * #BLI_mmap_read or when using the memory from #BLI_mmap_get_pointer directly. After an error,
+ * the mapped memory only contains zeros. */
+bool BLI_mmap_any_io_error(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 size_t BLI_mmap_get_length(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 
@@ -0,0 +1,156 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * A bounding volume hierarchy that is optimized for ray casts and nearest point queries on large
+ * sets of primitives, as an alternative to #BVHTree from `BLI_kdopbvh.h`.
+ *
+ * - The tree is built top-down with a binned surface area heuristic (SAH) instead of splitting
+ *   at the median. This results in much fewer node visits for meshes with an uneven
+ *   distribution of triangles.
+ * - Every inner node has up to four children, whose axis-aligned bounding boxes are stored per
+ *   axis. That way all children of a node can be tested at once with SIMD instructions.
+ * - Traversal is iterative and visits the children closest to the query first.
+ * - When the primitives move but stay the same otherwise, the tree can be refitted instead of
+ *   built again.
+ *
+ * The query functions use the same callbacks and result types as #BVHTree, so that existing
+ * callbacks can be used with both trees.
+ */
+
+#include "BLI_array.hh"
+#include "BLI_bounds_types.hh"
+#include "BLI_index_mask_fwd.hh"
+#include "BLI_kdopbvh.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+#include "BLI_utility_mixins.hh"
+
+namespace blender {
+
+class WideBVH : NonCopyable, NonMovable {
+ public:
+  /** Maximum number of children of every node. */
+  static constexpr int branching_factor = 4;
+  /** Maximum number of primitives in a leaf. */
+  static constexpr int max_leaf_size = 4;
+
+ private:
+  struct alignas(16) Node {
+    /** Bounds of the children, grouped by axis. Unused children have empty bounds. */
+    float bounds_min[3][branching_factor];
+    float bounds_max[3][branching_factor];
+    /**
+     * For inner children, the index of the child node. For leaves, the index of the first
+     * primitive in #prim_order_. -1 for unused children.
+     */
+    int children[branching_factor];
+    /** Number of primitives in leaves, zero for inner children. */
+    int leaf_sizes[branching_factor];
+  };
+
+  /** The root node is the first node. */
+  Array<Node> nodes_;
+  /** Primitive indices passed to callbacks, in the order in which they are stored in leaves. */
+  Array<int> prim_indices_;
+  /** Bounds of all primitives, in the same order as #prim_indices_. */
+  Array<Bounds<float3>> prim_bounds_;
+  /** Position of every primitive in the spans passed to the constructor, used when refitting. */
+  Array<int> prim_order_;
+  /** Surface area heuristic cost of the tree when it was built, see #refit. */
+  float build_cost_ = 0.0f;
+
+ public:
+  /**
+   * Build the tree. This is multi-threaded for large inputs.
+   * \param indices: The indices that are passed to callbacks for every primitive.
+   * \param bounds: Bounds of every primitive, with the same size as \a indices.
+   */
+  WideBVH(Span<int> indices, Span<Bounds<float3>> bounds);
+
+  bool is_empty() const
+  {
+    return prim_indices_.is_empty();
+  }
+
+  /** Number of primitives in the tree. */
+  int64_t size() const
+  {
+    return prim_indices_.size();
+  }
+
+  /**
+   * Whether the tree has been built with the same primitive indices in the same order. Only
+   * then it can be refitted for new bounds of the given primitives.
+   */
+  bool has_indices(Span<int> indices) const;
+
+  /**
+   * Update the bounds of all nodes after primitives moved, without changing the structure of the
+   * tree. This is much cheaper than building the tree again, but queries become slower when
+   * primitives move far from their original neighbors.
+   * \param bounds: New bounds of every primitive, in the same order as in the constructor.
+   * \return False if the quality of the tree degraded so much that building it again is better.
+   * The tree is valid in either case.
+   */
+  bool refit(Span<Bounds<float3>> bounds);
+
+  /**
+   * Find the closest hit along the ray. This behaves like #BLI_bvhtree_ray_cast_ex, except that
+   * a callback is required.
+   * \return The index of the closest hit, or -1 if nothing is hit.
+   */
+  int ray_cast(const float3 &origin,
+               const float3 &direction,
+               float radius,
+               BVHTreeRayHit *hit,
+               BVHTree_RayCastCallback callback,
+               void *userdata,
+               int flag = BVH_RAYCAST_DEFAULT) const;
+
+  /**
+   * Find the nearest primitive. This behaves like #BLI_bvhtree_find_nearest. Without a callback,
+   * the distance to the bounds of the primitives is used. Closer nodes are always visited first,
+   * similar to #BVH_NEAREST_OPTIMAL_ORDER.
+   * \return The index of the nearest primitive, or -1 if none is found.
+   */
+  int find_nearest(const float3 &co,
+                   BVHTreeNearest *nearest,
+                   BVHTree_NearestPointCallback callback,
+                   void *userdata) const;
+
+  /**
+   * Cast a ray for every index in \a mask, in parallel and in a cache coherent order. See
+   * #BLI_bvhtree_ray_cast_batch, the hits have to be initialized.
+   */
+  void ray_cast_batch(const IndexMask &mask,
+                      Span<float3> origins,
+                      Span<float3> directions,
+                      float radius,
+                      MutableSpan<BVHTreeRayHit> r_hits,
+                      BVHTree_RayCastCallback callback,
+                      void *userdata,
+                      int flag = BVH_RAYCAST_DEFAULT) const;
+
+  /**
+   * Find the nearest primitive for every position in \a mask, in parallel and in a cache coherent
+   * order. See #BLI_bvhtree_find_nearest_batch, the results have to be initialized.
+   */
+  void find_nearest_batch(const IndexMask &mask,
+                          Span<float3> positions,
+                          MutableSpan<BVHTreeNearest> r_nearest,
+                          BVHTree_NearestPointCallback callback,
+                          void *userdata) const;
+
+ private:
+  friend struct WideBVHBuilder;
+  friend struct WideBVHTraversal;
+  friend struct WideBVHRefit;
+};
+
+}  // namespace blender
@@ -8,9 +8,11 @@
 
 #include "BLI_mmap.h"
 #include "BLI_fileops.h"
-#include "BLI_listbase.h"
+#include "BLI_threads.h"
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include <string.h>
 
 #ifndef WIN32
@@ -33,6 +35,9 @@ struct BLI_mmap_file {
   /* Platform-specific handle for the mapping. */
   void *handle;
 
+  /* The mapped memory is writable, see #BLI_mmap_open_copy_on_write. */
+  bool copy_on_write;
+
   /* Flag to indicate IO errors. Needs to be volatile since it's being set from
    * within the signal handler, which is not part of the normal execution flow. */
   volatile bool io_error;
@@ -41,7 +46,7 @@ struct BLI_mmap_file {
 #ifndef WIN32
 /* When using memory-mapped files, any IO errors will result in a SIGBUS signal.
  * Therefore, we need to catch that signal and stop reading the file in question.
- * To do so, we keep a list of all current FileDatas that use memory-mapped files,
+ * To do so, we keep a registry of all current files that use memory-mapped IO,
  * and if a SIGBUS is caught, we check if the failed address is inside one of the
  * mapped regions.
  * If it is, we set a flag to indicate a failed read and remap the memory in
@@ -50,45 +55,84 @@ struct BLI_mmap_file {
  * set after it's done reading.
  * If the error occurred outside of a memory-mapped region, we call the previous
  * handler if one was configured and abort the process otherwise.
+ *
+ * The signal handler can interrupt any thread at any time, including one that is opening or
+ * freeing a file, so it must not take locks or allocate. The registry is a linked list of fixed
+ * size chunks that is only accessed with atomic operations. New chunks are appended when all
+ * slots are in use, chunks are never freed, so the handler can always walk the list safely.
+ * A file is only freed once no signal handler looks at it anymore.
  */
 
+#  define MMAP_REGISTRY_CHUNK_SIZE 1024
+
+typedef struct MMapRegistryChunk {
+  BLI_mmap_file *files[MMAP_REGISTRY_CHUNK_SIZE];
+  struct MMapRegistryChunk *next;
+} MMapRegistryChunk;
+
 static struct error_handler_data {
-  ListBase open_mmaps;
+  /* First chunk of the registry, further chunks are allocated when needed. */
+  MMapRegistryChunk open_mmaps;
+  /* Number of signal handlers that are currently looking at the registry. */
+  size_t active_handlers;
   char configured;
   void (*next_handler)(int, siginfo_t *, void *);
-} error_handler = {0};
+} error_handler = {{{0}}};
+
+/* Setting up the handler may happen from multiple threads at the same time. */
+static ThreadMutex error_handler_mutex = BLI_MUTEX_INITIALIZER;
+
+/* Only async-signal-safe functions may be used in the signal handler, which excludes `fprintf`. */
+static void sigbus_handler_print(const char *message)
+{
+  const ssize_t written = write(STDERR_FILENO, message, strlen(message));
+  UNUSED_VARS(written);
+}
 
 static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 {
   /* We only handle SIGBUS here for now. */
   BLI_assert(sig == SIGBUS);
 
+  atomic_add_and_fetch_z(&error_handler.active_handlers, 1);
+
   const char *error_addr = (const char *)siginfo->si_addr;
   /* Find the file that this error belongs to. */
-  LISTBASE_FOREACH (LinkData *, link, &error_handler.open_mmaps) {
-    BLI_mmap_file *file = link->data;
-
-    /* Is the address where the error occurred in this file's mapped range? */
-    if (error_addr >= file->memory && error_addr < file->memory + file->length) {
-      file->io_error = true;
-
-      /* Replace the mapped memory with zeroes. */
-      const void *mapped_memory = mmap(
-          file->memory, file->length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
-      if (mapped_memory == MAP_FAILED) {
-        fprintf(stderr, "SIGBUS handler: Error replacing mapped file with zeros\n");
+  for (MMapRegistryChunk *chunk = &error_handler.open_mmaps; chunk != NULL;
+       chunk = atomic_load_ptr((void **)&chunk->next))
+  {
+    for (int i = 0; i < MMAP_REGISTRY_CHUNK_SIZE; i++) {
+      BLI_mmap_file *file = atomic_load_ptr((void **)&chunk->files[i]);
+      if (file == NULL) {
+        continue;
       }
 
-      return;
+      /* Is the address where the error occurred in this file's mapped range? */
+      if (error_addr >= file->memory && error_addr < file->memory + file->length) {
+        file->io_error = true;
+
+        /* Replace the mapped memory with zeroes. */
+        const int prot = file->copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        const void *mapped_memory = mmap(
+            file->memory, file->length, prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+        if (mapped_memory == MAP_FAILED) {
+          sigbus_handler_print("SIGBUS handler: Error replacing mapped file with zeros\n");
+        }
+
+        atomic_sub_and_fetch_z(&error_handler.active_handlers, 1);
+        return;
+      }
     }
   }
 
+  atomic_sub_and_fetch_z(&error_handler.active_handlers, 1);
+
   /* Fall back to other handler if there was one. */
   if (error_handler.next_handler) {
     error_handler.next_handler(sig, siginfo, ptr);
   }
   else {
-    fprintf(stderr, "Unhandled SIGBUS caught\n");
+    sigbus_handler_print("Unhandled SIGBUS caught\n");
     abort();
   }
 }
@@ -96,6 +140,7 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 /* Ensures that the error handler is set up and ready. */
 static bool sigbus_handler_setup(void)
 {
+  BLI_mutex_lock(&error_handler_mutex);
   if (!error_handler.configured) {
     struct sigaction newact = {0}, oldact = {0};
 
@@ -103,6 +148,7 @@ static bool sigbus_handler_setup(void)
     newact.sa_flags = SA_SIGINFO;
 
     if (sigaction(SIGBUS, &newact, &oldact)) {
+      BLI_mutex_unlock(&error_handler_mutex);
       return false;
     }
 
@@ -111,25 +157,70 @@ static bool sigbus_handler_setup(void)
     error_handler.next_handler = oldact.sa_sigaction;
     error_handler.configured = 1;
   }
+  BLI_mutex_unlock(&error_handler_mutex);
 
   return true;
 }
 
-/* Adds a file to the list that the error handler checks. */
-static void sigbus_handler_add(BLI_mmap_file *file)
+/* Adds a file to the registry that the error handler checks, the registry grows when it is full.
+ * Returns false if no memory for a new chunk could be allocated, in which case the file can't be
+ * mapped safely. */
+static bool sigbus_handler_add(BLI_mmap_file *file)
+{
+  MMapRegistryChunk *chunk = &error_handler.open_mmaps;
+  while (true) {
+    for (int i = 0; i < MMAP_REGISTRY_CHUNK_SIZE; i++) {
+      if (atomic_cas_ptr((void **)&chunk->files[i], NULL, file) == NULL) {
+        return true;
+      }
+    }
+    MMapRegistryChunk *next = atomic_load_ptr((void **)&chunk->next);
+    if (next == NULL) {
+      /* Not using guarded allocation, because the chunks are never freed. The new chunk is
+       * published after the file has been added, so that it does not have to be searched again
+       * by other threads. */
+      MMapRegistryChunk *new_chunk = calloc(1, sizeof(MMapRegistryChunk));
+      if (new_chunk == NULL) {
+        return false;
+      }
+      new_chunk->files[0] = file;
+      next = atomic_cas_ptr((void **)&chunk->next, NULL, new_chunk);
+      if (next == NULL) {
+        return true;
+      }
+      /* Another thread appended a chunk in the meantime, continue with that one. */
+      free(new_chunk);
+    }
+    chunk = next;
+  }
+}
+
+static void sigbus_handler_registry_remove(BLI_mmap_file *file)
 {
-  BLI_addtail(&error_handler.open_mmaps, BLI_genericNodeN(file));
+  for (MMapRegistryChunk *chunk = &error_handler.open_mmaps; chunk != NULL;
+       chunk = atomic_load_ptr((void **)&chunk->next))
+  {
+    for (int i = 0; i < MMAP_REGISTRY_CHUNK_SIZE; i++) {
+      if (atomic_cas_ptr((void **)&chunk->files[i], file, NULL) == file) {
+        return;
+      }
+    }
+  }
 }
 
-/* Removes a file from the list that the error handler checks. */
+/* Removes a file from the registry that the error handler checks. Afterwards, the file can be
+ * freed safely. */
 static void sigbus_handler_remove(BLI_mmap_file *file)
 {
-  LinkData *link = BLI_findptr(&error_handler.open_mmaps, file, offsetof(LinkData, data));
-  BLI_freelinkN(&error_handler.open_mmaps, link);
+  sigbus_handler_registry_remove(file);
+  /* A signal handler in another thread may still look at the file. */
+  while (atomic_load_z(&error_handler.active_handlers) != 0) {
+    /* Spin, the handler only compares a few addresses. */
+  }
 }
 #endif
 
-BLI_mmap_file *BLI_mmap_open(int fd)
+static BLI_mmap_file *mmap_open_ex(int fd, const bool copy_on_write)
 {
   void *memory, *handle = NULL;
   const size_t length = BLI_lseek(fd, 0, SEEK_END);
@@ -144,7 +235,8 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   }
 
   /* Map the given file to memory. */
-  memory = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  const int prot = copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  memory = mmap(NULL, length, prot, MAP_PRIVATE, fd, 0);
   if (memory == MAP_FAILED) {
     return NULL;
   }
@@ -154,11 +246,12 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   /* Memory mapping on Windows is a two-step process - first we create a mapping,
    * then we create a view into that mapping.
    * In our case, one view that spans the entire file is enough. */
-  handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  handle = CreateFileMapping(
+      file_handle, NULL, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
   if (handle == NULL) {
     return NULL;
   }
-  memory = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+  memory = MapViewOfFile(handle, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
   if (memory == NULL) {
     CloseHandle(handle);
     return NULL;
@@ -170,15 +263,30 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   file->memory = memory;
   file->handle = handle;
   file->length = length;
+  file->copy_on_write = copy_on_write;
 
 #ifndef WIN32
   /* Register the file with the error handler. */
-  sigbus_handler_add(file);
+  if (!sigbus_handler_add(file)) {
+    munmap(memory, length);
+    MEM_freeN(file);
+    return NULL;
+  }
 #endif
 
   return file;
 }
 
+BLI_mmap_file *BLI_mmap_open(int fd)
+{
+  return mmap_open_ex(fd, false);
+}
+
+BLI_mmap_file *BLI_mmap_open_copy_on_write(int fd)
+{
+  return mmap_open_ex(fd, true);
+}
+
 bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
 {
   /* If a previous read has already failed or we try to read past the end,
@@ -208,6 +316,11 @@ bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length
   return !file->io_error;
 }
 
+bool BLI_mmap_any_io_error(const BLI_mmap_file *file)
+{
+  return file->io_error;
+}
+
 void *BLI_mmap_get_pointer(BLI_mmap_file *file)
 {
   return file->memory;
@@ -221,8 +334,9 @@ size_t BLI_mmap_get_length(const BLI_mmap_file *file)
 void BLI_mmap_free(BLI_mmap_file *file)
 {
 #ifndef WIN32
-  munmap((void *)file->memory, file->length);
+  /* Unregister first, a new mapping may reuse the same address range afterwards. */
   sigbus_handler_remove(file);
+  munmap((void *)file->memory, file->length);
 #else
   UnmapViewOfFile(file->memory);
   CloseHandle(file->handle);
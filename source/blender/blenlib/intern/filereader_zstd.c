@@ -11,6 +11,8 @@
 
 #include "BLI_filereader.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #ifdef __BIG_ENDIAN__
 #  include "BLI_endian_switch.h"
@@ -18,6 +20,59 @@
 
 #include "MEM_guardedalloc.h"
 
+/**
+ * Upper bound for the number of frames that are decompressed ahead of the reader.
+ * Frames written by Blender are 1 MB each, so this also bounds the memory used.
+ */
+#define ZSTD_READAHEAD_MAX_FRAMES 32
+
+typedef enum eZstdFrameSlotState {
+  ZSTD_SLOT_EMPTY = 0,
+  /** Compressed data is loaded, waiting for a worker (or the reader) to pick it up. */
+  ZSTD_SLOT_QUEUED,
+  /** Being decompressed, only the thread that claimed the slot may access its buffers. */
+  ZSTD_SLOT_RUNNING,
+  ZSTD_SLOT_DONE,
+  ZSTD_SLOT_FAILED,
+} eZstdFrameSlotState;
+
+typedef struct ZstdFrameSlot {
+  int frame;
+  eZstdFrameSlotState state;
+
+  char *compressed_data;
+  size_t compressed_size;
+  char *uncompressed_data;
+  size_t uncompressed_size;
+} ZstdFrameSlot;
+
+/**
+ * Window of frames following the read position that are decompressed on the task scheduler.
+ * Slot `i` holds frame `first_frame + k` where `(first_frame + k) % window_size == i`.
+ *
+ * Only the thread owning the #FileReader reads from the base file, workers only decompress.
+ * Slot state changes are protected by `mutex`, the buffers belong to whoever moved the slot into
+ * its current state.
+ */
+typedef struct ZstdReadahead {
+  TaskPool *pool;
+  ThreadMutex mutex;
+  ThreadCondition cond;
+
+  ZstdFrameSlot *slots;
+  int window_size;
+
+  /** First frame that is still needed by the reader. */
+  int first_frame;
+  /** Next frame to be queued for decompression. */
+  int next_frame;
+} ZstdReadahead;
+
+typedef struct ZstdReadaheadTask {
+  ZstdFrameSlot *slot;
+  int frame;
+} ZstdReadaheadTask;
+
 typedef struct {
   FileReader reader;
 
@@ -35,6 +90,9 @@ typedef struct {
     char *cached_content;
     int cached_frame;
   } seek;
+
+  /** Only used for seekable files opened with #BLI_filereader_new_zstd_readahead. */
+  ZstdReadahead *readahead;
 } ZstdReader;
 
 static bool zstd_read_u32(FileReader *base, uint32_t *val)
@@ -157,6 +215,192 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Frame Read-Ahead
+ *
+ * Decompress the frames following the read position on the task scheduler, so that reading a
+ * seekable file mostly just copies out of already decompressed frames.
+ * \{ */
+
+/* Decompress a slot that was claimed by the calling thread. */
+static void zstd_frame_slot_decompress(ZstdReadahead *ra, ZstdFrameSlot *slot)
+{
+  size_t res = ZSTD_decompress(slot->uncompressed_data,
+                               slot->uncompressed_size,
+                               slot->compressed_data,
+                               slot->compressed_size);
+  const bool success = !ZSTD_isError(res) && res >= slot->uncompressed_size;
+
+  MEM_freeN(slot->compressed_data);
+  slot->compressed_data = NULL;
+
+  BLI_mutex_lock(&ra->mutex);
+  slot->state = success ? ZSTD_SLOT_DONE : ZSTD_SLOT_FAILED;
+  BLI_condition_notify_all(&ra->cond);
+  BLI_mutex_unlock(&ra->mutex);
+}
+
+static void zstd_readahead_task_run(TaskPool *__restrict pool, void *taskdata)
+{
+  ZstdReadahead *ra = BLI_task_pool_user_data(pool);
+  ZstdReadaheadTask *task = taskdata;
+  ZstdFrameSlot *slot = task->slot;
+
+  /* The reader may have claimed the slot itself or recycled it for another frame already. */
+  BLI_mutex_lock(&ra->mutex);
+  const bool claimed = slot->frame == task->frame && slot->state == ZSTD_SLOT_QUEUED;
+  if (claimed) {
+    slot->state = ZSTD_SLOT_RUNNING;
+  }
+  BLI_mutex_unlock(&ra->mutex);
+
+  if (claimed) {
+    zstd_frame_slot_decompress(ra, slot);
+  }
+}
+
+/* Wait until no thread works on the slot anymore and free its buffers. */
+static void zstd_frame_slot_release(ZstdReadahead *ra, ZstdFrameSlot *slot)
+{
+  BLI_mutex_lock(&ra->mutex);
+  while (slot->state == ZSTD_SLOT_RUNNING) {
+    BLI_condition_wait(&ra->cond, &ra->mutex);
+  }
+  slot->state = ZSTD_SLOT_EMPTY;
+  slot->frame = -1;
+  BLI_mutex_unlock(&ra->mutex);
+
+  MEM_SAFE_FREE(slot->compressed_data);
+  MEM_SAFE_FREE(slot->uncompressed_data);
+}
+
+/* Load the compressed data of the frame and hand it to the task scheduler. */
+static bool zstd_readahead_queue(ZstdReader *zstd, int frame)
+{
+  ZstdReadahead *ra = zstd->readahead;
+  ZstdFrameSlot *slot = &ra->slots[frame % ra->window_size];
+  zstd_frame_slot_release(ra, slot);
+
+  size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
+  size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
+                             zstd->seek.uncompressed_ofs[frame];
+
+  char *compressed_data = MEM_mallocN(compressed_size, __func__);
+  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
+      zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
+  {
+    MEM_freeN(compressed_data);
+    return false;
+  }
+
+  slot->compressed_data = compressed_data;
+  slot->compressed_size = compressed_size;
+  slot->uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
+  slot->uncompressed_size = uncompressed_size;
+
+  BLI_mutex_lock(&ra->mutex);
+  slot->frame = frame;
+  slot->state = ZSTD_SLOT_QUEUED;
+  BLI_mutex_unlock(&ra->mutex);
+
+  ZstdReadaheadTask *task = MEM_mallocN(sizeof(ZstdReadaheadTask), __func__);
+  task->slot = slot;
+  task->frame = frame;
+  BLI_task_pool_push(ra->pool, zstd_readahead_task_run, task, true, NULL);
+  return true;
+}
+
+static void zstd_readahead_discard(ZstdReadahead *ra)
+{
+  for (int i = 0; i < ra->window_size; i++) {
+    zstd_frame_slot_release(ra, &ra->slots[i]);
+  }
+}
+
+static const char *zstd_ensure_cache_readahead(ZstdReader *zstd, int frame)
+{
+  ZstdReadahead *ra = zstd->readahead;
+
+  /* The previously cached frame is owned by its slot, which may be recycled below. */
+  zstd->seek.cached_frame = -1;
+  zstd->seek.cached_content = NULL;
+
+  if (frame < ra->first_frame || frame >= ra->next_frame) {
+    /* Seeking outside of the window, so restart decompression at the new position. */
+    zstd_readahead_discard(ra);
+    ra->next_frame = frame;
+  }
+  ra->first_frame = frame;
+
+  /* Top up the window, frames before `frame` are not needed anymore so their slots are reused. */
+  const int window_end = min_ii(frame + ra->window_size, zstd->seek.frames_num);
+  while (ra->next_frame < window_end) {
+    if (!zstd_readahead_queue(zstd, ra->next_frame)) {
+      break;
+    }
+    ra->next_frame++;
+  }
+
+  ZstdFrameSlot *slot = &ra->slots[frame % ra->window_size];
+
+  BLI_mutex_lock(&ra->mutex);
+  if (slot->frame != frame) {
+    /* Reading the compressed data failed. */
+    BLI_mutex_unlock(&ra->mutex);
+    return NULL;
+  }
+  if (slot->state == ZSTD_SLOT_QUEUED) {
+    /* No worker picked up the frame yet, decompress it here instead of waiting. */
+    slot->state = ZSTD_SLOT_RUNNING;
+    BLI_mutex_unlock(&ra->mutex);
+    zstd_frame_slot_decompress(ra, slot);
+    BLI_mutex_lock(&ra->mutex);
+  }
+  while (slot->state == ZSTD_SLOT_RUNNING) {
+    BLI_condition_wait(&ra->cond, &ra->mutex);
+  }
+  const bool success = slot->state == ZSTD_SLOT_DONE;
+  BLI_mutex_unlock(&ra->mutex);
+
+  if (!success) {
+    return NULL;
+  }
+
+  zstd->seek.cached_frame = frame;
+  zstd->seek.cached_content = slot->uncompressed_data;
+  return slot->uncompressed_data;
+}
+
+static ZstdReadahead *zstd_readahead_new(int window_size)
+{
+  ZstdReadahead *ra = MEM_callocN(sizeof(ZstdReadahead), __func__);
+  ra->window_size = window_size;
+  ra->slots = MEM_calloc_arrayN(window_size, sizeof(ZstdFrameSlot), __func__);
+  for (int i = 0; i < window_size; i++) {
+    ra->slots[i].frame = -1;
+  }
+  BLI_mutex_init(&ra->mutex);
+  BLI_condition_init(&ra->cond);
+  ra->pool = BLI_task_pool_create(ra, TASK_PRIORITY_HIGH);
+  return ra;
+}
+
+static void zstd_readahead_free(ZstdReadahead *ra)
+{
+  /* Skip frames that were not started yet and wait for the running ones. */
+  BLI_task_pool_cancel(ra->pool);
+  BLI_task_pool_free(ra->pool);
+
+  zstd_readahead_discard(ra);
+  MEM_freeN(ra->slots);
+
+  BLI_condition_end(&ra->cond);
+  BLI_mutex_end(&ra->mutex);
+  MEM_freeN(ra);
+}
+
+/** \} */
+
 /* Ensure that the currently loaded frame is the correct one. */
 static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
 {
@@ -165,6 +409,10 @@ static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
     return zstd->seek.cached_content;
   }
 
+  if (zstd->readahead) {
+    return zstd_ensure_cache_readahead(zstd, frame);
+  }
+
   /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
   MEM_SAFE_FREE(zstd->seek.cached_content);
 
@@ -282,6 +530,11 @@ static void zstd_close(FileReader *reader)
   ZstdReader *zstd = (ZstdReader *)reader;
 
   ZSTD_freeDCtx(zstd->ctx);
+  if (zstd->readahead) {
+    zstd_readahead_free(zstd->readahead);
+    /* The cached frame was owned by the read-ahead window. */
+    zstd->seek.cached_content = NULL;
+  }
   if (zstd->reader.seek) {
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
@@ -298,7 +551,7 @@ static void zstd_close(FileReader *reader)
   MEM_freeN(zstd);
 }
 
-FileReader *BLI_filereader_new_zstd(FileReader *base)
+static FileReader *zstd_filereader_new(FileReader *base, const bool use_readahead)
 {
   ZstdReader *zstd = MEM_callocN(sizeof(ZstdReader), __func__);
 
@@ -308,6 +561,13 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
   if (zstd_read_seek_table(zstd)) {
     zstd->reader.read = zstd_read_seekable;
     zstd->reader.seek = zstd_seek;
+
+    /* Keep two frames per thread in flight, so workers don't idle while the reader catches up. */
+    const int threads_num = BLI_task_scheduler_num_threads();
+    if (use_readahead && threads_num > 1 && zstd->seek.frames_num > 1) {
+      zstd->readahead = zstd_readahead_new(
+          min_iii(threads_num * 2, zstd->seek.frames_num, ZSTD_READAHEAD_MAX_FRAMES));
+    }
   }
   else {
     zstd->reader.read = zstd_read;
@@ -327,3 +587,13 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
 
   return (FileReader *)zstd;
 }
+
+FileReader *BLI_filereader_new_zstd(FileReader *base)
+{
+  return zstd_filereader_new(base, false);
+}
+
+FileReader *BLI_filereader_new_zstd_readahead(FileReader *base)
+{
+  return zstd_filereader_new(base, true);
+}
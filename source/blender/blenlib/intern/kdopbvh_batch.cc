@@ -0,0 +1,121 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ *
+ * Batched queries on #BVHTree. The traversal itself is implemented in `BLI_kdopbvh.c`.
+ */
+
+#include "BLI_array.hh"
+#include "BLI_bounds.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_kdopbvh.h"
+#include "BLI_sort.hh"
+#include "BLI_task.hh"
+
+namespace blender {
+
+/** Batches with fewer queries are not reordered, sorting them costs more than it gains. */
+static constexpr int64_t batch_sort_threshold = 1024;
+/** Queries are relatively expensive, so parallelize over small chunks. */
+static constexpr int64_t batch_grain_size = 256;
+
+/** Spread the lower 10 bits of the value so that there are two zero bits between each bit. */
+static uint32_t expand_bits_10(uint32_t value)
+{
+  value &= 0x3ffu;
+  value = (value | (value << 16)) & 0x030000ffu;
+  value = (value | (value << 8)) & 0x0300f00fu;
+  value = (value | (value << 4)) & 0x030c30c3u;
+  value = (value | (value << 2)) & 0x09249249u;
+  return value;
+}
+
+static uint32_t morton_code(const float3 &position, const Bounds<float3> &bounds)
+{
+  const float3 size = bounds.max - bounds.min;
+  uint32_t code = 0;
+  for (const int axis : IndexRange(3)) {
+    const float factor = size[axis] > 0.0f ? (position[axis] - bounds.min[axis]) / size[axis] :
+                                             0.0f;
+    const uint32_t quantized = uint32_t(std::clamp(factor * 1024.0f, 0.0f, 1023.0f));
+    code |= expand_bits_10(quantized) << axis;
+  }
+  return code;
+}
+
+void BLI_bvhtree_batch_query_order(const IndexMask &mask,
+                                   const Span<float3> positions,
+                                   const Span<float3> directions,
+                                   MutableSpan<int> r_order)
+{
+  BLI_assert(r_order.size() == mask.size());
+  mask.to_indices(r_order);
+  if (mask.size() < batch_sort_threshold) {
+    return;
+  }
+  const Bounds<float3> bounds = *bounds::min_max(mask, positions);
+
+  /* Pairs of sort key and index. Equal keys are ordered by index, to get a deterministic order. */
+  Array<std::pair<uint64_t, int>> sorted(mask.size());
+  threading::parallel_for(r_order.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const int index = r_order[i];
+      uint64_t key = morton_code(positions[index], bounds);
+      if (!directions.is_empty()) {
+        const float3 &direction = directions[index];
+        const uint64_t octant = (direction.x < 0.0f) | ((direction.y < 0.0f) << 1) |
+                                ((direction.z < 0.0f) << 2);
+        key |= octant << 32;
+      }
+      sorted[i] = {key, index};
+    }
+  });
+  parallel_sort(sorted.begin(), sorted.end());
+  threading::parallel_for(r_order.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      r_order[i] = sorted[i].second;
+    }
+  });
+}
+
+void BLI_bvhtree_ray_cast_batch(const BVHTree &tree,
+                                const IndexMask &mask,
+                                const Span<float3> origins,
+                                const Span<float3> directions,
+                                const float radius,
+                                MutableSpan<BVHTreeRayHit> r_hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                const int flag)
+{
+  Array<int> order(mask.size());
+  BLI_bvhtree_batch_query_order(mask, origins, directions, order);
+  threading::parallel_for(order.index_range(), batch_grain_size, [&](const IndexRange range) {
+    for (const int i : order.as_span().slice(range)) {
+      BLI_bvhtree_ray_cast_ex(
+          &tree, origins[i], directions[i], radius, &r_hits[i], callback, userdata, flag);
+    }
+  });
+}
+
+void BLI_bvhtree_find_nearest_batch(const BVHTree &tree,
+                                    const IndexMask &mask,
+                                    const Span<float3> positions,
+                                    MutableSpan<BVHTreeNearest> r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    const int flag)
+{
+  Array<int> order(mask.size());
+  BLI_bvhtree_batch_query_order(mask, positions, {}, order);
+  threading::parallel_for(order.index_range(), batch_grain_size, [&](const IndexRange range) {
+    for (const int i : order.as_span().slice(range)) {
+      BLI_bvhtree_find_nearest_ex(&tree, positions[i], &r_nearest[i], callback, userdata, flag);
+    }
+  });
+}
+
+}  // namespace blender
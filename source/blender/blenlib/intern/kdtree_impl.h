@@ -10,6 +10,7 @@
 
 #include "BLI_kdtree_impl.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include <string.h>
@@ -50,6 +51,11 @@ struct KDTree {
 
 #define KD_NODE_UNSET ((uint)-1)
 
+/** Sub-trees with fewer nodes are balanced by a single thread. */
+#define KD_BALANCE_PARALLEL_MIN 8192
+/** Batched queries are distributed over threads in chunks of this size. */
+#define KD_BATCH_CHUNK_SIZE 64
+
 /**
  * When set we know all values are unbalanced,
  * otherwise clear them when re-balancing: see #62210.
@@ -139,19 +145,16 @@ void BLI_kdtree_nd_(insert)(KDTree *tree, int index, const float co[KD_DIMS])
 #endif
 }
 
-static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const uint ofs)
+/**
+ * Partition the nodes around the median along the axis, so that all nodes before it are smaller
+ * and all nodes after it are larger.
+ * \return The index of the median, which is the root of the (sub) tree.
+ */
+static uint kdtree_balance_partition(KDTreeNode *nodes, uint nodes_len, uint axis)
 {
-  KDTreeNode *node;
   float co;
   uint left, right, median, i, j;
 
-  if (nodes_len <= 0) {
-    return KD_NODE_UNSET;
-  }
-  else if (nodes_len == 1) {
-    return 0 + ofs;
-  }
-
   /* Quick-sort style sorting around median. */
   left = 0;
   right = nodes_len - 1;
@@ -184,9 +187,25 @@ static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const u
     }
   }
 
+  nodes[median].d = axis;
+  return median;
+}
+
+static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const uint ofs)
+{
+  KDTreeNode *node;
+  uint median;
+
+  if (nodes_len <= 0) {
+    return KD_NODE_UNSET;
+  }
+  else if (nodes_len == 1) {
+    return 0 + ofs;
+  }
+
   /* Set node and sort sub-nodes. */
+  median = kdtree_balance_partition(nodes, nodes_len, axis);
   node = &nodes[median];
-  node->d = axis;
   axis = (axis + 1) % KD_DIMS;
   node->left = kdtree_balance(nodes, median, axis, ofs);
   node->right = kdtree_balance(
@@ -195,6 +214,112 @@ static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const u
   return median + ofs;
 }
 
+/** A range of nodes that still has to be balanced, see #kdtree_balance_parallel. */
+typedef struct KDTreeBalanceRange {
+  uint ofs;
+  uint nodes_len;
+  uint axis;
+  /** Receives the index of the root of the range, either in the tree or in the parent node. */
+  uint *r_root;
+} KDTreeBalanceRange;
+
+typedef struct KDTreeBalanceData {
+  KDTreeNode *nodes;
+  const KDTreeBalanceRange *ranges;
+  /** Two child ranges for every range, with zero length if there is no child. */
+  KDTreeBalanceRange *r_child_ranges;
+} KDTreeBalanceData;
+
+static void kdtree_balance_partition_task_cb(void *__restrict userdata,
+                                             const int i,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBalanceData *data = userdata;
+  const KDTreeBalanceRange *range = &data->ranges[i];
+  KDTreeNode *nodes = data->nodes + range->ofs;
+
+  const uint median = kdtree_balance_partition(nodes, range->nodes_len, range->axis);
+  KDTreeNode *node = &nodes[median];
+  *range->r_root = median + range->ofs;
+
+  const uint axis = (range->axis + 1) % KD_DIMS;
+  KDTreeBalanceRange *left = &data->r_child_ranges[i * 2];
+  KDTreeBalanceRange *right = &data->r_child_ranges[i * 2 + 1];
+  left->ofs = range->ofs;
+  left->nodes_len = median;
+  left->axis = axis;
+  left->r_root = &node->left;
+  right->ofs = range->ofs + median + 1;
+  right->nodes_len = range->nodes_len - (median + 1);
+  right->axis = axis;
+  right->r_root = &node->right;
+}
+
+static void kdtree_balance_task_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBalanceData *data = userdata;
+  const KDTreeBalanceRange *range = &data->ranges[i];
+  *range->r_root = kdtree_balance(
+      data->nodes + range->ofs, range->nodes_len, range->axis, range->ofs);
+}
+
+/**
+ * Build the same tree as #kdtree_balance, but level by level for the top of the tree, so that
+ * the ranges of a level can be partitioned in parallel. Once ranges are small enough, they are
+ * balanced recursively, also in parallel.
+ */
+static void kdtree_balance_parallel(KDTree *tree)
+{
+  /* Both children of a range larger than #KD_BALANCE_PARALLEL_MIN have at least half of that
+   * size. The ranges of a level and all small ranges are disjoint, which bounds their number. */
+  const uint ranges_len_max = tree->nodes_len / (KD_BALANCE_PARALLEL_MIN / 4) + 2;
+  KDTreeBalanceRange *ranges = MEM_mallocN(sizeof(*ranges) * ranges_len_max, __func__);
+  KDTreeBalanceRange *child_ranges = MEM_mallocN(sizeof(*child_ranges) * ranges_len_max,
+                                                 __func__);
+  KDTreeBalanceRange *small_ranges = MEM_mallocN(sizeof(*small_ranges) * ranges_len_max,
+                                                 __func__);
+  uint ranges_len = 1, small_ranges_len = 0;
+  ranges[0].ofs = 0;
+  ranges[0].nodes_len = tree->nodes_len;
+  ranges[0].axis = 0;
+  ranges[0].r_root = &tree->root;
+
+  KDTreeBalanceData data;
+  data.nodes = tree->nodes;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  while (ranges_len > 0) {
+    data.ranges = ranges;
+    data.r_child_ranges = child_ranges;
+    BLI_task_parallel_range(
+        0, (int)ranges_len, &data, kdtree_balance_partition_task_cb, &settings);
+
+    /* Continue with the next level for large children, the others are balanced at the end. */
+    const uint child_ranges_len = ranges_len * 2;
+    ranges_len = 0;
+    for (uint i = 0; i < child_ranges_len; i++) {
+      if (child_ranges[i].nodes_len > KD_BALANCE_PARALLEL_MIN) {
+        ranges[ranges_len++] = child_ranges[i];
+      }
+      else {
+        small_ranges[small_ranges_len++] = child_ranges[i];
+      }
+    }
+  }
+
+  data.ranges = small_ranges;
+  BLI_task_parallel_range(0, (int)small_ranges_len, &data, kdtree_balance_task_cb, &settings);
+
+  MEM_freeN(ranges);
+  MEM_freeN(child_ranges);
+  MEM_freeN(small_ranges);
+}
+
 void BLI_kdtree_nd_(balance)(KDTree *tree)
 {
   if (tree->root != KD_NODE_ROOT_IS_INIT) {
@@ -204,7 +329,12 @@ void BLI_kdtree_nd_(balance)(KDTree *tree)
     }
   }
 
-  tree->root = kdtree_balance(tree->nodes, tree->nodes_len, 0, 0);
+  if (tree->nodes_len > KD_BALANCE_PARALLEL_MIN) {
+    kdtree_balance_parallel(tree);
+  }
+  else {
+    tree->root = kdtree_balance(tree->nodes, tree->nodes_len, 0, 0);
+  }
 
 #ifndef NDEBUG
   tree->is_balanced = true;
@@ -800,6 +930,102 @@ finally:
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Batched Queries
+ * \{ */
+
+typedef struct KDTreeBatchData {
+  const KDTree *tree;
+  const float (*co)[KD_DIMS];
+  float range;
+  KDTreeNearest *r_nearest;
+  uint nearest_len_capacity;
+  uint *r_nearest_len;
+  bool (*search_cb)(
+      void *user_data, int co_index, int index, const float co[KD_DIMS], float dist_sq);
+  void *user_data;
+} KDTreeBatchData;
+
+static void kdtree_find_nearest_n_batch_task_cb(void *__restrict userdata,
+                                                const int i,
+                                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBatchData *data = userdata;
+  KDTreeNearest *r_nearest = &data->r_nearest[(size_t)i * data->nearest_len_capacity];
+  const int found = BLI_kdtree_nd_(find_nearest_n)(
+      data->tree, data->co[i], r_nearest, data->nearest_len_capacity);
+  data->r_nearest_len[i] = (uint)found;
+}
+
+void BLI_kdtree_nd_(find_nearest_n_batch)(const KDTree *tree,
+                                          const float (*co)[KD_DIMS],
+                                          uint co_len,
+                                          KDTreeNearest *r_nearest,
+                                          uint nearest_len_capacity,
+                                          uint *r_nearest_len)
+{
+  KDTreeBatchData data = {NULL};
+  data.tree = tree;
+  data.co = co;
+  data.r_nearest = r_nearest;
+  data.nearest_len_capacity = nearest_len_capacity;
+  data.r_nearest_len = r_nearest_len;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = KD_BATCH_CHUNK_SIZE;
+  BLI_task_parallel_range(0, (int)co_len, &data, kdtree_find_nearest_n_batch_task_cb, &settings);
+}
+
+/** Passes the index of the searched coordinate to the callback of the batch. */
+typedef struct KDTreeRangeSearchBatchItem {
+  const KDTreeBatchData *data;
+  int co_index;
+} KDTreeRangeSearchBatchItem;
+
+static bool kdtree_range_search_batch_item_cb(void *user_data,
+                                              int index,
+                                              const float co[KD_DIMS],
+                                              float dist_sq)
+{
+  const KDTreeRangeSearchBatchItem *item = user_data;
+  return item->data->search_cb(item->data->user_data, item->co_index, index, co, dist_sq);
+}
+
+static void kdtree_range_search_batch_task_cb(void *__restrict userdata,
+                                              const int i,
+                                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBatchData *data = userdata;
+  KDTreeRangeSearchBatchItem item = {data, i};
+  BLI_kdtree_nd_(range_search_cb)(
+      data->tree, data->co[i], data->range, kdtree_range_search_batch_item_cb, &item);
+}
+
+void BLI_kdtree_nd_(range_search_batch_cb)(
+    const KDTree *tree,
+    const float (*co)[KD_DIMS],
+    uint co_len,
+    float range,
+    bool (*search_cb)(
+        void *user_data, int co_index, int index, const float co[KD_DIMS], float dist_sq),
+    void *user_data)
+{
+  KDTreeBatchData data = {NULL};
+  data.tree = tree;
+  data.co = co;
+  data.range = range;
+  data.search_cb = search_cb;
+  data.user_data = user_data;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = KD_BATCH_CHUNK_SIZE;
+  BLI_task_parallel_range(0, (int)co_len, &data, kdtree_range_search_batch_task_cb, &settings);
+}
+
+/** \} */
+
 /**
  * Use when we want to loop over nodes ordered by index.
  * Requires indices to be aligned with nodes.
@@ -13,6 +13,7 @@
 #include "BLI_memory_cache.hh"
 #include "BLI_memory_counter.hh"
 #include "BLI_task.hh"
+#include "BLI_vector_set.hh"
 
 namespace blender::memory_cache {
 
@@ -28,6 +29,11 @@ struct StoredValue {
   std::shared_ptr<CachedValue> value;
   /** A logical time that indicates when the value was last used. Lower values are older. */
   int64_t last_use_time = 0;
+  /**
+   * Bytes that were added to the total cache memory when this value was counted last. Shared data
+   * is only counted for the first value that uses it.
+   */
+  int64_t counted_bytes = 0;
 };
 
 using CacheMap = ConcurrentMap<std::reference_wrapper<const GenericKey>, StoredValue>;
@@ -48,9 +54,9 @@ struct Cache {
   MemoryCount memory;
   /**
    * Keys currently cached. This is stored separately from the map, because the map does not allow
-   * thread-safe iteration.
+   * thread-safe iteration. It's a set so that single keys can be removed in constant time.
    */
-  Vector<const GenericKey *> keys;
+  VectorSet<const GenericKey *> keys;
 };
 
 static Cache &get_cache()
@@ -71,29 +77,27 @@ static void set_new_logical_time(const StoredValue &stored_value, const int64_t
   static_assert(sizeof(int64_t) == sizeof(std::atomic<int64_t>));
 }
 
-std::shared_ptr<CachedValue> get_base(const GenericKey &key,
-                                      const FunctionRef<std::unique_ptr<CachedValue>()> compute_fn)
+std::shared_ptr<CachedValue> lookup_base(const GenericKey &key)
 {
   Cache &cache = get_cache();
   /* "Touch" the cached value so that we know that it is still used. This makes it less likely that
    * it is removed. */
   const int64_t new_time = cache.logical_time.fetch_add(1, std::memory_order_relaxed);
-  {
-    /* Fast path when the value is already cached. */
-    CacheMap::ConstAccessor accessor;
-    if (cache.map.lookup(accessor, std::ref(key))) {
-      set_new_logical_time(accessor->second, new_time);
-      return accessor->second.value;
-    }
+  CacheMap::ConstAccessor accessor;
+  if (cache.map.lookup(accessor, std::ref(key))) {
+    set_new_logical_time(accessor->second, new_time);
+    return accessor->second.value;
   }
+  return {};
+}
 
-  /* Compute value while no locks are held to avoid potential for dead-locks. Not using a lock also
-   * means that the value may be computed more than once, but that's still better than locking all
-   * the time. It may be possible to implement something smarter in the future. */
-  std::shared_ptr<CachedValue> result = compute_fn();
-  /* Result should be valid. Use exception to propagate error if necessary. */
-  BLI_assert(result);
+std::shared_ptr<CachedValue> add(const GenericKey &key, std::shared_ptr<CachedValue> value)
+{
+  /* Value should be valid. Use exception to propagate error if necessary. */
+  BLI_assert(value);
 
+  Cache &cache = get_cache();
+  const int64_t new_time = cache.logical_time.fetch_add(1, std::memory_order_relaxed);
   {
     CacheMap::MutableAccessor accessor;
     const bool newly_inserted = cache.map.add(accessor, std::ref(key));
@@ -110,23 +114,63 @@ std::shared_ptr<CachedValue> get_base(const GenericKey &key,
         *accessor->second.key);
 
     /* Store the value. Don't move, because we still want to return the value from the function. */
-    accessor->second.value = result;
+    accessor->second.value = value;
     /* Set initial logical time for the new cached entry. */
     set_new_logical_time(accessor->second, new_time);
 
     {
       /* Update global data of the cache. */
       std::lock_guard lock{cache.global_mutex};
-      memory_counter::MemoryCounter memory_counter{cache.memory};
-      accessor->second.value->count_memory(memory_counter);
-      cache.keys.append(&accessor->first.get());
+      const int64_t old_bytes = cache.memory.total_bytes;
+      {
+        memory_counter::MemoryCounter memory_counter{cache.memory};
+        accessor->second.value->count_memory(memory_counter);
+      }
+      accessor->second.counted_bytes = cache.memory.total_bytes - old_bytes;
+      cache.keys.add_new(&accessor->first.get());
       cache.size_in_bytes = cache.memory.total_bytes;
     }
   }
   /* Potentially free elements from the cache. Note, even if this would free the value we just
    * added, it would still work correctly, because we already have a shared_ptr to it. */
   try_enforce_limit();
-  return result;
+  return value;
+}
+
+std::shared_ptr<CachedValue> get_base(const GenericKey &key,
+                                      const FunctionRef<std::unique_ptr<CachedValue>()> compute_fn)
+{
+  /* Fast path when the value is already cached. */
+  if (std::shared_ptr<CachedValue> value = lookup_base(key)) {
+    return value;
+  }
+
+  /* Compute value while no locks are held to avoid potential for dead-locks. Not using a lock also
+   * means that the value may be computed more than once, but that's still better than locking all
+   * the time. It may be possible to implement something smarter in the future. */
+  return add(key, compute_fn());
+}
+
+void remove(const GenericKey &key)
+{
+  Cache &cache = get_cache();
+  std::lock_guard lock{cache.global_mutex};
+
+  {
+    CacheMap::ConstAccessor accessor;
+    if (!cache.map.lookup(accessor, key)) {
+      return;
+    }
+    /* The stored key is freed together with the value, so remove it from the keys first. */
+    cache.keys.remove_contained(&accessor->first.get());
+    /* Shared data of the value stays in #MemoryCount::handled_shared_data, so it is not counted
+     * again until the next full recount when other values still use it. That only makes the
+     * estimate a bit lower. */
+    cache.memory.total_bytes = std::max<int64_t>(
+        0, cache.memory.total_bytes - accessor->second.counted_bytes);
+  }
+  cache.map.remove(key);
+  cache.size_in_bytes = cache.memory.total_bytes;
 }
 
 void set_approximate_size_limit(const int64_t limit_in_bytes)
@@ -185,11 +229,13 @@ static void try_enforce_limit()
     MemoryCounter memory_counter{cache.memory};
     for (const int i : keys_with_time.index_range()) {
       const GenericKey &key = *keys_with_time[i].second;
-      CacheMap::ConstAccessor accessor;
+      CacheMap::MutableAccessor accessor;
       if (!cache.map.lookup(accessor, key)) {
         continue;
       }
+      const int64_t old_bytes = cache.memory.total_bytes;
       accessor->second.value->count_memory(memory_counter);
+      accessor->second.counted_bytes = cache.memory.total_bytes - old_bytes;
       /* Undershoot a little bit. This typically results in more things being freed that have not
        * been used in a while. The benefit is that we have to do the decision what to free less
        * often than if we were always just freeing the minimum amount necessary. */
@@ -224,10 +270,10 @@ static void try_enforce_limit()
     cache.map.remove(key);
   }
 
-  /* Update keys vector. */
+  /* Update keys set. */
   cache.keys.clear();
   for (const int i : keys_with_time.index_range().take_front(*first_bad_index)) {
-    cache.keys.append(keys_with_time[i].second);
+    cache.keys.add_new(keys_with_time[i].second);
   }
 
   if (need_memory_recount) {
@@ -237,11 +283,13 @@ static void try_enforce_limit()
     MemoryCounter memory_counter{cache.memory};
     for (const int i : keys_with_time.index_range().take_front(*first_bad_index)) {
       const GenericKey &key = *keys_with_time[i].second;
-      CacheMap::ConstAccessor accessor;
+      CacheMap::MutableAccessor accessor;
       if (!cache.map.lookup(accessor, key)) {
         continue;
       }
+      const int64_t old_bytes = cache.memory.total_bytes;
       accessor->second.value->count_memory(memory_counter);
+      accessor->second.counted_bytes = cache.memory.total_bytes - old_bytes;
     }
   }
   cache.size_in_bytes = cache.memory.total_bytes;
@@ -1153,25 +1153,75 @@ static inline mpq3 tti_interp(
 }
 
 /**
- * Return +1, 0, -1 as a + ad is above, on, or below the oriented plane containing a, b, c in CCW
- * order. This is the same as -oriented(a, b, c, a + ad), but uses fewer arithmetic operations.
- * TODO: change arguments to `const Vert *` and use floating filters.
+ * Index of the determinant calculated in #filter_tti_above, assuming the input coordinates have
+ * index 1: each coordinate difference has index 2, the cross product coordinates have index 6,
+ * and the dot product of that with a difference has index 11.
+ */
+constexpr int index_tti_above = 11;
+
+/**
+ * Return the approximate side of point d with respect to the oriented plane containing a, b, c.
+ * The answer will be 1 if d is definitely above the plane and -1 if it is definitely below.
+ * If the answer is 0, we are unsure about which side of the plane (or if it is on the plane).
+ * In exact arithmetic, the answer is just `sgn(dot(d - a, cross(b - a, c - a)))`.
+ */
+static int filter_tti_above(const double3 &a,
+                            const double3 &b,
+                            const double3 &c,
+                            const double3 &d)
+{
+  double det = math::dot(d - a, math::cross(b - a, c - a));
+  if (det == 0.0) {
+    return 0;
+  }
+  double3 abs_a = math::abs(a);
+  double3 abs_ba = math::abs(b) + abs_a;
+  double3 abs_ca = math::abs(c) + abs_a;
+  double3 abs_da = math::abs(d) + abs_a;
+  double3 abs_n;
+  abs_n[0] = abs_ba[1] * abs_ca[2] + abs_ba[2] * abs_ca[1];
+  abs_n[1] = abs_ba[2] * abs_ca[0] + abs_ba[0] * abs_ca[2];
+  abs_n[2] = abs_ba[0] * abs_ca[1] + abs_ba[1] * abs_ca[0];
+  double supremum = math::dot(abs_da, abs_n);
+  double err_bound = supremum * index_tti_above * DBL_EPSILON;
+  if (fabs(det) > err_bound) {
+    return det > 0 ? 1 : -1;
+  }
+  return 0;
+}
+
+/**
+ * Return +1, 0, -1 as d is above, on, or below the oriented plane containing a, b, c in CCW
+ * order. This is the same as -oriented(a, b, c, d), but uses fewer arithmetic operations.
+ * The sign is calculated with floating point arithmetic first, and only if that is not
+ * conclusive with exact arithmetic, where ad is d - a.
  * The ba, ca, n, and dotbuf arguments are used as temporaries; declaring them
  * in the caller can avoid many allocations and frees of mpq3 and mpq_class structures.
  */
-static inline int tti_above(const mpq3 &a,
-                            const mpq3 &b,
-                            const mpq3 &c,
+static inline int tti_above(const Vert *a,
+                            const Vert *b,
+                            const Vert *c,
+                            const Vert *d,
                             const mpq3 &ad,
                             mpq3 &ba,
                             mpq3 &ca,
                             mpq3 &n,
                             mpq3 &dotbuf)
 {
-  ba = b;
-  ba -= a;
-  ca = c;
-  ca -= a;
+  int filter_side = filter_tti_above(a->co, b->co, c->co, d->co);
+  if (filter_side != 0) {
+#  ifdef PERFDEBUG
+    incperfcount(5); /* Orientation tests decided by filter. */
+#  endif
+    return filter_side;
+  }
+#  ifdef PERFDEBUG
+  incperfcount(6); /* Orientation tests decided by exact arithmetic. */
+#  endif
+  ba = b->co_exact;
+  ba -= a->co_exact;
+  ca = c->co_exact;
+  ca -= a->co_exact;
 
   n.x = ba.y * ca.z - ba.z * ca.y;
   n.y = ba.z * ca.x - ba.x * ca.z;
@@ -1193,16 +1243,22 @@ static inline int tti_above(const mpq3 &a,
  *   of the plane and at least one of q1 and r1 are off the plane.
  * Similarly for p2, q2, r2 with respect to the first triangle's plane.
  */
-static ITT_value itt_canon2(const mpq3 &p1,
-                            const mpq3 &q1,
-                            const mpq3 &r1,
-                            const mpq3 &p2,
-                            const mpq3 &q2,
-                            const mpq3 &r2,
+static ITT_value itt_canon2(const Vert *vp1,
+                            const Vert *vq1,
+                            const Vert *vr1,
+                            const Vert *vp2,
+                            const Vert *vq2,
+                            const Vert *vr2,
                             const mpq3 &n1,
                             const mpq3 &n2)
 {
   constexpr int dbg_level = 0;
+  const mpq3 &p1 = vp1->co_exact;
+  const mpq3 &q1 = vq1->co_exact;
+  const mpq3 &r1 = vr1->co_exact;
+  const mpq3 &p2 = vp2->co_exact;
+  const mpq3 &q2 = vq2->co_exact;
+  const mpq3 &r2 = vr2->co_exact;
   if (dbg_level > 0) {
     std::cout << "\ntri_tri_intersect_canon:\n";
     std::cout << "p1=" << p1 << " q1=" << q1 << " r1=" << r1 << "\n";
@@ -1224,11 +1280,11 @@ static ITT_value itt_canon2(const mpq3 &p1,
   mpq3 buf[4];
   bool no_overlap = false;
   /* Top test in classification tree. */
-  if (tti_above(p1, q1, r2, p1p2, buf[0], buf[1], buf[2], buf[3]) > 0) {
+  if (tti_above(vp1, vq1, vr2, vp2, p1p2, buf[0], buf[1], buf[2], buf[3]) > 0) {
     /* Middle right test in classification tree. */
-    if (tti_above(p1, r1, r2, p1p2, buf[0], buf[1], buf[2], buf[3]) <= 0) {
+    if (tti_above(vp1, vr1, vr2, vp2, p1p2, buf[0], buf[1], buf[2], buf[3]) <= 0) {
       /* Bottom right test in classification tree. */
-      if (tti_above(p1, r1, q2, p1p2, buf[0], buf[1], buf[2], buf[3]) > 0) {
+      if (tti_above(vp1, vr1, vq2, vp2, p1p2, buf[0], buf[1], buf[2], buf[3]) > 0) {
         /* Overlap is [k [i l] j]. */
         if (dbg_level > 0) {
           std::cout << "overlap [k [i l] j]\n";
@@ -1257,7 +1313,7 @@ static ITT_value itt_canon2(const mpq3 &p1,
   }
   else {
     /* Middle left test in classification tree. */
-    if (tti_above(p1, q1, q2, p1p2, buf[0], buf[1], buf[2], buf[3]) < 0) {
+    if (tti_above(vp1, vq1, vq2, vp2, p1p2, buf[0], buf[1], buf[2], buf[3]) < 0) {
       /* No overlap: [i j] [k l]. */
       if (dbg_level > 0) {
         std::cout << "no overlap: [i j] [k l]\n";
@@ -1266,7 +1322,7 @@ static ITT_value itt_canon2(const mpq3 &p1,
     }
     else {
       /* Bottom left test in classification tree. */
-      if (tti_above(p1, r1, q2, p1p2, buf[0], buf[1], buf[2], buf[3]) >= 0) {
+      if (tti_above(vp1, vr1, vq2, vp2, p1p2, buf[0], buf[1], buf[2], buf[3]) >= 0) {
         /* Overlap is [k [i j] l]. */
         if (dbg_level > 0) {
           std::cout << "overlap [k [i j] l]\n";
@@ -1303,12 +1359,12 @@ static ITT_value itt_canon2(const mpq3 &p1,
 
 /* Helper function for intersect_tri_tri. Arguments have been canonicalized for triangle 1. */
 
-static ITT_value itt_canon1(const mpq3 &p1,
-                            const mpq3 &q1,
-                            const mpq3 &r1,
-                            const mpq3 &p2,
-                            const mpq3 &q2,
-                            const mpq3 &r2,
+static ITT_value itt_canon1(const Vert *p1,
+                            const Vert *q1,
+                            const Vert *r1,
+                            const Vert *p2,
+                            const Vert *q2,
+                            const Vert *r2,
                             const mpq3 &n1,
                             const mpq3 &n2,
                             int sp2,
@@ -1510,49 +1566,49 @@ static ITT_value intersect_tri_tri(const IMesh &tm, int t1, int t2)
   ITT_value ans;
   if (sp1 > 0) {
     if (sq1 > 0) {
-      ans = itt_canon1(r1, p1, q1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+      ans = itt_canon1(vr1, vp1, vq1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
     }
     else if (sr1 > 0) {
-      ans = itt_canon1(q1, r1, p1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+      ans = itt_canon1(vq1, vr1, vp1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
     }
     else {
-      ans = itt_canon1(p1, q1, r1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+      ans = itt_canon1(vp1, vq1, vr1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
     }
   }
   else if (sp1 < 0) {
     if (sq1 < 0) {
-      ans = itt_canon1(r1, p1, q1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+      ans = itt_canon1(vr1, vp1, vq1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
     }
     else if (sr1 < 0) {
-      ans = itt_canon1(q1, r1, p1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+      ans = itt_canon1(vq1, vr1, vp1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
     }
     else {
-      ans = itt_canon1(p1, q1, r1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+      ans = itt_canon1(vp1, vq1, vr1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
     }
   }
   else {
     if (sq1 < 0) {
       if (sr1 >= 0) {
-        ans = itt_canon1(q1, r1, p1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+        ans = itt_canon1(vq1, vr1, vp1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
       }
       else {
-        ans = itt_canon1(p1, q1, r1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+        ans = itt_canon1(vp1, vq1, vr1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
       }
     }
     else if (sq1 > 0) {
       if (sr1 > 0) {
-        ans = itt_canon1(p1, q1, r1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+        ans = itt_canon1(vp1, vq1, vr1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
       }
       else {
-        ans = itt_canon1(q1, r1, p1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+        ans = itt_canon1(vq1, vr1, vp1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
       }
     }
     else {
       if (sr1 > 0) {
-        ans = itt_canon1(r1, p1, q1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+        ans = itt_canon1(vr1, vp1, vq1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
       }
       else if (sr1 < 0) {
-        ans = itt_canon1(r1, p1, q1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+        ans = itt_canon1(vr1, vp1, vq1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
       }
       else {
         if (dbg_level > 0) {
@@ -3025,10 +3081,15 @@ IMesh trimesh_nary_intersect(const IMesh &tm_in,
   std::cout << "subdivided non-cluster tris found, time = " << subdivided_tris_time - itt_time
             << "\n";
 #  endif
+  /* The clusters are independent of each other, and their sizes vary a lot, so use a grain size
+   * of one. The faces are extracted serially afterwards by #calc_cluster_tris. */
   Array<CDT_data> cluster_subdivided(clinfo.tot_cluster());
-  for (int c : clinfo.index_range()) {
-    cluster_subdivided[c] = calc_cluster_subdivided(clinfo, c, *tm_clean, tri_ov, itt_map, arena);
-  }
+  threading::parallel_for(clinfo.index_range(), 1, [&](IndexRange range) {
+    for (int c : range) {
+      cluster_subdivided[c] = calc_cluster_subdivided(
+          clinfo, c, *tm_clean, tri_ov, itt_map, arena);
+    }
+  });
 #  ifdef PERFDEBUG
   double cluster_subdivide_time = BLI_time_now_seconds();
   std::cout << "subdivided clusters found, time = "
@@ -3176,6 +3237,14 @@ static void perfdata_init()
   perfdata->count.append(0);
   perfdata->count_name.append("final non-NONE intersects");
 
+  /* count 5. */
+  perfdata->count.append(0);
+  perfdata->count_name.append("tri tri orientation tests decided by filter");
+
+  /* count 6. */
+  perfdata->count.append(0);
+  perfdata->count_name.append("tri tri orientation tests decided exactly");
+
   /* max 0. */
   perfdata->max.append(0);
   perfdata->max_name.append("total faces");
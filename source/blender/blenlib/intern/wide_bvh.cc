@@ -0,0 +1,761 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <algorithm>
+#include <atomic>
+
+#include "BLI_array.hh"
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_math_geom.h"
+#include "BLI_math_vector.hh"
+#include "BLI_simd.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+#include "BLI_wide_bvh.hh"
+
+namespace blender {
+
+/** Number of bins used to evaluate split candidates with the surface area heuristic. */
+static constexpr int sah_bins_num = 16;
+/** Children of nodes with more primitives are built in parallel. */
+static constexpr int64_t parallel_build_threshold = 4096;
+/** Binning and bounds computation are parallelized for ranges with more primitives. */
+static constexpr int64_t parallel_reduce_grain_size = 16384;
+/** Sub-trees are refitted in parallel up to this depth, resulting in up to 64 tasks. */
+static constexpr int parallel_refit_depth = 3;
+/** A refitted tree should be rebuilt when its cost grew by more than this factor. */
+static constexpr float refit_max_cost_factor = 2.0f;
+
+static Bounds<float3> empty_bounds()
+{
+  return {float3(FLT_MAX), float3(-FLT_MAX)};
+}
+
+static Bounds<float3> merge_bounds(const Bounds<float3> &a, const Bounds<float3> &b)
+{
+  return {math::min(a.min, b.min), math::max(a.max, b.max)};
+}
+
+/** Half of the surface area, which is enough to compare the cost of splits. */
+static float half_area(const Bounds<float3> &bounds)
+{
+  const float3 size = bounds.max - bounds.min;
+  return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+struct SAHBins {
+  int counts[3][sah_bins_num];
+  Bounds<float3> bounds[3][sah_bins_num];
+
+  SAHBins()
+  {
+    for (const int axis : IndexRange(3)) {
+      for (const int bin : IndexRange(sah_bins_num)) {
+        counts[axis][bin] = 0;
+        bounds[axis][bin] = empty_bounds();
+      }
+    }
+  }
+};
+
+struct WideBVHBuilder {
+  using Node = WideBVH::Node;
+
+  Span<Bounds<float3>> prim_bounds;
+  Span<float3> centroids;
+  /** Permutation of the primitives that is sorted so that every node references a range. */
+  MutableSpan<int> order;
+
+  Bounds<float3> compute_bounds(const IndexRange range) const
+  {
+    return threading::parallel_reduce(
+        range,
+        parallel_reduce_grain_size,
+        empty_bounds(),
+        [&](const IndexRange sub_range, Bounds<float3> bounds) {
+          for (const int i : order.slice(sub_range)) {
+            bounds = merge_bounds(bounds, prim_bounds[i]);
+          }
+          return bounds;
+        },
+        merge_bounds);
+  }
+
+  Bounds<float3> compute_centroid_bounds(const IndexRange range) const
+  {
+    return threading::parallel_reduce(
+        range,
+        parallel_reduce_grain_size,
+        empty_bounds(),
+        [&](const IndexRange sub_range, Bounds<float3> bounds) {
+          for (const int i : order.slice(sub_range)) {
+            bounds.min = math::min(bounds.min, centroids[i]);
+            bounds.max = math::max(bounds.max, centroids[i]);
+          }
+          return bounds;
+        },
+        merge_bounds);
+  }
+
+  /**
+   * Reorder the primitives in the range so that it can be split into two parts.
+   * \return The number of primitives in the first part, which is never zero or the full range.
+   */
+  int64_t split(const IndexRange range) const
+  {
+    BLI_assert(range.size() >= 2);
+    const Bounds<float3> centroid_bounds = this->compute_centroid_bounds(range);
+    const float3 extent = centroid_bounds.max - centroid_bounds.min;
+    float3 bin_scale;
+    for (const int axis : IndexRange(3)) {
+      bin_scale[axis] = extent[axis] > 0.0f ? float(sah_bins_num) / extent[axis] : 0.0f;
+    }
+    auto get_bin = [&](const float3 &centroid, const int axis) {
+      const int bin = int((centroid[axis] - centroid_bounds.min[axis]) * bin_scale[axis]);
+      return std::clamp(bin, 0, sah_bins_num - 1);
+    };
+
+    const SAHBins bins = threading::parallel_reduce(
+        range,
+        parallel_reduce_grain_size,
+        SAHBins(),
+        [&](const IndexRange sub_range, SAHBins bins) {
+          for (const int i : order.slice(sub_range)) {
+            for (const int axis : IndexRange(3)) {
+              const int bin = get_bin(centroids[i], axis);
+              bins.counts[axis][bin]++;
+              bins.bounds[axis][bin] = merge_bounds(bins.bounds[axis][bin], prim_bounds[i]);
+            }
+          }
+          return bins;
+        },
+        [](const SAHBins &a, const SAHBins &b) {
+          SAHBins result;
+          for (const int axis : IndexRange(3)) {
+            for (const int bin : IndexRange(sah_bins_num)) {
+              result.counts[axis][bin] = a.counts[axis][bin] + b.counts[axis][bin];
+              result.bounds[axis][bin] = merge_bounds(a.bounds[axis][bin], b.bounds[axis][bin]);
+            }
+          }
+          return result;
+        });
+
+    float best_cost = FLT_MAX;
+    int best_axis = -1;
+    int best_bin = -1;
+    for (const int axis : IndexRange(3)) {
+      if (bin_scale[axis] == 0.0f) {
+        continue;
+      }
+      /* Cost of the primitives on the right side of every split, which is after the bin. */
+      float right_costs[sah_bins_num];
+      Bounds<float3> right_bounds = empty_bounds();
+      int right_count = 0;
+      for (int bin = sah_bins_num - 1; bin > 0; bin--) {
+        right_bounds = merge_bounds(right_bounds, bins.bounds[axis][bin]);
+        right_count += bins.counts[axis][bin];
+        right_costs[bin - 1] = right_count > 0 ? right_count * half_area(right_bounds) : 0.0f;
+      }
+      Bounds<float3> left_bounds = empty_bounds();
+      int left_count = 0;
+      for (const int bin : IndexRange(sah_bins_num - 1)) {
+        left_bounds = merge_bounds(left_bounds, bins.bounds[axis][bin]);
+        left_count += bins.counts[axis][bin];
+        if (left_count == 0 || left_count == range.size()) {
+          continue;
+        }
+        const float cost = left_count * half_area(left_bounds) + right_costs[bin];
+        if (cost < best_cost) {
+          best_cost = cost;
+          best_axis = axis;
+          best_bin = bin;
+        }
+      }
+    }
+
+    MutableSpan<int> range_order = order.slice(range);
+    if (best_axis == -1) {
+      /* All centroids are in the same place or in the same bin. Split in the middle of the
+       * largest axis, which always results in two non-empty parts. */
+      const int axis = math::dominant_axis(extent);
+      const int64_t mid = range.size() / 2;
+      std::nth_element(range_order.begin(),
+                       range_order.begin() + mid,
+                       range_order.end(),
+                       [&](const int a, const int b) {
+                         return centroids[a][axis] < centroids[b][axis];
+                       });
+      return mid;
+    }
+    int *split_point = std::partition(
+        range_order.begin(), range_order.end(), [&](const int i) {
+          return get_bin(centroids[i], best_axis) <= best_bin;
+        });
+    return split_point - range_order.begin();
+  }
+
+  /**
+   * Build the node for the range and all its descendants and append them to the vector.
+   * \return The index of the new node.
+   */
+  int build_node(const IndexRange range, Vector<Node> &r_nodes) const
+  {
+    const int node_index = r_nodes.append_and_get_index({});
+
+    /* Split the children with the most primitives until the node is full. */
+    Vector<IndexRange, WideBVH::branching_factor> child_ranges = {range};
+    while (child_ranges.size() < WideBVH::branching_factor) {
+      int child_to_split = -1;
+      for (const int i : child_ranges.index_range()) {
+        const int64_t size = child_ranges[i].size();
+        if (size > WideBVH::max_leaf_size &&
+            (child_to_split == -1 || size > child_ranges[child_to_split].size()))
+        {
+          child_to_split = i;
+        }
+      }
+      if (child_to_split == -1) {
+        break;
+      }
+      const IndexRange child_range = child_ranges[child_to_split];
+      const int64_t left_size = this->split(child_range);
+      child_ranges[child_to_split] = child_range.take_front(left_size);
+      child_ranges.append(child_range.drop_front(left_size));
+    }
+
+    Node node;
+    for (const int i : IndexRange(WideBVH::branching_factor)) {
+      Bounds<float3> bounds = empty_bounds();
+      if (i < child_ranges.size()) {
+        bounds = this->compute_bounds(child_ranges[i]);
+      }
+      for (const int axis : IndexRange(3)) {
+        node.bounds_min[axis][i] = bounds.min[axis];
+        node.bounds_max[axis][i] = bounds.max[axis];
+      }
+      node.children[i] = -1;
+      node.leaf_sizes[i] = 0;
+      if (i < child_ranges.size() && child_ranges[i].size() <= WideBVH::max_leaf_size) {
+        node.children[i] = child_ranges[i].start();
+        node.leaf_sizes[i] = child_ranges[i].size();
+      }
+    }
+
+    auto is_inner = [&](const int i) {
+      return child_ranges[i].size() > WideBVH::max_leaf_size;
+    };
+    if (range.size() > parallel_build_threshold) {
+      /* Build the sub-trees independently and append them afterwards. */
+      Array<Vector<Node>> child_nodes(child_ranges.size());
+      threading::parallel_for(child_ranges.index_range(), 1, [&](const IndexRange children) {
+        for (const int i : children) {
+          if (is_inner(i)) {
+            this->build_node(child_ranges[i], child_nodes[i]);
+          }
+        }
+      });
+      for (const int i : child_ranges.index_range()) {
+        if (!is_inner(i)) {
+          continue;
+        }
+        const int offset = r_nodes.size();
+        node.children[i] = offset;
+        for (Node child_node : child_nodes[i]) {
+          for (const int j : IndexRange(WideBVH::branching_factor)) {
+            if (child_node.leaf_sizes[j] == 0 && child_node.children[j] != -1) {
+              child_node.children[j] += offset;
+            }
+          }
+          r_nodes.append(child_node);
+        }
+      }
+    }
+    else {
+      for (const int i : child_ranges.index_range()) {
+        if (is_inner(i)) {
+          node.children[i] = this->build_node(child_ranges[i], r_nodes);
+        }
+      }
+    }
+
+    r_nodes[node_index] = node;
+    return node_index;
+  }
+};
+
+struct WideBVHRefit {
+  using Node = WideBVH::Node;
+
+  /**
+   * Recompute the child bounds of the node and all its descendants from the primitive bounds.
+   * \return The bounds of the node.
+   */
+  static Bounds<float3> refit_node(WideBVH &bvh, const int node_index, const int depth)
+  {
+    Node &node = bvh.nodes_[node_index];
+    Bounds<float3> child_bounds[WideBVH::branching_factor];
+    auto refit_child = [&](const int i) {
+      child_bounds[i] = empty_bounds();
+      if (node.children[i] == -1) {
+        return;
+      }
+      if (node.leaf_sizes[i] == 0) {
+        child_bounds[i] = refit_node(bvh, node.children[i], depth + 1);
+        return;
+      }
+      for (const int prim : IndexRange(node.children[i], node.leaf_sizes[i])) {
+        child_bounds[i] = merge_bounds(child_bounds[i], bvh.prim_bounds_[prim]);
+      }
+    };
+    if (depth < parallel_refit_depth) {
+      const IndexRange children(WideBVH::branching_factor);
+      threading::parallel_for(children, 1, [&](const IndexRange range) {
+        for (const int i : range) {
+          refit_child(i);
+        }
+      });
+    }
+    else {
+      for (const int i : IndexRange(WideBVH::branching_factor)) {
+        refit_child(i);
+      }
+    }
+
+    Bounds<float3> bounds = empty_bounds();
+    for (const int i : IndexRange(WideBVH::branching_factor)) {
+      for (const int axis : IndexRange(3)) {
+        node.bounds_min[axis][i] = child_bounds[i].min[axis];
+        node.bounds_max[axis][i] = child_bounds[i].max[axis];
+      }
+      bounds = merge_bounds(bounds, child_bounds[i]);
+    }
+    return bounds;
+  }
+
+  /**
+   * The surface area heuristic cost of the tree: the area of every child weighted by the number
+   * of primitives in leaves, relative to the area of the root. This estimates the number of nodes
+   * and primitives that a random query visits.
+   */
+  static float cost(const WideBVH &bvh)
+  {
+    if (bvh.nodes_.is_empty()) {
+      return 0.0f;
+    }
+    auto child_bounds = [](const Node &node, const int i) {
+      return Bounds<float3>(
+          float3(node.bounds_min[0][i], node.bounds_min[1][i], node.bounds_min[2][i]),
+          float3(node.bounds_max[0][i], node.bounds_max[1][i], node.bounds_max[2][i]));
+    };
+    Bounds<float3> root_bounds = empty_bounds();
+    for (const int i : IndexRange(WideBVH::branching_factor)) {
+      root_bounds = merge_bounds(root_bounds, child_bounds(bvh.nodes_[0], i));
+    }
+    const float root_area = half_area(root_bounds);
+    if (root_area <= 0.0f) {
+      return 0.0f;
+    }
+    const double area_sum = threading::parallel_reduce(
+        bvh.nodes_.index_range(),
+        4096,
+        0.0,
+        [&](const IndexRange range, double sum) {
+          for (const Node &node : bvh.nodes_.as_span().slice(range)) {
+            for (const int i : IndexRange(WideBVH::branching_factor)) {
+              if (node.children[i] != -1) {
+                sum += half_area(child_bounds(node, i)) * std::max(node.leaf_sizes[i], 1);
+              }
+            }
+          }
+          return sum;
+        },
+        std::plus<>());
+    return float(area_sum / root_area);
+  }
+};
+
+WideBVH::WideBVH(const Span<int> indices, const Span<Bounds<float3>> bounds)
+{
+  BLI_assert(indices.size() == bounds.size());
+  if (indices.is_empty()) {
+    return;
+  }
+
+  Array<float3> centroids(bounds.size());
+  Array<int> order(bounds.size());
+  threading::parallel_for(bounds.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      centroids[i] = (bounds[i].min + bounds[i].max) * 0.5f;
+      order[i] = i;
+    }
+  });
+
+  WideBVHBuilder builder;
+  builder.prim_bounds = bounds;
+  builder.centroids = centroids;
+  builder.order = order;
+
+  Vector<Node> nodes;
+  builder.build_node(bounds.index_range(), nodes);
+  nodes_ = nodes.as_span();
+
+  prim_indices_.reinitialize(indices.size());
+  prim_bounds_.reinitialize(indices.size());
+  threading::parallel_for(order.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      prim_indices_[i] = indices[order[i]];
+      prim_bounds_[i] = bounds[order[i]];
+    }
+  });
+  prim_order_ = std::move(order);
+  build_cost_ = WideBVHRefit::cost(*this);
+}
+
+bool WideBVH::has_indices(const Span<int> indices) const
+{
+  if (indices.size() != prim_indices_.size()) {
+    return false;
+  }
+  std::atomic<bool> equal = true;
+  threading::parallel_for(prim_order_.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      if (indices[prim_order_[i]] != prim_indices_[i]) {
+        equal.store(false, std::memory_order_relaxed);
+        return;
+      }
+    }
+  });
+  return equal;
+}
+
+bool WideBVH::refit(const Span<Bounds<float3>> bounds)
+{
+  BLI_assert(bounds.size() == prim_bounds_.size());
+  if (nodes_.is_empty()) {
+    return true;
+  }
+  threading::parallel_for(prim_order_.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      prim_bounds_[i] = bounds[prim_order_[i]];
+    }
+  });
+  WideBVHRefit::refit_node(*this, 0, 0);
+  return WideBVHRefit::cost(*this) <= build_cost_ * refit_max_cost_factor;
+}
+
+namespace {
+
+struct TraversalItem {
+  /** Same meaning as #WideBVH::Node::children, zero leaf size for inner nodes. */
+  int child;
+  int leaf_size;
+  /** Distance to the bounds of the child, used to skip children when a closer hit was found. */
+  float dist;
+};
+
+using TraversalStack = Vector<TraversalItem, 64>;
+
+/** Add the children in the mask to the stack so that the closest one is visited next. */
+template<typename NodeT>
+static void push_children_sorted(const NodeT &node,
+                                 int mask,
+                                 const float dists[WideBVH::branching_factor],
+                                 TraversalStack &stack)
+{
+  int order[WideBVH::branching_factor];
+  int num = 0;
+  for (const int i : IndexRange(WideBVH::branching_factor)) {
+    if ((mask & (1 << i)) && node.children[i] != -1) {
+      /* Insertion sort from far to near. */
+      int j = num++;
+      while (j > 0 && dists[order[j - 1]] < dists[i]) {
+        order[j] = order[j - 1];
+        j--;
+      }
+      order[j] = i;
+    }
+  }
+  for (const int i : IndexRange(num)) {
+    const int child = order[i];
+    stack.append({node.children[child], node.leaf_sizes[child], dists[child]});
+  }
+}
+
+}  // namespace
+
+struct WideBVHTraversal {
+  using Node = WideBVH::Node;
+  static constexpr int branching_factor = WideBVH::branching_factor;
+
+  static int ray_cast(const WideBVH &bvh,
+                      const float3 &origin,
+                      const float3 &ray_direction,
+                      const float radius,
+                      BVHTreeRayHit *hit,
+                      BVHTree_RayCastCallback callback,
+                      void *userdata,
+                      const int flag,
+                      TraversalStack &stack)
+  {
+    BLI_assert(callback != nullptr);
+    /* Like #BLI_bvhtree_ray_cast_ex, which also keeps zero length directions unchanged. */
+    const float3 direction = math::normalize(ray_direction);
+
+    BVHTreeRay ray;
+    copy_v3_v3(ray.origin, origin);
+    copy_v3_v3(ray.direction, direction);
+    ray.radius = radius;
+#ifdef USE_KDOPBVH_WATERTIGHT
+    IsectRayPrecalc isect_precalc;
+    if (flag & BVH_RAYCAST_WATERTIGHT) {
+      isect_ray_tri_watertight_v3_precalc(&isect_precalc, ray.direction);
+      ray.isect_precalc = &isect_precalc;
+    }
+    else {
+      ray.isect_precalc = nullptr;
+    }
+#else
+    UNUSED_VARS(flag);
+#endif
+
+    BVHTreeRayHit local_hit;
+    if (hit) {
+      local_hit = *hit;
+    }
+    else {
+      local_hit.index = -1;
+      local_hit.dist = BVH_RAYCAST_DIST_MAX;
+    }
+
+    /* Rays that are almost parallel to an axis use a very large inverse instead of infinity, to
+     * avoid NaN when the origin is exactly on a bounding box plane. */
+    float3 inv_direction;
+    for (const int axis : IndexRange(3)) {
+      inv_direction[axis] = std::abs(direction[axis]) < FLT_EPSILON ? FLT_MAX :
+                                                                       1.0f / direction[axis];
+    }
+    /* The near and far planes of every box depend on the sign of the direction. Swapping the
+     * bounds instead of sorting the distances keeps empty boxes empty. */
+    bool negative[3];
+    float near_offset[3];
+    float far_offset[3];
+    for (const int axis : IndexRange(3)) {
+      negative[axis] = inv_direction[axis] < 0.0f;
+      near_offset[axis] = origin[axis] + (negative[axis] ? -radius : radius);
+      far_offset[axis] = origin[axis] - (negative[axis] ? -radius : radius);
+    }
+
+    stack.clear();
+    if (!bvh.nodes_.is_empty()) {
+      stack.append({0, 0, 0.0f});
+    }
+    while (!stack.is_empty()) {
+      const TraversalItem item = stack.pop_last();
+      if (item.dist >= local_hit.dist) {
+        continue;
+      }
+      if (item.leaf_size > 0) {
+        for (const int i : IndexRange(item.child, item.leaf_size)) {
+          callback(userdata, bvh.prim_indices_[i], &ray, &local_hit);
+        }
+        continue;
+      }
+      const Node &node = bvh.nodes_[item.child];
+      float dists[branching_factor];
+      int mask = 0;
+#if BLI_HAVE_SSE2
+      __m128 t_near = _mm_setzero_ps();
+      __m128 t_far = _mm_set1_ps(local_hit.dist);
+      for (const int axis : IndexRange(3)) {
+        const __m128 min = _mm_load_ps(node.bounds_min[axis]);
+        const __m128 max = _mm_load_ps(node.bounds_max[axis]);
+        const __m128 inv = _mm_set1_ps(inv_direction[axis]);
+        /* The radius expands the box, so it is subtracted from the near plane distance. */
+        const __m128 near_plane = negative[axis] ? max : min;
+        const __m128 far_plane = negative[axis] ? min : max;
+        t_near = _mm_max_ps(
+            t_near, _mm_mul_ps(_mm_sub_ps(near_plane, _mm_set1_ps(near_offset[axis])), inv));
+        t_far = _mm_min_ps(
+            t_far, _mm_mul_ps(_mm_sub_ps(far_plane, _mm_set1_ps(far_offset[axis])), inv));
+      }
+      mask = _mm_movemask_ps(_mm_cmple_ps(t_near, t_far));
+      _mm_storeu_ps(dists, t_near);
+#else
+      for (const int i : IndexRange(branching_factor)) {
+        float t_near = 0.0f;
+        float t_far = local_hit.dist;
+        for (const int axis : IndexRange(3)) {
+          const float near_plane = negative[axis] ? node.bounds_max[axis][i] :
+                                                    node.bounds_min[axis][i];
+          const float far_plane = negative[axis] ? node.bounds_min[axis][i] :
+                                                   node.bounds_max[axis][i];
+          t_near = std::max(t_near, (near_plane - near_offset[axis]) * inv_direction[axis]);
+          t_far = std::min(t_far, (far_plane - far_offset[axis]) * inv_direction[axis]);
+        }
+        dists[i] = t_near;
+        if (t_near <= t_far) {
+          mask |= 1 << i;
+        }
+      }
+#endif
+      push_children_sorted(node, mask, dists, stack);
+    }
+
+    if (hit) {
+      *hit = local_hit;
+    }
+    return local_hit.index;
+  }
+
+  static int find_nearest(const WideBVH &bvh,
+                          const float3 &co,
+                          BVHTreeNearest *nearest,
+                          BVHTree_NearestPointCallback callback,
+                          void *userdata,
+                          TraversalStack &stack)
+  {
+    BVHTreeNearest local_nearest;
+    if (nearest) {
+      local_nearest = *nearest;
+    }
+    else {
+      local_nearest.index = -1;
+      local_nearest.dist_sq = FLT_MAX;
+    }
+
+    stack.clear();
+    if (!bvh.nodes_.is_empty()) {
+      stack.append({0, 0, 0.0f});
+    }
+    while (!stack.is_empty()) {
+      const TraversalItem item = stack.pop_last();
+      if (item.dist >= local_nearest.dist_sq) {
+        continue;
+      }
+      if (item.leaf_size > 0) {
+        for (const int i : IndexRange(item.child, item.leaf_size)) {
+          if (callback) {
+            callback(userdata, bvh.prim_indices_[i], co, &local_nearest);
+            continue;
+          }
+          const float3 closest = math::clamp(co, bvh.prim_bounds_[i].min, bvh.prim_bounds_[i].max);
+          const float dist_sq = math::distance_squared(co, closest);
+          if (dist_sq < local_nearest.dist_sq) {
+            local_nearest.index = bvh.prim_indices_[i];
+            local_nearest.dist_sq = dist_sq;
+            copy_v3_v3(local_nearest.co, closest);
+          }
+        }
+        continue;
+      }
+      const Node &node = bvh.nodes_[item.child];
+      float dists[branching_factor];
+      int mask = 0;
+#if BLI_HAVE_SSE2
+      __m128 dist_sq = _mm_setzero_ps();
+      for (const int axis : IndexRange(3)) {
+        const __m128 p = _mm_set1_ps(co[axis]);
+        const __m128 below = _mm_sub_ps(_mm_load_ps(node.bounds_min[axis]), p);
+        const __m128 above = _mm_sub_ps(p, _mm_load_ps(node.bounds_max[axis]));
+        const __m128 d = _mm_max_ps(_mm_max_ps(below, above), _mm_setzero_ps());
+        dist_sq = _mm_add_ps(dist_sq, _mm_mul_ps(d, d));
+      }
+      mask = _mm_movemask_ps(_mm_cmplt_ps(dist_sq, _mm_set1_ps(local_nearest.dist_sq)));
+      _mm_storeu_ps(dists, dist_sq);
+#else
+      for (const int i : IndexRange(branching_factor)) {
+        float dist_sq = 0.0f;
+        for (const int axis : IndexRange(3)) {
+          const float d = std::max({node.bounds_min[axis][i] - co[axis],
+                                    co[axis] - node.bounds_max[axis][i],
+                                    0.0f});
+          dist_sq += d * d;
+        }
+        dists[i] = dist_sq;
+        if (dist_sq < local_nearest.dist_sq) {
+          mask |= 1 << i;
+        }
+      }
+#endif
+      push_children_sorted(node, mask, dists, stack);
+    }
+
+    if (nearest) {
+      *nearest = local_nearest;
+    }
+    return local_nearest.index;
+  }
+};
+
+int WideBVH::ray_cast(const float3 &origin,
+                      const float3 &direction,
+                      const float radius,
+                      BVHTreeRayHit *hit,
+                      BVHTree_RayCastCallback callback,
+                      void *userdata,
+                      const int flag) const
+{
+  TraversalStack stack;
+  return WideBVHTraversal::ray_cast(
+      *this, origin, direction, radius, hit, callback, userdata, flag, stack);
+}
+
+int WideBVH::find_nearest(const float3 &co,
+                          BVHTreeNearest *nearest,
+                          BVHTree_NearestPointCallback callback,
+                          void *userdata) const
+{
+  TraversalStack stack;
+  return WideBVHTraversal::find_nearest(*this, co, nearest, callback, userdata, stack);
+}
+
+/** Queries are relatively expensive, so parallelize over small chunks. */
+static constexpr int64_t batch_grain_size = 256;
+
+void WideBVH::ray_cast_batch(const IndexMask &mask,
+                             const Span<float3> origins,
+                             const Span<float3> directions,
+                             const float radius,
+                             MutableSpan<BVHTreeRayHit> r_hits,
+                             BVHTree_RayCastCallback callback,
+                             void *userdata,
+                             const int flag) const
+{
+  Array<int> order(mask.size());
+  BLI_bvhtree_batch_query_order(mask, origins, directions, order);
+  /* Reuse the traversal stacks, they may grow beyond their inline buffer for deep trees. */
+  threading::EnumerableThreadSpecific<TraversalStack> stacks;
+  threading::parallel_for(order.index_range(), batch_grain_size, [&](const IndexRange range) {
+    TraversalStack &stack = stacks.local();
+    for (const int i : order.as_span().slice(range)) {
+      WideBVHTraversal::ray_cast(
+          *this, origins[i], directions[i], radius, &r_hits[i], callback, userdata, flag, stack);
+    }
+  });
+}
+
+void WideBVH::find_nearest_batch(const IndexMask &mask,
+                                 const Span<float3> positions,
+                                 MutableSpan<BVHTreeNearest> r_nearest,
+                                 BVHTree_NearestPointCallback callback,
+                                 void *userdata) const
+{
+  Array<int> order(mask.size());
+  BLI_bvhtree_batch_query_order(mask, positions, {}, order);
+  threading::EnumerableThreadSpecific<TraversalStack> stacks;
+  threading::parallel_for(order.index_range(), batch_grain_size, [&](const IndexRange range) {
+    TraversalStack &stack = stacks.local();
+    for (const int i : order.as_span().slice(range)) {
+      WideBVHTraversal::find_nearest(
+          *this, positions[i], &r_nearest[i], callback, userdata, stack);
+    }
+  });
+}
+
+}  // namespace blender
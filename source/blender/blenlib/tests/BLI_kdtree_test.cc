@@ -5,8 +5,13 @@
 #include "testing/testing.h"
 
 #include "BLI_kdtree.h"
+#include "BLI_math_vector.h"
+#include "BLI_rand.h"
 
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <vector>
 
 /* -------------------------------------------------------------------- */
 /* Tests */
@@ -63,3 +68,109 @@ TEST(kdtree, Deduplicate)
 {
   deduplicate_test();
 }
+
+static std::vector<std::array<float, 3>> random_points(const int points_num, const uint seed)
+{
+  RNG *rng = BLI_rng_new(seed);
+  std::vector<std::array<float, 3>> points(points_num);
+  for (std::array<float, 3> &point : points) {
+    for (float &value : point) {
+      value = BLI_rng_get_float(rng);
+    }
+  }
+  BLI_rng_free(rng);
+  return points;
+}
+
+static KDTree_3d *kdtree_from_points(const std::vector<std::array<float, 3>> &points)
+{
+  KDTree_3d *tree = BLI_kdtree_3d_new(points.size());
+  for (int i = 0; i < int(points.size()); i++) {
+    BLI_kdtree_3d_insert(tree, i, points[i].data());
+  }
+  BLI_kdtree_3d_balance(tree);
+  return tree;
+}
+
+static int find_nearest_brute_force(const std::vector<std::array<float, 3>> &points,
+                                    const float co[3])
+{
+  int nearest = -1;
+  float nearest_dist_sq = FLT_MAX;
+  for (int i = 0; i < int(points.size()); i++) {
+    const float dist_sq = len_squared_v3v3(points[i].data(), co);
+    if (dist_sq < nearest_dist_sq) {
+      nearest_dist_sq = dist_sq;
+      nearest = i;
+    }
+  }
+  return nearest;
+}
+
+/* Large enough to use the multi-threaded balancing. */
+TEST(kdtree, ParallelBalance)
+{
+  const std::vector<std::array<float, 3>> points = random_points(100000, 1);
+  KDTree_3d *tree = kdtree_from_points(points);
+  for (const std::array<float, 3> &query : random_points(100, 2)) {
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest(tree, query.data(), nullptr),
+              find_nearest_brute_force(points, query.data()));
+  }
+  BLI_kdtree_3d_free(tree);
+}
+
+TEST(kdtree, FindNearestNBatch)
+{
+  const std::vector<std::array<float, 3>> points = random_points(20000, 1);
+  const std::vector<std::array<float, 3>> queries = random_points(500, 2);
+  KDTree_3d *tree = kdtree_from_points(points);
+
+  const int nearest_n = 4;
+  std::vector<KDTreeNearest_3d> nearest(queries.size() * nearest_n);
+  std::vector<uint> nearest_len(queries.size());
+  BLI_kdtree_3d_find_nearest_n_batch(tree,
+                                     reinterpret_cast<const float(*)[3]>(queries.data()),
+                                     queries.size(),
+                                     nearest.data(),
+                                     nearest_n,
+                                     nearest_len.data());
+
+  for (int i = 0; i < int(queries.size()); i++) {
+    KDTreeNearest_3d expected[nearest_n];
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest_n(tree, queries[i].data(), expected, nearest_n),
+              int(nearest_len[i]));
+    for (int j = 0; j < int(nearest_len[i]); j++) {
+      EXPECT_EQ(nearest[i * nearest_n + j].index, expected[j].index);
+    }
+  }
+  BLI_kdtree_3d_free(tree);
+}
+
+TEST(kdtree, RangeSearchBatch)
+{
+  const std::vector<std::array<float, 3>> points = random_points(20000, 1);
+  const std::vector<std::array<float, 3>> queries = random_points(500, 2);
+  KDTree_3d *tree = kdtree_from_points(points);
+
+  const float range = 0.05f;
+  std::vector<std::atomic<int>> found_num(queries.size());
+  BLI_kdtree_3d_range_search_batch_cb_cpp(
+      tree,
+      reinterpret_cast<const float(*)[3]>(queries.data()),
+      queries.size(),
+      range,
+      [&](const int co_index, const int /*index*/, const float * /*co*/, const float dist_sq) {
+        EXPECT_LE(dist_sq, range * range);
+        found_num[co_index]++;
+        return true;
+      });
+
+  for (int i = 0; i < int(queries.size()); i++) {
+    int expected = 0;
+    for (const std::array<float, 3> &point : points) {
+      expected += len_squared_v3v3(point.data(), queries[i].data()) <= range * range;
+    }
+    EXPECT_EQ(found_num[i], expected);
+  }
+  BLI_kdtree_3d_free(tree);
+}
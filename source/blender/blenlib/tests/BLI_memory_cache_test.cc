@@ -80,4 +80,58 @@ TEST(memory_cache, Simple)
   }
 }
 
+TEST(memory_cache, LookupAddRemove)
+{
+  memory_cache::clear();
+  EXPECT_EQ(memory_cache::lookup<CachedInt>(GenericIntKey(0)), nullptr);
+
+  const std::shared_ptr<const CachedInt> value = std::dynamic_pointer_cast<const CachedInt>(
+      memory_cache::add(GenericIntKey(0), std::make_shared<CachedInt>(4)));
+  EXPECT_EQ(memory_cache::lookup<CachedInt>(GenericIntKey(0)), value);
+  EXPECT_EQ(value->value, 4);
+  /* The value that has been added first is kept. */
+  EXPECT_EQ(std::dynamic_pointer_cast<const CachedInt>(
+                memory_cache::add(GenericIntKey(0), std::make_shared<CachedInt>(5)))
+                ->value,
+            4);
+
+  memory_cache::add(GenericIntKey(1), std::make_shared<CachedInt>(6));
+  memory_cache::remove(GenericIntKey(0));
+  EXPECT_EQ(memory_cache::lookup<CachedInt>(GenericIntKey(0)), nullptr);
+  EXPECT_EQ(memory_cache::lookup<CachedInt>(GenericIntKey(1))->value, 6);
+  /* Removing a key that is not cached does nothing. */
+  memory_cache::remove(GenericIntKey(0));
+  EXPECT_EQ(memory_cache::get<CachedInt>(GenericIntKey(0), []() {
+              return std::make_unique<CachedInt>(7);
+            })->value,
+            7);
+  memory_cache::clear();
+}
+
+TEST(memory_cache, RemoveMany)
+{
+  memory_cache::clear();
+  for (int i = 0; i < 1000; i++) {
+    memory_cache::add(GenericIntKey(i), std::make_shared<CachedInt>(i));
+  }
+  /* Remove every other key in an order different from how they were added. */
+  for (int i = 998; i >= 0; i -= 2) {
+    memory_cache::remove(GenericIntKey(i));
+  }
+  for (int i = 0; i < 1000; i++) {
+    const std::shared_ptr<const CachedInt> value = memory_cache::lookup<CachedInt>(
+        GenericIntKey(i));
+    if (i % 2 == 0) {
+      EXPECT_EQ(value, nullptr);
+    }
+    else {
+      ASSERT_NE(value, nullptr);
+      EXPECT_EQ(value->value, i);
+    }
+  }
+  /* Clearing after removing must not touch the removed keys. */
+  memory_cache::clear();
+  EXPECT_EQ(memory_cache::lookup<CachedInt>(GenericIntKey(1)), nullptr);
+}
+
 }  // namespace blender::memory_cache::tests
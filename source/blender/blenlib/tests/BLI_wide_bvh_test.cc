@@ -0,0 +1,304 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
+#include "BLI_rand.hh"
+#include "BLI_vector.hh"
+#include "BLI_wide_bvh.hh"
+
+namespace blender::tests {
+
+static Vector<float3> random_points(const int points_num, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Vector<float3> points;
+  for ([[maybe_unused]] const int i : IndexRange(points_num)) {
+    points.append(float3(rng.get_float(), rng.get_float(), rng.get_float()) * 10.0f - 5.0f);
+  }
+  return points;
+}
+
+static Vector<Bounds<float3>> point_bounds(const Span<float3> points, const float radius)
+{
+  Vector<Bounds<float3>> bounds;
+  for (const float3 &point : points) {
+    bounds.append({point - radius, point + radius});
+  }
+  return bounds;
+}
+
+TEST(wide_bvh, Empty)
+{
+  WideBVH bvh({}, {});
+  EXPECT_TRUE(bvh.is_empty());
+  EXPECT_EQ(bvh.find_nearest(float3(0.0f), nullptr, nullptr, nullptr), -1);
+}
+
+static void test_find_nearest(const int points_num)
+{
+  const Vector<float3> points = random_points(points_num, 42);
+  const Vector<Bounds<float3>> bounds = point_bounds(points, 0.0f);
+  Vector<int> indices;
+  for (const int i : points.index_range()) {
+    indices.append(i * 2);
+  }
+  WideBVH bvh(indices, bounds);
+
+  for (const float3 &query : random_points(100, 7)) {
+    int expected = -1;
+    float expected_dist_sq = FLT_MAX;
+    for (const int i : points.index_range()) {
+      const float dist_sq = math::distance_squared(query, points[i]);
+      if (dist_sq < expected_dist_sq) {
+        expected_dist_sq = dist_sq;
+        expected = i * 2;
+      }
+    }
+    BVHTreeNearest nearest;
+    nearest.index = -1;
+    nearest.dist_sq = FLT_MAX;
+    EXPECT_EQ(bvh.find_nearest(query, &nearest, nullptr, nullptr), expected);
+    EXPECT_FLOAT_EQ(nearest.dist_sq, expected_dist_sq);
+  }
+}
+
+TEST(wide_bvh, FindNearestSmall)
+{
+  test_find_nearest(3);
+}
+
+TEST(wide_bvh, FindNearestLarge)
+{
+  test_find_nearest(20000);
+}
+
+TEST(wide_bvh, FindNearestCoincident)
+{
+  const Vector<float3> points(100, float3(1.0f, 2.0f, 3.0f));
+  const Vector<Bounds<float3>> bounds = point_bounds(points, 0.0f);
+  Vector<int> indices;
+  for (const int i : points.index_range()) {
+    indices.append(i);
+  }
+  WideBVH bvh(indices, bounds);
+  EXPECT_NE(bvh.find_nearest(float3(0.0f), nullptr, nullptr, nullptr), -1);
+}
+
+TEST(wide_bvh, Refit)
+{
+  Vector<float3> points = random_points(5000, 42);
+  Vector<int> indices;
+  for (const int i : points.index_range()) {
+    indices.append(i);
+  }
+  WideBVH bvh(indices, point_bounds(points, 0.0f));
+
+  /* A small deformation keeps the tree structure good enough. */
+  for (float3 &point : points) {
+    point += float3(std::sin(point.y), 0.0f, 0.0f) * 0.1f;
+  }
+  EXPECT_TRUE(bvh.refit(point_bounds(points, 0.0f)));
+
+  for (const float3 &query : random_points(100, 7)) {
+    int expected = -1;
+    float expected_dist_sq = FLT_MAX;
+    for (const int i : points.index_range()) {
+      const float dist_sq = math::distance_squared(query, points[i]);
+      if (dist_sq < expected_dist_sq) {
+        expected_dist_sq = dist_sq;
+        expected = i;
+      }
+    }
+    EXPECT_EQ(bvh.find_nearest(query, nullptr, nullptr, nullptr), expected);
+  }
+}
+
+TEST(wide_bvh, HasIndices)
+{
+  const Vector<float3> points = random_points(1000, 42);
+  Vector<int> indices;
+  for (const int i : points.index_range()) {
+    indices.append(i * 2);
+  }
+  const WideBVH bvh(indices, point_bounds(points, 0.0f));
+  EXPECT_TRUE(bvh.has_indices(indices));
+
+  /* The same number of primitives with different indices, like when a different set of
+   * elements is hidden. */
+  Vector<int> other_indices = indices;
+  other_indices[500] += 1;
+  EXPECT_FALSE(bvh.has_indices(other_indices));
+  EXPECT_FALSE(bvh.has_indices(indices.as_span().drop_back(1)));
+}
+
+TEST(wide_bvh, RefitDegraded)
+{
+  const Vector<float3> points = random_points(5000, 42);
+  Vector<int> indices;
+  for (const int i : points.index_range()) {
+    indices.append(i);
+  }
+  WideBVH bvh(indices, point_bounds(points, 0.0f));
+
+  /* Moving every point to a random place makes all nodes overlap. */
+  const Vector<float3> shuffled_points = random_points(5000, 43);
+  EXPECT_FALSE(bvh.refit(point_bounds(shuffled_points, 0.0f)));
+  EXPECT_EQ(bvh.find_nearest(shuffled_points[10], nullptr, nullptr, nullptr), 10);
+}
+
+struct SphereCastData {
+  Span<float3> centers;
+  float radius;
+};
+
+static void ray_sphere_callback(void *userdata,
+                                const int index,
+                                const BVHTreeRay *ray,
+                                BVHTreeRayHit *hit)
+{
+  const SphereCastData &data = *static_cast<const SphereCastData *>(userdata);
+  const float3 origin(ray->origin);
+  const float3 direction(ray->direction);
+  const float3 offset = origin - data.centers[index];
+  const float b = math::dot(offset, direction);
+  const float c = math::dot(offset, offset) - data.radius * data.radius;
+  const float discriminant = b * b - c;
+  if (discriminant < 0.0f) {
+    return;
+  }
+  const float dist = -b - std::sqrt(discriminant);
+  if (dist >= 0.0f && dist < hit->dist) {
+    hit->index = index;
+    hit->dist = dist;
+  }
+}
+
+TEST(wide_bvh, RayCast)
+{
+  const float radius = 0.1f;
+  const Vector<float3> centers = random_points(5000, 3);
+  const Vector<Bounds<float3>> bounds = point_bounds(centers, radius);
+  Vector<int> indices;
+  for (const int i : centers.index_range()) {
+    indices.append(i);
+  }
+  WideBVH bvh(indices, bounds);
+  SphereCastData data{centers, radius};
+
+  const Vector<float3> origins = random_points(200, 11);
+  const Vector<float3> targets = random_points(200, 13);
+  for (const int ray_i : origins.index_range()) {
+    const float3 direction = math::normalize(targets[ray_i] - origins[ray_i]);
+    BVHTreeRay ray;
+    copy_v3_v3(ray.origin, origins[ray_i]);
+    /* The tree normalizes the direction again, do the same to get exactly the same distances. */
+    copy_v3_v3(ray.direction, math::normalize(direction));
+    ray.radius = 0.0f;
+
+    BVHTreeRayHit expected;
+    expected.index = -1;
+    expected.dist = BVH_RAYCAST_DIST_MAX;
+    for (const int i : centers.index_range()) {
+      ray_sphere_callback(&data, i, &ray, &expected);
+    }
+
+    BVHTreeRayHit hit;
+    hit.index = -1;
+    hit.dist = BVH_RAYCAST_DIST_MAX;
+    bvh.ray_cast(origins[ray_i], direction, 0.0f, &hit, ray_sphere_callback, &data, 0);
+    EXPECT_EQ(hit.index, expected.index);
+    if (expected.index != -1) {
+      EXPECT_FLOAT_EQ(hit.dist, expected.dist);
+    }
+  }
+}
+
+TEST(wide_bvh, RayCastBatch)
+{
+  const float radius = 0.1f;
+  const Vector<float3> centers = random_points(5000, 3);
+  const Vector<Bounds<float3>> bounds = point_bounds(centers, radius);
+  Vector<int> indices;
+  for (const int i : centers.index_range()) {
+    indices.append(i);
+  }
+  WideBVH bvh(indices, bounds);
+  SphereCastData data{centers, radius};
+
+  const Vector<float3> origins = random_points(3000, 11);
+  Vector<float3> directions = random_points(3000, 13);
+  for (float3 &direction : directions) {
+    direction = math::normalize(direction);
+  }
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      origins.index_range(), GrainSize(512), memory, [](const int i) { return i % 3 != 0; });
+
+  Array<BVHTreeRayHit> hits(origins.size());
+  for (BVHTreeRayHit &hit : hits) {
+    hit.index = -2;
+    hit.dist = BVH_RAYCAST_DIST_MAX;
+  }
+  bvh.ray_cast_batch(mask, origins, directions, 0.0f, hits, ray_sphere_callback, &data, 0);
+
+  for (const int i : origins.index_range()) {
+    if (!mask.contains(i)) {
+      EXPECT_EQ(hits[i].index, -2);
+      continue;
+    }
+    BVHTreeRayHit expected;
+    expected.index = -2;
+    expected.dist = BVH_RAYCAST_DIST_MAX;
+    bvh.ray_cast(origins[i], directions[i], 0.0f, &expected, ray_sphere_callback, &data, 0);
+    EXPECT_EQ(hits[i].index, expected.index);
+    EXPECT_EQ(hits[i].dist, expected.dist);
+  }
+}
+
+TEST(wide_bvh, FindNearestBatch)
+{
+  const Vector<float3> points = random_points(5000, 42);
+  const Vector<Bounds<float3>> bounds = point_bounds(points, 0.0f);
+  Vector<int> indices;
+  for (const int i : points.index_range()) {
+    indices.append(i);
+  }
+  WideBVH bvh(indices, bounds);
+
+  const Vector<float3> queries = random_points(2000, 7);
+  Array<BVHTreeNearest> nearest(queries.size());
+  for (BVHTreeNearest &item : nearest) {
+    item.index = -1;
+    item.dist_sq = FLT_MAX;
+  }
+  bvh.find_nearest_batch(queries.index_range(), queries, nearest, nullptr, nullptr);
+
+  for (const int i : queries.index_range()) {
+    EXPECT_EQ(nearest[i].index, bvh.find_nearest(queries[i], nullptr, nullptr, nullptr));
+  }
+}
+
+TEST(wide_bvh, RayCastAxisAligned)
+{
+  const float radius = 0.5f;
+  const Vector<float3> centers = {float3(0.0f, 0.0f, 5.0f), float3(0.0f, 0.0f, 2.0f)};
+  const Vector<Bounds<float3>> bounds = point_bounds(centers, radius);
+  WideBVH bvh(Vector<int>{0, 1}, bounds);
+  SphereCastData data{centers, radius};
+
+  BVHTreeRayHit hit;
+  hit.index = -1;
+  hit.dist = BVH_RAYCAST_DIST_MAX;
+  bvh.ray_cast(
+      float3(0.0f), float3(0.0f, 0.0f, 1.0f), 0.0f, &hit, ray_sphere_callback, &data, 0);
+  EXPECT_EQ(hit.index, 1);
+  EXPECT_FLOAT_EQ(hit.dist, 1.5f);
+}
+
+}  // namespace blender::tests
@@ -52,6 +52,12 @@ enum {
    * (written to #BLENDER_STARTUP_FILE & #BLENDER_USERPREF_FILE).
    */
   BLO_CODE_USER = BLEND_MAKE_ID('U', 'S', 'E', 'R'),
+  /**
+   * Index of all blocks except #BLO_CODE_DATA, with their file offsets and ID names,
+   * written right before #BLO_CODE_ENDB. Allows to list the IDs of a file without reading it all.
+   * (ignored for regular file reading).
+   */
+  BLO_CODE_INDX = BLEND_MAKE_ID('I', 'N', 'D', 'X'),
   /**
    * Terminate reading (no data).
    */
@@ -30,10 +30,12 @@ struct MemFileSharedStorage {
 
 struct MemFileChunk {
   void *next, *prev;
+  /** Reference counted buffer, possibly shared with chunks of any other #MemFile. */
   const char *buf;
   /** Size in bytes. */
   size_t size;
-  /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  /** When true, this chunk is identical to the matching one in the previous step (used by undo
+   * code to detect unchanged IDs). */
   bool is_identical;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
@@ -46,7 +48,15 @@ struct MemFileChunk {
 
 struct MemFile {
   ListBase chunks;
+  /** Size of the data added by this memfile, i.e. not shared with previous ones when written. */
   size_t size;
+  /** Estimated size of the implicitly shared data in #shared_storage. */
+  size_t shared_size;
+  /**
+   * Size of the chunk buffers this memfile is the most recent user of. Maintained by the chunk
+   * store as buffers gain and lose users.
+   */
+  size_t chunks_unique_size;
   /**
    * Some data is not serialized into a new buffer because the undo-step can take ownership of it
    * without making a copy. This is faster and requires less memory.
@@ -101,8 +111,20 @@ void BLO_memfile_free(MemFile *memfile);
 /**
  * Result is that 'first' is being freed.
  * To keep the #MemFile linked list of consistent, `first` is always first in list.
+ *
+ * \note Chunk buffers are reference counted, so this is the same as freeing `first`.
  */
 void BLO_memfile_merge(MemFile *first, MemFile *second);
+/**
+ * Memory used by the memfile, where buffers shared with other memfiles are only counted for the
+ * most recent one using them. The sum from the newest memfile down to any older one is the memory
+ * needed to keep all of them.
+ */
+size_t BLO_memfile_size_unique(const MemFile *memfile);
+/**
+ * Free the global store used to share chunk buffers between memfiles, on exit.
+ */
+void BLO_memfile_chunk_store_free();
 /**
  * Clear is_identical_future before adding next memfile.
  */
@@ -9,6 +9,7 @@
  * \brief external `writefile.cc` function prototypes.
  */
 
+struct BlendFileSnapshot;
 struct BlendThumbnail;
 struct Main;
 struct MemFile;
@@ -59,4 +60,23 @@ extern bool BLO_write_file(Main *mainvar,
  */
 extern bool BLO_write_file_mem(Main *mainvar, MemFile *compare, MemFile *current, int write_flags);
 
+/**
+ * Serialize \a mainvar in memory, so that it can be written to disk later, from any thread,
+ * with #BLO_write_snapshot_to_file. Implicitly shared data is referenced instead of copied.
+ * Main is validated in the same way as by #BLO_write_file.
+ *
+ * \return nullptr on failure.
+ */
+BlendFileSnapshot *BLO_write_snapshot_create(Main *mainvar,
+                                             int write_flags,
+                                             ReportList *reports);
+/**
+ * Write a snapshot to \a filepath (through a temporary file), thread-safe.
+ * Compressed when the snapshot was created with #G_FILE_COMPRESS.
+ *
+ * \return Success.
+ */
+bool BLO_write_snapshot_to_file(const BlendFileSnapshot *snapshot, const char *filepath);
+void BLO_write_snapshot_free(BlendFileSnapshot *snapshot);
+
 /** \} */
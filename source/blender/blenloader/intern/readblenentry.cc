@@ -89,7 +89,7 @@ LinkNode *BLO_blendhandle_get_datablock_names(BlendHandle *bh,
   BHead *bhead;
   int tot = 0;
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next_indexed(fd, bhead)) {
     if (bhead->code == ofblocktype) {
       const char *idname = blo_bhead_id_name(fd, bhead);
       if (use_assets_only && blo_bhead_id_asset_data_address(fd, bhead) == nullptr) {
@@ -120,7 +120,7 @@ LinkNode *BLO_blendhandle_get_datablock_info(BlendHandle *bh,
 
   const int sdna_nr_preview_image = DNA_struct_find_with_alias(fd->filesdna, "PreviewImage");
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next_indexed(fd, bhead)) {
     if (bhead->code == BLO_CODE_ENDB) {
       break;
     }
@@ -223,7 +223,9 @@ PreviewImage *BLO_blendhandle_get_preview_for_id(BlendHandle *bh,
   bool looking = false;
   const int sdna_preview_image = DNA_struct_find_with_alias(fd->filesdna, "PreviewImage");
 
-  for (BHead *bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  for (BHead *bhead = blo_bhead_first(fd); bhead;
+       bhead = looking ? blo_bhead_next(fd, bhead) : blo_bhead_next_indexed(fd, bhead))
+  {
     if (bhead->code == BLO_CODE_DATA) {
       if (looking && bhead->SDNAnr == sdna_preview_image) {
         PreviewImage *preview_from_file = static_cast<PreviewImage *>(
@@ -263,7 +265,7 @@ LinkNode *BLO_blendhandle_get_linkable_groups(BlendHandle *bh)
   LinkNode *names = nullptr;
   BHead *bhead;
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next_indexed(fd, bhead)) {
     if (bhead->code == BLO_CODE_ENDB) {
       break;
     }
@@ -50,6 +50,7 @@
 #include "MEM_alloc_string_storage.hh"
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
@@ -58,8 +59,10 @@
 #include "BLI_map.hh"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_time.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -193,6 +196,11 @@ struct BHeadN {
   off64_t file_offset;
   /** When set, the remainder of this allocation is the data, otherwise it needs to be read. */
   bool has_data;
+  /**
+   * When set, the blocks in the file between this one and #next have not been read yet. Only used
+   * for lists created from the #BLO_CODE_INDX index, see #read_file_bhead_index.
+   */
+  bool has_unread_next;
 #endif
   bool is_memchunk_identical;
   BHead bhead;
@@ -201,10 +209,15 @@ struct BHeadN {
 #define BHEADN_FROM_BHEAD(bh) ((BHeadN *)POINTER_OFFSET(bh, -int(offsetof(BHeadN, bhead))))
 
 /**
- * We could change this in the future, for now it's simplest if only data is delayed
- * because ID names are used in lookup tables.
+ * Data blocks are always delayed. ID blocks are delayed as well, but keep their first
+ * #BHEAD_ID_PREFIX_LEN bytes in memory since ID names are used in lookup tables. This way opening
+ * a file only keeps a compact index of all blocks and their file offsets in memory, the actual
+ * content is only read for the IDs that are used (e.g. when linking a few IDs from a library).
  */
-#define BHEAD_USE_READ_ON_DEMAND(bhead) ((bhead)->code == BLO_CODE_DATA)
+#define BHEAD_USE_READ_ON_DEMAND(fd, bhead) \
+  ((bhead)->code == BLO_CODE_DATA || \
+   (blo_bhead_is_id(bhead) && (bhead)->len > BHEAD_ID_PREFIX_LEN && \
+    ((fd)->flags & FD_FLAGS_NO_ID_READ_ON_DEMAND) == 0))
 
 /* -------------------------------------------------------------------- */
 /** \name Blend Loader Reporting Wrapper
@@ -502,7 +515,7 @@ static void read_file_bhead_idname_map_create(FileData *fd)
   int code_prev = BLO_CODE_ENDB;
   uint reserve = 0;
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next_indexed(fd, bhead)) {
     if (code_prev != bhead->code) {
       code_prev = bhead->code;
       is_link = blo_bhead_is_id_valid_type(bhead) ?
@@ -519,7 +532,7 @@ static void read_file_bhead_idname_map_create(FileData *fd)
 
   fd->bhead_idname_hash = BLI_ghash_str_new_ex(__func__, reserve);
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next_indexed(fd, bhead)) {
     if (code_prev != bhead->code) {
       code_prev = bhead->code;
       is_link = blo_bhead_is_id_valid_type(bhead) ?
@@ -692,7 +705,8 @@ static void bh8_from_bh4(BHead *bhead, BHead4 *bhead4)
   }
 }
 
-static BHeadN *get_bhead(FileData *fd)
+/** Read the #BHead at the current file position, without adding it to the list. */
+static BHeadN *read_bhead(FileData *fd)
 {
   BHeadN *new_bhead = nullptr;
   int64_t readsize;
@@ -771,16 +785,22 @@ static BHeadN *get_bhead(FileData *fd)
         /* pass */
       }
 #ifdef USE_BHEAD_READ_ON_DEMAND
-      else if (fd->file->seek != nullptr && BHEAD_USE_READ_ON_DEMAND(&bhead)) {
-        /* Delay reading bhead content. */
-        new_bhead = static_cast<BHeadN *>(MEM_mallocN(sizeof(BHeadN), "new_bhead"));
+      else if (fd->file->seek != nullptr && BHEAD_USE_READ_ON_DEMAND(fd, &bhead)) {
+        /* Delay reading bhead content, only the leading part of IDs is needed right away. */
+        const int64_t prefix_len = blo_bhead_is_id(&bhead) ? BHEAD_ID_PREFIX_LEN : 0;
+        new_bhead = static_cast<BHeadN *>(MEM_mallocN(sizeof(BHeadN) + prefix_len, "new_bhead"));
         if (new_bhead) {
           new_bhead->next = new_bhead->prev = nullptr;
           new_bhead->file_offset = fd->file->offset;
           new_bhead->has_data = false;
+          new_bhead->has_unread_next = false;
           new_bhead->is_memchunk_identical = false;
           new_bhead->bhead = bhead;
-          const off64_t seek_new = fd->file->seek(fd->file, bhead.len, SEEK_CUR);
+          off64_t seek_new = -1;
+          if (prefix_len == 0 || fd->file->read(fd->file, new_bhead + 1, prefix_len) == prefix_len)
+          {
+            seek_new = fd->file->seek(fd->file, bhead.len - prefix_len, SEEK_CUR);
+          }
           if (UNLIKELY(seek_new == -1)) {
             fd->is_eof = true;
             MEM_freeN(new_bhead);
@@ -803,6 +823,7 @@ static BHeadN *get_bhead(FileData *fd)
 #ifdef USE_BHEAD_READ_ON_DEMAND
           new_bhead->file_offset = 0; /* don't seek. */
           new_bhead->has_data = true;
+          new_bhead->has_unread_next = false;
 #endif
           new_bhead->is_memchunk_identical = false;
           new_bhead->bhead = bhead;
@@ -826,6 +847,13 @@ static BHeadN *get_bhead(FileData *fd)
     }
   }
 
+  return new_bhead;
+}
+
+static BHeadN *get_bhead(FileData *fd)
+{
+  BHeadN *new_bhead = read_bhead(fd);
+
   /* We've read a new block. Now add it to the list
    * of blocks.
    */
@@ -836,6 +864,45 @@ static BHeadN *get_bhead(FileData *fd)
   return new_bhead;
 }
 
+#ifdef USE_BHEAD_READ_ON_DEMAND
+/**
+ * Read the blocks in between \a bheadn and the next block in the list, which were skipped when
+ * the list was created from the #BLO_CODE_INDX index.
+ */
+static void blo_bhead_read_unread_next(FileData *fd, BHeadN *bheadn)
+{
+  BLI_assert(bheadn->has_unread_next && bheadn->next != nullptr);
+  bheadn->has_unread_next = false;
+
+  const off64_t offset_end = bheadn->next->file_offset - off64_t(sizeof(BHead));
+  const off64_t offset_backup = fd->file->offset;
+  bool success = fd->file->seek(fd->file, bheadn->file_offset + bheadn->bhead.len, SEEK_SET) !=
+                 -1;
+
+  BHeadN *prev = bheadn;
+  while (success && fd->file->offset < offset_end) {
+    BHeadN *new_bhead = read_bhead(fd);
+    if (new_bhead == nullptr) {
+      success = false;
+      break;
+    }
+    BLI_insertlinkafter(&fd->bhead_list, prev, new_bhead);
+    prev = new_bhead;
+  }
+  if (fd->file->offset != offset_end) {
+    /* The skipped blocks don't line up with the index. */
+    success = false;
+  }
+
+  if (fd->file->seek(fd->file, offset_backup, SEEK_SET) == -1) {
+    success = false;
+  }
+  if (!success) {
+    fd->flags &= ~FD_FLAGS_FILE_OK;
+  }
+}
+#endif
+
 BHead *blo_bhead_first(FileData *fd)
 {
   BHeadN *new_bhead;
@@ -856,11 +923,20 @@ BHead *blo_bhead_first(FileData *fd)
   return bhead;
 }
 
-BHead *blo_bhead_prev(FileData * /*fd*/, BHead *thisblock)
+BHead *blo_bhead_prev(FileData *fd, BHead *thisblock)
 {
   BHeadN *bheadn = BHEADN_FROM_BHEAD(thisblock);
   BHeadN *prev = bheadn->prev;
 
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  if (prev && prev->has_unread_next) {
+    blo_bhead_read_unread_next(fd, prev);
+    prev = bheadn->prev;
+  }
+#else
+  UNUSED_VARS(fd);
+#endif
+
   return (prev) ? &prev->bhead : nullptr;
 }
 
@@ -874,6 +950,12 @@ BHead *blo_bhead_next(FileData *fd, BHead *thisblock)
      * We calculate the BHeadN pointer from the BHead pointer below */
     new_bhead = BHEADN_FROM_BHEAD(thisblock);
 
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    if (new_bhead->has_unread_next) {
+      blo_bhead_read_unread_next(fd, new_bhead);
+    }
+#endif
+
     /* get the next BHeadN. If it doesn't exist we read in the next one */
     new_bhead = new_bhead->next;
     if (new_bhead == nullptr) {
@@ -890,6 +972,18 @@ BHead *blo_bhead_next(FileData *fd, BHead *thisblock)
   return bhead;
 }
 
+BHead *blo_bhead_next_indexed(FileData *fd, BHead *thisblock)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  BHeadN *bheadn = BHEADN_FROM_BHEAD(thisblock);
+  if (bheadn->has_unread_next) {
+    /* Skip the #BLO_CODE_DATA blocks that weren't read yet. */
+    return &bheadn->next->bhead;
+  }
+#endif
+  return blo_bhead_next(fd, thisblock);
+}
+
 #ifdef USE_BHEAD_READ_ON_DEMAND
 static bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
 {
@@ -922,6 +1016,7 @@ static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
   new_bhead_data->bhead = new_bhead->bhead;
   new_bhead_data->file_offset = new_bhead->file_offset;
   new_bhead_data->has_data = true;
+  new_bhead_data->has_unread_next = new_bhead->has_unread_next;
   new_bhead_data->is_memchunk_identical = false;
   if (!blo_bhead_read_data(fd, thisblock, new_bhead_data + 1)) {
     MEM_freeN(new_bhead_data);
@@ -929,6 +1024,176 @@ static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
   }
   return &new_bhead_data->bhead;
 }
+
+/**
+ * Ensure the #ID members used for lookups of ID blocks that are read on demand are available, in
+ * the unlikely case the file DNA places them beyond #BHEAD_ID_PREFIX_LEN, read those IDs fully.
+ */
+static bool read_file_bhead_id_prefix_ensure(FileData *fd)
+{
+  const int prefix_len_needed = std::max(fd->id_name_offset + MAX_ID_NAME,
+                                         fd->id_asset_data_offset + fd->filesdna->pointer_size);
+  if (prefix_len_needed <= BHEAD_ID_PREFIX_LEN) {
+    return true;
+  }
+
+  LISTBASE_FOREACH_MUTABLE (BHeadN *, new_bhead, &fd->bhead_list) {
+    if (new_bhead->has_data || !blo_bhead_is_id(&new_bhead->bhead)) {
+      continue;
+    }
+    BHead *bhead_full = blo_bhead_read_full(fd, &new_bhead->bhead);
+    if (bhead_full == nullptr) {
+      return false;
+    }
+    BLI_insertlinkreplace(&fd->bhead_list, new_bhead, BHEADN_FROM_BHEAD(bhead_full));
+    MEM_freeN(new_bhead);
+  }
+  /* Also read the remaining ID blocks fully. */
+  fd->flags |= FD_FLAGS_NO_ID_READ_ON_DEMAND;
+  return true;
+}
+
+static bool read_file_bhead_index_impl(FileData *fd)
+{
+  FileReader *file = fd->file;
+
+  /* The index block is the last one before #BLO_CODE_ENDB and ends with #BHeadIndexTrailer. */
+  const off64_t offset_endb = file->seek(file, -off64_t(sizeof(BHead)), SEEK_END);
+  if (offset_endb < off64_t(SIZEOFBLENDERHEADER + sizeof(BHead) + sizeof(BHeadIndexTrailer))) {
+    return false;
+  }
+  BHead bhead_endb;
+  if (file->read(file, &bhead_endb, sizeof(BHead)) != sizeof(BHead) ||
+      bhead_endb.code != BLO_CODE_ENDB)
+  {
+    return false;
+  }
+
+  BHeadIndexTrailer trailer;
+  if (file->seek(file, offset_endb - off64_t(sizeof(trailer)), SEEK_SET) == -1 ||
+      file->read(file, &trailer, sizeof(trailer)) != sizeof(trailer) ||
+      memcmp(trailer.magic, BHEAD_INDEX_MAGIC, sizeof(trailer.magic)) != 0)
+  {
+    return false;
+  }
+
+  const off64_t offset_index = off64_t(trailer.index_bhead_offset);
+  BHead bhead_index;
+  if (offset_index < SIZEOFBLENDERHEADER || file->seek(file, offset_index, SEEK_SET) == -1 ||
+      file->read(file, &bhead_index, sizeof(BHead)) != sizeof(BHead) ||
+      bhead_index.code != BLO_CODE_INDX ||
+      offset_index + off64_t(sizeof(BHead)) + bhead_index.len != offset_endb ||
+      bhead_index.len < int(sizeof(BHeadIndexHeader) + sizeof(BHeadIndexTrailer)))
+  {
+    return false;
+  }
+
+  blender::Array<char> index_data(bhead_index.len, blender::NoInitialization());
+  if (file->read(file, index_data.data(), index_data.size()) != index_data.size()) {
+    return false;
+  }
+
+  BHeadIndexHeader header;
+  memcpy(&header, index_data.data(), sizeof(header));
+  const int64_t entries_end = int64_t(sizeof(header)) +
+                              int64_t(header.entries_num) * int64_t(sizeof(BHeadIndexEntry));
+  const int64_t prefixes_end = index_data.size() - int64_t(sizeof(BHeadIndexTrailer));
+  if (header.id_prefix_len != BHEAD_ID_PREFIX_LEN || header.entries_num <= 0 ||
+      entries_end > prefixes_end)
+  {
+    return false;
+  }
+  const BHeadIndexEntry *entries = reinterpret_cast<const BHeadIndexEntry *>(
+      index_data.data() + sizeof(header));
+  const char *id_prefix = index_data.data() + entries_end;
+
+  /* Blocks must not overlap and the first one must directly follow the file header, there is no
+   * list element to attach skipped blocks before it to. */
+  off64_t offset_prev_end = SIZEOFBLENDERHEADER;
+  for (int i = 0; i < header.entries_num; i++) {
+    const BHeadIndexEntry &entry = entries[i];
+    const BHead &bhead = entry.bhead;
+    const off64_t offset = off64_t(entry.offset);
+    if (bhead.code == BLO_CODE_DATA || bhead.len < 0 ||
+        offset < offset_prev_end + off64_t(sizeof(BHead)) ||
+        (i == 0 && offset != offset_prev_end + off64_t(sizeof(BHead))))
+    {
+      return false;
+    }
+    offset_prev_end = offset + bhead.len;
+
+    BHeadN *new_bhead;
+    if (blo_bhead_is_id(&bhead)) {
+      const int64_t prefix_len = std::min<int64_t>(bhead.len, BHEAD_ID_PREFIX_LEN);
+      if (id_prefix + prefix_len > index_data.data() + prefixes_end) {
+        return false;
+      }
+      new_bhead = static_cast<BHeadN *>(MEM_mallocN(sizeof(BHeadN) + prefix_len, "new_bhead"));
+      memcpy(new_bhead + 1, id_prefix, prefix_len);
+      new_bhead->has_data = (prefix_len == bhead.len);
+      id_prefix += prefix_len;
+    }
+    else {
+      /* Global blocks (#BLO_CODE_GLOB, #BLO_CODE_DNA1, ...) are read right away as usual. */
+      new_bhead = static_cast<BHeadN *>(MEM_mallocN(sizeof(BHeadN) + bhead.len, "new_bhead"));
+      new_bhead->has_data = true;
+      if (file->seek(file, offset, SEEK_SET) == -1 ||
+          file->read(file, new_bhead + 1, bhead.len) != bhead.len)
+      {
+        MEM_freeN(new_bhead);
+        return false;
+      }
+    }
+    new_bhead->next = new_bhead->prev = nullptr;
+    new_bhead->file_offset = offset;
+    new_bhead->has_unread_next = true;
+    new_bhead->is_memchunk_identical = false;
+    new_bhead->bhead = bhead;
+    BLI_addtail(&fd->bhead_list, new_bhead);
+  }
+
+  /* The index directly follows the last indexed block (#BLO_CODE_DNA1). */
+  if (offset_prev_end != offset_index) {
+    return false;
+  }
+  static_cast<BHeadN *>(fd->bhead_list.last)->has_unread_next = false;
+
+  BHeadN *new_bhead_endb = static_cast<BHeadN *>(MEM_mallocN(sizeof(BHeadN), "new_bhead"));
+  new_bhead_endb->next = new_bhead_endb->prev = nullptr;
+  new_bhead_endb->file_offset = offset_endb + off64_t(sizeof(BHead));
+  new_bhead_endb->has_data = true;
+  new_bhead_endb->has_unread_next = false;
+  new_bhead_endb->is_memchunk_identical = false;
+  new_bhead_endb->bhead = bhead_endb;
+  BLI_addtail(&fd->bhead_list, new_bhead_endb);
+
+  /* Continue reading after #BLO_CODE_ENDB, like after scanning the whole file. */
+  return file->seek(file, 0, SEEK_END) != -1;
+}
+
+/**
+ * Create the #BHead list from the #BLO_CODE_INDX index at the end of the file, instead of scanning
+ * all blocks. The #BLO_CODE_DATA blocks in between the indexed blocks are only read when iterating
+ * over them with #blo_bhead_next.
+ *
+ * Only used when the file has the same endianness and pointer size as the current platform,
+ * otherwise (or for files without index) the list is created by scanning the file as usual.
+ */
+static void read_file_bhead_index(FileData *fd)
+{
+  BLI_assert(BLI_listbase_is_empty(&fd->bhead_list));
+  if (fd->file->seek == nullptr ||
+      (fd->flags & (FD_FLAGS_SWITCH_ENDIAN | FD_FLAGS_POINTSIZE_DIFFERS | FD_FLAGS_IS_MEMFILE)))
+  {
+    return;
+  }
+
+  const off64_t offset_backup = fd->file->offset;
+  if (!read_file_bhead_index_impl(fd)) {
+    BLI_freelistN(&fd->bhead_list);
+    fd->file->seek(fd->file, offset_backup, SEEK_SET);
+  }
+}
 #endif /* USE_BHEAD_READ_ON_DEMAND */
 
 const char *blo_bhead_id_name(const FileData *fd, const BHead *bhead)
@@ -999,7 +1264,7 @@ static bool read_file_dna(FileData *fd, const char **r_error_message)
   BHead *bhead;
   int subversion = 0;
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next_indexed(fd, bhead)) {
     if (bhead->code == BLO_CODE_GLOB) {
       /* Before this, the subversion didn't exist in 'FileGlobal' so the subversion
        * value isn't accessible for the purpose of DNA versioning in this case. */
@@ -1035,6 +1300,13 @@ static bool read_file_dna(FileData *fd, const char **r_error_message)
         fd->id_asset_data_offset = DNA_struct_member_offset_by_name_with_alias(
             fd->filesdna, "ID", "AssetMetaData", "*asset_data");
 
+#ifdef USE_BHEAD_READ_ON_DEMAND
+        if (!read_file_bhead_id_prefix_ensure(fd)) {
+          *r_error_message = "Failed to read ID blocks";
+          return false;
+        }
+#endif
+
         return true;
       }
 
@@ -1168,6 +1440,11 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
   decode_blender_header(fd);
 
   if (fd->flags & FD_FLAGS_FILE_OK) {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    /* Avoid scanning all blocks when the file has an index. */
+    read_file_bhead_index(fd);
+#endif
+
     const char *error_message = nullptr;
     if (read_file_dna(fd, &error_message) == false) {
       BKE_reportf(
@@ -1198,9 +1475,14 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
   return fd;
 }
 
+/**
+ * \param use_readahead: Decompress ahead of the read position on worker threads,
+ * only worth it when the whole file is going to be read.
+ */
 static FileData *blo_filedata_from_file_descriptor(const char *filepath,
                                                    BlendFileReadReport *reports,
-                                                   int filedes)
+                                                   int filedes,
+                                                   const bool use_readahead)
 {
   char header[7];
   FileReader *rawfile = BLI_filereader_new_file(filedes);
@@ -1243,7 +1525,8 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
     }
   }
   else if (BLI_file_magic_is_zstd(header)) {
-    file = BLI_filereader_new_zstd(rawfile);
+    file = use_readahead ? BLI_filereader_new_zstd_readahead(rawfile) :
+                           BLI_filereader_new_zstd(rawfile);
     if (file != nullptr) {
       rawfile = nullptr; /* The `Zstd` #FileReader takes ownership of `rawfile`. */
     }
@@ -1264,7 +1547,9 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   return fd;
 }
 
-static FileData *blo_filedata_from_file_open(const char *filepath, BlendFileReadReport *reports)
+static FileData *blo_filedata_from_file_open(const char *filepath,
+                                             BlendFileReadReport *reports,
+                                             const bool use_readahead)
 {
   errno = 0;
   const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
@@ -1276,12 +1561,12 @@ static FileData *blo_filedata_from_file_open(const char *filepath, BlendFileRead
                 errno ? strerror(errno) : RPT_("unknown error reading file"));
     return nullptr;
   }
-  return blo_filedata_from_file_descriptor(filepath, reports, file);
+  return blo_filedata_from_file_descriptor(filepath, reports, file, use_readahead);
 }
 
 FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *reports)
 {
-  FileData *fd = blo_filedata_from_file_open(filepath, reports);
+  FileData *fd = blo_filedata_from_file_open(filepath, reports, true);
   if (fd != nullptr) {
     /* needed for library_append and read_libraries */
     STRNCPY(fd->relabase, filepath);
@@ -1298,7 +1583,7 @@ FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *repo
 static FileData *blo_filedata_from_file_minimal(const char *filepath)
 {
   BlendFileReadReport read_report{};
-  FileData *fd = blo_filedata_from_file_open(filepath, &read_report);
+  FileData *fd = blo_filedata_from_file_open(filepath, &read_report, false);
   if (fd != nullptr) {
     decode_blender_header(fd);
     if (fd->flags & FD_FLAGS_FILE_OK) {
@@ -1365,7 +1650,7 @@ void blo_filedata_free(FileData *fd)
   /* Sanity check we're not keeping memory we don't need. */
   LISTBASE_FOREACH_MUTABLE (BHeadN *, new_bhead, &fd->bhead_list) {
 #  ifdef USE_BHEAD_READ_ON_DEMAND
-    if (fd->file->seek != nullptr && BHEAD_USE_READ_ON_DEMAND(&new_bhead->bhead)) {
+    if (fd->file->seek != nullptr && BHEAD_USE_READ_ON_DEMAND(fd, &new_bhead->bhead)) {
       BLI_assert(new_bhead->has_data == 0);
     }
 #  endif
@@ -1880,6 +2165,117 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname, const i
   return temp;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Threaded Struct Conversion
+ *
+ * Converting blocks written with a different SDNA or endianness is CPU bound, while reading them
+ * is mostly bound by I/O. Large blocks are converted by worker threads, so that the main thread
+ * can keep reading the following data blocks of the same ID in the mean time.
+ * \{ */
+
+/** Smaller blocks are converted directly, the overhead of a task is not worth it for them. */
+#define READ_STRUCT_THREADED_MIN_SIZE (64 * 1024)
+
+struct ReadStructTask {
+  const SDNA *filesdna;
+  const DNA_ReconstructInfo *reconstruct_info;
+  /** Block with its data fully read, owned by the task when `bh_owned` is set. */
+  BHead *bh;
+  bool bh_owned;
+  bool switch_endian;
+  bool reconstruct;
+  const char *alloc_name;
+  /** Converted data, only valid once the task pool has finished. */
+  void *result;
+};
+
+/**
+ * Whether reading \a bh requires a conversion that is worth doing in a worker thread.
+ * Must match the logic of #read_struct.
+ */
+static bool read_struct_use_thread(FileData *fd, BHead *bh)
+{
+  if (bh->len < READ_STRUCT_THREADED_MIN_SIZE) {
+    return false;
+  }
+  if (fd->compflags[bh->SDNAnr] == SDNA_CMP_REMOVED) {
+    return false;
+  }
+  if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+    return true;
+  }
+  return (bh->SDNAnr > SDNA_RAW_DATA_STRUCT_INDEX) && (fd->flags & FD_FLAGS_SWITCH_ENDIAN);
+}
+
+static void read_struct_task_run(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  ReadStructTask *task = static_cast<ReadStructTask *>(taskdata);
+  BHead *bh = task->bh;
+
+  if (task->switch_endian) {
+    switch_endian_structs(task->filesdna, bh);
+  }
+
+  if (task->reconstruct) {
+    task->result = DNA_struct_reconstruct(
+        task->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1), task->alloc_name);
+  }
+  else {
+    const int alignment = DNA_struct_alignment(task->filesdna, bh->SDNAnr);
+    task->result = MEM_mallocN_aligned(bh->len, alignment, task->alloc_name);
+    memcpy(task->result, (bh + 1), bh->len);
+  }
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  if (task->bh_owned) {
+    MEM_freeN(BHEADN_FROM_BHEAD(bh));
+  }
+#endif
+}
+
+/**
+ * Same as #read_struct, but the conversion is pushed to \a task_pool.
+ * The result is stored in the returned task once the pool finished its work.
+ *
+ * \return nullptr when the block data could not be read.
+ */
+static ReadStructTask *read_struct_threaded(FileData *fd,
+                                            TaskPool *task_pool,
+                                            BHead *bh,
+                                            const char *blockname,
+                                            const int id_type_index)
+{
+  BLI_assert(read_struct_use_thread(fd, bh));
+
+  ReadStructTask *task = MEM_cnew<ReadStructTask>(__func__);
+  task->filesdna = fd->filesdna;
+  task->reconstruct_info = fd->reconstruct_info;
+  task->switch_endian = (bh->SDNAnr > SDNA_RAW_DATA_STRUCT_INDEX) &&
+                        (fd->flags & FD_FLAGS_SWITCH_ENDIAN);
+  task->reconstruct = fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL;
+  task->alloc_name = get_alloc_name(fd, bh, blockname, id_type_index);
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
+    BHead *bh_full = blo_bhead_read_full(fd, bh);
+    if (UNLIKELY(bh_full == nullptr)) {
+      fd->flags &= ~FD_FLAGS_FILE_OK;
+      MEM_freeN(task);
+      return nullptr;
+    }
+    bh = bh_full;
+    task->bh_owned = true;
+  }
+#endif
+  task->bh = bh;
+
+  /* Task data is freed by the caller, after it took ownership of the result. */
+  BLI_task_pool_push(task_pool, read_struct_task_run, task, false, nullptr);
+  return task;
+}
+
+/** \} */
+
 /* Like read_struct, but gets a pointer without allocating. Only works for
  * undo since DNA must match. */
 static const void *peek_struct_undo(FileData *fd, BHead *bhead)
@@ -2481,23 +2877,62 @@ static BHead *read_data_into_datamap(FileData *fd,
                                      const char *allocname,
                                      const int id_type_index)
 {
+  struct DataBlock {
+    const void *old;
+    void *data;
+    ReadStructTask *task;
+  };
+  blender::Vector<DataBlock, 16> blocks;
+  /* Only created when there is a large block to convert. */
+  TaskPool *task_pool = nullptr;
+  const bool use_threads = BLI_task_scheduler_num_threads() > 1;
+
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == BLO_CODE_DATA) {
-    void *data = read_struct(fd, bhead, allocname, id_type_index);
-    if (data) {
-      const bool is_new = oldnewmap_insert(fd->datamap, bhead->old, data, 0);
-      if (!is_new) {
-        CLOG_ERROR(&LOG,
-                   "Blendfile corruption: Invalid, or multiple `bhead` with same old address "
-                   "value (%p) for a given ID.",
-                   bhead->old);
+    if (use_threads && read_struct_use_thread(fd, bhead)) {
+      if (task_pool == nullptr) {
+        task_pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+      }
+      ReadStructTask *task = read_struct_threaded(
+          fd, task_pool, bhead, allocname, id_type_index);
+      if (task) {
+        blocks.append({bhead->old, nullptr, task});
+      }
+    }
+    else {
+      void *data = read_struct(fd, bhead, allocname, id_type_index);
+      if (data) {
+        blocks.append({bhead->old, data, nullptr});
       }
     }
 
     bhead = blo_bhead_next(fd, bhead);
   }
 
+  if (task_pool) {
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+  }
+
+  /* Insert in file order, so that the same block wins in case of duplicate addresses. */
+  for (DataBlock &block : blocks) {
+    if (block.task) {
+      block.data = block.task->result;
+      MEM_freeN(block.task);
+    }
+    if (block.data == nullptr) {
+      continue;
+    }
+    const bool is_new = oldnewmap_insert(fd->datamap, block.old, block.data, 0);
+    if (!is_new) {
+      CLOG_ERROR(&LOG,
+                 "Blendfile corruption: Invalid, or multiple `bhead` with same old address "
+                 "value (%p) for a given ID.",
+                 block.old);
+    }
+  }
+
   return bhead;
 }
 
@@ -3878,7 +4313,8 @@ static void sort_bhead_old_map(FileData *fd)
   BHeadSort *bhs;
   int tot = 0;
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  /* Only used to look up IDs, no need to read skipped #BLO_CODE_DATA blocks. */
+  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next_indexed(fd, bhead)) {
     tot++;
   }
 
@@ -3890,7 +4326,7 @@ static void sort_bhead_old_map(FileData *fd)
   bhs = fd->bheadmap = static_cast<BHeadSort *>(
       MEM_malloc_arrayN(tot, sizeof(BHeadSort), "BHeadSort"));
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead), bhs++) {
+  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next_indexed(fd, bhead), bhs++) {
     bhs->bhead = bhead;
     bhs->old = bhead->old;
   }
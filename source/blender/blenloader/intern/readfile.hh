@@ -48,8 +48,13 @@ enum eFileDataFlag {
    * 'from the future'. Improves report to the user.
    */
   FD_FLAGS_FILE_FUTURE = 1 << 5,
+  /**
+   * ID blocks are read fully when reading the #BHead, instead of on demand.
+   * Only needed for file layouts where the leading part of an ID block doesn't contain its name.
+   */
+  FD_FLAGS_NO_ID_READ_ON_DEMAND = 1 << 6,
 };
-ENUM_OPERATORS(eFileDataFlag, FD_FLAGS_IS_MEMFILE)
+ENUM_OPERATORS(eFileDataFlag, FD_FLAGS_NO_ID_READ_ON_DEMAND)
 
 /* Disallow since it's 32bit on ms-windows. */
 #ifdef __GNUC__
@@ -154,6 +159,43 @@ struct FileData {
 
 #define SIZEOFBLENDERHEADER 12
 
+/**
+ * Leading part of ID blocks that is read right away when the rest of the block is read on demand.
+ * Enough to cover the #ID members used for lookups (see #blo_bhead_id_name and
+ * #blo_bhead_id_asset_data_address) in all known file layouts, this is verified once the file
+ * DNA is known.
+ */
+#define BHEAD_ID_PREFIX_LEN 256
+
+/**
+ * Content of the #BLO_CODE_INDX block, in the byte order and pointer size of the file:
+ * - #BHeadIndexHeader.
+ * - #BHeadIndexHeader.entries_num times #BHeadIndexEntry, for all blocks up to and including
+ *   #BLO_CODE_DNA1 that are not #BLO_CODE_DATA, in file order.
+ * - For each ID block in the entries, its first `min(len, BHeadIndexHeader.id_prefix_len)` bytes.
+ * - Padding to a multiple of 8 bytes.
+ * - #BHeadIndexTrailer.
+ */
+struct BHeadIndexHeader {
+  int entries_num;
+  /** Always #BHEAD_ID_PREFIX_LEN currently. */
+  int id_prefix_len;
+};
+
+struct BHeadIndexEntry {
+  BHead bhead;
+  /** Position of the block data (after its #BHead) in the uncompressed file. */
+  uint64_t offset;
+};
+
+struct BHeadIndexTrailer {
+  /** Position of the #BHead of the #BLO_CODE_INDX block in the uncompressed file. */
+  uint64_t index_bhead_offset;
+  char magic[8];
+};
+
+#define BHEAD_INDEX_MAGIC "BHEADIDX"
+
 /***/
 void blo_join_main(ListBase *mainlist);
 void blo_split_main(ListBase *mainlist, Main *main);
@@ -188,6 +230,12 @@ void blo_filedata_free(FileData *fd) ATTR_NONNULL(1);
 
 BHead *blo_bhead_first(FileData *fd) ATTR_NONNULL(1);
 BHead *blo_bhead_next(FileData *fd, BHead *thisblock) ATTR_NONNULL(1);
+/**
+ * Same as #blo_bhead_next, but skips #BLO_CODE_DATA blocks that were not read yet because the
+ * #BHead list was created from the file's #BLO_CODE_INDX index. Use when only ID and global blocks
+ * are of interest.
+ */
+BHead *blo_bhead_next_indexed(FileData *fd, BHead *thisblock) ATTR_NONNULL(1, 2);
 BHead *blo_bhead_prev(FileData *fd, BHead *thisblock) ATTR_NONNULL(1, 2);
 
 /**
@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <mutex>
 
 /* open/close */
 #ifndef _WIN32
@@ -26,6 +27,8 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_implicit_sharing.hh"
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
 
 #include "BLO_readfile.hh"
 #include "BLO_undofile.hh"
@@ -34,21 +37,173 @@
 #include "BKE_main.hh"
 #include "BKE_undo_system.hh"
 
+#include <xxhash.h>
+
 #include "BLI_strict_flags.h" /* Keep last. */
 
+/* -------------------------------------------------------------------- */
+/** \name Chunk Store
+ *
+ * Chunk buffers are reference counted and de-duplicated by content between all memfiles (i.e.
+ * the whole undo stack), not only with the chunk at the same position in the previous step. Data
+ * that is changed back and forth, or moved around in the file, is only stored once.
+ * \{ */
+
+/** Header of a chunk buffer, the data directly follows it. */
+struct MemFileChunkBuffer {
+  uint64_t hash;
+  size_t size;
+  /**
+   * Memfiles using this buffer, once per chunk and in the order the references were added. The
+   * buffer size is accounted in #MemFile::chunks_unique_size of the last one.
+   */
+  blender::Vector<MemFile *, 2> users;
+  /** Whether this buffer is the one found in #MemFileChunkStore for its hash. */
+  bool is_stored;
+};
+
+struct MemFileChunkStore {
+  std::mutex mutex;
+  blender::Map<uint64_t, MemFileChunkBuffer *> buffers;
+};
+
+static MemFileChunkStore &chunk_store_get()
+{
+  static MemFileChunkStore store;
+  return store;
+}
+
+static MemFileChunkBuffer *chunk_buffer_from_data(const char *data)
+{
+  return reinterpret_cast<MemFileChunkBuffer *>(const_cast<char *>(data)) - 1;
+}
+
+static const char *chunk_buffer_data(const MemFileChunkBuffer *buffer)
+{
+  return reinterpret_cast<const char *>(buffer + 1);
+}
+
+/** Move the size of the buffer to the memfile that is now its last user. Store mutex is locked. */
+static void chunk_buffer_owner_update(MemFileChunkBuffer *buffer, MemFile *prev_owner)
+{
+  MemFile *owner = buffer->users.is_empty() ? nullptr : buffer->users.last();
+  if (owner == prev_owner) {
+    return;
+  }
+  if (prev_owner) {
+    prev_owner->chunks_unique_size -= buffer->size;
+  }
+  if (owner) {
+    owner->chunks_unique_size += buffer->size;
+  }
+}
+
+/** Add a user to a chunk buffer. Store mutex is locked. */
+static void chunk_buffer_add_user_locked(MemFileChunkBuffer *buffer, MemFile *memfile)
+{
+  MemFile *prev_owner = buffer->users.is_empty() ? nullptr : buffer->users.last();
+  buffer->users.append(memfile);
+  chunk_buffer_owner_update(buffer, prev_owner);
+}
+
+/** Add a user to an existing chunk buffer, from another chunk sharing it. */
+static void chunk_buffer_add_user(const char *data, MemFile *memfile)
+{
+  MemFileChunkStore &store = chunk_store_get();
+  std::lock_guard lock(store.mutex);
+  chunk_buffer_add_user_locked(chunk_buffer_from_data(data), memfile);
+}
+
+static void chunk_buffer_remove_user(const char *data, MemFile *memfile)
+{
+  MemFileChunkStore &store = chunk_store_get();
+  MemFileChunkBuffer *buffer = chunk_buffer_from_data(data);
+  {
+    std::lock_guard lock(store.mutex);
+    MemFile *prev_owner = buffer->users.last();
+    /* Memfiles are usually freed oldest first, search from the start. */
+    const int64_t index = buffer->users.first_index_of(memfile);
+    buffer->users.remove(index);
+    chunk_buffer_owner_update(buffer, prev_owner);
+    if (!buffer->users.is_empty()) {
+      return;
+    }
+    if (buffer->is_stored) {
+      store.buffers.remove(buffer->hash);
+    }
+  }
+  buffer->~MemFileChunkBuffer();
+  MEM_freeN(buffer);
+}
+
+/**
+ * Get a buffer with the given content, sharing an existing one if possible.
+ *
+ * \param r_is_new: Set when a new buffer was allocated.
+ */
+static const char *chunk_buffer_ensure(const char *buf,
+                                       const size_t size,
+                                       MemFile *memfile,
+                                       bool *r_is_new)
+{
+  MemFileChunkStore &store = chunk_store_get();
+  const uint64_t hash = XXH3_64bits(buf, size);
+  {
+    std::lock_guard lock(store.mutex);
+    if (MemFileChunkBuffer *buffer = store.buffers.lookup_default(hash, nullptr)) {
+      if (buffer->size == size && memcmp(chunk_buffer_data(buffer), buf, size) == 0) {
+        chunk_buffer_add_user_locked(buffer, memfile);
+        *r_is_new = false;
+        return chunk_buffer_data(buffer);
+      }
+    }
+  }
+
+  MemFileChunkBuffer *buffer = new (MEM_mallocN(sizeof(MemFileChunkBuffer) + size, "Chunk buffer"))
+      MemFileChunkBuffer();
+  buffer->hash = hash;
+  buffer->size = size;
+  memcpy(reinterpret_cast<char *>(buffer + 1), buf, size);
+
+  std::lock_guard lock(store.mutex);
+  chunk_buffer_add_user_locked(buffer, memfile);
+  /* On hash collision keep the existing buffer in the store, this one is simply not shared. */
+  buffer->is_stored = store.buffers.add(hash, buffer);
+  *r_is_new = true;
+  return chunk_buffer_data(buffer);
+}
+
+void BLO_memfile_chunk_store_free()
+{
+  MemFileChunkStore &store = chunk_store_get();
+  std::lock_guard lock(store.mutex);
+  /* Buffers are owned by the memfiles using them, all undo steps are expected to be freed. */
+  BLI_assert(store.buffers.is_empty());
+  store.buffers.clear_and_shrink();
+}
+
+/** \} */
+
 /* **************** support for memory-write, for undo buffers *************** */
 
 void BLO_memfile_free(MemFile *memfile)
 {
   while (MemFileChunk *chunk = static_cast<MemFileChunk *>(BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
-      MEM_freeN((void *)chunk->buf);
-    }
+    chunk_buffer_remove_user(chunk->buf, memfile);
     MEM_freeN(chunk);
   }
   MEM_delete(memfile->shared_storage);
   memfile->shared_storage = nullptr;
   memfile->size = 0;
+  memfile->shared_size = 0;
+  BLI_assert(memfile->chunks_unique_size == 0);
+}
+
+size_t BLO_memfile_size_unique(const MemFile *memfile)
+{
+  MemFileChunkStore &store = chunk_store_get();
+  std::lock_guard lock(store.mutex);
+  return memfile->shared_size + memfile->chunks_unique_size;
 }
 
 MemFileSharedStorage::~MemFileSharedStorage()
@@ -59,34 +214,9 @@ MemFileSharedStorage::~MemFileSharedStorage()
   }
 }
 
-void BLO_memfile_merge(MemFile *first, MemFile *second)
+void BLO_memfile_merge(MemFile *first, MemFile * /*second*/)
 {
-  /* We use this mapping to store the memory buffers from second memfile chunks which are not owned
-   * by it (i.e. shared with some previous memory steps). */
-  blender::Map<const char *, MemFileChunk *> buffer_to_second_memchunk;
-
-  /* First, detect all memchunks in second memfile that are not owned by it. */
-  LISTBASE_FOREACH (MemFileChunk *, sc, &second->chunks) {
-    if (sc->is_identical) {
-      buffer_to_second_memchunk.add(sc->buf, sc);
-    }
-  }
-
-  /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
-   * it is also used by the second memfile, transfer the ownership. */
-  LISTBASE_FOREACH (MemFileChunk *, fc, &first->chunks) {
-    if (!fc->is_identical) {
-      if (MemFileChunk *sc = buffer_to_second_memchunk.lookup_default(fc->buf, nullptr)) {
-        BLI_assert(sc->is_identical);
-        sc->is_identical = false;
-        fc->is_identical = true;
-      }
-      /* Note that if the second memfile does not use that chunk, we assume that the first one
-       * fully owns it without sharing it with any other memfile, and hence it should be freed with
-       * it. */
-    }
-  }
-
+  /* Chunk buffers are reference counted, the ones still used by other memfiles are kept. */
   BLO_memfile_free(first);
 }
 
@@ -153,17 +283,20 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
         curchunk->buf = compchunk->buf;
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
+        chunk_buffer_add_user(curchunk->buf, memfile);
       }
     }
     *compchunk_step = static_cast<MemFileChunk *>(compchunk->next);
   }
 
-  /* not equal... */
+  /* Not equal to the previous step, but the content may still be stored already. Such chunks are
+   * not considered identical, as that is used to detect changes compared to the previous step. */
   if (curchunk->buf == nullptr) {
-    char *buf_new = static_cast<char *>(MEM_mallocN(size, "Chunk buffer"));
-    memcpy(buf_new, buf, size);
-    curchunk->buf = buf_new;
-    memfile->size += size;
+    bool is_new;
+    curchunk->buf = chunk_buffer_ensure(buf, size, memfile, &is_new);
+    if (is_new) {
+      memfile->size += size;
+    }
   }
 }
 
@@ -53,6 +53,7 @@
  * - write #BLO_CODE_GLOB (#RenderInfo struct. 128x128 blend file preview is optional).
  * - write #BLO_CODE_GLOB (#FileGlobal struct) (some global vars).
  * - write #BLO_CODE_DNA1 (#SDNA struct)
+ * - write #BLO_CODE_INDX (index of all blocks except #BLO_CODE_DATA, see #BHeadIndexHeader).
  * - write #BLO_CODE_USER (#UserDef struct) for file paths:
  *   - #BLENDER_STARTUP_FILE (on UNIX `~/.config/blender/X.X/config/startup.blend`).
  *   - #BLENDER_USERPREF_FILE (on UNIX `~/.config/blender/X.X/config/userpref.blend`).
@@ -98,6 +99,7 @@
 #include "BLI_mempool.h"
 #include "BLI_set.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "MEM_guardedalloc.h" /* MEM_freeN */
 
@@ -167,9 +169,21 @@ class WriteWrap {
   virtual bool open(const char *filepath) = 0;
   virtual bool close() = 0;
   virtual bool write(const void *buf, size_t buf_len) = 0;
+  /**
+   * Write data owned by \a sharing_info, only called when #use_write_shared is set.
+   * The data is immutable as long as a user of \a sharing_info is kept.
+   */
+  virtual bool write_shared(const void *buf,
+                            size_t buf_len,
+                            const blender::ImplicitSharingInfo & /*sharing_info*/)
+  {
+    return this->write(buf, buf_len);
+  }
 
   /** Buffer output (we only want when output isn't already buffered). */
   bool use_buf = true;
+  /** Pass implicitly shared data to #write_shared instead of copying it into the buffer. */
+  bool use_write_shared = false;
 };
 
 class RawWriteWrap : public WriteWrap {
@@ -393,6 +407,69 @@ bool ZstdWriteWrap::write(const void *buf, size_t buf_len)
   return true;
 }
 
+/** A piece of #BlendFileSnapshot data. */
+struct BlendFileSnapshotSegment {
+  const void *data;
+  size_t size;
+  /** Owner of the data when it is implicitly shared, otherwise it is owned by the snapshot. */
+  const blender::ImplicitSharingInfo *sharing_info;
+};
+
+struct BlendFileSnapshot {
+  blender::Vector<BlendFileSnapshotSegment> segments;
+  int write_flags;
+
+  ~BlendFileSnapshot()
+  {
+    for (const BlendFileSnapshotSegment &segment : segments) {
+      if (segment.sharing_info) {
+        segment.sharing_info->remove_user_and_delete_if_last();
+      }
+      else {
+        MEM_freeN(const_cast<void *>(segment.data));
+      }
+    }
+  }
+};
+
+/**
+ * Keeps written data in a #BlendFileSnapshot. Implicitly shared data is not copied, a user is
+ * added to it instead, which makes it immutable until the snapshot is freed.
+ */
+class SnapshotWriteWrap : public WriteWrap {
+  BlendFileSnapshot &snapshot;
+
+ public:
+  SnapshotWriteWrap(BlendFileSnapshot &snapshot) : snapshot(snapshot)
+  {
+    use_write_shared = true;
+  }
+
+  bool open(const char * /*filepath*/) override
+  {
+    return true;
+  }
+  bool close() override
+  {
+    return true;
+  }
+  bool write(const void *buf, size_t buf_len) override
+  {
+    void *data = MEM_mallocN(buf_len, "BlendFileSnapshotSegment");
+    memcpy(data, buf, buf_len);
+    snapshot.segments.append({data, buf_len, nullptr});
+    return true;
+  }
+  bool write_shared(const void *buf,
+                    size_t buf_len,
+                    const blender::ImplicitSharingInfo &sharing_info) override
+  {
+    sharing_info.add_user();
+    snapshot.segments.append({buf, buf_len, &sharing_info});
+    return true;
+  }
+};
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -442,6 +519,24 @@ struct WriteData {
    */
   blender::Set<const void *> per_id_written_shared_addresses;
 
+  /** Implicitly shared data currently written, see #WriteWrap.use_write_shared. */
+  struct {
+    const void *data;
+    const blender::ImplicitSharingInfo *sharing_info;
+  } shared_write;
+
+  /**
+   * Index of all blocks that are not #BLO_CODE_DATA, written as #BLO_CODE_INDX before
+   * #BLO_CODE_ENDB, see #BHeadIndexHeader. Not used for undo.
+   */
+  struct {
+    bool use;
+    /** Position in the uncompressed file, i.e. the number of bytes written so far. */
+    uint64_t file_offset;
+    blender::Vector<BHeadIndexEntry> entries;
+    blender::Vector<char> id_prefixes;
+  } bhead_index;
+
   /** #MemFile writing (used for undo). */
   MemFileWriteData mem;
   /** When true, write to #WriteData.current, could also call 'is_undo'. */
@@ -553,6 +648,16 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
 #ifdef USE_WRITE_DATA_LEN
   wd->write_len += len;
 #endif
+  wd->bhead_index.file_offset += len;
+
+  if (wd->shared_write.sharing_info && adr == wd->shared_write.data) {
+    BLI_assert(wd->ww && wd->ww->use_write_shared);
+    mywrite_flush(wd);
+    if (!wd->ww->write_shared(adr, len, *wd->shared_write.sharing_info)) {
+      wd->validation_data.critical_error = true;
+    }
+    return;
+  }
 
   if (wd->buffer.buf == nullptr) {
     writedata_do_write(wd, adr, len);
@@ -603,6 +708,7 @@ static WriteData *mywrite_begin(WriteWrap *ww, MemFile *compare, MemFile *curren
     BLO_memfile_write_init(&wd->mem, current, compare);
     wd->use_memfile = true;
   }
+  wd->bhead_index.use = !wd->use_memfile;
 
   return wd;
 }
@@ -690,6 +796,34 @@ static void mywrite_id_end(WriteData *wd, ID * /*id*/)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BHead Index
+ * \{ */
+
+/**
+ * Add a block that is about to be written to the index, must be called before writing its #BHead.
+ */
+static void write_bhead_index_add(WriteData *wd, const BHead &bh, const void *data)
+{
+  if (!wd->bhead_index.use || ELEM(bh.code, BLO_CODE_DATA, BLO_CODE_INDX)) {
+    return;
+  }
+
+  BHeadIndexEntry entry;
+  entry.bhead = bh;
+  entry.offset = wd->bhead_index.file_offset + sizeof(BHead);
+  wd->bhead_index.entries.append(entry);
+
+  /* ID codes only use the two least significant bytes. */
+  if (bh.code <= 0xFFFF) {
+    const int64_t prefix_len = std::min<int64_t>(bh.len, BHEAD_ID_PREFIX_LEN);
+    wd->bhead_index.id_prefixes.extend(
+        blender::Span<char>(static_cast<const char *>(data), prefix_len));
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Generic DNA File Writing
  * \{ */
@@ -746,6 +880,7 @@ static void writestruct_at_address_nr(
     return;
   }
 
+  write_bhead_index_add(wd, bh, data);
   mywrite(wd, &bh, sizeof(BHead));
   mywrite(wd, data, size_t(bh.len));
 }
@@ -787,6 +922,7 @@ static void writedata(WriteData *wd, int filecode, size_t len, const void *adr)
   bh.SDNAnr = SDNA_RAW_DATA_STRUCT_INDEX;
   bh.len = int(len);
 
+  write_bhead_index_add(wd, bh, adr);
   mywrite(wd, &bh, sizeof(BHead));
   mywrite(wd, adr, len);
 }
@@ -1288,6 +1424,30 @@ static int write_id_direct_linked_data_process_cb(LibraryIDLinkCallbackData *cb_
   return IDWALK_RET_NOP;
 }
 
+/**
+ * Write the #BLO_CODE_INDX block, it has to be the last one before #BLO_CODE_ENDB and directly
+ * follow the last indexed block.
+ */
+static void write_bhead_index(WriteData *wd)
+{
+  BHeadIndexHeader header;
+  header.entries_num = int(wd->bhead_index.entries.size());
+  header.id_prefix_len = BHEAD_ID_PREFIX_LEN;
+
+  BHeadIndexTrailer trailer;
+  trailer.index_bhead_offset = wd->bhead_index.file_offset;
+  memcpy(trailer.magic, BHEAD_INDEX_MAGIC, sizeof(trailer.magic));
+
+  blender::Vector<char> buffer;
+  buffer.extend(blender::Span<char>(reinterpret_cast<const char *>(&header), sizeof(header)));
+  buffer.extend(wd->bhead_index.entries.as_span().cast<char>());
+  buffer.extend(wd->bhead_index.id_prefixes.as_span());
+  buffer.append_n_times(0, (8 - buffer.size() % 8) % 8);
+  buffer.extend(blender::Span<char>(reinterpret_cast<const char *>(&trailer), sizeof(trailer)));
+
+  writedata(wd, BLO_CODE_INDX, size_t(buffer.size()), buffer.data());
+}
+
 /**
  * When #MemFile arguments are non-null, this is a file-safe to memory.
  *
@@ -1500,6 +1660,10 @@ static bool write_file_handle(Main *mainvar,
    * so writing each time uses the same address and doesn't cause unnecessary undo overhead. */
   writedata(wd, BLO_CODE_DNA1, size_t(wd->sdna->data_size), wd->sdna->data);
 
+  if (wd->bhead_index.use) {
+    write_bhead_index(wd);
+  }
+
   /* End of file. */
   memset(&bhead, 0, sizeof(BHead));
   bhead.code = BLO_CODE_ENDB;
@@ -1787,6 +1951,86 @@ bool BLO_write_file_mem(Main *mainvar, MemFile *compare, MemFile *current, int w
   return (err == 0);
 }
 
+BlendFileSnapshot *BLO_write_snapshot_create(Main *mainvar,
+                                             const int write_flags,
+                                             ReportList *reports)
+{
+  if ((write_flags & G_FILE_ASSET_EDIT_FILE) && !mainvar->is_asset_edit_file) {
+    CLOG_ERROR(&LOG, "Cannot save normal file as asset system file");
+    return nullptr;
+  }
+
+  BlendFileSnapshot *snapshot = MEM_new<BlendFileSnapshot>(__func__);
+  snapshot->write_flags = write_flags;
+
+  /* Same validation as when writing the file directly, see #BLO_write_file_impl. */
+  write_file_main_validate_pre(mainvar, reports);
+
+  SnapshotWriteWrap snapshot_wrap(*snapshot);
+  const bool err = write_file_handle(
+      mainvar, &snapshot_wrap, nullptr, nullptr, write_flags, false, nullptr);
+
+  write_file_main_validate_post(mainvar, reports);
+  if (err) {
+    MEM_delete(snapshot);
+    return nullptr;
+  }
+  return snapshot;
+}
+
+static bool write_snapshot_segments(const BlendFileSnapshot *snapshot, WriteWrap &ww)
+{
+  for (const BlendFileSnapshotSegment &segment : snapshot->segments) {
+    /* Shared data can be arbitrarily large, split it like #mywrite does. */
+    const char *data = static_cast<const char *>(segment.data);
+    size_t remaining_len = segment.size;
+    while (remaining_len > 0) {
+      const size_t len = std::min<size_t>(remaining_len, ZSTD_CHUNK_SIZE);
+      if (!ww.write(data, len)) {
+        return false;
+      }
+      data += len;
+      remaining_len -= len;
+    }
+  }
+  return true;
+}
+
+bool BLO_write_snapshot_to_file(const BlendFileSnapshot *snapshot, const char *filepath)
+{
+  char tempname[FILE_MAX + 1];
+  SNPRINTF(tempname, "%s@", filepath);
+
+  RawWriteWrap raw_wrap;
+  std::optional<ZstdWriteWrap> zstd_wrap;
+  WriteWrap *ww = &raw_wrap;
+  if (snapshot->write_flags & G_FILE_COMPRESS) {
+    ww = &zstd_wrap.emplace(raw_wrap);
+  }
+
+  if (!ww->open(tempname)) {
+    CLOG_ERROR(&LOG, "Cannot open file %s for writing: %s", tempname, strerror(errno));
+    return false;
+  }
+  const bool success = write_snapshot_segments(snapshot, *ww);
+  if (!ww->close() || !success) {
+    CLOG_ERROR(&LOG, "Failed to write %s: %s", tempname, strerror(errno));
+    remove(tempname);
+    return false;
+  }
+
+  if (BLI_rename_overwrite(tempname, filepath) != 0) {
+    CLOG_ERROR(&LOG, "Cannot change old file %s (file saved with @)", filepath);
+    return false;
+  }
+  return true;
+}
+
+void BLO_write_snapshot_free(BlendFileSnapshot *snapshot)
+{
+  MEM_delete(snapshot);
+}
+
 /*
  * API to handle writing IDs while clearing some of their runtime data.
  */
@@ -1974,7 +2218,9 @@ void BLO_write_shared(BlendWriter *writer,
         /* The undo-step takes (shared) ownership of the data, which also makes it immutable. */
         sharing_info->add_user();
         /* This size is an estimate, but good enough to count data with many users less. */
-        memfile.size += approximate_size_in_bytes / sharing_info->strong_users();
+        const size_t shared_size = approximate_size_in_bytes / sharing_info->strong_users();
+        memfile.size += shared_size;
+        memfile.shared_size += shared_size;
         return;
       }
     }
@@ -1984,6 +2230,16 @@ void BLO_write_shared(BlendWriter *writer,
       /* Was written already. */
       return;
     }
+    WriteData *wd = writer->wd;
+    if (wd->ww && wd->ww->use_write_shared) {
+      BLI_assert(wd->shared_write.sharing_info == nullptr);
+      wd->shared_write.data = data;
+      wd->shared_write.sharing_info = sharing_info;
+      write_fn();
+      wd->shared_write.data = nullptr;
+      wd->shared_write.sharing_info = nullptr;
+      return;
+    }
   }
   write_fn();
 }
@@ -871,9 +871,11 @@ static void bm_to_mesh_shape(BMesh *bm,
 
       if (currkey->data && (currkey->totelem == bm->totvert)) {
         /* Use memory in-place. */
+        BKE_keyblock_data_for_write(currkey);
       }
       else {
-        currkey->data = MEM_reallocN(currkey->data, key->elemsize * bm->totvert);
+        /* All values are written below, no need to keep the old ones. */
+        BKE_keyblock_data_replace(currkey, MEM_mallocN(key->elemsize * bm->totvert, __func__));
         currkey->totelem = bm->totvert;
       }
       currkey_data = (float(*)[3])currkey->data;
@@ -948,10 +950,7 @@ static void bm_to_mesh_shape(BMesh *bm,
       }
 
       currkey->totelem = bm->totvert;
-      if (currkey->data) {
-        MEM_freeN(currkey->data);
-      }
-      currkey->data = currkey_data;
+      BKE_keyblock_data_replace(currkey, currkey_data);
     }
   }
 
@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include "BLI_function_ref.hh"
+#include "BLI_span.hh"
+
 #include "DNA_ID.h"
 
 /* Dependency Graph */
@@ -200,6 +203,26 @@ void DEG_evaluate_on_refresh(
     Depsgraph *graph,
     DepsgraphEvaluateSyncWriteback sync_writeback = DEG_EVALUATE_SYNC_WRITEBACK_NO);
 
+/**
+ * Evaluate the scene at all the given frames, multiple frames at a time. Every frame is evaluated
+ * in one of the given independent dependency graphs, which share the original data. This is
+ * meant for exporters and bakers, which need the evaluated state of many frames.
+ *
+ * The graphs have to be built by the caller for the same scene and view layer, on the main
+ * thread, because building may change the original data. More graphs than frames are not used.
+ *
+ * \a frame_fn is called on the calling thread for every frame, in the order of \a frames, with the
+ * graph evaluated at that frame. The following frames are evaluated in the background meanwhile.
+ * When it returns false, no further frames are evaluated, for example when the job is canceled.
+ *
+ * \note The graphs are not active, nothing is written back to the original data and frame change
+ * handlers are not called. The Python GIL is released while the frames are evaluated, so
+ * \a frame_fn must not use Python.
+ */
+void DEG_evaluate_frames(blender::Span<Depsgraph *> graphs,
+                         blender::Span<float> frames,
+                         blender::FunctionRef<bool(Depsgraph *graph, float frame)> frame_fn);
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
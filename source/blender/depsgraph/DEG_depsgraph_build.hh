@@ -72,6 +72,13 @@ void DEG_graph_relations_update(Depsgraph *graph);
 /** Tag all relations in the database for update. */
 void DEG_relations_tag_update(Main *bmain);
 
+/**
+ * Tag relations of the given ID for update, for example when a constraint or a driver was added
+ * to an object. Unlike #DEG_relations_tag_update this allows the dependency graphs to only
+ * re-build nodes and relations of this ID, instead of building them from scratch.
+ */
+void DEG_id_relations_tag_update(Main *bmain, ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /**
@@ -52,6 +52,23 @@ void DEG_debug_stats_gnuplot(const Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Trace */
+
+/**
+ * Start recording the evaluation of all dependency graphs: the start and end time and thread of
+ * every evaluated operation. Any previously recorded trace is discarded.
+ */
+void DEG_debug_trace_begin();
+/**
+ * Stop recording and write the trace to \a filepath, in the Chrome trace event JSON format which
+ * can be opened in `chrome://tracing` or Perfetto.
+ *
+ * \return false if no trace was being recorded or the file could not be written.
+ */
+bool DEG_debug_trace_end(const char *filepath);
+bool DEG_debug_trace_is_active();
+
 /* ************************************************ */
 
 /** Compare two dependency graphs. */
@@ -18,10 +18,12 @@
 #include "DNA_object_types.h"
 
 #include "BLI_stack.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "BKE_action.hh"
 #include "BKE_collection.hh"
+#include "BKE_global.hh"
 #include "BKE_lib_id.hh"
 
 #include "RNA_prototypes.hh"
@@ -181,12 +183,15 @@ void deg_graph_build_finalize(Main *bmain, Depsgraph *graph)
   deg_graph_flush_visibility_flags(graph);
   deg_graph_remove_unused_noops(graph);
 
+  /* Components only access their own operations when finalizing. */
+  deg_foreach_id_node_parallel(
+      graph, [&](const int64_t /*index*/, IDNode *id_node) { id_node->finalize_build(graph); });
+
   /* Re-tag IDs for update if it was tagged before the relations
    * update tag. */
   for (IDNode *id_node : graph->id_nodes) {
     const ID_Type id_type = id_node->id_type;
     ID *id_orig = id_node->id_orig;
-    id_node->finalize_build(graph);
     int flag = 0;
     /* Tag rebuild if special evaluation flags changed. */
     if (id_node->eval_flags != id_node->previous_eval_flags) {
@@ -246,4 +251,27 @@ void deg_graph_build_finalize(Main *bmain, Depsgraph *graph)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Parallel Passes Over ID Nodes.
+ * \{ */
+
+void deg_foreach_id_node_parallel(const Depsgraph *graph,
+                                  const FunctionRef<void(int64_t index, IDNode *id_node)> fn)
+{
+  const Span<IDNode *> id_nodes = graph->id_nodes;
+  if (G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS) {
+    for (const int64_t i : id_nodes.index_range()) {
+      fn(i, id_nodes[i]);
+    }
+    return;
+  }
+  threading::parallel_for(id_nodes.index_range(), 32, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      fn(i, id_nodes[i]);
+    }
+  });
+}
+
+/** \} */
+
 }  // namespace blender::deg
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "BLI_function_ref.hh"
+
 struct Base;
 struct ID;
 struct Main;
@@ -20,6 +22,7 @@ struct bPoseChannel;
 namespace blender::deg {
 
 struct Depsgraph;
+struct IDNode;
 class DepsgraphBuilderCache;
 
 class DepsgraphBuilder {
@@ -57,4 +60,13 @@ bool deg_check_id_in_depsgraph(const Depsgraph *graph, ID *id_orig);
 bool deg_check_base_in_depsgraph(const Depsgraph *graph, Base *base);
 void deg_graph_build_finalize(Main *bmain, Depsgraph *graph);
 
+/* Run the function for every ID node of the graph, in parallel unless the dependency graph is
+ * forced to be single threaded for debugging.
+ *
+ * The function is called with the index of the ID node in #Depsgraph::id_nodes, which can be used
+ * to store per-ID results which are then applied to the graph in a deterministic order. The
+ * function must not modify nodes or relations which are shared with other IDs. */
+void deg_foreach_id_node_parallel(const Depsgraph *graph,
+                                  FunctionRef<void(int64_t index, IDNode *id_node)> fn);
+
 }  // namespace blender::deg
@@ -15,6 +15,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
 #include "BLI_span.hh"
 #include "BLI_string.h"
@@ -110,6 +111,7 @@
 #include "intern/builder/deg_builder_rna.h"
 #include "intern/depsgraph.hh"
 #include "intern/depsgraph_light_linking.hh"
+#include "intern/depsgraph_relation.hh"
 #include "intern/depsgraph_tag.hh"
 #include "intern/depsgraph_type.hh"
 #include "intern/eval/deg_eval_copy_on_write.h"
@@ -375,31 +377,36 @@ ID *DepsgraphNodeBuilder::ensure_cow_id(ID *id_orig)
 
 /* **** Build functions for entity nodes **** */
 
+void DepsgraphNodeBuilder::store_id_info(IDNode *id_node)
+{
+  /* It is possible that the ID does not need to have evaluated version in which case id_cow is
+   * the same as id_orig. Additionally, such ID might have been removed, which makes the check
+   * for whether id_cow is expanded to access freed memory. In order to deal with this we
+   * check whether an evaluated copy is needed based on a scalar value which does not lead to
+   * access of possibly deleted memory. */
+  IDInfo *id_info = (IDInfo *)MEM_mallocN(sizeof(IDInfo), "depsgraph id info");
+  if (deg_eval_copy_is_needed(id_node->id_type) && deg_eval_copy_is_expanded(id_node->id_cow) &&
+      id_node->id_orig != id_node->id_cow)
+  {
+    id_info->id_cow = id_node->id_cow;
+  }
+  else {
+    id_info->id_cow = nullptr;
+  }
+  id_info->previously_visible_components_mask = id_node->visible_components_mask;
+  id_info->previous_eval_flags = id_node->eval_flags;
+  id_info->previous_customdata_masks = id_node->customdata_masks;
+  BLI_assert(!id_info_hash_.contains(id_node->id_orig_session_uid));
+  id_info_hash_.add_new(id_node->id_orig_session_uid, id_info);
+  id_node->id_cow = nullptr;
+}
+
 void DepsgraphNodeBuilder::begin_build()
 {
   /* Store existing evaluated versions of datablock, so we can re-use
    * them for new ID nodes. */
   for (IDNode *id_node : graph_->id_nodes) {
-    /* It is possible that the ID does not need to have evaluated version in which case id_cow is
-     * the same as id_orig. Additionally, such ID might have been removed, which makes the check
-     * for whether id_cow is expanded to access freed memory. In order to deal with this we
-     * check whether an evaluated copy is needed based on a scalar value which does not lead to
-     * access of possibly deleted memory. */
-    IDInfo *id_info = (IDInfo *)MEM_mallocN(sizeof(IDInfo), "depsgraph id info");
-    if (deg_eval_copy_is_needed(id_node->id_type) && deg_eval_copy_is_expanded(id_node->id_cow) &&
-        id_node->id_orig != id_node->id_cow)
-    {
-      id_info->id_cow = id_node->id_cow;
-    }
-    else {
-      id_info->id_cow = nullptr;
-    }
-    id_info->previously_visible_components_mask = id_node->visible_components_mask;
-    id_info->previous_eval_flags = id_node->eval_flags;
-    id_info->previous_customdata_masks = id_node->customdata_masks;
-    BLI_assert(!id_info_hash_.contains(id_node->id_orig_session_uid));
-    id_info_hash_.add_new(id_node->id_orig_session_uid, id_info);
-    id_node->id_cow = nullptr;
+    store_id_info(id_node);
   }
 
   for (const OperationNode *op_node : graph_->entry_tags) {
@@ -428,41 +435,32 @@ void DepsgraphNodeBuilder::begin_build()
  * NOTE: This is split in two, a static function and a public method of the node builder, to allow
  * the code to access the builder's data more easily. */
 
-int DepsgraphNodeBuilder::foreach_id_cow_detect_need_for_update_callback(ID *id_cow_self,
-                                                                         ID *id_pointer)
+bool DepsgraphNodeBuilder::is_cow_pointer_invalid(ID *id_pointer)
 {
   if (id_pointer->orig_id == nullptr) {
-    /* `id_cow_self` uses a non-cow ID, if that ID has an evaluated copy in current depsgraph its
+    /* The user uses a non-cow ID, if that ID has an evaluated copy in current depsgraph its
      * owner needs to be remapped, i.e. copy-on-eval-flushed. */
     IDNode *id_node = find_id_node(id_pointer);
-    if (id_node != nullptr && id_node->id_cow != nullptr) {
-      graph_id_tag_update(bmain_,
-                          graph_,
-                          id_cow_self->orig_id,
-                          ID_RECALC_SYNC_TO_EVAL,
-                          DEG_UPDATE_SOURCE_RELATIONS);
-      return IDWALK_RET_STOP_ITER;
-    }
-  }
-  else {
-    /* `id_cow_self` uses an evaluated ID, if that evaluated copy is removed from current depsgraph
-     * its owner needs to be remapped, i.e. copy-on-eval-flushed. */
-    /* NOTE: at that stage, old existing evaluated copies that are to be removed from current state
-     * of evaluated depsgraph are still valid pointers, they are freed later (typically during
-     * destruction of the builder itself). */
-    IDNode *id_node = find_id_node(id_pointer->orig_id);
-    if (id_node == nullptr) {
-      graph_id_tag_update(bmain_,
-                          graph_,
-                          id_cow_self->orig_id,
-                          ID_RECALC_SYNC_TO_EVAL,
-                          DEG_UPDATE_SOURCE_RELATIONS);
-      return IDWALK_RET_STOP_ITER;
-    }
+    return id_node != nullptr && id_node->id_cow != nullptr;
   }
-  return IDWALK_RET_NOP;
+  /* The user uses an evaluated ID, if that evaluated copy is removed from current depsgraph
+   * its owner needs to be remapped, i.e. copy-on-eval-flushed. */
+  /* NOTE: at that stage, old existing evaluated copies that are to be removed from current state
+   * of evaluated depsgraph are still valid pointers, they are freed later (typically during
+   * destruction of the builder itself). */
+  IDNode *id_node = find_id_node(id_pointer->orig_id);
+  return id_node == nullptr;
 }
 
+namespace {
+
+struct CowPointersCheckData {
+  DepsgraphNodeBuilder *builder;
+  bool has_invalid_pointer;
+};
+
+}  // namespace
+
 static int foreach_id_cow_detect_need_for_update_callback(LibraryIDLinkCallbackData *cb_data)
 {
   ID *id = *cb_data->id_pointer;
@@ -475,10 +473,12 @@ static int foreach_id_cow_detect_need_for_update_callback(LibraryIDLinkCallbackD
     return IDWALK_RET_NOP;
   }
 
-  DepsgraphNodeBuilder *builder = static_cast<DepsgraphNodeBuilder *>(cb_data->user_data);
-  ID *id_cow_self = cb_data->self_id;
-
-  return builder->foreach_id_cow_detect_need_for_update_callback(id_cow_self, id);
+  CowPointersCheckData *data = static_cast<CowPointersCheckData *>(cb_data->user_data);
+  if (data->builder->is_cow_pointer_invalid(id)) {
+    data->has_invalid_pointer = true;
+    return IDWALK_RET_STOP_ITER;
+  }
+  return IDWALK_RET_NOP;
 }
 
 void DepsgraphNodeBuilder::update_invalid_cow_pointers()
@@ -491,20 +491,24 @@ void DepsgraphNodeBuilder::update_invalid_cow_pointers()
    *
    * NOTE: This mechanism may also 'fix' some missing update tagging from non-depsgraph code in
    * some cases. This is slightly unfortunate (as it may hide issues in other parts of Blender
-   * code), but cannot really be avoided currently. */
+   * code), but cannot really be avoided currently.
+   *
+   * The pointers of every ID are checked in parallel, the IDs are then tagged in the order of
+   * the ID nodes. */
 
-  for (const IDNode *id_node : graph_->id_nodes) {
+  Array<bool> needs_update(graph_->id_nodes.size(), false);
+  deg_foreach_id_node_parallel(graph_, [&](const int64_t index, IDNode *id_node) {
     if (id_node->previously_visible_components_mask == 0) {
       /* Newly added node/ID, no need to check it. */
-      continue;
+      return;
     }
     if (ELEM(id_node->id_cow, id_node->id_orig, nullptr)) {
       /* Node/ID with no copy-on-eval data, no need to check it. */
-      continue;
+      return;
     }
     if ((id_node->id_cow->recalc & ID_RECALC_SYNC_TO_EVAL) != 0) {
       /* Node/ID already tagged for copy-on-eval flush, no need to check it. */
-      continue;
+      return;
     }
     if ((id_node->id_cow->flag & ID_FLAG_EMBEDDED_DATA) != 0) {
       /* For now, we assume embedded data are managed by their owner IDs and do not need to be
@@ -521,13 +525,25 @@ void DepsgraphNodeBuilder::update_invalid_cow_pointers()
        * completely new different pointer, and the existing copy-on-eval of the old master
        * collection in the matching deg node is therefore pointing to fully invalid (freed) memory.
        */
-      continue;
+      return;
     }
+    CowPointersCheckData data = {this, false};
     BKE_library_foreach_ID_link(nullptr,
                                 id_node->id_cow,
                                 deg::foreach_id_cow_detect_need_for_update_callback,
-                                this,
+                                &data,
                                 IDWALK_IGNORE_EMBEDDED_ID | IDWALK_READONLY);
+    needs_update[index] = data.has_invalid_pointer;
+  });
+
+  for (const int64_t i : graph_->id_nodes.index_range()) {
+    if (needs_update[i]) {
+      graph_id_tag_update(bmain_,
+                          graph_,
+                          graph_->id_nodes[i]->id_orig,
+                          ID_RECALC_SYNC_TO_EVAL,
+                          DEG_UPDATE_SOURCE_RELATIONS);
+    }
   }
 }
 
@@ -562,6 +578,139 @@ void DepsgraphNodeBuilder::end_build()
   update_invalid_cow_pointers();
 }
 
+void DepsgraphNodeBuilder::begin_build_incremental(const Set<IDNode *> &id_nodes_to_rebuild)
+{
+  for (IDNode *id_node : graph_->id_nodes) {
+    if (id_nodes_to_rebuild.contains(id_node)) {
+      continue;
+    }
+    /* The node is kept, only detect changes which are caused by the nodes which are re-built. */
+    id_node->previously_visible_components_mask = id_node->visible_components_mask;
+    id_node->previous_eval_flags = id_node->eval_flags;
+    id_node->previous_customdata_masks = id_node->customdata_masks;
+    built_map_.tagBuild(id_node->id_orig);
+    kept_id_nodes_.add_new(id_node);
+  }
+
+  for (IDNode *id_node : id_nodes_to_rebuild) {
+    RebuiltIDState state;
+    state.linked_state = id_node->linked_state;
+    state.is_visible_on_build = id_node->is_visible_on_build;
+    state.has_base = id_node->has_base;
+    state.eval_flags = id_node->eval_flags;
+    state.customdata_masks = id_node->customdata_masks;
+    rebuilt_id_states_.add_new(id_node->id_orig_session_uid, state);
+
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        if (graph_->entry_tags.contains(op_node)) {
+          saved_entry_tags_.append_as(op_node);
+        }
+        if (op_node->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
+          needs_update_operations_.append_as(op_node);
+        }
+        for (const Relation *rel : op_node->inlinks) {
+          if (rel->from->type == NodeType::OPERATION) {
+            IDNode *from_id_node = static_cast<OperationNode *>(rel->from)->owner->owner;
+            if (kept_id_nodes_.contains(from_id_node)) {
+              unused_id_node_candidates_.add(from_id_node);
+            }
+          }
+        }
+        for (const Relation *rel : op_node->outlinks) {
+          if (rel->to->type == NodeType::OPERATION) {
+            IDNode *to_id_node = static_cast<OperationNode *>(rel->to)->owner->owner;
+            if (kept_id_nodes_.contains(to_id_node)) {
+              unused_id_node_candidates_.add(to_id_node);
+            }
+          }
+        }
+      }
+    }
+
+    store_id_info(id_node);
+  }
+
+  graph_->remove_id_nodes(id_nodes_to_rebuild);
+}
+
+/* Call the function for every ID node of the graph which is used by the given ID. */
+static void foreach_used_id_node(Depsgraph *graph,
+                                 IDNode *id_node,
+                                 FunctionRef<void(IDNode *used_id_node)> fn)
+{
+  BKE_library_foreach_ID_link(
+      nullptr,
+      id_node->id_orig,
+      [&](LibraryIDLinkCallbackData *cb_data) {
+        const ID *id = *cb_data->id_pointer;
+        /* Pointers back to the owner of embedded IDs and shape keys do not make it used. */
+        if (id == nullptr ||
+            (cb_data->cb_flag & (IDWALK_CB_LOOPBACK | IDWALK_CB_EMBEDDED_NOT_OWNING)))
+        {
+          return IDWALK_RET_NOP;
+        }
+        IDNode *used_id_node = graph->find_id_node(id);
+        if (!ELEM(used_id_node, nullptr, id_node)) {
+          fn(used_id_node);
+        }
+        return IDWALK_RET_NOP;
+      },
+      nullptr,
+      IDWALK_READONLY);
+}
+
+void DepsgraphNodeBuilder::remove_unused_id_nodes()
+{
+  if (unused_id_node_candidates_.is_empty()) {
+    return;
+  }
+
+  /* Number of references to ID nodes from the other IDs of the graph. A build from scratch only
+   * adds IDs which are referenced by the IDs it has built, starting from the scene. */
+  Map<IDNode *, int> users_num;
+  for (IDNode *id_node : graph_->id_nodes) {
+    foreach_used_id_node(graph_, id_node, [&](IDNode *used_id_node) {
+      users_num.lookup_or_add(used_id_node, 0)++;
+    });
+  }
+
+  /* Removing an ID can make the IDs it uses unused as well. IDs which only use each other are
+   * kept until the next build from scratch. */
+  Set<IDNode *> id_nodes_to_remove;
+  Vector<IDNode *> stack(unused_id_node_candidates_.begin(), unused_id_node_candidates_.end());
+  while (!stack.is_empty()) {
+    IDNode *id_node = stack.pop_last();
+    if (id_node->has_base || id_node->linked_state != DEG_ID_LINKED_INDIRECTLY ||
+        id_node->id_orig == &graph_->scene->id || !kept_id_nodes_.contains(id_node) ||
+        id_nodes_to_remove.contains(id_node) || users_num.lookup_default(id_node, 0) > 0)
+    {
+      continue;
+    }
+    id_nodes_to_remove.add_new(id_node);
+    foreach_used_id_node(graph_, id_node, [&](IDNode *used_id_node) {
+      if (--users_num.lookup(used_id_node) == 0) {
+        stack.append(used_id_node);
+      }
+    });
+  }
+
+  for (IDNode *id_node : id_nodes_to_remove) {
+    /* The evaluated copy is freed along with the builder, after the pointers of its users have
+     * been checked by #update_invalid_cow_pointers. */
+    store_id_info(id_node);
+    kept_id_nodes_.remove(id_node);
+  }
+  graph_->remove_id_nodes(id_nodes_to_remove);
+}
+
+void DepsgraphNodeBuilder::end_build_incremental()
+{
+  remove_unused_id_nodes();
+  tag_previously_tagged_nodes();
+  update_invalid_cow_pointers();
+}
+
 void DepsgraphNodeBuilder::build_id(ID *id, const bool force_be_visible)
 {
   if (id == nullptr) {
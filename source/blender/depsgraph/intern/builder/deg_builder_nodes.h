@@ -90,10 +90,29 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void end_build();
 
   /**
-   * `id_cow_self` is the user of `id_pointer`,
-   * see also `LibraryIDLinkCallbackData` struct definition.
+   * Begin build of nodes of the given IDs in an existing graph.
+   *
+   * The nodes of these IDs are removed from the graph, with their evaluated copies kept for the
+   * nodes which are created when the IDs are built again. All other IDs of the graph are
+   * considered built, and are kept as-is.
+   */
+  virtual void begin_build_incremental(const Set<IDNode *> &id_nodes_to_rebuild);
+  /**
+   * Finish build of the nodes of the IDs passed to #begin_build_incremental.
+   *
+   * IDs which were used by the re-built IDs and are not used by any ID of the graph anymore are
+   * removed, the same as they would not be added by a build from scratch. New ID nodes are not
+   * removed, and stay at the end of the graph's ID nodes.
    */
-  int foreach_id_cow_detect_need_for_update_callback(ID *id_cow_self, ID *id_pointer);
+  virtual void end_build_incremental();
+
+  /**
+   * Check whether `id_pointer` used by an evaluated ID is not valid for the current state of the
+   * graph anymore, which means the user needs to be remapped.
+   *
+   * Only reads the graph, so it can be used for different users in parallel.
+   */
+  bool is_cow_pointer_invalid(ID *id_pointer);
 
   IDNode *add_id_node(ID *id);
   IDNode *find_id_node(const ID *id);
@@ -171,6 +190,13 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void build_scene_compositor(Scene *scene);
 
   virtual void build_layer_collections(ListBase *lb);
+  /**
+   * Build object which was removed from the graph by #begin_build_incremental, in the same way
+   * as it was built by #build_view_layer.
+   */
+  virtual void build_view_layer_object_incremental(Scene *scene,
+                                                   ViewLayer *view_layer,
+                                                   Object *object);
   virtual void build_view_layer(Scene *scene,
                                 ViewLayer *view_layer,
                                 eDepsNode_LinkedState_Type linked_state);
@@ -295,6 +321,16 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
     DEGCustomDataMeshMasks previous_customdata_masks;
   };
 
+  /* State of an ID node which is re-built by incremental build. It is accumulated by builders of
+   * the other IDs, which do not run again, so it is carried over to the new node. */
+  struct RebuiltIDState {
+    eDepsNode_LinkedState_Type linked_state;
+    bool is_visible_on_build;
+    bool has_base;
+    uint32_t eval_flags;
+    DEGCustomDataMeshMasks customdata_masks;
+  };
+
  protected:
   /* Entry tags and non-updated operations from the previous state of the dependency graph.
    * The entry tags are operations which were directly tagged, the matching operations from the
@@ -317,7 +353,9 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
                               bool is_reference,
                               void *user_data);
 
+  void store_id_info(IDNode *id_node);
   void tag_previously_tagged_nodes();
+  void remove_unused_id_nodes();
   /**
    * Check for IDs that need to be flushed (copy-on-eval-updated)
    * because the depsgraph itself created or removed some of their evaluated dependencies.
@@ -338,6 +376,13 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   /* Indexed by original ID.session_uid, values are IDInfo. */
   Map<uint, IDInfo *> id_info_hash_;
 
+  /* Indexed by original ID.session_uid, only used by incremental build. */
+  Map<uint, RebuiltIDState> rebuilt_id_states_;
+  /* ID nodes which are kept by incremental build. */
+  Set<IDNode *> kept_id_nodes_;
+  /* Kept ID nodes which were connected to the re-built IDs, and might not be used anymore. */
+  Set<IDNode *> unused_id_node_candidates_;
+
   /* Set of IDs which were already build. Makes it easier to keep track of
    * what was already built and what was not. */
   BuilderMap built_map_;
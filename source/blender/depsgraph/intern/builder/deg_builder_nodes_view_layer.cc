@@ -69,6 +69,52 @@ void DepsgraphNodeBuilder::build_freestyle_lineset(FreestyleLineSet *fls)
   }
 }
 
+void DepsgraphNodeBuilder::build_view_layer_object_incremental(Scene *scene,
+                                                               ViewLayer *view_layer,
+                                                               Object *object)
+{
+  /* Same context as set up by build_view_layer(). */
+  view_layer_index_ = 0;
+  scene_ = scene;
+  view_layer_ = view_layer;
+
+  const RebuiltIDState &state = rebuilt_id_states_.lookup(object->id.session_uid);
+
+  /* Find the same base index as build_view_layer() did. */
+  int base_index = -1;
+  if (state.has_base) {
+    int index = 0;
+    BKE_view_layer_synced_ensure(scene, view_layer);
+    LISTBASE_FOREACH (Base *, base, BKE_view_layer_object_bases_get(view_layer)) {
+      if (!need_pull_base_into_graph(base)) {
+        continue;
+      }
+      if (base->object == object) {
+        base_index = index;
+        break;
+      }
+      index++;
+    }
+  }
+
+  if (base_index != -1) {
+    build_object(base_index, object, DEG_ID_LINKED_DIRECTLY, true);
+    if (!graph_->has_animated_visibility) {
+      graph_->has_animated_visibility |= is_object_visibility_animated(object);
+    }
+  }
+  else {
+    build_object(-1, object, state.linked_state, state.is_visible_on_build);
+  }
+
+  IDNode *id_node = find_id_node(&object->id);
+  id_node->linked_state = max(id_node->linked_state, state.linked_state);
+  id_node->is_visible_on_build |= state.is_visible_on_build;
+  id_node->has_base |= state.has_base;
+  id_node->eval_flags |= state.eval_flags;
+  id_node->customdata_masks |= state.customdata_masks;
+}
+
 void DepsgraphNodeBuilder::build_view_layer(Scene *scene,
                                             ViewLayer *view_layer,
                                             eDepsNode_LinkedState_Type linked_state)
@@ -18,6 +18,7 @@
 #include "DNA_modifier_types.h"
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
 #include "BLI_span.hh"
 #include "BLI_utildefines.h"
@@ -72,6 +73,7 @@
 #include "BKE_image.hh"
 #include "BKE_key.hh"
 #include "BKE_layer.hh"
+#include "BKE_lib_id.hh"
 #include "BKE_lib_query.hh"
 #include "BKE_material.h"
 #include "BKE_mball.hh"
@@ -375,7 +377,8 @@ Relation *DepsgraphRelationBuilder::add_time_relation(TimeSourceNode *timesrc,
                                                       int flags)
 {
   if (timesrc && node_to) {
-    return graph_->add_new_relation(timesrc, node_to, description, flags);
+    return graph_->add_new_relation(
+        timesrc, node_to, description, flags, current_owner_session_uid());
   }
 
   DEG_DEBUG_PRINTF((::Depsgraph *)graph_,
@@ -403,7 +406,8 @@ Relation *DepsgraphRelationBuilder::add_operation_relation(OperationNode *node_f
                                                            int flags)
 {
   if (node_from && node_to) {
-    return graph_->add_new_relation(node_from, node_to, description, flags);
+    return graph_->add_new_relation(
+        node_from, node_to, description, flags, current_owner_session_uid());
   }
 
   DEG_DEBUG_PRINTF((::Depsgraph *)graph_,
@@ -517,6 +521,21 @@ Depsgraph *DepsgraphRelationBuilder::getGraph()
 
 void DepsgraphRelationBuilder::begin_build() {}
 
+void DepsgraphRelationBuilder::begin_build_incremental(Span<IDNode *> built_id_nodes)
+{
+  scene_ = graph_->scene;
+  for (IDNode *id_node : built_id_nodes) {
+    built_map_.tagBuild(id_node->id_orig);
+    built_id_nodes_.add_new(id_node);
+  }
+}
+
+uint DepsgraphRelationBuilder::current_owner_session_uid() const
+{
+  const ID *id = stack_.innermost_id();
+  return (id != nullptr) ? id->session_uid : MAIN_ID_SESSION_UID_UNSET;
+}
+
 void DepsgraphRelationBuilder::build_id(ID *id)
 {
   if (id == nullptr) {
@@ -1656,8 +1675,11 @@ void DepsgraphRelationBuilder::build_animdata_fcurve_target(
     add_relation(adt_key, pose_init_key, "Animation -> Prop", RELATION_CHECK_BEFORE_ADD);
     return;
   }
-  graph_->add_new_relation(
-      operation_from, operation_to, "Animation -> Prop", RELATION_CHECK_BEFORE_ADD);
+  graph_->add_new_relation(operation_from,
+                           operation_to,
+                           "Animation -> Prop",
+                           RELATION_CHECK_BEFORE_ADD,
+                           current_owner_session_uid());
   /* It is possible that animation is writing to a nested ID data-block,
    * need to make sure animation is evaluated after target ID is copied. */
   const IDNode *id_node_from = operation_from->owner->owner;
@@ -3470,8 +3492,27 @@ void DepsgraphRelationBuilder::build_vfont(VFont *vfont)
 
 void DepsgraphRelationBuilder::build_copy_on_write_relations()
 {
-  for (IDNode *id_node : graph_->id_nodes) {
-    build_copy_on_write_relations(id_node);
+  /* Relations of an ID only depend on its own nodes and on relations which are not created by
+   * this pass, so they are collected in parallel. Adding them in the order of the ID nodes gives
+   * the same graph as building them on a single thread. */
+  Array<Vector<PendingRelation>> relations(graph_->id_nodes.size());
+  deg_foreach_id_node_parallel(graph_, [&](const int64_t index, IDNode *id_node) {
+    collect_copy_on_write_relations(id_node, relations[index]);
+  });
+  for (const int64_t i : graph_->id_nodes.index_range()) {
+    add_pending_relations(graph_->id_nodes[i], relations[i]);
+  }
+}
+
+void DepsgraphRelationBuilder::add_pending_relations(IDNode *id_node,
+                                                     const Span<PendingRelation> relations)
+{
+  if (relations.is_empty()) {
+    return;
+  }
+  const BuilderStack::ScopedEntry stack_entry = stack_.trace(*id_node->id_orig);
+  for (const PendingRelation &relation : relations) {
+    add_operation_relation(relation.from, relation.to, relation.description, relation.flags);
   }
 }
 
@@ -3512,6 +3553,14 @@ void DepsgraphRelationBuilder::build_nested_shapekey(ID *owner, Key *key)
 }
 
 void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
+{
+  Vector<PendingRelation> relations;
+  collect_copy_on_write_relations(id_node, relations);
+  add_pending_relations(id_node, relations);
+}
+
+void DepsgraphRelationBuilder::collect_copy_on_write_relations(
+    IDNode *id_node, Vector<PendingRelation> &r_relations) const
 {
   ID *id_orig = id_node->id_orig;
 
@@ -3521,13 +3570,16 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
     return;
   }
 
+  /* Components of the IDs which are kept during incremental build already have the relations,
+   * only new operations are to be connected. */
+  const int check_flag = built_id_nodes_.contains(id_node) ? RELATION_CHECK_BEFORE_ADD : 0;
+
   OperationKey copy_on_write_key(id_orig, NodeType::COPY_ON_EVAL, OperationCode::COPY_ON_EVAL);
   /* XXX: This is a quick hack to make Alt-A to work. */
   // add_relation(time_source_key, copy_on_write_key, "Fluxgate capacitor hack");
   /* Resat of code is using rather low level trickery, so need to get some
    * explicit pointers. */
-  Node *node_cow = find_node(copy_on_write_key);
-  OperationNode *op_cow = node_cow->get_exit_operation();
+  OperationNode *op_cow = find_node(copy_on_write_key);
   /* Plug any other components to this one. */
   for (ComponentNode *comp_node : id_node->components.values()) {
     if (comp_node->type == NodeType::COPY_ON_EVAL) {
@@ -3575,17 +3627,15 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
      * copy of ID. */
     OperationNode *op_entry = comp_node->get_entry_operation();
     if (op_entry != nullptr) {
-      Relation *rel = graph_->add_new_relation(op_cow, op_entry, "Copy-on-Eval Dependency");
-      rel->flag |= rel_flag;
+      r_relations.append({op_cow, op_entry, "Copy-on-Eval Dependency", check_flag | rel_flag});
     }
     /* All dangling operations should also be executed after copy-on-evaluation. */
-    for (OperationNode *op_node : comp_node->operations_map->values()) {
+    auto add_dangling_operation_relation = [&](OperationNode *op_node) {
       if (op_node == op_entry) {
-        continue;
+        return;
       }
       if (op_node->inlinks.is_empty()) {
-        Relation *rel = graph_->add_new_relation(op_cow, op_node, "Copy-on-Eval Dependency");
-        rel->flag |= rel_flag;
+        r_relations.append({op_cow, op_node, "Copy-on-Eval Dependency", check_flag | rel_flag});
       }
       else {
         bool has_same_comp_dependency = false;
@@ -3600,10 +3650,21 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
           }
         }
         if (!has_same_comp_dependency) {
-          Relation *rel = graph_->add_new_relation(op_cow, op_node, "Copy-on-Eval Dependency");
-          rel->flag |= rel_flag;
+          r_relations.append(
+              {op_cow, op_node, "Copy-on-Eval Dependency", check_flag | rel_flag});
         }
       }
+    };
+    if (comp_node->operations_map != nullptr) {
+      for (OperationNode *op_node : comp_node->operations_map->values()) {
+        add_dangling_operation_relation(op_node);
+      }
+    }
+    else {
+      /* Components of the IDs which are kept during incremental build are finalized already. */
+      for (OperationNode *op_node : comp_node->operations) {
+        add_dangling_operation_relation(op_node);
+      }
     }
     /* NOTE: We currently ignore implicit relations to an external
      * data-blocks for copy-on-evaluation operations. This means, for example,
@@ -3622,8 +3683,10 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
       if (deg_eval_copy_is_needed(object_data_id)) {
         OperationKey data_copy_on_write_key(
             object_data_id, NodeType::COPY_ON_EVAL, OperationCode::COPY_ON_EVAL);
-        add_relation(
-            data_copy_on_write_key, copy_on_write_key, "Eval Order", RELATION_FLAG_GODMODE);
+        r_relations.append({find_node(data_copy_on_write_key),
+                            op_cow,
+                            "Eval Order",
+                            check_flag | RELATION_FLAG_GODMODE});
       }
     }
     else {
@@ -17,7 +17,9 @@
 
 #include "RNA_path.hh"
 
+#include "BLI_set.hh"
 #include "BLI_span.hh"
+#include "BLI_vector.hh"
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 
@@ -86,6 +88,9 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   DepsgraphRelationBuilder(Main *bmain, Depsgraph *graph, DepsgraphBuilderCache *cache);
 
   void begin_build();
+  /* Begin build of relations of IDs which are added to an existing graph. The given ID nodes
+   * are kept from the previous build, and their relations are not built again. */
+  void begin_build_incremental(Span<IDNode *> built_id_nodes);
 
   template<typename KeyFrom, typename KeyTo>
   Relation *add_relation(const KeyFrom &key_from,
@@ -310,6 +315,23 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
                                    const char *description,
                                    int flags = 0);
 
+  /* Session UID of the ID whose relations are being built, stored in the created relations. */
+  uint current_owner_session_uid() const;
+
+  /* Relation which is collected by a pass running over the ID nodes in parallel. The collected
+   * relations are added to the graph afterwards, in the order of the ID nodes. */
+  struct PendingRelation {
+    OperationNode *from;
+    OperationNode *to;
+    const char *description;
+    int flags;
+  };
+
+  /* Only reads the graph, can be used for different ID nodes in parallel. */
+  void collect_copy_on_write_relations(IDNode *id_node,
+                                       Vector<PendingRelation> &r_relations) const;
+  void add_pending_relations(IDNode *id_node, Span<PendingRelation> relations);
+
   template<typename KeyType>
   DepsNodeHandle create_node_handle(const KeyType &key, const char *default_name = "");
 
@@ -346,6 +368,9 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   BuilderMap built_map_;
   RNANodeQuery rna_node_query_;
   BuilderStack stack_;
+
+  /* ID nodes which are kept from the previous build, see #begin_build_incremental. */
+  Set<const IDNode *> built_id_nodes_;
 };
 
 struct DepsNodeHandle {
@@ -117,6 +117,17 @@ class BuilderStack {
 
   void print_backtrace(std::ostream &stream);
 
+  /* Innermost ID which is being built, nullptr if there is no ID on the stack. */
+  const ID *innermost_id() const
+  {
+    for (int64_t i = stack_.size() - 1; i >= 0; i--) {
+      if (stack_[i].id_ != nullptr) {
+        return stack_[i].id_;
+      }
+    }
+    return nullptr;
+  }
+
   template<class... Args> ScopedEntry trace(const Args &...args)
   {
     stack_.append_as(args...);
@@ -15,6 +15,8 @@
 #include "deg_builder_relations.h"
 #include "deg_builder_transitive.h"
 
+#include "intern/eval/deg_eval_critical_path.h"
+
 namespace blender::deg {
 
 AbstractBuilderPipeline::AbstractBuilderPipeline(::Depsgraph *graph)
@@ -83,6 +85,8 @@ void AbstractBuilderPipeline::build_step_finalize()
   deg_graph_->scene_cow = (Scene *)deg_graph_->get_cow_id(&deg_graph_->scene->id);
   /* Flush visibility layer and re-schedule nodes for update. */
   deg_graph_build_finalize(bmain_, deg_graph_);
+  /* Relations used to find the critical path are final now. */
+  deg_graph_critical_path_build(deg_graph_);
   DEG_graph_tag_on_visible_update(reinterpret_cast<::Depsgraph *>(deg_graph_), false);
 #if 0
   if (!DEG_debug_consistency_check(deg_graph_)) {
@@ -92,6 +96,14 @@ void AbstractBuilderPipeline::build_step_finalize()
 #endif
   /* Relations are up to date. */
   deg_graph_->need_update_relations = false;
+  deg_graph_->need_update_all_relations = false;
+  deg_graph_->need_update_relations_ids.clear();
+  deg_graph_->supports_incremental_relations_update = supports_incremental_build();
+}
+
+bool AbstractBuilderPipeline::supports_incremental_build() const
+{
+  return false;
 }
 
 unique_ptr<DepsgraphNodeBuilder> AbstractBuilderPipeline::construct_node_builder()
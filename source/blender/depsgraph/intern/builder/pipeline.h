@@ -48,6 +48,10 @@ class AbstractBuilderPipeline {
   virtual unique_ptr<DepsgraphNodeBuilder> construct_node_builder();
   virtual unique_ptr<DepsgraphRelationBuilder> construct_relation_builder();
 
+  /* Whether relations of individual IDs of the built graph can be updated by the
+   * #IncrementalBuilderPipeline. */
+  virtual bool supports_incremental_build() const;
+
   virtual void build_step_sanity_check();
   void build_step_nodes();
   void build_step_relations();
@@ -47,6 +47,13 @@ AllObjectsBuilderPipeline::AllObjectsBuilderPipeline(::Depsgraph *graph)
 {
 }
 
+bool AllObjectsBuilderPipeline::supports_incremental_build() const
+{
+  /* Objects are pulled into the graph by the builders which are not used for the incremental
+   * build. */
+  return false;
+}
+
 unique_ptr<DepsgraphNodeBuilder> AllObjectsBuilderPipeline::construct_node_builder()
 {
   return std::make_unique<AllObjectsNodeBuilder>(bmain_, deg_graph_, &builder_cache_);
@@ -20,6 +20,7 @@ class AllObjectsBuilderPipeline : public ViewLayerBuilderPipeline {
   AllObjectsBuilderPipeline(::Depsgraph *graph);
 
  protected:
+  virtual bool supports_incremental_build() const override;
   virtual unique_ptr<DepsgraphNodeBuilder> construct_node_builder() override;
   virtual unique_ptr<DepsgraphRelationBuilder> construct_relation_builder() override;
 };
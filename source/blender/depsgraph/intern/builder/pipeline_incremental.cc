@@ -0,0 +1,299 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "pipeline_incremental.h"
+
+#include "BLI_time.h"
+
+#include "BKE_global.hh"
+#include "BKE_layer.hh"
+
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "intern/builder/deg_builder_key.h"
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/debug/deg_debug.h"
+#include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node_component.hh"
+#include "intern/node/deg_node_id.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+IncrementalBuilderPipeline::IncrementalBuilderPipeline(::Depsgraph *graph)
+    : ViewLayerBuilderPipeline(graph)
+{
+}
+
+IncrementalBuilderPipeline::~IncrementalBuilderPipeline() = default;
+
+bool IncrementalBuilderPipeline::build_incremental()
+{
+  if (!collect_objects_to_rebuild()) {
+    return false;
+  }
+
+  double start_time = 0.0;
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    start_time = BLI_time_now_seconds();
+  }
+
+  /* Relations from the builders of other IDs are not created again, remember them before the
+   * nodes they are connected to are removed. */
+  save_relations();
+
+  /* Nodes. New ID nodes are appended to the kept ones. */
+  Vector<IDNode *> new_id_nodes;
+  Set<const ID *> touched_ids;
+  {
+    unique_ptr<DepsgraphNodeBuilder> node_builder = construct_node_builder();
+    node_builder->begin_build_incremental(id_nodes_to_rebuild_);
+    const int64_t kept_id_nodes_num = deg_graph_->id_nodes.size();
+    const int64_t kept_operations_num = deg_graph_->operations.size();
+    build_nodes(*node_builder);
+    new_id_nodes.extend(deg_graph_->id_nodes.as_span().drop_front(kept_id_nodes_num));
+
+    /* New operations might have been added to the components of the kept IDs, for example
+     * properties used by new drivers. They need relations to the copy-on-evaluation. */
+    const Set<const IDNode *> new_id_nodes_set(new_id_nodes.as_span().cast<const IDNode *>());
+    for (const OperationNode *op_node :
+         deg_graph_->operations.as_span().drop_front(kept_operations_num))
+    {
+      const IDNode *id_node = op_node->owner->owner;
+      if (!new_id_nodes_set.contains(id_node)) {
+        touched_ids.add(id_node->id_orig);
+      }
+    }
+
+    /* Removes the kept IDs which are not used anymore. */
+    node_builder->end_build_incremental();
+  }
+  for (const ID *id : touched_ids) {
+    if (IDNode *id_node = deg_graph_->find_id_node(id)) {
+      touched_id_nodes_.add(id_node);
+    }
+  }
+
+  const Span<IDNode *> kept_id_nodes = deg_graph_->id_nodes.as_span().drop_back(
+      new_id_nodes.size());
+
+  /* Relations. */
+  {
+    unique_ptr<DepsgraphRelationBuilder> relation_builder = construct_relation_builder();
+    relation_builder->begin_build_incremental(kept_id_nodes);
+    build_relations(*relation_builder);
+    restore_relations();
+    for (IDNode *id_node : new_id_nodes) {
+      relation_builder->build_copy_on_write_relations(id_node);
+    }
+    for (IDNode *id_node : touched_id_nodes_) {
+      relation_builder->build_copy_on_write_relations(id_node);
+    }
+    for (IDNode *id_node : new_id_nodes) {
+      relation_builder->build_driver_relations(id_node);
+    }
+  }
+
+  /* Cycles are detected again for the whole graph, a cycle might have been solved by the
+   * change. */
+  for (OperationNode *op_node : deg_graph_->operations) {
+    for (Relation *rel : op_node->outlinks) {
+      rel->flag &= ~RELATION_FLAG_CYCLIC;
+    }
+  }
+  build_step_finalize();
+
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    printf("Depsgraph relations of %d object(s) updated in %f seconds.\n",
+           int(objects_to_rebuild_.size()),
+           BLI_time_now_seconds() - start_time);
+  }
+
+  return true;
+}
+
+void IncrementalBuilderPipeline::build_nodes(DepsgraphNodeBuilder &node_builder)
+{
+  for (Object *object : objects_to_rebuild_) {
+    node_builder.build_view_layer_object_incremental(scene_, view_layer_, object);
+  }
+}
+
+void IncrementalBuilderPipeline::build_relations(DepsgraphRelationBuilder &relation_builder)
+{
+  for (Object *object : objects_to_rebuild_) {
+    if (objects_with_base_.contains(object)) {
+      relation_builder.build_object_from_view_layer_base(object);
+    }
+    else {
+      relation_builder.build_object(object);
+    }
+  }
+}
+
+bool IncrementalBuilderPipeline::collect_objects_to_rebuild()
+{
+  if (deg_graph_->need_update_all_relations || !deg_graph_->supports_incremental_relations_update)
+  {
+    return false;
+  }
+  if (deg_graph_->light_linking_cache.has_light_linking()) {
+    /* The cache is built for the whole graph. */
+    return false;
+  }
+  if (G.debug_value == 799) {
+    /* Transitive reduction removed relations which are not restored by the builders. */
+    return false;
+  }
+
+  for (IDNode *id_node : deg_graph_->id_nodes) {
+    if (!deg_graph_->need_update_relations_ids.contains(id_node->id_orig_session_uid)) {
+      continue;
+    }
+    if (!can_rebuild_object(id_node)) {
+      id_nodes_to_rebuild_.clear();
+      objects_to_rebuild_.clear();
+      objects_with_base_.clear();
+      return false;
+    }
+    Object *object = reinterpret_cast<Object *>(id_node->id_orig);
+    id_nodes_to_rebuild_.add_new(id_node);
+    objects_to_rebuild_.append(object);
+    if (id_node->has_base) {
+      objects_with_base_.add(object);
+    }
+  }
+
+  /* IDs which are not in the graph do not affect its relations. Those which become used by the
+   * re-built objects are added to the graph by their builders. */
+  return true;
+}
+
+bool IncrementalBuilderPipeline::can_rebuild_object(const IDNode *id_node) const
+{
+  if (id_node->id_type != ID_OB) {
+    /* Relations of other types of IDs are mostly built as a part of their users. */
+    return false;
+  }
+  if (id_node->linked_state == DEG_ID_LINKED_VIA_SET) {
+    return false;
+  }
+  const Object *object = reinterpret_cast<const Object *>(id_node->id_orig);
+  if (object->light_linking != nullptr) {
+    return false;
+  }
+  if (id_node->has_base) {
+    /* The base is to be found again to get the same index of the base flags evaluation. */
+    BKE_view_layer_synced_ensure(scene_, view_layer_);
+    const Base *base = BKE_view_layer_base_find(view_layer_, const_cast<Object *>(object));
+    if (base == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+IncrementalBuilderPipeline::RelationEndpoint IncrementalBuilderPipeline::save_relation_endpoint(
+    Node *node) const
+{
+  RelationEndpoint endpoint;
+  if (node->type == NodeType::OPERATION) {
+    /* Operations are found by key also when their ID is kept, as it can be removed when it is
+     * not used anymore. */
+    endpoint.key = std::make_unique<PersistentOperationKey>(
+        static_cast<const OperationNode *>(node));
+    return endpoint;
+  }
+  endpoint.node = node;
+  return endpoint;
+}
+
+Node *IncrementalBuilderPipeline::find_relation_endpoint(const RelationEndpoint &endpoint) const
+{
+  if (endpoint.key == nullptr) {
+    return endpoint.node;
+  }
+  const PersistentOperationKey &key = *endpoint.key;
+  const IDNode *id_node = deg_graph_->find_id_node(key.id);
+  if (id_node == nullptr) {
+    return nullptr;
+  }
+  const ComponentNode *comp_node = id_node->find_component(key.component_type,
+                                                           key.component_name);
+  if (comp_node == nullptr) {
+    return nullptr;
+  }
+  return comp_node->find_operation(key.opcode, key.name, key.name_tag);
+}
+
+void IncrementalBuilderPipeline::save_relations()
+{
+  Set<uint> rebuilt_session_uids;
+  for (const IDNode *id_node : id_nodes_to_rebuild_) {
+    rebuilt_session_uids.add(id_node->id_orig_session_uid);
+  }
+
+  Set<const Relation *> visited_relations;
+  auto save_relation = [&](Relation *rel) {
+    if (!visited_relations.add(rel)) {
+      return;
+    }
+    if (rebuilt_session_uids.contains(rel->owner_session_uid)) {
+      /* Is created again by the builder of the re-built object. */
+      return;
+    }
+    SavedRelation saved_relation;
+    saved_relation.from = save_relation_endpoint(rel->from);
+    saved_relation.to = save_relation_endpoint(rel->to);
+    saved_relation.name = rel->name;
+    saved_relation.flag = rel->flag;
+    saved_relation.owner_session_uid = rel->owner_session_uid;
+    saved_relations_.append(std::move(saved_relation));
+  };
+
+  for (IDNode *id_node : id_nodes_to_rebuild_) {
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        for (Relation *rel : op_node->inlinks) {
+          save_relation(rel);
+        }
+        for (Relation *rel : op_node->outlinks) {
+          save_relation(rel);
+        }
+      }
+    }
+  }
+}
+
+void IncrementalBuilderPipeline::restore_relations()
+{
+  for (const SavedRelation &saved_relation : saved_relations_) {
+    Node *from = find_relation_endpoint(saved_relation.from);
+    Node *to = find_relation_endpoint(saved_relation.to);
+    if (from == nullptr || to == nullptr) {
+      /* The operation does not exist anymore, which is the same as the builder of the other ID
+       * would do when building the graph from scratch. */
+      DEG_DEBUG_PRINTF((::Depsgraph *)deg_graph_,
+                       BUILD,
+                       "Relation '%s' is not restored, its operation was removed\n",
+                       saved_relation.name);
+      continue;
+    }
+    deg_graph_->add_new_relation(from,
+                                 to,
+                                 saved_relation.name,
+                                 saved_relation.flag | RELATION_CHECK_BEFORE_ADD,
+                                 saved_relation.owner_session_uid);
+  }
+  saved_relations_.clear();
+}
+
+}  // namespace blender::deg
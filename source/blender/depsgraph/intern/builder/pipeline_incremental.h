@@ -0,0 +1,83 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+#include "pipeline_view_layer.h"
+
+struct Object;
+
+namespace blender::deg {
+
+struct IDNode;
+struct Node;
+struct PersistentOperationKey;
+
+/* Update of relations of a dependency graph built by the #ViewLayerBuilderPipeline, when only
+ * relations of a few objects have changed (tagged by #DEG_id_relations_tag_update).
+ *
+ * Instead of building the graph from scratch, nodes and relations of the tagged objects are
+ * removed from the graph and built again. IDs which are newly referenced by these objects are
+ * added to the graph. Relations between the re-built objects and the rest of the graph which were
+ * created by builders of other IDs are restored.
+ *
+ * IDs which were used by the re-built objects and are not used by any ID of the graph anymore are
+ * removed. */
+class IncrementalBuilderPipeline : public ViewLayerBuilderPipeline {
+ public:
+  IncrementalBuilderPipeline(::Depsgraph *graph);
+  ~IncrementalBuilderPipeline();
+
+  /* Returns false when the graph can not be updated incrementally, in which case it is not
+   * modified and is to be built from scratch. */
+  bool build_incremental();
+
+ protected:
+  virtual void build_nodes(DepsgraphNodeBuilder &node_builder) override;
+  virtual void build_relations(DepsgraphRelationBuilder &relation_builder) override;
+
+ private:
+  /* Endpoint of a relation: either the key of an operation, which is found again after the build,
+   * or another node which is kept in the graph. */
+  struct RelationEndpoint {
+    Node *node = nullptr;
+    std::unique_ptr<PersistentOperationKey> key;
+  };
+
+  /* Relation to or from a re-built ID which was created by builder of another ID. */
+  struct SavedRelation {
+    RelationEndpoint from;
+    RelationEndpoint to;
+    const char *name;
+    int flag;
+    uint owner_session_uid;
+  };
+
+  bool collect_objects_to_rebuild();
+  bool can_rebuild_object(const IDNode *id_node) const;
+
+  RelationEndpoint save_relation_endpoint(Node *node) const;
+  Node *find_relation_endpoint(const RelationEndpoint &endpoint) const;
+  void save_relations();
+  void restore_relations();
+
+  Set<IDNode *> id_nodes_to_rebuild_;
+  Vector<Object *> objects_to_rebuild_;
+  /* Objects which were pulled into the graph via a base of the view layer. */
+  Set<const Object *> objects_with_base_;
+  Vector<SavedRelation> saved_relations_;
+  /* ID nodes which are kept in the graph, but got new operations. */
+  Set<IDNode *> touched_id_nodes_;
+};
+
+}  // namespace blender::deg
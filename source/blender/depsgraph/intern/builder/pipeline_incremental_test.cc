@@ -0,0 +1,173 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "blendfile_loading_base_test.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "BKE_collection.hh"
+#include "BKE_constraint.h"
+#include "BKE_layer.hh"
+#include "BKE_main.hh"
+#include "BKE_object.hh"
+#include "BKE_scene.hh"
+
+#include "DEG_depsgraph_build.hh"
+
+#include "DNA_constraint_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
+
+#include "intern/builder/pipeline_incremental.h"
+#include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node_id.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg::tests {
+
+class DepsgraphIncrementalBuildTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  ViewLayer *view_layer = nullptr;
+  char use_incremental_relations_prev = 0;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    use_incremental_relations_prev = U.experimental.use_incremental_depsgraph_relations;
+    U.experimental.use_incremental_depsgraph_relations = true;
+
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    view_layer = BKE_view_layer_default_view(scene);
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain);
+    U.experimental.use_incremental_depsgraph_relations = use_incremental_relations_prev;
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  Object *add_object(const char *name, const bool in_scene)
+  {
+    Object *object = BKE_object_add_only_object(bmain, OB_EMPTY, name);
+    if (in_scene) {
+      BKE_collection_object_add(bmain, scene->master_collection, object);
+    }
+    BKE_view_layer_synced_ensure(scene, view_layer);
+    return object;
+  }
+
+  ::Depsgraph *build_graph()
+  {
+    ::Depsgraph *graph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_VIEWPORT);
+    DEG_graph_build_from_view_layer(graph);
+    return graph;
+  }
+
+  /* Update relations of the object incrementally, and compare the result with a graph which is
+   * built from scratch. */
+  void update_and_compare(::Depsgraph *graph, Object *object)
+  {
+    DEG_id_relations_tag_update(bmain, &object->id);
+    IncrementalBuilderPipeline builder(graph);
+    ASSERT_TRUE(builder.build_incremental());
+
+    ::Depsgraph *full_graph = build_graph();
+    EXPECT_EQ(id_names(graph), id_names(full_graph));
+    EXPECT_EQ(relation_names(graph), relation_names(full_graph));
+    DEG_graph_free(full_graph);
+  }
+
+  static std::vector<std::string> id_names(const ::Depsgraph *graph)
+  {
+    const Depsgraph *deg_graph = reinterpret_cast<const Depsgraph *>(graph);
+    std::vector<std::string> names;
+    for (const IDNode *id_node : deg_graph->id_nodes) {
+      names.push_back(id_node->name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+  }
+
+  static std::vector<std::string> relation_names(const ::Depsgraph *graph)
+  {
+    const Depsgraph *deg_graph = reinterpret_cast<const Depsgraph *>(graph);
+    std::vector<std::string> names;
+    for (const OperationNode *op_node : deg_graph->operations) {
+      for (const Relation *rel : op_node->inlinks) {
+        const std::string from_name =
+            rel->from->type == NodeType::OPERATION ?
+                static_cast<const OperationNode *>(rel->from)->full_identifier() :
+                rel->from->identifier();
+        names.push_back(from_name + " -> " + op_node->full_identifier() + " (" + rel->name +
+                        ")");
+      }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+  }
+
+  static bool graph_has_id(const ::Depsgraph *graph, const ID *id)
+  {
+    return reinterpret_cast<const Depsgraph *>(graph)->find_id_node(id) != nullptr;
+  }
+};
+
+TEST_F(DepsgraphIncrementalBuildTest, ConstraintTarget)
+{
+  Object *owner = add_object("Owner", true);
+  add_object("Other", true);
+  Object *target = add_object("Target", false);
+
+  ::Depsgraph *graph = build_graph();
+  EXPECT_FALSE(graph_has_id(graph, &target->id));
+
+  /* The target is pulled into the graph by the re-built object. */
+  bConstraint *con = BKE_constraint_add_for_object(owner, "Copy Location", CONSTRAINT_TYPE_LOCLIKE);
+  static_cast<bLocateLikeConstraint *>(con->data)->tar = target;
+  update_and_compare(graph, owner);
+  EXPECT_TRUE(graph_has_id(graph, &target->id));
+
+  /* The target is not used by any object anymore. */
+  BKE_constraint_remove(&owner->constraints, con);
+  update_and_compare(graph, owner);
+  EXPECT_FALSE(graph_has_id(graph, &target->id));
+
+  DEG_graph_free(graph);
+}
+
+TEST_F(DepsgraphIncrementalBuildTest, SharedConstraintTarget)
+{
+  Object *owner = add_object("Owner", true);
+  Object *other = add_object("Other", true);
+  Object *target = add_object("Target", false);
+
+  bConstraint *other_con = BKE_constraint_add_for_object(
+      other, "Copy Location", CONSTRAINT_TYPE_LOCLIKE);
+  static_cast<bLocateLikeConstraint *>(other_con->data)->tar = target;
+  bConstraint *con = BKE_constraint_add_for_object(owner, "Copy Location", CONSTRAINT_TYPE_LOCLIKE);
+  static_cast<bLocateLikeConstraint *>(con->data)->tar = target;
+
+  ::Depsgraph *graph = build_graph();
+
+  /* The target is still used by the other object. */
+  BKE_constraint_remove(&owner->constraints, con);
+  update_and_compare(graph, owner);
+  EXPECT_TRUE(graph_has_id(graph, &target->id));
+
+  DEG_graph_free(graph);
+}
+
+}  // namespace blender::deg::tests
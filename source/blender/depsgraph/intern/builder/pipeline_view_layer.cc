@@ -15,6 +15,11 @@ ViewLayerBuilderPipeline::ViewLayerBuilderPipeline(::Depsgraph *graph)
 {
 }
 
+bool ViewLayerBuilderPipeline::supports_incremental_build() const
+{
+  return true;
+}
+
 void ViewLayerBuilderPipeline::build_nodes(DepsgraphNodeBuilder &node_builder)
 {
   node_builder.build_view_layer(scene_, view_layer_, DEG_ID_LINKED_DIRECTLY);
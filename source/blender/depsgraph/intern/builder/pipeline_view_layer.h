@@ -17,6 +17,7 @@ class ViewLayerBuilderPipeline : public AbstractBuilderPipeline {
   ViewLayerBuilderPipeline(::Depsgraph *graph);
 
  protected:
+  virtual bool supports_incremental_build() const override;
   virtual void build_nodes(DepsgraphNodeBuilder &node_builder) override;
   virtual void build_relations(DepsgraphRelationBuilder &relation_builder) override;
 };
@@ -0,0 +1,211 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_fileops.hh"
+#include "BLI_serialize.hh"
+#include "BLI_threads.h"
+#include "BLI_time.h"
+#include "BLI_vector.hh"
+
+#include "DEG_depsgraph_debug.hh"
+
+#include "intern/depsgraph.hh"
+#include "intern/node/deg_node_component.hh"
+#include "intern/node/deg_node_id.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+namespace {
+
+struct TraceEvent {
+  std::string name;
+  /** Static string, the component type of operations. */
+  const char *category;
+  std::string depsgraph_name;
+  double start_time;
+  double end_time;
+};
+
+/** Events recorded by a single thread, the lock is only contended when the trace ends. */
+struct TraceThreadBuffer {
+  int thread_index;
+  bool is_main_thread;
+  std::unique_ptr<std::mutex> mutex;
+  Vector<TraceEvent> events;
+};
+
+struct TraceRecorder {
+  std::atomic<bool> is_active = false;
+  /** Protects against concurrent begin and end. */
+  std::mutex mutex;
+  double start_time = 0.0;
+  std::atomic<int> threads_num = 0;
+  threading::EnumerableThreadSpecific<TraceThreadBuffer> buffers;
+
+  TraceRecorder()
+      : buffers([this]() {
+          TraceThreadBuffer buffer;
+          buffer.thread_index = threads_num.fetch_add(1);
+          buffer.is_main_thread = BLI_thread_is_main();
+          buffer.mutex = std::make_unique<std::mutex>();
+          return buffer;
+        })
+  {
+  }
+};
+
+TraceRecorder &trace_recorder_get()
+{
+  static TraceRecorder recorder;
+  return recorder;
+}
+
+void trace_add_event(TraceEvent &&event)
+{
+  TraceRecorder &recorder = trace_recorder_get();
+  TraceThreadBuffer &buffer = recorder.buffers.local();
+  std::lock_guard lock(*buffer.mutex);
+  /* Evaluation may have started before the trace ended. */
+  if (recorder.is_active) {
+    buffer.events.append(std::move(event));
+  }
+}
+
+/** Time in microseconds since the trace started, as expected by the trace format. */
+double trace_timestamp(const TraceRecorder &recorder, const double time)
+{
+  return (time - recorder.start_time) * 1e6;
+}
+
+bool trace_write(TraceRecorder &recorder, const char *filepath)
+{
+  using namespace io::serialize;
+
+  DictionaryValue root;
+  ArrayValue &trace_events = *root.append_array("traceEvents");
+
+  for (TraceThreadBuffer &buffer : recorder.buffers) {
+    std::lock_guard lock(*buffer.mutex);
+    if (buffer.events.is_empty()) {
+      continue;
+    }
+    /* Metadata event naming the thread in the timeline. */
+    std::shared_ptr<DictionaryValue> thread_name = trace_events.append_dict();
+    thread_name->append_str("name", "thread_name");
+    thread_name->append_str("ph", "M");
+    thread_name->append_int("pid", 0);
+    thread_name->append_int("tid", buffer.thread_index);
+    thread_name->append_dict("args")->append_str(
+        "name",
+        buffer.is_main_thread ? std::string("Main") :
+                                "Worker " + std::to_string(buffer.thread_index));
+
+    for (const TraceEvent &event : buffer.events) {
+      std::shared_ptr<DictionaryValue> value = trace_events.append_dict();
+      value->append_str("name", event.name);
+      value->append_str("cat", event.category);
+      value->append_str("ph", "X");
+      value->append_double("ts", trace_timestamp(recorder, event.start_time));
+      value->append_double("dur", (event.end_time - event.start_time) * 1e6);
+      value->append_int("pid", 0);
+      value->append_int("tid", buffer.thread_index);
+      if (!event.depsgraph_name.empty()) {
+        value->append_dict("args")->append_str("depsgraph", event.depsgraph_name);
+      }
+    }
+  }
+  root.append_str("displayTimeUnit", "ms");
+
+  fstream stream(filepath, std::ios::out | std::ios::binary);
+  if (!stream.is_open()) {
+    return false;
+  }
+  JsonFormatter formatter;
+  formatter.serialize(stream, root);
+  return stream.good();
+}
+
+}  // namespace
+
+bool deg_debug_trace_is_active()
+{
+  return trace_recorder_get().is_active.load(std::memory_order_relaxed);
+}
+
+void deg_debug_trace_add_operation(const Depsgraph &graph,
+                                   const OperationNode &operation_node,
+                                   const double start_time,
+                                   const double end_time)
+{
+  TraceEvent event;
+  event.name = operation_node.full_identifier();
+  event.category = nodeTypeAsString(operation_node.owner->type);
+  event.depsgraph_name = graph.debug.name;
+  event.start_time = start_time;
+  event.end_time = end_time;
+  trace_add_event(std::move(event));
+}
+
+void deg_debug_trace_add_evaluation(const Depsgraph &graph,
+                                    const double start_time,
+                                    const double end_time)
+{
+  TraceEvent event;
+  event.name = graph.debug.name.empty() ? "Depsgraph" : "Depsgraph [" + graph.debug.name + "]";
+  event.category = "DEPSGRAPH";
+  event.depsgraph_name = graph.debug.name;
+  event.start_time = start_time;
+  event.end_time = end_time;
+  trace_add_event(std::move(event));
+}
+
+}  // namespace blender::deg
+
+namespace deg = blender::deg;
+
+void DEG_debug_trace_begin()
+{
+  deg::TraceRecorder &recorder = deg::trace_recorder_get();
+  std::lock_guard lock(recorder.mutex);
+  for (deg::TraceThreadBuffer &buffer : recorder.buffers) {
+    std::lock_guard buffer_lock(*buffer.mutex);
+    buffer.events.clear_and_shrink();
+  }
+  recorder.start_time = BLI_time_now_seconds();
+  recorder.is_active = true;
+}
+
+bool DEG_debug_trace_end(const char *filepath)
+{
+  deg::TraceRecorder &recorder = deg::trace_recorder_get();
+  std::lock_guard lock(recorder.mutex);
+  if (!recorder.is_active) {
+    return false;
+  }
+  recorder.is_active = false;
+
+  const bool success = deg::trace_write(recorder, filepath);
+  for (deg::TraceThreadBuffer &buffer : recorder.buffers) {
+    std::lock_guard buffer_lock(*buffer.mutex);
+    buffer.events.clear_and_shrink();
+  }
+  return success;
+}
+
+bool DEG_debug_trace_is_active()
+{
+  return deg::deg_debug_trace_is_active();
+}
@@ -0,0 +1,31 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Recording of a timeline of the evaluation of all dependency graphs, which can be exported in
+ * the Chrome trace event format (viewable in `chrome://tracing` or Perfetto).
+ */
+
+#pragma once
+
+namespace blender::deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/** Whether the evaluation trace is currently being recorded. */
+bool deg_debug_trace_is_active();
+
+/** Record the evaluation of an operation, on the calling thread. */
+void deg_debug_trace_add_operation(const Depsgraph &graph,
+                                   const OperationNode &operation_node,
+                                   double start_time,
+                                   double end_time);
+
+/** Record the evaluation of the whole graph. */
+void deg_debug_trace_add_evaluation(const Depsgraph &graph, double start_time, double end_time);
+
+}  // namespace blender::deg
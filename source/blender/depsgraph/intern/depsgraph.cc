@@ -48,6 +48,8 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
     : time_source(nullptr),
       has_animated_visibility(false),
       need_update_relations(true),
+      need_update_all_relations(true),
+      supports_incremental_relations_update(false),
       need_update_nodes_visibility(true),
       need_tag_id_on_graph_visibility_update(true),
       need_tag_id_on_graph_visibility_time_update(false),
@@ -174,7 +176,8 @@ void Depsgraph::clear_id_nodes()
   light_linking_cache.clear();
 }
 
-Relation *Depsgraph::add_new_relation(Node *from, Node *to, const char *description, int flags)
+Relation *Depsgraph::add_new_relation(
+    Node *from, Node *to, const char *description, int flags, uint owner_session_uid)
 {
   Relation *rel = nullptr;
   if (flags & RELATION_CHECK_BEFORE_ADD) {
@@ -182,6 +185,11 @@ Relation *Depsgraph::add_new_relation(Node *from, Node *to, const char *descript
   }
   if (rel != nullptr) {
     rel->flag |= flags;
+    /* Relation is needed by builders of different IDs, it is to be kept when either of them is
+     * re-built. */
+    if (rel->owner_session_uid != owner_session_uid) {
+      rel->owner_session_uid = 0;
+    }
     return rel;
   }
 
@@ -197,6 +205,7 @@ Relation *Depsgraph::add_new_relation(Node *from, Node *to, const char *descript
   /* Create new relation, and add it to the graph. */
   rel = new Relation(from, to, description);
   rel->flag |= flags;
+  rel->owner_session_uid = owner_session_uid;
   return rel;
 }
 
@@ -232,6 +241,41 @@ void Depsgraph::add_entry_tag(OperationNode *node)
   entry_tags.add(node);
 }
 
+void Depsgraph::remove_id_nodes(const Set<IDNode *> &id_nodes_to_remove)
+{
+  if (id_nodes_to_remove.is_empty()) {
+    return;
+  }
+
+  /* Relations are unlinked from both sides first, so that the destructor of the nodes does not
+   * free relations which are still referenced by the nodes which are kept in the graph. */
+  Set<Relation *> relations_to_remove;
+  for (IDNode *id_node : id_nodes_to_remove) {
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        relations_to_remove.add_multiple(op_node->inlinks);
+        relations_to_remove.add_multiple(op_node->outlinks);
+        entry_tags.remove(op_node);
+      }
+    }
+  }
+  for (Relation *rel : relations_to_remove) {
+    rel->unlink();
+    delete rel;
+  }
+
+  operations.remove_if([&](const OperationNode *op_node) {
+    return id_nodes_to_remove.contains(op_node->owner->owner);
+  });
+  id_nodes.remove_if(
+      [&](IDNode *id_node) { return id_nodes_to_remove.contains(id_node); });
+
+  for (IDNode *id_node : id_nodes_to_remove) {
+    id_hash.remove(id_node->id_orig);
+    delete id_node;
+  }
+}
+
 void Depsgraph::clear_all_nodes()
 {
   clear_id_nodes();
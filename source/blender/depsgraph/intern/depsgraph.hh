@@ -59,8 +59,14 @@ struct Depsgraph {
   IDNode *add_id_node(ID *id, ID *id_cow_hint = nullptr);
   void clear_id_nodes();
 
-  /** Add new relationship between two nodes. */
-  Relation *add_new_relation(Node *from, Node *to, const char *description, int flags = 0);
+  /**
+   * Add new relationship between two nodes.
+   *
+   * The owner is the session UID of the ID whose builder requested the relation, it is used to
+   * find relations which need to be re-created on incremental relations update.
+   */
+  Relation *add_new_relation(
+      Node *from, Node *to, const char *description, int flags = 0, uint owner_session_uid = 0);
 
   /* Check whether two nodes are connected by relation with given
    * description. Description might be nullptr to check ANY relation between
@@ -73,6 +79,15 @@ struct Depsgraph {
   /* Clear storage used by all nodes. */
   void clear_all_nodes();
 
+  /**
+   * Remove the given ID nodes from the graph, together with all their operations and relations
+   * to and from them.
+   *
+   * The evaluated copies of the IDs are freed by the nodes, unless the caller has taken their
+   * ownership by setting #IDNode::id_cow to nullptr.
+   */
+  void remove_id_nodes(const Set<IDNode *> &id_nodes_to_remove);
+
   /* Copy-on-Write Functionality ........ */
 
   /* For given original ID get ID which is created by copy-on-evaluation system. */
@@ -98,6 +113,15 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update_relations;
 
+  /* Relations of the whole graph are to be re-built. When false while #need_update_relations is
+   * true, only relations of the IDs from #need_update_relations_ids have changed, which allows to
+   * patch the existing graph instead. */
+  bool need_update_all_relations;
+  /* Session UIDs of the IDs tagged with #DEG_id_relations_tag_update. */
+  Set<uint> need_update_relations_ids;
+  /* The graph was built by a pipeline which allows to update relations of individual IDs. */
+  bool supports_incremental_relations_update;
+
   /* Indicates whether indirect effect of nodes on a directly visible ones needs to be updated. */
   bool need_update_nodes_visibility;
 
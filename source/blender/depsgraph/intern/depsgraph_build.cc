@@ -21,6 +21,7 @@
 #include "DNA_node_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BKE_collection.hh"
 #include "BKE_main.hh"
@@ -35,6 +36,7 @@
 #include "builder/pipeline_compositor.h"
 #include "builder/pipeline_from_collection.h"
 #include "builder/pipeline_from_ids.h"
+#include "builder/pipeline_incremental.h"
 #include "builder/pipeline_render.h"
 #include "builder/pipeline_view_layer.h"
 
@@ -288,6 +290,7 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
   DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations for update.\n", __func__);
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
   deg_graph->need_update_relations = true;
+  deg_graph->need_update_all_relations = true;
 
   /* NOTE: When relations are updated, it's quite possible that we've got new bases in the scene.
    * This means, we need to re-create flat array of bases in view layer. */
@@ -311,6 +314,12 @@ void DEG_graph_relations_update(Depsgraph *graph)
     /* Graph is up to date, nothing to do. */
     return;
   }
+  if (!deg_graph->need_update_all_relations) {
+    deg::IncrementalBuilderPipeline builder(graph);
+    if (builder.build_incremental()) {
+      return;
+    }
+  }
   DEG_graph_build_from_view_layer(graph);
 }
 
@@ -321,3 +330,23 @@ void DEG_relations_tag_update(Main *bmain)
     DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
   }
 }
+
+void DEG_id_relations_tag_update(Main *bmain, ID *id)
+{
+  if (!USER_EXPERIMENTAL_TEST(&U, use_incremental_depsgraph_relations)) {
+    DEG_relations_tag_update(bmain);
+    return;
+  }
+  DEG_GLOBAL_DEBUG_PRINTF(TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  for (deg::Depsgraph *depsgraph : deg::get_all_registered_graphs(bmain)) {
+    if (depsgraph->need_update_all_relations) {
+      continue;
+    }
+    if (depsgraph->find_id_node(id) == nullptr) {
+      /* The ID is not used by the graph, so its relations do not affect the graph. */
+      continue;
+    }
+    depsgraph->need_update_relations = true;
+    depsgraph->need_update_relations_ids.add(id->session_uid);
+  }
+}
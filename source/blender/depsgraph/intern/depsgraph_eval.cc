@@ -8,11 +8,18 @@
  * Evaluation engine entry-points for Depsgraph Engine.
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_listbase.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "BKE_global.hh"
 #include "BKE_scene.hh"
 
 #include "DNA_object_types.h"
@@ -32,6 +39,10 @@
 #include "intern/depsgraph.hh"
 #include "intern/depsgraph_tag.hh"
 
+#ifdef WITH_PYTHON
+#  include "BPY_extern.hh"
+#endif
+
 namespace deg = blender::deg;
 
 static void deg_flush_updates_and_refresh(deg::Depsgraph *deg_graph,
@@ -92,3 +103,124 @@ void DEG_evaluate_on_framechange(Depsgraph *graph,
   deg_graph->ctime = BKE_scene_frame_to_ctime(scene, frame);
   deg_flush_updates_and_refresh(deg_graph, sync_writeback);
 }
+
+/* -------------------------------------------------------------------- */
+/** \name Multi-Frame Evaluation
+ * \{ */
+
+namespace blender::deg {
+
+namespace {
+
+/** Dependency graph which evaluates every N-th frame. */
+struct FrameEvaluationSlot {
+  ::Depsgraph *graph = nullptr;
+  /** Index of the frame which is scheduled or evaluated in the graph. */
+  int64_t frame_index = -1;
+  /** The frame is evaluated either by a task, or by the calling thread when no task started it
+   * yet. Whoever claims the slot first evaluates it. */
+  std::atomic<bool> is_claimed = true;
+  bool is_evaluated = false;
+  std::mutex mutex;
+  std::condition_variable condition;
+};
+
+void frame_slot_evaluate(const Span<float> frames, FrameEvaluationSlot &slot)
+{
+  if (slot.is_claimed.exchange(true)) {
+    return;
+  }
+  DEG_evaluate_on_framechange(slot.graph, frames[slot.frame_index]);
+  {
+    std::lock_guard lock(slot.mutex);
+    slot.is_evaluated = true;
+  }
+  slot.condition.notify_all();
+}
+
+void frame_slot_evaluate_task(TaskPool *__restrict pool, void *taskdata)
+{
+  const Span<float> &frames = *static_cast<const Span<float> *>(BLI_task_pool_user_data(pool));
+  frame_slot_evaluate(frames, *static_cast<FrameEvaluationSlot *>(taskdata));
+}
+
+}  // namespace
+
+}  // namespace blender::deg
+
+void DEG_evaluate_frames(const blender::Span<Depsgraph *> graphs,
+                         blender::Span<float> frames,
+                         const blender::FunctionRef<bool(Depsgraph *graph, float frame)> frame_fn)
+{
+  BLI_assert(!graphs.is_empty());
+  if (frames.is_empty()) {
+    return;
+  }
+  const int64_t slots_num = std::min(graphs.size(), frames.size());
+
+  blender::Array<deg::FrameEvaluationSlot> slots(slots_num);
+  for (const int64_t i : slots.index_range()) {
+    slots[i].graph = graphs[i];
+  }
+
+#ifdef WITH_PYTHON
+  /* Release the GIL for all of the evaluation, not only while a graph is evaluated on this
+   * thread. Otherwise waiting for a frame that is evaluated by a task dead-locks when that task
+   * evaluates Python drivers. */
+  BPy_BEGIN_ALLOW_THREADS;
+#endif
+
+  TaskPool *task_pool = nullptr;
+  if (slots_num > 1 && !(G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS)) {
+    task_pool = BLI_task_pool_create(&frames, TASK_PRIORITY_HIGH);
+  }
+
+  auto schedule_frame = [&](deg::FrameEvaluationSlot &slot, const int64_t frame_index) {
+    slot.frame_index = frame_index;
+    slot.is_evaluated = false;
+    slot.is_claimed.store(false);
+    if (task_pool) {
+      BLI_task_pool_push(task_pool, deg::frame_slot_evaluate_task, &slot, false, nullptr);
+    }
+  };
+
+  for (const int64_t i : slots.index_range()) {
+    schedule_frame(slots[i], i);
+  }
+
+  for (const int64_t frame_index : frames.index_range()) {
+    deg::FrameEvaluationSlot &slot = slots[frame_index % slots_num];
+    /* Evaluate the frame here when no task got to it yet, otherwise wait for the task. */
+    deg::frame_slot_evaluate(frames, slot);
+    {
+      std::unique_lock lock(slot.mutex);
+      slot.condition.wait(lock, [&]() { return slot.is_evaluated; });
+    }
+
+    if (!frame_fn(slot.graph, frames[frame_index])) {
+      break;
+    }
+
+    const bool backup = false;
+    DEG_ids_clear_recalc(slot.graph, backup);
+    if (frame_index + slots_num < frames.size()) {
+      schedule_frame(slot, frame_index + slots_num);
+    }
+  }
+
+  if (task_pool) {
+    /* Frames which are not evaluated yet are skipped when stopped early. Remaining tasks find
+     * their slot claimed, or are still evaluating it. */
+    for (deg::FrameEvaluationSlot &slot : slots) {
+      slot.is_claimed.store(true);
+    }
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+  }
+
+#ifdef WITH_PYTHON
+  BPy_END_ALLOW_THREADS;
+#endif
+}
+
+/** \} */
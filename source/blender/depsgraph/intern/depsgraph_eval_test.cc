@@ -0,0 +1,134 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_action.hh"
+#include "BKE_anim_data.hh"
+#include "BKE_collection.hh"
+#include "BKE_fcurve.hh"
+#include "BKE_layer.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_object.hh"
+#include "BKE_scene.hh"
+
+#include "BLI_listbase.h"
+#include "BLI_string.h"
+#include "BLI_vector.hh"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_query.hh"
+
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+namespace blender::deg::tests {
+
+class DepsgraphEvaluateFramesTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  ViewLayer *view_layer = nullptr;
+  Object *object = nullptr;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    view_layer = BKE_view_layer_default_view(scene);
+    object = BKE_object_add_only_object(bmain, OB_EMPTY, "Object");
+    BKE_collection_object_add(bmain, scene->master_collection, object);
+    BKE_view_layer_synced_ensure(scene, view_layer);
+
+    /* The X location of the object is animated linearly, from 0 at frame 1 to 100 at frame 101. */
+    FCurve *fcu = BKE_fcurve_create();
+    fcu->rna_path = BLI_strdup("location");
+    fcu->array_index = 0;
+    fcu->totvert = 2;
+    fcu->bezt = MEM_cnew_array<BezTriple>(fcu->totvert, __func__);
+    for (const int i : IndexRange(fcu->totvert)) {
+      BezTriple &bezt = fcu->bezt[i];
+      bezt.vec[1][0] = 1.0f + 100.0f * i;
+      bezt.vec[1][1] = 100.0f * i;
+      bezt.ipo = BEZT_IPO_LIN;
+      bezt.h1 = bezt.h2 = HD_AUTO_ANIM;
+    }
+    BKE_fcurve_handles_recalc(fcu);
+
+    bAction *action = BKE_action_add(bmain, "Action");
+    BLI_addtail(&action->curves, fcu);
+    AnimData *adt = BKE_animdata_ensure_id(&object->id);
+    adt->action = action;
+    id_us_plus(&action->id);
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  /* Evaluate the frames, and return the X location of the object at every delivered frame. */
+  Vector<float> evaluate_frames(const Span<float> frames,
+                                const int graphs_num,
+                                const int64_t stop_after = -1)
+  {
+    Vector<Depsgraph *> graphs;
+    for (int i = 0; i < graphs_num; i++) {
+      Depsgraph *graph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+      DEG_graph_build_from_view_layer(graph);
+      graphs.append(graph);
+    }
+
+    Vector<float> locations;
+    DEG_evaluate_frames(graphs, frames, [&](Depsgraph *graph, const float frame) {
+      EXPECT_EQ(frame, frames[locations.size()]);
+      EXPECT_EQ(DEG_get_ctime(graph), frame);
+      const Object *object_eval = DEG_get_evaluated_object(graph, object);
+      locations.append(object_eval->loc[0]);
+      return locations.size() != stop_after;
+    });
+
+    for (Depsgraph *graph : graphs) {
+      DEG_graph_free(graph);
+    }
+    return locations;
+  }
+};
+
+TEST_F(DepsgraphEvaluateFramesTest, PerFrameResults)
+{
+  /* Frames are not in order, and some are repeated. */
+  const Vector<float> frames = {1.0f, 11.0f, 6.0f, 51.0f, 51.0f, 21.5f, 101.0f, 2.0f};
+  for (const int graphs_num : {1, 3, 16}) {
+    const Vector<float> locations = evaluate_frames(frames, graphs_num);
+    ASSERT_EQ(locations.size(), frames.size());
+    for (const int64_t i : frames.index_range()) {
+      EXPECT_FLOAT_EQ(locations[i], frames[i] - 1.0f) << "graphs_num " << graphs_num;
+    }
+  }
+  /* The original data is not changed. */
+  EXPECT_EQ(object->loc[0], 0.0f);
+}
+
+TEST_F(DepsgraphEvaluateFramesTest, StopEarly)
+{
+  const Vector<float> frames = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const Vector<float> locations = evaluate_frames(frames, 2, 3);
+  ASSERT_EQ(locations.size(), 3);
+  EXPECT_FLOAT_EQ(locations[2], 2.0f);
+}
+
+}  // namespace blender::deg::tests
@@ -10,6 +10,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_sys_types.h"
+
 namespace blender::deg {
 
 struct Node;
@@ -48,6 +50,11 @@ struct Relation {
   const char *name; /* label for debugging */
   int flag;         /* Bitmask of RelationFlag) */
 
+  /* Session UID of the ID whose builder has created this relation, or 0 when it is not known or
+   * when the same relation was requested by builders of different IDs.
+   * Used by incremental relations update to find relations which are to be re-created. */
+  uint owner_session_uid;
+
   MEM_CXX_CLASS_ALLOC_FUNCS("Relation");
 };
 
@@ -11,8 +11,10 @@
 #include "intern/eval/deg_eval.h"
 
 #include "BLI_compiler_attrs.h"
+#include "BLI_enumerable_thread_specific.hh"
 #include "BLI_function_ref.hh"
 #include "BLI_gsqueue.h"
+#include "BLI_heap_simple.h"
 #include "BLI_task.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
@@ -32,10 +34,15 @@
 
 #include "atomic_ops.h"
 
+#include <algorithm>
+#include <mutex>
+
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/depsgraph.hh"
 #include "intern/depsgraph_relation.hh"
 #include "intern/depsgraph_tag.hh"
 #include "intern/eval/deg_eval_copy_on_write.h"
+#include "intern/eval/deg_eval_critical_path.h"
 #include "intern/eval/deg_eval_flush.h"
 #include "intern/eval/deg_eval_stats.h"
 #include "intern/eval/deg_eval_visibility.h"
@@ -80,25 +87,66 @@ enum class EvaluationStage {
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  /* Record the evaluation timeline, see #DEG_debug_trace_begin. */
+  bool do_trace;
   EvaluationStage stage;
   bool need_update_pending_parents = true;
   bool need_single_thread_pass = false;
+
+  /* Operations which are ready to be evaluated by the task pool, the ones with the highest
+   * #OperationNode::critical_path_cost first. Every task pushed to the pool evaluates one of
+   * them, not necessarily the one which was made ready along with the task. */
+  HeapSimple *ready_operations = nullptr;
+  std::mutex ready_operations_mutex;
+
+  /* Measure the evaluation time of all operations to update their cost estimates. Otherwise only
+   * operations without an estimate are measured, to avoid the overhead of the timer calls. */
+  bool do_sample_cost;
+  /* Operations whose cost estimate has been updated during this evaluation. */
+  threading::EnumerableThreadSpecific<Vector<OperationNode *>> cost_changed_operations;
 };
 
-void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
+/* Weight of the last evaluation time in the averaged cost estimate of operations. */
+constexpr float COST_ESTIMATE_FACTOR = 0.3f;
+/* Number of graph evaluations between two updates of the cost estimates of all operations. */
+constexpr uint64_t COST_SAMPLE_INTERVAL = 8;
+
+void update_cost_estimate(OperationNode *operation_node, const double time)
+{
+  if (operation_node->cost_estimate == 0.0f) {
+    operation_node->cost_estimate = float(time);
+  }
+  else {
+    operation_node->cost_estimate += (float(time) - operation_node->cost_estimate) *
+                                     COST_ESTIMATE_FACTOR;
+  }
+}
+
+void evaluate_node(DepsgraphEvalState *state, OperationNode *operation_node)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
-  if (state->do_stats) {
-    const double start_time = BLI_time_now_seconds();
+  const bool do_time = state->do_stats || state->do_trace || state->do_sample_cost ||
+                       operation_node->cost_estimate == 0.0f;
+  if (!do_time) {
     operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += BLI_time_now_seconds() - start_time;
   }
   else {
+    /* Perform operation. */
+    const double start_time = BLI_time_now_seconds();
     operation_node->evaluate(depsgraph);
+    const double end_time = BLI_time_now_seconds();
+
+    update_cost_estimate(operation_node, end_time - start_time);
+    state->cost_changed_operations.local().append(operation_node);
+    if (state->do_stats) {
+      operation_node->stats.current_time += end_time - start_time;
+    }
+    if (state->do_trace) {
+      deg_debug_trace_add_operation(*state->graph, *operation_node, start_time, end_time);
+    }
   }
 
   /* Clear the flag early on, allowing partial updates without re-evaluating the same node multiple
@@ -108,18 +156,32 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   operation_node->flag &= ~DEPSOP_FLAG_CLEAR_ON_EVAL;
 }
 
-void deg_task_run_func(TaskPool *pool, void *taskdata)
+void schedule_node_to_pool(DepsgraphEvalState *state, TaskPool *pool, OperationNode *node)
+{
+  {
+    std::lock_guard lock(state->ready_operations_mutex);
+    BLI_heapsimple_insert(state->ready_operations, -node->critical_path_cost, node);
+  }
+  BLI_task_pool_push(pool, deg_task_run_func, nullptr, false, nullptr);
+}
+
+void deg_task_run_func(TaskPool *pool, void * /*taskdata*/)
 {
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
+  /* Evaluate the most critical ready node. */
+  OperationNode *operation_node;
+  {
+    std::lock_guard lock(state->ready_operations_mutex);
+    operation_node = static_cast<OperationNode *>(
+        BLI_heapsimple_pop_min(state->ready_operations));
+  }
   evaluate_node(state, operation_node);
 
   /* Schedule children. */
   schedule_children(state, operation_node, [&](OperationNode *node) {
-    BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
+    schedule_node_to_pool(state, pool, node);
   });
 }
 
@@ -317,9 +379,8 @@ void evaluate_graph_threaded_stage(DepsgraphEvalState *state,
 
   calculate_pending_parents_if_needed(state);
 
-  schedule_graph(state, [&](OperationNode *node) {
-    BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
-  });
+  schedule_graph(state,
+                 [&](OperationNode *node) { schedule_node_to_pool(state, task_pool, node); });
   BLI_task_pool_work_and_wait(task_pool);
 }
 
@@ -402,6 +463,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_trace = deg_debug_trace_is_active();
+  state.do_sample_cost = graph->update_count % COST_SAMPLE_INTERVAL == 0;
+  const double trace_start_time = state.do_trace ? BLI_time_now_seconds() : 0.0;
 
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -424,6 +488,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
    * - Single-threaded pass of all remaining operations. */
 
   TaskPool *task_pool = deg_evaluate_task_pool_create(&state);
+  state.ready_operations = BLI_heapsimple_new();
 
   evaluate_graph_threaded_stage(&state, task_pool, EvaluationStage::COPY_ON_EVAL);
 
@@ -447,9 +512,18 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   evaluate_graph_threaded_stage(&state, task_pool, EvaluationStage::THREADED_EVALUATION);
 
   BLI_task_pool_free(task_pool);
+  BLI_heapsimple_free(state.ready_operations, nullptr);
 
   evaluate_graph_single_threaded_if_needed(&state);
 
+  /* Start long chains of expensive operations first in the next evaluation, so that they do not
+   * end up evaluated on their own at the end, leaving other threads idle. */
+  Vector<OperationNode *> cost_changed_operations;
+  for (const Vector<OperationNode *> &operations : state.cost_changed_operations) {
+    cost_changed_operations.extend(operations);
+  }
+  deg_graph_critical_path_update(cost_changed_operations);
+
   /* Finalize statistics gathering. This is because we only gather single
    * operation timing here, without aggregating anything to avoid any extra
    * synchronization. */
@@ -465,6 +539,10 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   BPy_END_ALLOW_THREADS;
 #endif
 
+  if (state.do_trace) {
+    deg_debug_trace_add_evaluation(*graph, trace_start_time, BLI_time_now_seconds());
+  }
+
   graph->debug.end_graph_evaluation();
 }
 
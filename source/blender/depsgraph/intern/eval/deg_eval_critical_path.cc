@@ -0,0 +1,122 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/eval/deg_eval_critical_path.h"
+
+#include <algorithm>
+
+#include "BLI_heap_simple.h"
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+#include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+static bool is_critical_path_relation(const Relation *rel)
+{
+  return rel->from->type == NodeType::OPERATION && rel->to->type == NodeType::OPERATION &&
+         (rel->flag & RELATION_FLAG_CYCLIC) == 0;
+}
+
+static float calculate_critical_path_cost(const OperationNode *node)
+{
+  float children_cost = 0.0f;
+  for (const Relation *rel : node->outlinks) {
+    if (is_critical_path_relation(rel)) {
+      const OperationNode *to = static_cast<const OperationNode *>(rel->to);
+      children_cost = std::max(children_cost, to->critical_path_cost);
+    }
+  }
+  return node->cost_estimate + children_cost;
+}
+
+void deg_graph_critical_path_build(Depsgraph *graph)
+{
+  /* Operations are visited from the end of the graph, once all of their children have been
+   * handled. */
+  Vector<OperationNode *> stack;
+  for (OperationNode *node : graph->operations) {
+    int children_num = 0;
+    for (const Relation *rel : node->outlinks) {
+      if (is_critical_path_relation(rel)) {
+        children_num++;
+      }
+    }
+    /* Used as the number of children which are not handled yet. */
+    node->custom_flags = children_num;
+    node->critical_path_index = -1;
+    if (children_num == 0) {
+      stack.append(node);
+    }
+  }
+
+  int index = 0;
+  while (!stack.is_empty()) {
+    OperationNode *node = stack.pop_last();
+    node->critical_path_index = index++;
+    node->critical_path_cost = calculate_critical_path_cost(node);
+    for (const Relation *rel : node->inlinks) {
+      if (!is_critical_path_relation(rel)) {
+        continue;
+      }
+      OperationNode *from = static_cast<OperationNode *>(rel->from);
+      if (--from->custom_flags == 0) {
+        stack.append(from);
+      }
+    }
+  }
+
+  /* Only happens if there is a cycle which was not detected, the cost of such operations is not
+   * known reliably. */
+  for (OperationNode *node : graph->operations) {
+    if (node->critical_path_index == -1) {
+      node->critical_path_index = index++;
+      node->critical_path_cost = node->cost_estimate;
+    }
+  }
+}
+
+void deg_graph_critical_path_update(const Span<OperationNode *> changed_nodes)
+{
+  if (changed_nodes.is_empty()) {
+    return;
+  }
+  /* Children are handled before their parents, as they have a lower index. */
+  HeapSimple *heap = BLI_heapsimple_new();
+  Set<OperationNode *> queued_nodes;
+  for (OperationNode *node : changed_nodes) {
+    if (queued_nodes.add(node)) {
+      BLI_heapsimple_insert(heap, float(node->critical_path_index), node);
+    }
+  }
+
+  while (!BLI_heapsimple_is_empty(heap)) {
+    OperationNode *node = static_cast<OperationNode *>(BLI_heapsimple_pop_min(heap));
+    const float cost = calculate_critical_path_cost(node);
+    if (cost == node->critical_path_cost) {
+      continue;
+    }
+    node->critical_path_cost = cost;
+    for (const Relation *rel : node->inlinks) {
+      if (!is_critical_path_relation(rel)) {
+        continue;
+      }
+      OperationNode *from = static_cast<OperationNode *>(rel->from);
+      if (queued_nodes.add(from)) {
+        BLI_heapsimple_insert(heap, float(from->critical_path_index), from);
+      }
+    }
+  }
+
+  BLI_heapsimple_free(heap, nullptr);
+}
+
+}  // namespace blender::deg
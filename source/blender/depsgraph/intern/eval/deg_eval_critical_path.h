@@ -0,0 +1,26 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include "BLI_span.hh"
+
+namespace blender::deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/* Calculate #OperationNode::critical_path_cost of all operations from their cost estimates, and
+ * the order used to update them. Is to be called after relations of the graph have changed. */
+void deg_graph_critical_path_build(Depsgraph *graph);
+
+/* Update #OperationNode::critical_path_cost after the cost estimates of the given operations have
+ * changed. Only these operations and the ones depending on them are visited. */
+void deg_graph_critical_path_update(Span<OperationNode *> changed_nodes);
+
+}  // namespace blender::deg
@@ -169,8 +169,15 @@ OperationNode *ComponentNode::add_operation(const DepsEvalOperationCb &op,
     op_node = (OperationNode *)factory->create_node(this->owner->id_orig, "", name);
 
     /* register opnode in this component's operation set */
-    OperationIDKey key(opcode, op_node->name.c_str(), name_tag);
-    operations_map->add(key, op_node);
+    if (operations_map != nullptr) {
+      OperationIDKey key(opcode, op_node->name.c_str(), name_tag);
+      operations_map->add(key, op_node);
+    }
+    else {
+      /* Component of an ID which is kept during incremental relations update, its build is
+       * already finalized. */
+      operations.append(op_node);
+    }
 
     /* Set back-link. */
     op_node->owner = this;
@@ -279,6 +286,10 @@ OperationNode *ComponentNode::get_exit_operation()
 
 void ComponentNode::finalize_build(Depsgraph * /*graph*/)
 {
+  if (operations_map == nullptr) {
+    /* Build was finalized already, the graph is updated incrementally. */
+    return;
+  }
   operations.reserve(operations_map->size());
   for (OperationNode *op_node : operations_map->values()) {
     operations.append(op_node);
@@ -211,7 +211,10 @@ const char *operationCodeAsString(OperationCode opcode)
   return "UNKNOWN";
 }
 
-OperationNode::OperationNode() : name_tag(-1), flag(0) {}
+OperationNode::OperationNode()
+    : name_tag(-1), flag(0), cost_estimate(0.0f), critical_path_cost(0.0f), critical_path_index(0)
+{
+}
 
 string OperationNode::identifier() const
 {
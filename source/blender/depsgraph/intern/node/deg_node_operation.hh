@@ -289,6 +289,16 @@ struct OperationNode : public Node {
   /* (OperationFlag) extra settings affecting evaluation. */
   int flag;
 
+  /* Evaluation time in seconds, averaged over previous evaluations. */
+  float cost_estimate;
+  /* Estimated time of the longest chain of dependent operations starting with this one, used to
+   * evaluate operations on the critical path first. Computed when relations are built, and
+   * updated after evaluations which changed cost estimates. */
+  float critical_path_cost;
+  /* Position of the operation in the graph where all its children come first, used to update the
+   * critical path costs in order. */
+  int critical_path_index;
+
   DEG_DEPSNODE_DECLARE;
 };
 
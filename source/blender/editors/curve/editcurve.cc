@@ -485,7 +485,7 @@ static void switch_keys_direction(Curve *cu, Nurb *actnu)
   int a;
 
   LISTBASE_FOREACH (KeyBlock *, currkey, &cu->key->block) {
-    fp = static_cast<float *>(currkey->data);
+    fp = static_cast<float *>(BKE_keyblock_data_for_write(currkey));
 
     LISTBASE_FOREACH (Nurb *, nu, nubase) {
       if (nu->bezt) {
@@ -887,10 +887,7 @@ static void calc_shapeKeys(Object *obedit, ListBase *newnurbs)
     }
 
     currkey->totelem = totvert;
-    if (currkey->data) {
-      MEM_freeN(currkey->data);
-    }
-    currkey->data = newkey;
+    BKE_keyblock_data_replace(currkey, newkey);
   }
 
   MEM_SAFE_FREE(ofs);
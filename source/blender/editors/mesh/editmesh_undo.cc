@@ -467,10 +467,7 @@ static void um_arraystore_compact_ex(UndoMesh *um, const UndoMesh *um_ref, bool
                   bs, keyblock->data, size_t(keyblock->totelem) * stride, state_reference);
             }
 
-            if (keyblock->data) {
-              MEM_freeN(keyblock->data);
-              keyblock->data = nullptr;
-            }
+            BKE_keyblock_data_free(keyblock);
           }
         }
       },
@@ -221,6 +221,14 @@ struct NodeBakeRequest {
   std::unique_ptr<bake::BlobWriteSharing> blob_sharing;
 };
 
+static std::unique_ptr<bake::BlobWriteSharing> create_blob_write_sharing(
+    const NodesModifierData &nmd, const int bake_id)
+{
+  const NodesModifierBake *bake = nmd.find_bake(bake_id);
+  const bool use_compression = bake && (bake->flag & NODES_MODIFIER_BAKE_COMPRESS);
+  return std::make_unique<bake::BlobWriteSharing>(use_compression);
+}
+
 struct BakeGeometryNodesJob {
   wmWindowManager *wm;
   Main *bmain;
@@ -625,7 +633,7 @@ static Vector<NodeBakeRequest> collect_simulations_to_bake(Main &bmain,
         request.nmd = nmd;
         request.bake_id = id;
         request.node_type = node->type;
-        request.blob_sharing = std::make_unique<bake::BlobWriteSharing>();
+        request.blob_sharing = create_blob_write_sharing(*nmd, id);
         if (bake::get_node_bake_target(*object, *nmd, id) == NODES_MODIFIER_BAKE_TARGET_DISK) {
           request.path = bake::get_node_bake_path(bmain, *object, *nmd, id);
         }
@@ -949,7 +957,7 @@ static Vector<NodeBakeRequest> bake_single_node_gather_bake_request(bContext *C,
   request.nmd = &nmd;
   request.bake_id = bake_id;
   request.node_type = node->type;
-  request.blob_sharing = std::make_unique<bake::BlobWriteSharing>();
+  request.blob_sharing = create_blob_write_sharing(nmd, bake_id);
 
   const NodesModifierBake *bake = nmd.find_bake(bake_id);
   if (!bake) {
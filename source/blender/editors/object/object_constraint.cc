@@ -1356,7 +1356,7 @@ void constraint_dependency_update(Main *bmain, Object *ob)
   if (ob->pose) {
     object_pose_tag_update(bmain, ob);
   }
-  DEG_relations_tag_update(bmain);
+  DEG_id_relations_tag_update(bmain, &ob->id);
 }
 
 void constraint_tag_update(Main *bmain, Object *ob, bConstraint *con)
@@ -186,6 +186,7 @@ static bool object_shape_key_mirror(
   kb = static_cast<KeyBlock *>(BLI_findlink(&key->block, ob->shapenr - 1));
 
   if (kb) {
+    float *kb_data = static_cast<float *>(BKE_keyblock_data_for_write(kb));
     char *tag_elem = static_cast<char *>(
         MEM_callocN(sizeof(char) * kb->totelem, "shape_key_mirror"));
 
@@ -200,15 +201,15 @@ static bool object_shape_key_mirror(
       for (i1 = 0; i1 < mesh->verts_num; i1++) {
         i2 = mesh_get_x_mirror_vert(ob, nullptr, i1, use_topology);
         if (i2 == i1) {
-          fp1 = ((float *)kb->data) + i1 * 3;
+          fp1 = kb_data + i1 * 3;
           fp1[0] = -fp1[0];
           tag_elem[i1] = 1;
           totmirr++;
         }
         else if (i2 != -1) {
           if (tag_elem[i1] == 0 && tag_elem[i2] == 0) {
-            fp1 = ((float *)kb->data) + i1 * 3;
-            fp2 = ((float *)kb->data) + i2 * 3;
+            fp1 = kb_data + i1 * 3;
+            fp2 = kb_data + i2 * 3;
 
             copy_v3_v3(tvec, fp1);
             copy_v3_v3(fp1, fp2);
@@ -250,7 +251,7 @@ static bool object_shape_key_mirror(
             float tvec[3];
             if (u == u_inv) {
               i1 = BKE_lattice_index_from_uvw(lt, u, v, w);
-              fp1 = ((float *)kb->data) + i1 * 3;
+              fp1 = kb_data + i1 * 3;
               fp1[0] = -fp1[0];
               totmirr++;
             }
@@ -258,8 +259,8 @@ static bool object_shape_key_mirror(
               i1 = BKE_lattice_index_from_uvw(lt, u, v, w);
               i2 = BKE_lattice_index_from_uvw(lt, u_inv, v, w);
 
-              fp1 = ((float *)kb->data) + i1 * 3;
-              fp2 = ((float *)kb->data) + i2 * 3;
+              fp1 = kb_data + i1 * 3;
+              fp2 = kb_data + i2 * 3;
 
               copy_v3_v3(tvec, fp1);
               copy_v3_v3(fp1, fp2);
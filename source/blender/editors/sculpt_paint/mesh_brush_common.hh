@@ -420,6 +420,12 @@ void update_shape_keys(Object &object,
                        Span<float3> translations,
                        Span<float3> positions_orig);
 
+/**
+ * Make sure the data of the shape keys modified by #update_shape_keys is not shared with other
+ * data-blocks, since it is written from multiple threads.
+ */
+void ensure_shape_keys_mutable(const Object &object, Mesh &mesh);
+
 /**
  * Creates OffsetIndices based on each node's unique vertex count, allowing for easy slicing of a
  * new array.
@@ -1035,6 +1035,9 @@ void restore_position_from_undo_step(const Depsgraph &depsgraph, Object &object)
 
       const KeyBlock *active_key = BKE_keyblock_from_object(&object);
       const bool need_translations = !ss.deform_imats.is_empty() || active_key;
+      if (active_key) {
+        ensure_shape_keys_mutable(object, mesh);
+      }
 
       threading::EnumerableThreadSpecific<LocalData> all_tls;
       node_mask.foreach_index(GrainSize(1), [&](const int i) {
@@ -7141,6 +7144,7 @@ PositionDeformData::PositionDeformData(const Depsgraph &depsgraph, Object &objec
     active_key_ = BKE_keyblock_find_by_index(keys, active_index);
     basis_active_ = active_key_ == keys->refkey;
     dependent_keys_ = BKE_keyblock_get_dependent_keys(keys_, active_index);
+    ensure_shape_keys_mutable(object_orig, mesh);
   }
   else {
     keys_ = nullptr;
@@ -7227,6 +7231,26 @@ void update_shape_keys(Object &object,
   }
 }
 
+void ensure_shape_keys_mutable(const Object &object, Mesh &mesh)
+{
+  Key *keys = mesh.key;
+  if (keys == nullptr) {
+    return;
+  }
+  const int active_index = object.shapenr - 1;
+  if (KeyBlock *active_key = BKE_keyblock_find_by_index(keys, active_index)) {
+    BKE_keyblock_data_for_write(active_key);
+  }
+  if (std::optional<Array<bool>> dependent = BKE_keyblock_get_dependent_keys(keys, active_index)) {
+    int i;
+    LISTBASE_FOREACH_INDEX (KeyBlock *, other_key, &keys->block, i) {
+      if ((*dependent)[i]) {
+        BKE_keyblock_data_for_write(other_key);
+      }
+    }
+  }
+}
+
 void scale_translations(const MutableSpan<float3> translations, const Span<float> factors)
 {
   for (const int i : translations.index_range()) {
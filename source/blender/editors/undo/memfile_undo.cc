@@ -325,6 +325,13 @@ static void memfile_undosys_step_free(UndoStep *us_p)
   BKE_memfile_undo_free(us->data);
 }
 
+static void memfile_undosys_step_data_size_update(UndoStep *us_p)
+{
+  MemFileUndoStep *us = (MemFileUndoStep *)us_p;
+  /* Chunks shared with other steps are accounted in the most recent one using them. */
+  us_p->data_size = BLO_memfile_size_unique(&us->data->memfile);
+}
+
 void ED_memfile_undosys_type(UndoType *ut)
 {
   ut->name = "Global Undo";
@@ -332,6 +339,7 @@ void ED_memfile_undosys_type(UndoType *ut)
   ut->step_encode = memfile_undosys_step_encode;
   ut->step_decode = memfile_undosys_step_decode;
   ut->step_free = memfile_undosys_step_free;
+  ut->step_data_size_update = memfile_undosys_step_data_size_update;
 
   ut->flags = 0;
 
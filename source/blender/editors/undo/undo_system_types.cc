@@ -24,6 +24,8 @@
 #include "ED_undo.hh"
 #include "undo_intern.hh"
 
+#include "BLO_undofile.hh"
+
 /* Keep last */
 #include "BKE_undo_system.hh"
 
@@ -60,4 +62,5 @@ void ED_undosys_type_init()
 void ED_undosys_type_free()
 {
   BKE_undosys_type_free_all();
+  BLO_memfile_chunk_store_free();
 }
@@ -278,6 +278,12 @@ class LazyFunction {
    * Allow executing the function even if previously requested values are not yet available.
    */
   bool allow_missing_requested_inputs_ = false;
+  /**
+   * The function is known to execute quickly, so that the overhead of scheduling it separately
+   * would be significant compared to the actual work. Graph executors may then execute it together
+   * with other nodes.
+   */
+  bool is_cheap_ = false;
 
  public:
   virtual ~LazyFunction() = default;
@@ -341,6 +347,14 @@ class LazyFunction {
     return allow_missing_requested_inputs_;
   }
 
+  /**
+   * See #is_cheap_.
+   */
+  bool is_cheap() const
+  {
+    return is_cheap_;
+  }
+
  private:
   /**
    * Needs to be implemented by subclasses. This is separate from #execute so that additional
@@ -118,6 +118,38 @@ class GraphExecutor : public LazyFunction {
     int total_size;
   } init_buffer_info_;
 
+  /**
+   * Cheap nodes that always use all their inputs don't need the lazy scheduling of the executor
+   * when all their outputs are only used by other such nodes. Those are grouped together with the
+   * node they are linked to. Only the last node of a group is scheduled. When it runs, it first
+   * executes the other nodes of the group in a fixed order, without locking or scheduling.
+   */
+  struct StraightLineGroup {
+    /**
+     * Nodes in the order they are executed in. Only the outputs of the last node are used outside
+     * of the group.
+     */
+    Vector<const FunctionNode *> nodes;
+    /**
+     * Offsets of the output values of every node in a buffer that is allocated once per group.
+     * Unlinked outputs and outputs of the last node are not stored in the buffer and have the
+     * offset -1.
+     */
+    Vector<Array<int>> output_offsets;
+    /**
+     * Inputs of nodes in the group that are linked to nodes outside of the group. These are
+     * requested when the last node of the group runs for the first time.
+     */
+    Vector<const InputSocket *> entry_inputs;
+    int buffer_size = 0;
+    int buffer_alignment = 1;
+  };
+  Vector<StraightLineGroup> straight_line_groups_;
+  /**
+   * Index of the straight-line group of every node or -1, indexed by #Node::index_in_graph.
+   */
+  Array<int> straight_line_group_by_node_;
+
   friend class Executor;
 
  public:
@@ -134,8 +166,20 @@ class GraphExecutor : public LazyFunction {
   std::string input_name(int index) const override;
   std::string output_name(int index) const override;
 
+  /**
+   * Number of straight-line groups the nodes of the graph have been combined into, see
+   * #StraightLineGroup.
+   */
+  int straight_line_groups_num() const;
+  /**
+   * Nodes of a straight-line group in the order they are executed in.
+   */
+  Span<const FunctionNode *> straight_line_group_nodes(int group_index) const;
+
  private:
   void execute_impl(Params &params, const Context &context) const override;
+
+  void build_straight_line_groups();
 };
 
 }  // namespace blender::fn::lazy_function
@@ -138,6 +138,16 @@ class MultiFunction : NonCopyable, NonMovable {
   virtual ExecutionHints get_execution_hints() const;
 };
 
+/**
+ * Add all parameters of #full_params to #r_sliced_params, so that index `i` in the sliced
+ * parameters corresponds to index `slice_range.start() + i` in the full parameters. Only single
+ * value parameters are supported.
+ */
+void add_sliced_parameters(const Signature &signature,
+                           Params &full_params,
+                           IndexRange slice_range,
+                           ParamsBuilder &r_sliced_params);
+
 inline ParamsBuilder::ParamsBuilder(const MultiFunction &fn, const IndexMask *mask)
     : ParamsBuilder(fn.signature(), *mask)
 {
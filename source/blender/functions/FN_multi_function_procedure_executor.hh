@@ -17,6 +17,11 @@ class ProcedureExecutor : public MultiFunction {
  private:
   Signature signature_;
   const Procedure &procedure_;
+  /**
+   * True when the procedure can be evaluated on smaller chunks of the mask one after another,
+   * which requires that all parameters can be sliced.
+   */
+  bool supports_chunked_execution_ = true;
 
  public:
   ProcedureExecutor(const Procedure &procedure);
@@ -165,6 +165,11 @@ struct NodeState {
    * This happens the first time the node function is executed.
    */
   bool storage_and_defaults_initialized = false;
+  /**
+   * Set to true once the other nodes of the straight-line group that ends with this node have been
+   * executed. See #GraphExecutor::StraightLineGroup.
+   */
+  bool straight_line_group_executed = false;
   /**
    * Nodes with side effects should always be executed when their required inputs have been
    * computed.
@@ -213,6 +218,7 @@ struct LockedNode {
 
 class Executor;
 class GraphExecutorLFParams;
+class StraightLineNodeParams;
 
 /**
  * Keeps track of nodes that are currently scheduled on a thread. A node can only be scheduled by
@@ -329,6 +335,7 @@ class Executor {
   bool is_first_execution_ = true;
 
   friend GraphExecutorLFParams;
+  friend StraightLineNodeParams;
 
   /**
    * Data that is local to the current thread. It is passed around in many places to avoid
@@ -406,8 +413,10 @@ class Executor {
       Vector<const FunctionNode *> side_effect_nodes;
       if (self_.side_effect_provider_ != nullptr) {
         side_effect_nodes = self_.side_effect_provider_->get_nodes_with_side_effects(context);
-        for (const FunctionNode *node : side_effect_nodes) {
+        for (const FunctionNode *&node : side_effect_nodes) {
           BLI_assert(self_.graph_.nodes().contains(node));
+          /* Nodes in a straight-line group are only executed as part of the last node. */
+          node = static_cast<const FunctionNode *>(&this->get_owner_node(*node));
           const int node_index = node->index_in_graph();
           NodeState &node_state = *node_states_[node_index];
           node_state.has_side_effects = true;
@@ -429,6 +438,38 @@ class Executor {
   }
 
  private:
+  /**
+   * The straight-line group that ends with the given node, if any.
+   */
+  const GraphExecutor::StraightLineGroup *get_straight_line_group(const Node &node) const
+  {
+    const int group_index = self_.straight_line_group_by_node_[node.index_in_graph()];
+    if (group_index == -1) {
+      return nullptr;
+    }
+    const GraphExecutor::StraightLineGroup &group = self_.straight_line_groups_[group_index];
+    BLI_assert(group.nodes.last() == &node);
+    return &group;
+  }
+
+  /**
+   * Nodes in a straight-line group are never scheduled or locked themselves. Instead, the last
+   * node of the group is responsible for them.
+   */
+  const Node &get_owner_node(const Node &node) const
+  {
+    const int group_index = self_.straight_line_group_by_node_[node.index_in_graph()];
+    if (group_index == -1) {
+      return node;
+    }
+    return *self_.straight_line_groups_[group_index].nodes.last();
+  }
+
+  InputState &get_input_state(const InputSocket &socket) const
+  {
+    return node_states_[socket.node().index_in_graph()]->inputs[socket.index()];
+  }
+
   void initialize_node_states(char *buffer)
   {
     Span<const Node *> nodes = self_.graph_.nodes();
@@ -694,6 +735,7 @@ class Executor {
     }
 
     BLI_assert(node.is_function());
+    BLI_assert(&this->get_owner_node(node) == &node);
     this->with_locked_node(
         node, node_state, current_task, local_data, [&](LockedNode &locked_node) {
           if (output_state.usage == ValueUsage::Used) {
@@ -712,6 +754,7 @@ class Executor {
     const int index_in_node = socket.index();
     NodeState &node_state = *node_states_[node.index_in_graph()];
     OutputState &output_state = node_state.outputs[index_in_node];
+    BLI_assert(&this->get_owner_node(node) == &node);
 
     this->with_locked_node(
         node, node_state, current_task, local_data, [&](LockedNode &locked_node) {
@@ -834,6 +877,8 @@ class Executor {
     LinearAllocator<> &allocator = *local_data.allocator;
     Context local_context{context_->storage, context_->user_data, local_data.local_user_data};
     const LazyFunction &fn = node.function();
+    const GraphExecutor::StraightLineGroup *straight_line_group = this->get_straight_line_group(
+        node);
 
     bool node_needs_execution = false;
     this->with_locked_node(
@@ -858,14 +903,23 @@ class Executor {
           }
 
           if (!node_state.always_used_inputs_requested) {
-            /* Request linked inputs that are always needed. */
-            const Span<Input> fn_inputs = fn.inputs();
-            for (const int input_index : fn_inputs.index_range()) {
-              const Input &fn_input = fn_inputs[input_index];
-              if (fn_input.usage == ValueUsage::Used) {
-                const InputSocket &input_socket = node.input(input_index);
-                if (input_socket.origin() != nullptr) {
-                  this->set_input_required(locked_node, input_socket);
+            if (straight_line_group) {
+              /* All nodes in the group use all their inputs. Inputs linked within the group are
+               * computed when the group is executed. */
+              for (const InputSocket *input_socket : straight_line_group->entry_inputs) {
+                this->set_input_required(locked_node, *input_socket);
+              }
+            }
+            else {
+              /* Request linked inputs that are always needed. */
+              const Span<Input> fn_inputs = fn.inputs();
+              for (const int input_index : fn_inputs.index_range()) {
+                const Input &fn_input = fn_inputs[input_index];
+                if (fn_input.usage == ValueUsage::Used) {
+                  const InputSocket &input_socket = node.input(input_index);
+                  if (input_socket.origin() != nullptr) {
+                    this->set_input_required(locked_node, input_socket);
+                  }
                 }
               }
             }
@@ -888,37 +942,47 @@ class Executor {
               }
             }
           }
+          if (straight_line_group) {
+            for (const InputSocket *input_socket : straight_line_group->entry_inputs) {
+              InputState &input_state = this->get_input_state(*input_socket);
+              if (input_state.was_ready_for_execution) {
+                continue;
+              }
+              if (input_state.value != nullptr) {
+                input_state.was_ready_for_execution = true;
+                continue;
+              }
+              if (input_state.usage == ValueUsage::Used) {
+                return;
+              }
+            }
+          }
 
           node_needs_execution = true;
         });
 
     if (node_needs_execution) {
       if (!node_state.storage_and_defaults_initialized) {
-        /* Initialize storage. */
-        node_state.storage = fn.init_storage(allocator);
-
-        /* Load unlinked inputs. */
-        for (const int input_index : node.inputs().index_range()) {
-          const InputSocket &input_socket = node.input(input_index);
-          if (input_socket.origin() != nullptr) {
-            continue;
+        if (straight_line_group) {
+          for (const FunctionNode *group_node : straight_line_group->nodes) {
+            this->initialize_storage_and_defaults(*group_node,
+                                                  *node_states_[group_node->index_in_graph()],
+                                                  allocator,
+                                                  local_context);
           }
-          InputState &input_state = node_state.inputs[input_index];
-          const CPPType &type = input_socket.type();
-          const void *default_value = input_socket.default_value();
-          BLI_assert(default_value != nullptr);
-          if (self_.logger_ != nullptr) {
-            self_.logger_->log_socket_value(input_socket, {type, default_value}, local_context);
-          }
-          BLI_assert(input_state.value == nullptr);
-          input_state.value = allocator.allocate(type.size(), type.alignment());
-          type.copy_construct(default_value, input_state.value);
-          input_state.was_ready_for_execution = true;
         }
-
+        else {
+          this->initialize_storage_and_defaults(node, node_state, allocator, local_context);
+        }
         node_state.storage_and_defaults_initialized = true;
       }
 
+      if (straight_line_group && !node_state.straight_line_group_executed) {
+        /* Compute the inputs of this node that are linked to other nodes in the group. */
+        this->execute_straight_line_group(*straight_line_group, current_task, local_data);
+        node_state.straight_line_group_executed = true;
+      }
+
       /* Importantly, the node must not be locked when it is executed. That would result in locks
        * being hold very long in some cases and results in multiple locks being hold by the same
        * thread in the same graph which can lead to deadlocks. */
@@ -942,6 +1006,34 @@ class Executor {
         });
   }
 
+  void initialize_storage_and_defaults(const FunctionNode &node,
+                                       NodeState &node_state,
+                                       LinearAllocator<> &allocator,
+                                       const Context &local_context)
+  {
+    /* Initialize storage. */
+    node_state.storage = node.function().init_storage(allocator);
+
+    /* Load unlinked inputs. */
+    for (const int input_index : node.inputs().index_range()) {
+      const InputSocket &input_socket = node.input(input_index);
+      if (input_socket.origin() != nullptr) {
+        continue;
+      }
+      InputState &input_state = node_state.inputs[input_index];
+      const CPPType &type = input_socket.type();
+      const void *default_value = input_socket.default_value();
+      BLI_assert(default_value != nullptr);
+      if (self_.logger_ != nullptr) {
+        self_.logger_->log_socket_value(input_socket, {type, default_value}, local_context);
+      }
+      BLI_assert(input_state.value == nullptr);
+      input_state.value = allocator.allocate(type.size(), type.alignment());
+      type.copy_construct(default_value, input_state.value);
+      input_state.was_ready_for_execution = true;
+    }
+  }
+
   void assert_expected_outputs_have_been_computed(LockedNode &locked_node,
                                                   const LocalData &local_data)
   {
@@ -995,18 +1087,38 @@ class Executor {
         return;
       }
     }
+    const GraphExecutor::StraightLineGroup *straight_line_group = this->get_straight_line_group(
+        node);
+    if (straight_line_group) {
+      for (const InputSocket *input_socket : straight_line_group->entry_inputs) {
+        const InputState &input_state = this->get_input_state(*input_socket);
+        if (input_state.usage == ValueUsage::Used && !input_state.was_ready_for_execution) {
+          return;
+        }
+      }
+    }
 
     node_state.node_has_finished = true;
 
-    for (const int input_index : node.inputs().index_range()) {
-      const InputSocket &input_socket = node.input(input_index);
-      InputState &input_state = node_state.inputs[input_index];
+    auto release_input = [&](const InputSocket &input_socket) {
+      InputState &input_state = this->get_input_state(input_socket);
       if (input_state.usage == ValueUsage::Maybe) {
         this->set_input_unused(locked_node, input_socket);
       }
       else if (input_state.usage == ValueUsage::Used) {
         this->destruct_input_value_if_exists(input_state, input_socket.type());
       }
+    };
+    for (const InputSocket *input_socket : node.inputs()) {
+      release_input(*input_socket);
+    }
+    if (straight_line_group) {
+      /* Inputs of the other nodes in the group which are linked to nodes outside of the group. */
+      for (const InputSocket *input_socket : straight_line_group->entry_inputs) {
+        if (&input_socket->node() != &node) {
+          release_input(*input_socket);
+        }
+      }
     }
 
     if (node_state.storage != nullptr) {
@@ -1031,6 +1143,10 @@ class Executor {
                     CurrentTask &current_task,
                     const LocalData &local_data);
 
+  void execute_straight_line_group(const GraphExecutor::StraightLineGroup &group,
+                                   CurrentTask &current_task,
+                                   const LocalData &local_data);
+
   void set_input_unused_during_execution(const Node &node,
                                          NodeState &node_state,
                                          const int input_index,
@@ -1046,9 +1162,8 @@ class Executor {
 
   void set_input_unused(LockedNode &locked_node, const InputSocket &input_socket)
   {
-    NodeState &node_state = locked_node.node_state;
-    const int input_index = input_socket.index();
-    InputState &input_state = node_state.inputs[input_index];
+    BLI_assert(&locked_node.node == &this->get_owner_node(input_socket.node()));
+    InputState &input_state = this->get_input_state(input_socket);
 
     BLI_assert(input_state.usage != ValueUsage::Used);
     if (input_state.usage == ValueUsage::Unused) {
@@ -1062,6 +1177,10 @@ class Executor {
     }
     const OutputSocket *origin = input_socket.origin();
     if (origin != nullptr) {
+      if (&this->get_owner_node(origin->node()) != &origin->node()) {
+        /* The origin is in the same straight-line group, it is not executed separately. */
+        return;
+      }
       locked_node.delayed_unused_outputs.append(origin);
     }
   }
@@ -1083,10 +1202,9 @@ class Executor {
 
   void *set_input_required(LockedNode &locked_node, const InputSocket &input_socket)
   {
-    BLI_assert(&locked_node.node == &input_socket.node());
+    BLI_assert(&locked_node.node == &this->get_owner_node(input_socket.node()));
     NodeState &node_state = locked_node.node_state;
-    const int input_index = input_socket.index();
-    InputState &input_state = node_state.inputs[input_index];
+    InputState &input_state = this->get_input_state(input_socket);
 
     BLI_assert(input_state.usage != ValueUsage::Unused);
 
@@ -1161,8 +1279,11 @@ class Executor {
         }
         continue;
       }
+      /* Inputs of nodes in a straight-line group are protected by the last node of the group. */
+      const Node &owner_node = this->get_owner_node(target_node);
+      NodeState &owner_node_state = *node_states_[owner_node.index_in_graph()];
       this->with_locked_node(
-          target_node, node_state, current_task, local_data, [&](LockedNode &locked_node) {
+          owner_node, owner_node_state, current_task, local_data, [&](LockedNode &locked_node) {
             if (input_state.usage == ValueUsage::Unused) {
               return;
             }
@@ -1460,6 +1581,194 @@ inline void Executor::execute_node(const FunctionNode &node,
   }
 }
 
+/**
+ * Parameters for nodes that are executed as part of a straight-line group. All inputs are
+ * available and the outputs are written to their final location directly. The node states are
+ * only accessed by the thread executing the group, so no locking is necessary.
+ */
+class StraightLineNodeParams final : public Params {
+ private:
+  NodeState &node_state_;
+  const Node &node_;
+  LinearAllocator<> &allocator_;
+
+ public:
+  StraightLineNodeParams(const LazyFunction &fn,
+                         const Node &node,
+                         NodeState &node_state,
+                         LinearAllocator<> &allocator)
+      : Params(fn, false), node_state_(node_state), node_(node), allocator_(allocator)
+  {
+  }
+
+ private:
+  void *try_get_input_data_ptr_impl(const int index) const override
+  {
+    return node_state_.inputs[index].value;
+  }
+
+  void *try_get_input_data_ptr_or_request_impl(const int index) override
+  {
+    return node_state_.inputs[index].value;
+  }
+
+  void *get_output_data_ptr_impl(const int index) override
+  {
+    OutputState &output_state = node_state_.outputs[index];
+    BLI_assert(!output_state.has_been_computed);
+    if (output_state.value == nullptr) {
+      /* The output is not linked, but the node may compute it anyway. */
+      const CPPType &type = node_.output(index).type();
+      output_state.value = allocator_.allocate(type.size(), type.alignment());
+    }
+    return output_state.value;
+  }
+
+  void output_set_impl(const int index) override
+  {
+    OutputState &output_state = node_state_.outputs[index];
+    BLI_assert(!output_state.has_been_computed);
+    output_state.has_been_computed = true;
+  }
+
+  bool output_was_set_impl(const int index) const override
+  {
+    return node_state_.outputs[index].has_been_computed;
+  }
+
+  ValueUsage get_output_usage_impl(const int index) const override
+  {
+    return node_state_.outputs[index].usage_for_execution;
+  }
+
+  void set_input_unused_impl(const int /*index*/) override
+  {
+    /* Nodes in straight-line groups always use all inputs. */
+    BLI_assert_unreachable();
+  }
+
+  bool try_enable_multi_threading_impl() override
+  {
+    return false;
+  }
+};
+
+/**
+ * Execute all nodes of the group except for the last one, which is executed like any other node.
+ * The values passed between the nodes are stored in a single buffer.
+ */
+inline void Executor::execute_straight_line_group(const GraphExecutor::StraightLineGroup &group,
+                                                  CurrentTask &current_task,
+                                                  const LocalData &local_data)
+{
+  LinearAllocator<> &allocator = *local_data.allocator;
+  char *buffer = static_cast<char *>(allocator.allocate(group.buffer_size, group.buffer_alignment));
+  const Context local_context{context_->storage, context_->user_data, local_data.local_user_data};
+
+  /* See #execute_node. */
+  auto blocking_hint_fn = [&]() {
+    if (!current_task.has_scheduled_nodes.load()) {
+      return;
+    }
+    if (!this->try_enable_multi_threading()) {
+      return;
+    }
+    this->push_all_scheduled_nodes_to_task_pool(current_task);
+  };
+  lazy_threading::HintReceiver blocking_hint_receiver{blocking_hint_fn};
+
+  for (const int group_node_index : group.nodes.index_range().drop_back(1)) {
+    const FunctionNode &node = *group.nodes[group_node_index];
+    const Span<int> output_offsets = group.output_offsets[group_node_index];
+    NodeState &node_state = *node_states_[node.index_in_graph()];
+    const LazyFunction &fn = node.function();
+
+    for (const int input_index : node.inputs().index_range()) {
+      InputState &input_state = node_state.inputs[input_index];
+      BLI_assert(input_state.value != nullptr);
+      input_state.was_ready_for_execution = true;
+    }
+    for (const int output_index : node.outputs().index_range()) {
+      OutputState &output_state = node_state.outputs[output_index];
+      const int offset = output_offsets[output_index];
+      output_state.usage_for_execution = offset == -1 ? ValueUsage::Unused : ValueUsage::Used;
+      output_state.value = offset == -1 ? nullptr : buffer + offset;
+    }
+
+    StraightLineNodeParams node_params{fn, node, node_state, allocator};
+    const Context fn_context{node_state.storage, context_->user_data, local_data.local_user_data};
+    if (self_.logger_ != nullptr) {
+      self_.logger_->log_before_node_execute(node, node_params, fn_context);
+    }
+    if (self_.node_execute_wrapper_) {
+      self_.node_execute_wrapper_->execute_node(node, node_params, fn_context);
+    }
+    else {
+      fn.execute(node_params, fn_context);
+    }
+    if (self_.logger_ != nullptr) {
+      self_.logger_->log_after_node_execute(node, node_params, fn_context);
+    }
+
+    /* Pass the computed values to the linked inputs, which are all in the same group. */
+    for (const int output_index : node.outputs().index_range()) {
+      const OutputSocket &output_socket = node.output(output_index);
+      OutputState &output_state = node_state.outputs[output_index];
+      const CPPType &type = output_socket.type();
+      if (!output_state.has_been_computed) {
+        if (output_state.usage_for_execution == ValueUsage::Used) {
+          if (self_.logger_ != nullptr) {
+            self_.logger_->dump_when_outputs_are_missing(node, {&output_socket}, local_context);
+          }
+          BLI_assert_unreachable();
+        }
+        continue;
+      }
+      const Span<const InputSocket *> targets = output_socket.targets();
+      if (targets.is_empty()) {
+        type.destruct(output_state.value);
+        output_state.value = nullptr;
+        continue;
+      }
+      if (self_.logger_ != nullptr) {
+        self_.logger_->log_socket_value(output_socket, {type, output_state.value}, local_context);
+      }
+      for (const int target_index : targets.index_range()) {
+        const InputSocket &target_socket = *targets[target_index];
+        InputState &input_state = this->get_input_state(target_socket);
+        BLI_assert(input_state.value == nullptr);
+        if (self_.logger_ != nullptr) {
+          self_.logger_->log_socket_value(
+              target_socket, {type, output_state.value}, local_context);
+        }
+        if (target_index == 0) {
+          /* The first target owns the value in the buffer. */
+          input_state.value = output_state.value;
+        }
+        else {
+          input_state.value = allocator.allocate(type.size(), type.alignment());
+          type.copy_construct(output_state.value, input_state.value);
+        }
+        input_state.usage = ValueUsage::Used;
+        input_state.was_ready_for_execution = true;
+      }
+      output_state.value = nullptr;
+    }
+
+    /* The node is done. */
+    for (const int input_index : node.inputs().index_range()) {
+      InputState &input_state = node_state.inputs[input_index];
+      input_state.usage = ValueUsage::Used;
+      this->destruct_input_value_if_exists(input_state, node.input(input_index).type());
+    }
+    if (node_state.storage != nullptr) {
+      fn.destruct_storage(node_state.storage);
+      node_state.storage = nullptr;
+    }
+    node_state.node_has_finished = true;
+  }
+}
+
 GraphExecutor::GraphExecutor(const Graph &graph,
                              Vector<const GraphInputSocket *> graph_inputs,
                              Vector<const GraphOutputSocket *> graph_outputs,
@@ -1517,6 +1826,170 @@ GraphExecutor::GraphExecutor(const Graph &graph,
   }
 
   init_buffer_info_.total_size = offset;
+
+  this->build_straight_line_groups();
+}
+
+/**
+ * Nodes that can be executed without laziness, because they use all their inputs anyway.
+ */
+static bool is_straight_line_node(const Node &node)
+{
+  if (!node.is_function()) {
+    return false;
+  }
+  const LazyFunction &fn = static_cast<const FunctionNode &>(node).function();
+  if (fn.allow_missing_requested_inputs()) {
+    return false;
+  }
+  for (const Input &input : fn.inputs()) {
+    if (input.usage != ValueUsage::Used) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GraphExecutor::build_straight_line_groups()
+{
+  const Span<const Node *> nodes = graph_.nodes();
+  straight_line_group_by_node_.reinitialize(nodes.size());
+  straight_line_group_by_node_.fill(-1);
+  if (!graph_.node_indices_are_valid()) {
+    return;
+  }
+
+  /* Sort nodes so that every node comes after all the nodes that its outputs are linked to, using
+   * a depth-first search along the links. Links that close a cycle are ignored. */
+  Vector<const Node *> targets_first_order;
+  targets_first_order.reserve(nodes.size());
+  {
+    struct StackItem {
+      const Node *node;
+      int output_index;
+      int target_index;
+    };
+    Array<bool> visited_nodes(nodes.size(), false);
+    Vector<StackItem> stack;
+    for (const Node *start_node : nodes) {
+      if (visited_nodes[start_node->index_in_graph()]) {
+        continue;
+      }
+      visited_nodes[start_node->index_in_graph()] = true;
+      stack.append({start_node, 0, 0});
+      while (!stack.is_empty()) {
+        StackItem &item = stack.last();
+        const Span<const OutputSocket *> outputs = item.node->outputs();
+        if (item.output_index == outputs.size()) {
+          targets_first_order.append(item.node);
+          stack.pop_last();
+          continue;
+        }
+        const Span<const InputSocket *> targets = outputs[item.output_index]->targets();
+        if (item.target_index == targets.size()) {
+          item.output_index++;
+          item.target_index = 0;
+          continue;
+        }
+        const Node &target_node = targets[item.target_index]->node();
+        item.target_index++;
+        if (!visited_nodes[target_node.index_in_graph()]) {
+          visited_nodes[target_node.index_in_graph()] = true;
+          stack.append({&target_node, 0, 0});
+        }
+      }
+    }
+  }
+
+  /* Find the last node of the group that every node belongs to. A cheap node joins the group of
+   * the nodes its outputs are linked to, if those are all in the same group. */
+  Array<int> last_node_by_node(nodes.size(), -1);
+  for (const Node *node : targets_first_order) {
+    const int node_index = node->index_in_graph();
+    last_node_by_node[node_index] = node_index;
+    if (!is_straight_line_node(*node)) {
+      continue;
+    }
+    if (!static_cast<const FunctionNode *>(node)->function().is_cheap()) {
+      continue;
+    }
+    int last_node_index = -1;
+    bool can_join_group = true;
+    for (const OutputSocket *output_socket : node->outputs()) {
+      for (const InputSocket *target_socket : output_socket->targets()) {
+        const Node &target_node = target_socket->node();
+        /* Targets that are not processed yet are part of a cycle. */
+        const int target_last_node_index = last_node_by_node[target_node.index_in_graph()];
+        if (!is_straight_line_node(target_node) || target_last_node_index == -1 ||
+            !ELEM(last_node_index, -1, target_last_node_index))
+        {
+          can_join_group = false;
+          break;
+        }
+        last_node_index = target_last_node_index;
+      }
+    }
+    if (can_join_group && last_node_index != -1) {
+      last_node_by_node[node_index] = last_node_index;
+    }
+  }
+
+  /* Create the groups, with the nodes in the order they can be executed in. */
+  Array<int> group_by_last_node(nodes.size(), -1);
+  for (int64_t i = targets_first_order.size() - 1; i >= 0; i--) {
+    const Node *node = targets_first_order[i];
+    const int node_index = node->index_in_graph();
+    const int last_node_index = last_node_by_node[node_index];
+    if (last_node_index == node_index) {
+      continue;
+    }
+    int &group_index = group_by_last_node[last_node_index];
+    if (group_index == -1) {
+      group_index = straight_line_groups_.append_and_get_index({});
+    }
+    straight_line_groups_[group_index].nodes.append(static_cast<const FunctionNode *>(node));
+    straight_line_group_by_node_[node_index] = group_index;
+  }
+  for (const int last_node_index : group_by_last_node.index_range()) {
+    const int group_index = group_by_last_node[last_node_index];
+    if (group_index == -1) {
+      continue;
+    }
+    straight_line_groups_[group_index].nodes.append(
+        static_cast<const FunctionNode *>(nodes[last_node_index]));
+    straight_line_group_by_node_[last_node_index] = group_index;
+  }
+
+  for (const int group_index : straight_line_groups_.index_range()) {
+    StraightLineGroup &group = straight_line_groups_[group_index];
+    for (const int group_node_index : group.nodes.index_range()) {
+      const FunctionNode &node = *group.nodes[group_node_index];
+      for (const InputSocket *input_socket : node.inputs()) {
+        const OutputSocket *origin = input_socket->origin();
+        if (origin == nullptr) {
+          continue;
+        }
+        if (straight_line_group_by_node_[origin->node().index_in_graph()] != group_index) {
+          group.entry_inputs.append(input_socket);
+        }
+      }
+      group.output_offsets.append(Array<int>(node.outputs().size(), -1));
+      MutableSpan<int> output_offsets = group.output_offsets.last();
+      if (group_node_index == group.nodes.index_range().last()) {
+        continue;
+      }
+      for (const OutputSocket *output_socket : node.outputs()) {
+        if (output_socket->targets().is_empty()) {
+          continue;
+        }
+        const CPPType &type = output_socket->type();
+        group.buffer_size = (group.buffer_size + type.alignment() - 1) & ~(type.alignment() - 1);
+        output_offsets[output_socket->index()] = group.buffer_size;
+        group.buffer_size += type.size();
+        group.buffer_alignment = std::max<int>(group.buffer_alignment, type.alignment());
+      }
+    }
+  }
 }
 
 void GraphExecutor::execute_impl(Params &params, const Context &context) const
@@ -1548,6 +2021,16 @@ std::string GraphExecutor::output_name(const int index) const
   return socket.name();
 }
 
+int GraphExecutor::straight_line_groups_num() const
+{
+  return straight_line_groups_.size();
+}
+
+Span<const FunctionNode *> GraphExecutor::straight_line_group_nodes(const int group_index) const
+{
+  return straight_line_groups_[group_index].nodes;
+}
+
 void GraphExecutorLogger::log_socket_value(const Socket &socket,
                                            const GPointer value,
                                            const Context &context) const
@@ -14,6 +14,9 @@ ProcedureExecutor::ProcedureExecutor(const Procedure &procedure) : procedure_(pr
 
   for (const ConstParameter &param : procedure.params()) {
     builder.add("Parameter", ParamType(param.type, param.variable->data_type()));
+    if (param.variable->data_type().is_vector()) {
+      supports_chunked_execution_ = false;
+    }
   }
 
   this->set_signature(&signature_);
@@ -21,6 +24,15 @@ ProcedureExecutor::ProcedureExecutor(const Procedure &procedure) : procedure_(pr
 
 using IndicesSplitVectors = std::array<Vector<int64_t>, 2>;
 
+/**
+ * Large masks are split into chunks that contain indices from a range of at most this size. Every
+ * chunk is evaluated with the entire procedure before the next one starts. This way, intermediate
+ * buffers stay small enough to remain in the CPU cache while they are passed from one function to
+ * the next, instead of being materialized for the full mask. The size is large enough to make the
+ * overhead of interpreting the procedure for every chunk negligible.
+ */
+static constexpr int64_t chunk_size = 2048;
+
 namespace {
 enum class ValueType {
   GVArray = 0,
@@ -135,6 +147,12 @@ class ValueAllocator : NonCopyable, NonMovable {
    */
   std::array<Stack<VariableValue *>, tot_variable_value_types> variable_value_free_lists_;
 
+  /**
+   * Span buffers are allocated for at least this many elements. This allows reusing them when the
+   * allocator is used for multiple masks of different sizes.
+   */
+  int64_t min_span_size_ = 0;
+
   /**
    * The integer key is the size of one element (e.g. 4 for an integer buffer). All buffers are
    * aligned to #min_alignment bytes.
@@ -151,6 +169,11 @@ class ValueAllocator : NonCopyable, NonMovable {
  public:
   ValueAllocator(LinearAllocator<> &linear_allocator) : linear_allocator_(linear_allocator) {}
 
+  void set_min_span_size(const int64_t size)
+  {
+    min_span_size_ = size;
+  }
+
   VariableValue_GVArray *obtain_GVArray(const GVArray &varray)
   {
     return this->obtain<VariableValue_GVArray>(varray);
@@ -166,10 +189,11 @@ class ValueAllocator : NonCopyable, NonMovable {
     return this->obtain<VariableValue_Span>(buffer, false);
   }
 
-  VariableValue_Span *obtain_Span(const CPPType &type, int size)
+  VariableValue_Span *obtain_Span(const CPPType &type, int64_t size)
   {
     void *buffer = nullptr;
 
+    size = std::max(size, min_span_size_);
     const int64_t element_size = type.size();
     const int64_t alignment = type.alignment();
 
@@ -813,17 +837,17 @@ class VariableState : NonCopyable, NonMovable {
 /** Keeps track of the states of all variables during evaluation. */
 class VariableStates {
  private:
-  ValueAllocator value_allocator_;
+  ValueAllocator &value_allocator_;
   const Procedure &procedure_;
   /** The state of every variable, indexed by #Variable::index_in_procedure(). */
   Array<VariableState> variable_states_;
   const IndexMask &full_mask_;
 
  public:
-  VariableStates(LinearAllocator<> &linear_allocator,
+  VariableStates(ValueAllocator &value_allocator,
                  const Procedure &procedure,
                  const IndexMask &full_mask)
-      : value_allocator_(linear_allocator),
+      : value_allocator_(value_allocator),
         procedure_(procedure),
         variable_states_(procedure.variables().size()),
         full_mask_(full_mask)
@@ -1157,19 +1181,18 @@ class InstructionScheduler {
   }
 };
 
-void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context context) const
+static void execute_procedure(const ProcedureExecutor &fn,
+                              const Procedure &procedure,
+                              const IndexMask &full_mask,
+                              Params params,
+                              const Context &context,
+                              ValueAllocator &value_allocator)
 {
-  BLI_assert(procedure_.validate());
-
-  AlignedBuffer<512, 64> local_buffer;
-  LinearAllocator<> linear_allocator;
-  linear_allocator.provide_buffer(local_buffer);
-
-  VariableStates variable_states{linear_allocator, procedure_, full_mask};
-  variable_states.add_initial_variable_states(*this, procedure_, params);
+  VariableStates variable_states{value_allocator, procedure, full_mask};
+  variable_states.add_initial_variable_states(fn, procedure, params);
 
   InstructionScheduler scheduler;
-  scheduler.add_referenced_indices(*procedure_.entry(), full_mask);
+  scheduler.add_referenced_indices(*procedure.entry(), full_mask);
 
   /* Loop until all indices got to a return instruction. */
   while (!scheduler.is_done()) {
@@ -1218,9 +1241,9 @@ void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context
     }
   }
 
-  for (const int param_index : this->param_indices()) {
-    const ParamType param_type = this->param_type(param_index);
-    const Variable *variable = procedure_.params()[param_index].variable;
+  for (const int param_index : fn.param_indices()) {
+    const ParamType param_type = fn.param_type(param_index);
+    const Variable *variable = procedure.params()[param_index].variable;
     VariableState &variable_state = variable_states.get_variable_state(*variable);
     switch (param_type.interface_type()) {
       case ParamType::Input: {
@@ -1241,6 +1264,41 @@ void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context
   }
 }
 
+void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context context) const
+{
+  BLI_assert(procedure_.validate());
+
+  AlignedBuffer<512, 64> local_buffer;
+  LinearAllocator<> linear_allocator;
+  linear_allocator.provide_buffer(local_buffer);
+  ValueAllocator value_allocator{linear_allocator};
+
+  if (!supports_chunked_execution_ || full_mask.min_array_size() <= chunk_size) {
+    execute_procedure(*this, procedure_, full_mask, params, context, value_allocator);
+    return;
+  }
+
+  /* All chunks can use the same intermediate buffers, because they are freed again after every
+   * chunk. */
+  value_allocator.set_min_span_size(chunk_size);
+
+  int64_t chunk_mask_start = 0;
+  while (chunk_mask_start < full_mask.size()) {
+    const int64_t chunk_start = full_mask[chunk_mask_start];
+    const IndexMask chunk_mask = full_mask.slice_content(chunk_start, chunk_size);
+
+    IndexMaskMemory memory;
+    const IndexMask shifted_chunk_mask = chunk_mask.shift(-chunk_start, memory);
+    const IndexRange slice_range{chunk_start, shifted_chunk_mask.min_array_size()};
+
+    ParamsBuilder chunk_params{*this, &shifted_chunk_mask};
+    add_sliced_parameters(signature_, params, slice_range, chunk_params);
+    execute_procedure(*this, procedure_, shifted_chunk_mask, chunk_params, context, value_allocator);
+
+    chunk_mask_start += chunk_mask.size();
+  }
+}
+
 MultiFunction::ExecutionHints ProcedureExecutor::get_execution_hints() const
 {
   ExecutionHints hints;
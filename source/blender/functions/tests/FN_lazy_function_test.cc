@@ -70,6 +70,35 @@ class SimpleSideEffectProvider : public GraphExecutor::SideEffectProvider {
   }
 };
 
+class CheapAddLazyFunction : public AddLazyFunction {
+ public:
+  CheapAddLazyFunction()
+  {
+    is_cheap_ = true;
+  }
+};
+
+class CheapStoreValueFunction : public LazyFunction {
+ private:
+  int *dst_;
+
+ public:
+  CheapStoreValueFunction(int *dst) : dst_(dst)
+  {
+    debug_name_ = "Cheap Store Value";
+    is_cheap_ = true;
+    inputs_.append({"A", CPPType::get<int>()});
+    outputs_.append({"A", CPPType::get<int>()});
+  }
+
+  void execute_impl(Params &params, const Context & /*context*/) const override
+  {
+    const int a = params.get_input<int>(0);
+    *dst_ = a;
+    params.set_output(0, a);
+  }
+};
+
 TEST(lazy_function, SimpleAdd)
 {
   const AddLazyFunction add_fn;
@@ -116,6 +145,52 @@ TEST(lazy_function, SideEffects)
   EXPECT_EQ(dst2, 105);
 }
 
+TEST(lazy_function, StraightLineGroup)
+{
+  BLI_task_scheduler_init();
+  int stored = 0;
+
+  const CheapAddLazyFunction add_fn;
+  const CheapStoreValueFunction store_fn{&stored};
+
+  Graph graph;
+  GraphInputSocket &graph_input = graph.add_input(CPPType::get<int>());
+  GraphOutputSocket &graph_output = graph.add_output(CPPType::get<int>());
+  FunctionNode &store_node = graph.add_function(store_fn);
+  FunctionNode &add_node_1 = graph.add_function(add_fn);
+  FunctionNode &add_node_2 = graph.add_function(add_fn);
+  FunctionNode &add_node_3 = graph.add_function(add_fn);
+
+  /* All nodes are in a single group that ends with the last add node. */
+  graph.add_link(graph_input, store_node.input(0));
+  graph.add_link(store_node.output(0), add_node_1.input(0));
+  graph.add_link(add_node_1.output(0), add_node_2.input(0));
+  graph.add_link(add_node_1.output(0), add_node_2.input(1));
+  graph.add_link(add_node_2.output(0), add_node_3.input(0));
+  graph.add_link(graph_input, add_node_3.input(1));
+  graph.add_link(add_node_3.output(0), graph_output);
+
+  const int value_1 = 1;
+  add_node_1.input(1).set_default_value(&value_1);
+
+  graph.update_node_indices();
+
+  SimpleSideEffectProvider side_effect_provider{{&store_node}};
+
+  GraphExecutor executor_fn{
+      graph, {&graph_input}, {&graph_output}, nullptr, &side_effect_provider, nullptr};
+  ASSERT_EQ(executor_fn.straight_line_groups_num(), 1);
+  EXPECT_EQ(executor_fn.straight_line_group_nodes(0),
+            Span<const FunctionNode *>({&store_node, &add_node_1, &add_node_2, &add_node_3}));
+
+  int result = 0;
+  execute_lazy_function_eagerly(
+      executor_fn, nullptr, nullptr, std::make_tuple(10), std::make_tuple(&result));
+
+  EXPECT_EQ(stored, 10);
+  EXPECT_EQ(result, (10 + 1) * 2 + 10);
+}
+
 class PartialEvaluationTestFunction : public LazyFunction {
  public:
   PartialEvaluationTestFunction()
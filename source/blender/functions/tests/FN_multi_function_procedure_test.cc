@@ -392,6 +392,72 @@ TEST(multi_function_procedure, BufferReuse)
   EXPECT_EQ(results[4], 53);
 }
 
+TEST(multi_function_procedure, LargeMaskTest)
+{
+  /**
+   * procedure(int var1, int *var3) {
+   *   int var2 = var1 + var1;
+   *   bool var4 = var2 > 1000;
+   *   if (var4) {
+   *     var2 += 10;
+   *   }
+   *   var3 = var1 + var2;
+   * }
+   */
+
+  auto add_fn = build::SI2_SO<int, int, int>("add", [](int a, int b) { return a + b; });
+  auto greater_fn = build::SI1_SO<int, bool>("greater", [](int a) { return a > 1000; });
+  auto add_10_fn = build::SM<int>("add_10", [](int &a) { a += 10; });
+
+  Procedure procedure;
+  ProcedureBuilder builder{procedure};
+
+  Variable *var1 = &builder.add_single_input_parameter<int>();
+  auto [var2] = builder.add_call<1>(add_fn, {var1, var1});
+  auto [var4] = builder.add_call<1>(greater_fn, {var2});
+  ProcedureBuilder::Branch branch = builder.add_branch(*var4);
+  branch.branch_true.add_call(add_10_fn, {var2});
+  builder.set_cursor_after_branch(branch);
+  auto [var3] = builder.add_call<1>(add_fn, {var1, var2});
+  builder.add_destruct({var1, var2, var4});
+  builder.add_return();
+  builder.add_output_parameter(*var3);
+
+  EXPECT_TRUE(procedure.validate());
+
+  ProcedureExecutor procedure_fn{procedure};
+
+  /* Use a mask that is large enough to be split into multiple chunks, with gaps in it. */
+  const int size = 10000;
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      IndexRange(size), GrainSize(1024), memory, [](const int64_t i) {
+        return i % 3 != 0 && !IndexRange(4000, 3000).contains(i);
+      });
+
+  Array<int> inputs(size);
+  for (const int i : inputs.index_range()) {
+    inputs[i] = i;
+  }
+  Array<int> results(size, -1);
+
+  ParamsBuilder params{procedure_fn, &mask};
+  params.add_readonly_single_input(inputs.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+
+  ContextBuilder context;
+  procedure_fn.call(mask, params, context);
+
+  for (const int i : IndexRange(size)) {
+    if (mask.contains(i)) {
+      EXPECT_EQ(results[i], i * 3 + (i * 2 > 1000 ? 10 : 0));
+    }
+    else {
+      EXPECT_EQ(results[i], -1);
+    }
+  }
+}
+
 TEST(multi_function_procedure, OutputBufferReplaced)
 {
   Procedure procedure;
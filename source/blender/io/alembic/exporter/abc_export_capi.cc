@@ -15,6 +15,7 @@
 
 #include "DNA_scene_types.h"
 
+#include "BKE_callbacks.hh"
 #include "BKE_context.hh"
 #include "BKE_global.hh"
 #include "BKE_lib_id.hh"
@@ -24,7 +25,9 @@
 #include "BLI_fileops.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "WM_api.hh"
 #include "WM_types.hh"
@@ -34,11 +37,21 @@ static CLG_LogRef LOG = {"io.alembic"};
 
 #include <memory>
 
+/* Maximum number of dependency graphs evaluating frames of an animation at the same time. Every
+ * graph has its own evaluated copy of the scene. */
+static constexpr int EXPORT_FRAME_GRAPHS_MAX = 4;
+
 struct ExportJobData {
   Main *bmain;
   Depsgraph *depsgraph;
   wmWindowManager *wm;
 
+  /* Dependency graphs that evaluate the frames of an animation concurrently, see
+   * #DEG_evaluate_frames. When there are none, the frames are evaluated one after the other by
+   * changing the frame of the scene. */
+  Depsgraph *frame_depsgraphs[EXPORT_FRAME_GRAPHS_MAX];
+  int frame_depsgraphs_num;
+
   char filepath[FILE_MAX];
   AlembicExportParams params;
 
@@ -50,7 +63,7 @@ struct ExportJobData {
 namespace blender::io::alembic {
 
 /* Construct the depsgraph for exporting. */
-static bool build_depsgraph(ExportJobData *job)
+static bool build_depsgraph(ExportJobData *job, Depsgraph *depsgraph)
 {
   if (job->params.collection[0]) {
     Collection *collection = reinterpret_cast<Collection *>(
@@ -61,13 +74,13 @@ static bool build_depsgraph(ExportJobData *job)
       return false;
     }
 
-    DEG_graph_build_from_collection(job->depsgraph, collection);
+    DEG_graph_build_from_collection(depsgraph, collection);
   }
   else if (job->params.visible_objects_only) {
-    DEG_graph_build_from_view_layer(job->depsgraph);
+    DEG_graph_build_from_view_layer(depsgraph);
   }
   else {
-    DEG_graph_build_for_all_objects(job->depsgraph);
+    DEG_graph_build_for_all_objects(depsgraph);
   }
 
   return true;
@@ -102,9 +115,7 @@ static void export_startjob(void *customdata, wmJobWorkerStatus *worker_status)
     BKE_scene_graph_update_tagged(data->depsgraph, data->bmain);
   }
 
-  /* For restoring the current frame after exporting animation is done. */
   Scene *scene = DEG_get_input_scene(data->depsgraph);
-  const int orig_frame = scene->r.cfra;
   const bool export_animation = (data->params.frame_start != data->params.frame_end);
 
   /* Create the Alembic archive. */
@@ -136,11 +147,43 @@ static void export_startjob(void *customdata, wmJobWorkerStatus *worker_status)
 
   ABCHierarchyIterator iter(data->bmain, data->depsgraph, abc_archive.get(), data->params);
 
-  if (export_animation) {
+  /* Writing the animated frames is not 100% of the work, but it's our best guess. */
+  const float progress_per_frame = 1.0f / std::max(size_t(1), abc_archive->total_frame_count());
+
+  if (export_animation && data->frame_depsgraphs_num > 0) {
+    CLOG_INFO(&LOG, 2, "Exporting animation");
+
+    const Vector<double> frames(abc_archive->frames_begin(), abc_archive->frames_end());
+    const Vector<float> frames_float(frames.begin(), frames.end());
+    int64_t frame_index = 0;
+
+    /* Following frames are evaluated in other dependency graphs while a frame is written. The
+     * original scene is not changed. */
+    const Span<Depsgraph *> frame_depsgraphs(data->frame_depsgraphs, data->frame_depsgraphs_num);
+    DEG_evaluate_frames(
+        frame_depsgraphs, frames_float, [&](Depsgraph *depsgraph, float /*frame*/) {
+          if (G.is_break || worker_status->stop) {
+            return false;
+          }
+          const double frame = frames[frame_index++];
+
+          CLOG_INFO(&LOG, 2, "Exporting frame %.2f", frame);
+          ExportSubset export_subset = abc_archive->export_subset_for_frame(frame);
+          iter.set_depsgraph(depsgraph);
+          iter.set_export_subset(export_subset);
+          iter.iterate_and_write();
+
+          worker_status->progress += progress_per_frame;
+          worker_status->do_update = true;
+          return true;
+        });
+    iter.set_depsgraph(data->depsgraph);
+  }
+  else if (export_animation) {
     CLOG_INFO(&LOG, 2, "Exporting animation");
 
-    /* Writing the animated frames is not 100% of the work, but it's our best guess. */
-    const float progress_per_frame = 1.0f / std::max(size_t(1), abc_archive->total_frame_count());
+    /* Frame change handlers are registered, which only run when the frame of the scene changes. */
+    const int orig_frame = scene->r.cfra;
     ABCArchive::Frames::const_iterator frame_it = abc_archive->frames_begin();
     const ABCArchive::Frames::const_iterator frames_end = abc_archive->frames_end();
 
@@ -164,6 +207,12 @@ static void export_startjob(void *customdata, wmJobWorkerStatus *worker_status)
       worker_status->progress += progress_per_frame;
       worker_status->do_update = true;
     }
+
+    /* Finish up by going back to the keyframe that was current before we started. */
+    if (scene->r.cfra != orig_frame) {
+      scene->r.cfra = orig_frame;
+      BKE_scene_graph_update_for_newframe(data->depsgraph);
+    }
   }
   else {
     /* If we're not animating, a single iteration over all objects is enough. */
@@ -172,12 +221,6 @@ static void export_startjob(void *customdata, wmJobWorkerStatus *worker_status)
 
   iter.release_writers();
 
-  /* Finish up by going back to the keyframe that was current before we started. */
-  if (scene->r.cfra != orig_frame) {
-    scene->r.cfra = orig_frame;
-    BKE_scene_graph_update_for_newframe(data->depsgraph);
-  }
-
   data->export_ok = !data->was_canceled;
 
   worker_status->progress = 1.0f;
@@ -189,6 +232,9 @@ static void export_endjob(void *customdata)
   ExportJobData *data = static_cast<ExportJobData *>(customdata);
 
   DEG_graph_free(data->depsgraph);
+  for (int i = 0; i < data->frame_depsgraphs_num; i++) {
+    DEG_graph_free(data->frame_depsgraphs[i]);
+  }
 
   if (data->was_canceled && BLI_exists(data->filepath)) {
     BLI_delete(data->filepath, false, false);
@@ -224,10 +270,26 @@ bool ABC_export(Scene *scene,
    *
    * Has to be done from main thread currently, as it may affect Main original data (e.g. when
    * doing deferred update of the view-layers, see #112534 for details). */
-  if (!blender::io::alembic::build_depsgraph(job)) {
+  if (!blender::io::alembic::build_depsgraph(job, job->depsgraph)) {
     return false;
   }
 
+  /* Frames of an animation are evaluated in more dependency graphs, which are built here for the
+   * same reason. Frame change handlers are not run that way, so they are only used when there are
+   * no such handlers. */
+  job->frame_depsgraphs_num = 0;
+  if (params->frame_start != params->frame_end &&
+      !BKE_callback_has_active(BKE_CB_EVT_FRAME_CHANGE_PRE) &&
+      !BKE_callback_has_active(BKE_CB_EVT_FRAME_CHANGE_POST))
+  {
+    const int graphs_num = std::min(BLI_system_thread_count(), EXPORT_FRAME_GRAPHS_MAX);
+    for (int i = 0; i < graphs_num; i++) {
+      Depsgraph *depsgraph = DEG_graph_new(job->bmain, scene, view_layer, params->evaluation_mode);
+      blender::io::alembic::build_depsgraph(job, depsgraph);
+      job->frame_depsgraphs[job->frame_depsgraphs_num++] = depsgraph;
+    }
+  }
+
   bool export_ok = false;
   if (as_background_job) {
     wmJob *wm_job = WM_jobs_get(job->wm,
@@ -143,7 +143,6 @@ ABCWriterConstructorArgs ABCHierarchyIterator::writer_constructor_args(
     const HierarchyContext *context) const
 {
   ABCWriterConstructorArgs constructor_args;
-  constructor_args.depsgraph = depsgraph_;
   constructor_args.abc_archive = abc_archive_;
   constructor_args.abc_parent = get_alembic_parent(context);
   constructor_args.abc_name = context->export_name;
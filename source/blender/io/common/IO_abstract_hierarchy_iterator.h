@@ -231,6 +231,12 @@ class AbstractHierarchyIterator {
    * previous iteration. */
   void set_export_subset(ExportSubset export_subset);
 
+  /* Use another depsgraph for the following iterations, built for the same scene. This allows
+   * exporting frames which are evaluated by different dependency graphs. Writers should get the
+   * depsgraph from the iterator, rather than keeping it. */
+  void set_depsgraph(Depsgraph *depsgraph);
+  Depsgraph *depsgraph() const;
+
   /* Convert the given name to something that is valid for the exported file format.
    * This base implementation is a no-op; override in a concrete subclass. */
   virtual std::string make_valid_name(const std::string &name) const;
@@ -199,6 +199,21 @@ void AbstractHierarchyIterator::set_export_subset(ExportSubset export_subset)
   export_subset_ = export_subset;
 }
 
+void AbstractHierarchyIterator::set_depsgraph(Depsgraph *depsgraph)
+{
+  if (depsgraph == depsgraph_) {
+    return;
+  }
+  depsgraph_ = depsgraph;
+  /* Contains evaluated IDs of the previous depsgraph. */
+  duplisource_export_path_.clear();
+}
+
+Depsgraph *AbstractHierarchyIterator::depsgraph() const
+{
+  return depsgraph_;
+}
+
 std::string AbstractHierarchyIterator::make_valid_name(const std::string &name) const
 {
   return name;
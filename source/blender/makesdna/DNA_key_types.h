@@ -15,6 +15,8 @@
 #include "DNA_defs.h"
 #include "DNA_listBase.h"
 
+#include "BLI_implicit_sharing.h"
+
 struct AnimData;
 struct Ipo;
 
@@ -45,6 +47,17 @@ typedef struct KeyBlock {
 
   /** array of shape key values, size is `(Key->elemsize * KeyBlock->totelem)` */
   void *data;
+  /**
+   * Sharing info corresponding to the data above, it is shared with the evaluated copies of the
+   * key. Use #BKE_keyblock_data_free, #BKE_keyblock_data_replace and #BKE_keyblock_data_for_write
+   * to free, replace or modify the data. This is run-time data.
+   */
+  const ImplicitSharingInfoHandle *data_sharing_info;
+  /**
+   * Address of the data before #BKE_keyblock_data_for_write copied it last, so that RNA pointers
+   * into the old data can be mapped to the new data. Never dereferenced. This is run-time data.
+   */
+  const void *data_previous;
   /** MAX_NAME (unique name, user assigned) */
   char name[64];
   /** MAX_VGROUP_NAME (optional vertex group), array gets allocated into 'weights' when set */
@@ -761,7 +761,8 @@ typedef struct UserDef_Experimental {
   char use_shader_node_previews;
   char use_animation_baklava;
   char enable_new_cpu_compositor;
-  char _pad[2];
+  char use_incremental_depsgraph_relations;
+  char _pad[1];
   /** `makesdna` does not allow empty structs. */
 } UserDef_Experimental;
 
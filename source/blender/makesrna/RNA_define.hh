@@ -440,6 +440,12 @@ void RNA_def_property_ui_icon(PropertyRNA *prop, int icon, int consecutive);
 void RNA_def_property_update(PropertyRNA *prop, int noteflag, const char *updatefunc);
 void RNA_def_property_editable_func(PropertyRNA *prop, const char *editable);
 void RNA_def_property_editable_array_func(PropertyRNA *prop, const char *editable);
+/**
+ * Allow reading a float property stored in DNA as raw array (used by `foreach_get`), even though
+ * it has custom get and set functions. They must behave like plain reads and writes of the DNA
+ * member apart from finding the up-to-date data. Writing always uses the set function.
+ */
+void RNA_def_property_raw_access_read_only(PropertyRNA *prop);
 
 /**
  * Set custom callbacks for override operations handling.
@@ -2152,7 +2152,9 @@ static void rna_def_property_funcs(FILE *f, StructRNA *srna, PropertyDefRNA *dp)
       }
 
       if (!prop->arraydimension) {
-        if (!fprop->get && !fprop->set) {
+        if ((!fprop->get && !fprop->set) ||
+            (prop->flag_internal & PROP_INTERN_RAW_ACCESS_READ_ONLY))
+        {
           rna_set_raw_property(dp, prop);
         }
 
@@ -2162,7 +2164,9 @@ static void rna_def_property_funcs(FILE *f, StructRNA *srna, PropertyDefRNA *dp)
             rna_def_property_set_func(f, srna, prop, dp, (const char *)fprop->set));
       }
       else {
-        if (!fprop->getarray && !fprop->setarray) {
+        if ((!fprop->getarray && !fprop->setarray) ||
+            (prop->flag_internal & PROP_INTERN_RAW_ACCESS_READ_ONLY))
+        {
           rna_set_raw_property(dp, prop);
         }
 
@@ -4598,7 +4598,8 @@ int RNA_property_collection_raw_array(
   BLI_assert(RNA_property_type(prop) == PROP_COLLECTION);
 
   if (!(prop->flag_internal & PROP_INTERN_RAW_ARRAY) ||
-      !(itemprop->flag_internal & PROP_INTERN_RAW_ACCESS))
+      !(itemprop->flag_internal & PROP_INTERN_RAW_ACCESS) ||
+      (set && (itemprop->flag_internal & PROP_INTERN_RAW_ACCESS_READ_ONLY)))
   {
     return 0;
   }
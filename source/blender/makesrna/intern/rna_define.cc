@@ -2937,6 +2937,16 @@ void RNA_def_property_editable_func(PropertyRNA *prop, const char *editable)
   }
 }
 
+void RNA_def_property_raw_access_read_only(PropertyRNA *prop)
+{
+  if (!DefRNA.preprocess) {
+    CLOG_ERROR(&LOG, "only during preprocessing.");
+    return;
+  }
+
+  prop->flag_internal |= PROP_INTERN_RAW_ACCESS_READ_ONLY;
+}
+
 void RNA_def_property_editable_array_func(PropertyRNA *prop, const char *editable)
 {
   if (!DefRNA.preprocess) {
@@ -281,6 +281,22 @@ static void rna_Depsgraph_debug_stats_gnuplot(Depsgraph *depsgraph,
   fclose(f);
 }
 
+static void rna_Depsgraph_debug_trace_begin()
+{
+  DEG_debug_trace_begin();
+}
+
+static void rna_Depsgraph_debug_trace_end(ReportList *reports, const char *filepath)
+{
+  if (!DEG_debug_trace_is_active()) {
+    BKE_report(reports, RPT_ERROR, "No evaluation trace is being recorded");
+    return;
+  }
+  if (!DEG_debug_trace_end(filepath)) {
+    BKE_reportf(reports, RPT_ERROR, "Could not write evaluation trace to \"%s\"", filepath);
+  }
+}
+
 static void rna_Depsgraph_debug_tag_update(Depsgraph *depsgraph)
 {
   DEG_graph_tag_relations_update(depsgraph);
@@ -732,6 +748,21 @@ static void rna_def_depsgraph(BlenderRNA *brna)
                                   "File name where gnuplot script will save the result");
   RNA_def_parameter_flags(parm, PropertyFlag(0), PARM_REQUIRED);
 
+  func = RNA_def_function(srna, "debug_trace_begin", "rna_Depsgraph_debug_trace_begin");
+  RNA_def_function_ui_description(
+      func, "Start recording the timeline of the evaluation of all dependency graphs");
+  RNA_def_function_flag(func, FUNC_NO_SELF);
+
+  func = RNA_def_function(srna, "debug_trace_end", "rna_Depsgraph_debug_trace_end");
+  RNA_def_function_ui_description(
+      func,
+      "Stop recording the evaluation timeline and write it as a Chrome trace event file, which "
+      "can be opened in Perfetto");
+  RNA_def_function_flag(func, FUNC_NO_SELF | FUNC_USE_REPORTS);
+  parm = RNA_def_string_file_path(
+      func, "filepath", nullptr, FILE_MAX, "File Name", "Output path for the JSON trace file");
+  RNA_def_parameter_flags(parm, PropertyFlag(0), PARM_REQUIRED);
+
   func = RNA_def_function(srna, "debug_tag_update", "rna_Depsgraph_debug_tag_update");
 
   func = RNA_def_function(srna, "debug_stats", "rna_Depsgraph_debug_stats");
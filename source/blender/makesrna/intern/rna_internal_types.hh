@@ -395,6 +395,8 @@ enum PropertyFlagIntern {
   /* Negative mirror of PROP_PTR_NO_OWNERSHIP, used to prevent automatically setting that one in
    * makesrna when pointer is an ID... */
   PROP_INTERN_PTR_OWNERSHIP_FORCED = (1 << 5),
+  /* Raw access is only used to read the property, writes go through its set function. */
+  PROP_INTERN_RAW_ACCESS_READ_ONLY = (1 << 6),
 };
 
 /* Property Types */
@@ -327,9 +327,39 @@ static void rna_ShapeKey_relative_key_set(PointerRNA *ptr,
   kb->relative = rna_object_shapekey_index_set(ptr->owner_id, value, kb->relative);
 }
 
+/**
+ * Get the data of a shape key point for reading or writing. Key-block data is shared with the
+ * evaluated copies of the key and is only copied when it is modified, which moves it. Pointers
+ * that were created before that still refer to the previous data and are mapped to the new data.
+ */
+static float *rna_ShapeKeyPoint_data(PointerRNA *ptr, const bool for_write)
+{
+  Key *key = rna_ShapeKey_find_key(ptr->owner_id);
+  if (key == nullptr) {
+    return static_cast<float *>(ptr->data);
+  }
+  const char *point = static_cast<const char *>(ptr->data);
+  /* Check the current data of all key-blocks first, the previous data may have been freed and its
+   * address may be used by another key-block now. */
+  for (const bool use_previous : {false, true}) {
+    LISTBASE_FOREACH (KeyBlock *, kb, &key->block) {
+      const char *start = static_cast<const char *>(use_previous ? kb->data_previous : kb->data);
+      if (start == nullptr || point < start ||
+          point >= start + int64_t(key->elemsize) * kb->totelem)
+      {
+        continue;
+      }
+      char *data = static_cast<char *>(for_write ? BKE_keyblock_data_for_write(kb) : kb->data);
+      ptr->data = data + (point - start);
+      return static_cast<float *>(ptr->data);
+    }
+  }
+  return static_cast<float *>(ptr->data);
+}
+
 static void rna_ShapeKeyPoint_co_get(PointerRNA *ptr, float *values)
 {
-  float *vec = (float *)ptr->data;
+  const float *vec = rna_ShapeKeyPoint_data(ptr, false);
 
   values[0] = vec[0];
   values[1] = vec[1];
@@ -338,7 +368,7 @@ static void rna_ShapeKeyPoint_co_get(PointerRNA *ptr, float *values)
 
 static void rna_ShapeKeyPoint_co_set(PointerRNA *ptr, const float *values)
 {
-  float *vec = (float *)ptr->data;
+  float *vec = rna_ShapeKeyPoint_data(ptr, true);
 
   vec[0] = values[0];
   vec[1] = values[1];
@@ -347,32 +377,32 @@ static void rna_ShapeKeyPoint_co_set(PointerRNA *ptr, const float *values)
 
 static float rna_ShapeKeyCurvePoint_tilt_get(PointerRNA *ptr)
 {
-  float *vec = (float *)ptr->data;
+  const float *vec = rna_ShapeKeyPoint_data(ptr, false);
   return vec[3];
 }
 
 static void rna_ShapeKeyCurvePoint_tilt_set(PointerRNA *ptr, float value)
 {
-  float *vec = (float *)ptr->data;
+  float *vec = rna_ShapeKeyPoint_data(ptr, true);
   vec[3] = value;
 }
 
 static float rna_ShapeKeyCurvePoint_radius_get(PointerRNA *ptr)
 {
-  float *vec = (float *)ptr->data;
+  const float *vec = rna_ShapeKeyPoint_data(ptr, false);
   return vec[4];
 }
 
 static void rna_ShapeKeyCurvePoint_radius_set(PointerRNA *ptr, float value)
 {
-  float *vec = (float *)ptr->data;
+  float *vec = rna_ShapeKeyPoint_data(ptr, true);
   CLAMP_MIN(value, 0.0f);
   vec[4] = value;
 }
 
 static void rna_ShapeKeyBezierPoint_co_get(PointerRNA *ptr, float *values)
 {
-  float *vec = (float *)ptr->data;
+  const float *vec = rna_ShapeKeyPoint_data(ptr, false);
 
   values[0] = vec[0 + 3];
   values[1] = vec[1 + 3];
@@ -381,7 +411,7 @@ static void rna_ShapeKeyBezierPoint_co_get(PointerRNA *ptr, float *values)
 
 static void rna_ShapeKeyBezierPoint_co_set(PointerRNA *ptr, const float *values)
 {
-  float *vec = (float *)ptr->data;
+  float *vec = rna_ShapeKeyPoint_data(ptr, true);
 
   vec[0 + 3] = values[0];
   vec[1 + 3] = values[1];
@@ -390,7 +420,7 @@ static void rna_ShapeKeyBezierPoint_co_set(PointerRNA *ptr, const float *values)
 
 static void rna_ShapeKeyBezierPoint_handle_1_co_get(PointerRNA *ptr, float *values)
 {
-  float *vec = (float *)ptr->data;
+  const float *vec = rna_ShapeKeyPoint_data(ptr, false);
 
   values[0] = vec[0];
   values[1] = vec[1];
@@ -399,7 +429,7 @@ static void rna_ShapeKeyBezierPoint_handle_1_co_get(PointerRNA *ptr, float *valu
 
 static void rna_ShapeKeyBezierPoint_handle_1_co_set(PointerRNA *ptr, const float *values)
 {
-  float *vec = (float *)ptr->data;
+  float *vec = rna_ShapeKeyPoint_data(ptr, true);
 
   vec[0] = values[0];
   vec[1] = values[1];
@@ -408,7 +438,7 @@ static void rna_ShapeKeyBezierPoint_handle_1_co_set(PointerRNA *ptr, const float
 
 static void rna_ShapeKeyBezierPoint_handle_2_co_get(PointerRNA *ptr, float *values)
 {
-  float *vec = (float *)ptr->data;
+  const float *vec = rna_ShapeKeyPoint_data(ptr, false);
 
   values[0] = vec[6 + 0];
   values[1] = vec[6 + 1];
@@ -417,7 +447,7 @@ static void rna_ShapeKeyBezierPoint_handle_2_co_get(PointerRNA *ptr, float *valu
 
 static void rna_ShapeKeyBezierPoint_handle_2_co_set(PointerRNA *ptr, const float *values)
 {
-  float *vec = (float *)ptr->data;
+  float *vec = rna_ShapeKeyPoint_data(ptr, true);
 
   vec[6 + 0] = values[0];
   vec[6 + 1] = values[1];
@@ -426,25 +456,25 @@ static void rna_ShapeKeyBezierPoint_handle_2_co_set(PointerRNA *ptr, const float
 
 static float rna_ShapeKeyBezierPoint_tilt_get(PointerRNA *ptr)
 {
-  float *vec = (float *)ptr->data;
+  const float *vec = rna_ShapeKeyPoint_data(ptr, false);
   return vec[9];
 }
 
 static void rna_ShapeKeyBezierPoint_tilt_set(PointerRNA *ptr, float value)
 {
-  float *vec = (float *)ptr->data;
+  float *vec = rna_ShapeKeyPoint_data(ptr, true);
   vec[9] = value;
 }
 
 static float rna_ShapeKeyBezierPoint_radius_get(PointerRNA *ptr)
 {
-  float *vec = (float *)ptr->data;
+  const float *vec = rna_ShapeKeyPoint_data(ptr, false);
   return vec[10];
 }
 
 static void rna_ShapeKeyBezierPoint_radius_set(PointerRNA *ptr, float value)
 {
-  float *vec = (float *)ptr->data;
+  float *vec = rna_ShapeKeyPoint_data(ptr, true);
   CLAMP_MIN(value, 0.0f);
   vec[10] = value;
 }
@@ -597,7 +627,7 @@ static void rna_ShapeKey_data_begin(CollectionPropertyIterator *iter, PointerRNA
     }
   }
 
-  rna_iterator_array_begin(iter, (void *)kb->data, size, tot, 0, nullptr);
+  rna_iterator_array_begin(iter, kb->data, size, tot, 0, nullptr);
 }
 
 static int rna_ShapeKey_data_length(PointerRNA *ptr)
@@ -679,7 +709,7 @@ static void rna_ShapeKey_points_begin(CollectionPropertyIterator *iter, PointerR
     /* Legacy curves have only curve points and bezier points. */
     tot = 0;
   }
-  rna_iterator_array_begin(iter, (void *)kb->data, key->elemsize, tot, 0, nullptr);
+  rna_iterator_array_begin(iter, kb->data, key->elemsize, tot, 0, nullptr);
 }
 
 static int rna_ShapeKey_points_length(PointerRNA *ptr)
@@ -824,7 +854,8 @@ static std::optional<std::string> rna_ShapeKeyPoint_path(const PointerRNA *ptr)
   ID *id = ptr->owner_id;
   Key *key = rna_ShapeKey_find_key(ptr->owner_id);
   KeyBlock *kb;
-  float *point = (float *)ptr->data;
+  PointerRNA point_ptr = *ptr;
+  float *point = rna_ShapeKeyPoint_data(&point_ptr, false);
 
   /* if we can get a key block, we can construct a path */
   kb = rna_ShapeKeyData_find_keyblock(key, point);
@@ -866,6 +897,10 @@ static void rna_def_keydata(BlenderRNA *brna)
   prop = RNA_def_property(srna, "co", PROP_FLOAT, PROP_TRANSLATION);
   RNA_def_property_float_sdna(prop, nullptr, "x");
   RNA_def_property_array(prop, 3);
+  /* The data is made mutable when it is set, reading can still use raw access. */
+  RNA_def_property_float_funcs(
+      prop, "rna_ShapeKeyPoint_co_get", "rna_ShapeKeyPoint_co_set", nullptr);
+  RNA_def_property_raw_access_read_only(prop);
   RNA_def_property_ui_text(prop, "Location", "");
   RNA_def_property_update(prop, 0, "rna_Key_update_data");
 
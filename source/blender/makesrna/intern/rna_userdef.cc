@@ -7571,6 +7571,14 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, nullptr, "enable_new_cpu_compositor", 1);
   RNA_def_property_ui_text(prop, "CPU Compositor", "Enable the new CPU compositor");
 
+  prop = RNA_def_property(srna, "use_incremental_depsgraph_relations", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "use_incremental_depsgraph_relations", 1);
+  RNA_def_property_ui_text(prop,
+                           "Incremental Dependency Graph Relations",
+                           "When a constraint or a driver is added, only update relations of the "
+                           "object it was added to, instead of re-building the dependency graph "
+                           "of the whole scene");
+
   prop = RNA_def_property(srna, "use_all_linked_data_direct", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(
       prop,
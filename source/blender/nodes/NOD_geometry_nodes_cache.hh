@@ -0,0 +1,83 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup nodes
+ *
+ * Caches the outputs of node group evaluations across multiple evaluations of the modifier. When
+ * a node group is evaluated again in the same compute context with the same inputs, the outputs
+ * of the previous evaluation are reused instead of evaluating the group again. This avoids
+ * recomputing expensive parts of a node tree when only nodes after them changed.
+ *
+ * The group is still evaluated lazily. The cache key only contains the inputs that have actually
+ * been used by the group. To find a cached result, the inputs that were used by the previous
+ * evaluation in the same compute context are requested. If the values of those inputs did not
+ * change, the group makes the same decisions and uses the same inputs again, so the outputs are
+ * the same as well.
+ *
+ * Input geometries are identified by the implicitly shared arrays they reference and the versions
+ * of those arrays. That works across evaluations because the geometry passed to the modifier
+ * shares its data with the original geometry when it has not changed.
+ *
+ * The cached values are stored in the global #memory_cache, so they are freed automatically
+ * when the cache becomes too large. Additionally, only a few results are kept per compute
+ * context, so that inputs which change all the time (e.g. when they are animated) don't fill the
+ * cache with results that are never used again.
+ */
+
+#include "BLI_compute_context.hh"
+#include "BLI_linear_allocator.hh"
+
+#include "FN_lazy_function.hh"
+
+struct bNodeTree;
+
+namespace blender::nodes {
+struct GeometryNodesLazyFunctionGraphInfo;
+}
+
+namespace blender::nodes::geo_eval_cache {
+
+namespace lf = fn::lazy_function;
+
+/**
+ * Whether the outputs of the node tree only depend on its inputs, which is required for caching
+ * them. That is not the case if it or one of its nested node groups contains nodes that read
+ * other data, like the scene time, objects, fonts or files, or nodes that have side effects.
+ */
+bool node_tree_is_deterministic(const bNodeTree &tree);
+
+/**
+ * State of a single cached evaluation of a node group. It is stored in the storage of the
+ * lazy-function that calls the group.
+ */
+struct GroupCallStorage;
+
+GroupCallStorage *init_group_call_storage(LinearAllocator<> &allocator,
+                                          const GeometryNodesLazyFunctionGraphInfo &graph_info);
+/**
+ * Adds the outputs of the evaluation to the cache, if they have been computed lazily.
+ */
+void destruct_group_call_storage(GroupCallStorage *storage);
+
+/**
+ * Evaluate the node group or use cached outputs. Like any other lazy-function, this has to be
+ * called until all required outputs are set.
+ *
+ * \param group_context: Context used to evaluate the group lazy-function. Its storage belongs
+ *   to the group lazy-function and its user data contains the compute context of the group.
+ */
+void execute_group(GroupCallStorage &storage,
+                   lf::Params &params,
+                   const lf::Context &group_context);
+
+/**
+ * Free all cached results of a node group. This is called when the lazy-function graph of the
+ * group is freed, because its results can't be looked up anymore afterwards.
+ */
+void remove_graph(uint64_t graph_session_uid);
+
+}  // namespace blender::nodes::geo_eval_cache
@@ -22,10 +22,13 @@
 
 #include <variant>
 
+#include "MEM_guardedalloc.h"
+
 #include "FN_lazy_function_graph.hh"
 #include "FN_lazy_function_graph_executor.hh"
 
 #include "NOD_geometry_nodes_log.hh"
+#include "NOD_geometry_nodes_profile.hh"
 #include "NOD_multi_function.hh"
 
 #include "BLI_compute_context.hh"
@@ -424,6 +427,13 @@ struct GeometryNodesLazyFunctionGraphInfo {
    * This can be used as a simple heuristic for the complexity of the node group.
    */
   int num_inline_nodes_approximate = 0;
+  /**
+   * Identifies this graph. It is never reused, even when the graph is rebuilt for the same node
+   * tree, so it can be used to identify results of previous evaluations.
+   */
+  uint64_t session_uid = 0;
+
+  ~GeometryNodesLazyFunctionGraphInfo();
 };
 
 std::unique_ptr<LazyFunction> get_simulation_output_lazy_function(
@@ -479,10 +489,17 @@ class ScopedComputeContextTimer {
  private:
   lf::Context &context_;
   geo_eval_log::TimePoint start_;
+  /** Only used when #geo_eval_profile is active. */
+  bool use_profile_ = false;
+  size_t memory_start_ = 0;
 
  public:
   ScopedComputeContextTimer(lf::Context &entered_context) : context_(entered_context)
   {
+    if (geo_eval_profile::is_active()) {
+      use_profile_ = true;
+      memory_start_ = MEM_get_memory_in_use();
+    }
     start_ = geo_eval_log::Clock::now();
   }
 
@@ -495,6 +512,14 @@ class ScopedComputeContextTimer {
     {
       tree_logger->execution_time += (end - start_);
     }
+    if (use_profile_) {
+      const int64_t memory_delta = int64_t(MEM_get_memory_in_use()) - int64_t(memory_start_);
+      geo_eval_profile::add_compute_context_execution(user_data.compute_context,
+                                                      user_data.call_data->self_object(),
+                                                      start_,
+                                                      end,
+                                                      memory_delta);
+    }
   }
 };
 
@@ -506,10 +531,18 @@ class ScopedNodeTimer {
   const lf::Context &context_;
   const bNode &node_;
   geo_eval_log::TimePoint start_;
+  /** Only used when #geo_eval_profile is active. */
+  bool use_profile_ = false;
+  size_t memory_start_ = 0;
+  int64_t input_elements_num_ = -1;
 
  public:
   ScopedNodeTimer(const lf::Context &context, const bNode &node) : context_(context), node_(node)
   {
+    if (geo_eval_profile::is_active()) {
+      use_profile_ = true;
+      memory_start_ = MEM_get_memory_in_use();
+    }
     start_ = geo_eval_log::Clock::now();
   }
 
@@ -523,6 +556,26 @@ class ScopedNodeTimer {
       tree_logger->node_execution_times.append(*tree_logger->allocator,
                                                {node_.identifier, start_, end});
     }
+    if (use_profile_) {
+      const int64_t memory_delta = int64_t(MEM_get_memory_in_use()) - int64_t(memory_start_);
+      geo_eval_profile::add_node_execution(user_data.compute_context,
+                                           user_data.call_data->self_object(),
+                                           node_,
+                                           start_,
+                                           end,
+                                           memory_delta,
+                                           input_elements_num_);
+    }
+  }
+
+  bool is_profiled() const
+  {
+    return use_profile_;
+  }
+
+  void set_input_elements_num(const int64_t elements_num)
+  {
+    input_elements_num_ = elements_num;
   }
 };
 
@@ -254,6 +254,27 @@ class GeoTreeLogger {
   void log_viewer_node(const bNode &viewer_node, bke::GeometrySet geometry);
 };
 
+/**
+ * Copy of the data that has been logged in a compute context, which can be added to another
+ * #GeoModifierLog later on. This is used when the evaluation of a node group is skipped because
+ * its outputs are cached. Socket values, viewer geometries and debug messages are not included.
+ */
+struct CapturedTreeLog {
+  struct AttributeUsageWithNode {
+    int32_t node_id;
+    std::string attribute_name;
+    NamedAttributeUsage usage;
+  };
+
+  ComputeContextHash hash;
+  std::optional<ComputeContextHash> parent_hash;
+  std::optional<int32_t> parent_node_id;
+  std::chrono::nanoseconds execution_time{};
+  Vector<GeoTreeLogger::WarningWithNode> node_warnings;
+  Vector<GeoTreeLogger::NodeExecutionTime> node_execution_times;
+  Vector<AttributeUsageWithNode> used_named_attributes;
+};
+
 /**
  * Contains data that has been logged for a specific node in a context. So when the node is in a
  * node group that is used multiple times, there will be a different #GeoNodeLog for every
@@ -378,6 +399,18 @@ class GeoModifierLog {
    */
   GeoTreeLogger &get_local_tree_logger(const ComputeContext &compute_context);
 
+  /**
+   * Copy the data logged in all compute contexts. This must not be called while other threads
+   * are still logging.
+   */
+  Vector<CapturedTreeLog> capture_tree_logs();
+
+  /**
+   * Add data that has been captured from another log to the loggers of the current thread, as if
+   * it had been logged in this evaluation.
+   */
+  void add_captured_tree_logs(Span<CapturedTreeLog> tree_logs);
+
   /**
    * Get a log a specific node tree instance.
    */
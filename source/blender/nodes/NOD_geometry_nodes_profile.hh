@@ -0,0 +1,75 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup nodes
+ *
+ * Profiling of geometry nodes evaluation that does not depend on the user interface, so that it
+ * also works when rendering from the command line. Contrary to #geo_eval_log, which is only used
+ * for the active depsgraph, all evaluations are recorded while the profile is active.
+ *
+ * For every execution of a node (including node groups and zones) the wall time, the thread, the
+ * change of memory usage and the number of elements in the input geometries are recorded. The
+ * profile is written in the Chrome trace event format, which is JSON and can be opened in
+ * `chrome://tracing` or Perfetto.
+ */
+
+#include <chrono>
+#include <cstdint>
+
+struct bNode;
+struct Object;
+namespace blender {
+class ComputeContext;
+namespace bke {
+struct GeometrySet;
+}
+}  // namespace blender
+
+namespace blender::nodes::geo_eval_profile {
+
+using Clock = std::chrono::steady_clock;
+using TimePoint = Clock::time_point;
+
+/** Start recording, previously recorded data is discarded. */
+void begin();
+/**
+ * Stop recording and write the profile to the given file.
+ * \return False when the profile was not active or the file could not be written.
+ */
+bool end(const char *filepath);
+bool is_active();
+
+/**
+ * Record a single execution of a node on the calling thread.
+ *
+ * \param memory_delta: Change of the total memory usage during the execution. It also contains
+ * allocations of other nodes that are evaluated at the same time.
+ * \param input_elements_num: Number of elements in all input geometries, or -1 if unknown.
+ */
+void add_node_execution(const ComputeContext *compute_context,
+                        const Object *self_object,
+                        const bNode &node,
+                        TimePoint start,
+                        TimePoint end,
+                        int64_t memory_delta,
+                        int64_t input_elements_num);
+
+/**
+ * Record the time spent in a compute context, e.g. the evaluation of a node group.
+ *
+ * \param memory_delta: Change of the total memory usage, see #add_node_execution.
+ */
+void add_compute_context_execution(const ComputeContext *compute_context,
+                                   const Object *self_object,
+                                   TimePoint start,
+                                   TimePoint end,
+                                   int64_t memory_delta);
+
+/** Number of elements in all domains of all components of the geometry. */
+int64_t geometry_elements_num(const bke::GeometrySet &geometry);
+
+}  // namespace blender::nodes::geo_eval_profile
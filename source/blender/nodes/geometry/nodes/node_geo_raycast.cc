@@ -100,31 +100,38 @@ static void raycast_to_mesh(const IndexMask &mask,
                             const MutableSpan<float> r_hit_distances)
 {
   BVHTreeFromMesh tree_data;
-  BKE_bvhtree_from_mesh_get(&tree_data, &mesh, BVHTREE_FROM_CORNER_TRIS, 4);
+  BKE_bvhtree_from_mesh_wide_get(tree_data, mesh, BVHTREE_FROM_CORNER_TRIS);
   BLI_SCOPED_DEFER([&]() { free_bvhtree_from_mesh(&tree_data); });
 
-  if (tree_data.tree == nullptr) {
+  if (tree_data.wide_tree == nullptr) {
     return;
   }
   /* We shouldn't be rebuilding the BVH tree when calling this function in parallel. */
   BLI_assert(tree_data.cached);
 
-  mask.foreach_index([&](const int i) {
-    const float ray_length = ray_lengths[i];
-    const float3 ray_origin = ray_origins[i];
-    const float3 ray_direction = ray_directions[i];
-
-    BVHTreeRayHit hit;
-    hit.index = -1;
-    hit.dist = ray_length;
-    if (BLI_bvhtree_ray_cast(tree_data.tree,
-                             ray_origin,
-                             ray_direction,
-                             0.0f,
-                             &hit,
-                             tree_data.raycast_callback,
-                             &tree_data) != -1)
-    {
+  /* The rays are indexed by their position in the mask, so that their size only depends on the
+   * size of the mask, which is usually a small chunk of a larger domain. */
+  Array<float3> origins(mask.size());
+  Array<float3> directions(mask.size());
+  ray_origins.materialize_compressed(mask, origins);
+  ray_directions.materialize_compressed(mask, directions);
+  Array<BVHTreeRayHit> hits(mask.size());
+  mask.foreach_index([&](const int i, const int pos) {
+    hits[pos].index = -1;
+    hits[pos].dist = ray_lengths[i];
+  });
+  BKE_bvhtree_from_mesh_ray_cast_batch(tree_data,
+                                       IndexMask(mask.size()),
+                                       origins,
+                                       directions,
+                                       0.0f,
+                                       hits,
+                                       tree_data.raycast_callback,
+                                       &tree_data);
+
+  mask.foreach_index([&](const int i, const int pos) {
+    const BVHTreeRayHit &hit = hits[pos];
+    if (hit.index != -1) {
       if (!r_hit.is_empty()) {
         r_hit[i] = hit.index >= 0;
       }
@@ -156,7 +163,7 @@ static void raycast_to_mesh(const IndexMask &mask,
         r_hit_normals[i] = float3(0.0f, 0.0f, 0.0f);
       }
       if (!r_hit_distances.is_empty()) {
-        r_hit_distances[i] = ray_length;
+        r_hit_distances[i] = ray_lengths[i];
       }
     }
   });
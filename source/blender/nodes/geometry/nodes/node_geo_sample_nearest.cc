@@ -29,13 +29,24 @@ void get_closest_in_bvhtree(BVHTreeFromMesh &tree_data,
   BLI_assert(positions.size() >= r_distances_sq.size());
   BLI_assert(positions.size() >= r_positions.size());
 
-  mask.foreach_index([&](const int i) {
-    BVHTreeNearest nearest;
+  /* The queries are indexed by their position in the mask, so that their size only depends on the
+   * size of the mask, which is usually a small chunk of a larger domain. */
+  Array<float3> query_positions(mask.size());
+  positions.materialize_compressed(mask, query_positions);
+  Array<BVHTreeNearest> nearests(mask.size());
+  for (BVHTreeNearest &nearest : nearests) {
     nearest.index = -1;
     nearest.dist_sq = FLT_MAX;
-    const float3 position = positions[i];
-    BLI_bvhtree_find_nearest(
-        tree_data.tree, position, &nearest, tree_data.nearest_callback, &tree_data);
+  }
+  BKE_bvhtree_from_mesh_find_nearest_batch(tree_data,
+                                           IndexMask(mask.size()),
+                                           query_positions,
+                                           nearests,
+                                           tree_data.nearest_callback,
+                                           &tree_data);
+
+  mask.foreach_index([&](const int i, const int pos) {
+    const BVHTreeNearest &nearest = nearests[pos];
     if (!r_indices.is_empty()) {
       r_indices[i] = nearest.index;
     }
@@ -88,13 +99,22 @@ static void get_closest_pointcloud_points(const PointCloud &pointcloud,
     return;
   }
 
-  mask.foreach_index([&](const int i) {
-    BVHTreeNearest nearest;
+  Array<float3> query_positions(mask.size());
+  positions.materialize_compressed(mask, query_positions);
+  Array<BVHTreeNearest> nearests(mask.size());
+  for (BVHTreeNearest &nearest : nearests) {
     nearest.index = -1;
     nearest.dist_sq = FLT_MAX;
-    const float3 position = positions[i];
-    BLI_bvhtree_find_nearest(
-        tree_data.tree, position, &nearest, tree_data.nearest_callback, &tree_data);
+  }
+  BLI_bvhtree_find_nearest_batch(*tree_data.tree,
+                                 IndexMask(mask.size()),
+                                 query_positions,
+                                 nearests,
+                                 tree_data.nearest_callback,
+                                 &tree_data);
+
+  mask.foreach_index([&](const int i, const int pos) {
+    const BVHTreeNearest &nearest = nearests[pos];
     r_indices[i] = nearest.index;
     if (!r_distances_sq.is_empty()) {
       r_distances_sq[i] = nearest.dist_sq;
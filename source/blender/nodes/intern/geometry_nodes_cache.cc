@@ -0,0 +1,934 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <mutex>
+
+#include "BLI_generic_key.hh"
+#include "BLI_hash.hh"
+#include "BLI_implicit_sharing_ptr.hh"
+#include "BLI_linear_allocator.hh"
+#include "BLI_listbase.h"
+#include "BLI_map.hh"
+#include "BLI_memory_cache.hh"
+#include "BLI_memory_counter.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_curves_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_curves.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_instances.hh"
+#include "BKE_mesh_types.hh"
+#include "BKE_node.hh"
+#include "BKE_node_runtime.hh"
+#include "BKE_node_socket_value.hh"
+
+#include "NOD_geometry_nodes_cache.hh"
+#include "NOD_geometry_nodes_lazy_function.hh"
+
+namespace blender::nodes::geo_eval_cache {
+
+static bool node_type_is_deterministic(const int type)
+{
+  switch (type) {
+    /* Read data from other objects or the scene. */
+    case GEO_NODE_COLLECTION_INFO:
+    case GEO_NODE_OBJECT_INFO:
+    case GEO_NODE_SELF_OBJECT:
+    case GEO_NODE_INPUT_ACTIVE_CAMERA:
+    case GEO_NODE_INPUT_SCENE_TIME:
+    case GEO_NODE_IS_VIEWPORT:
+    case GEO_NODE_DEFORM_CURVES_ON_SURFACE:
+    case GEO_NODE_MESH_TO_VOLUME:
+    /* Read data from files. */
+    case GEO_NODE_IMAGE_TEXTURE:
+    case GEO_NODE_IMAGE_INFO:
+    case GEO_NODE_IMPORT_STL:
+    case GEO_NODE_IMPORT_OBJ:
+    case GEO_NODE_IMPORT_PLY:
+    /* Read fonts. */
+    case GEO_NODE_STRING_TO_CURVES:
+    /* Store state between evaluations. */
+    case GEO_NODE_SIMULATION_INPUT:
+    case GEO_NODE_SIMULATION_OUTPUT:
+    case GEO_NODE_BAKE:
+    /* Have side effects. */
+    case GEO_NODE_VIEWER:
+    case GEO_NODE_WARNING:
+    case GEO_NODE_GIZMO_LINEAR:
+    case GEO_NODE_GIZMO_DIAL:
+    case GEO_NODE_GIZMO_TRANSFORM:
+    /* Only used in tools. */
+    case GEO_NODE_TOOL_SELECTION:
+    case GEO_NODE_TOOL_SET_SELECTION:
+    case GEO_NODE_TOOL_3D_CURSOR:
+    case GEO_NODE_TOOL_FACE_SET:
+    case GEO_NODE_TOOL_SET_FACE_SET:
+    case GEO_NODE_TOOL_VIEWPORT_TRANSFORM:
+    case GEO_NODE_TOOL_MOUSE_POSITION:
+    case GEO_NODE_TOOL_ACTIVE_ELEMENT:
+      return false;
+  }
+  return true;
+}
+
+bool node_tree_is_deterministic(const bNodeTree &tree)
+{
+  tree.ensure_topology_cache();
+  for (const bNode *node : tree.all_nodes()) {
+    if (node->is_group()) {
+      const bNodeTree *group = reinterpret_cast<const bNodeTree *>(node->id);
+      if (group != nullptr && !node_tree_is_deterministic(*group)) {
+        return false;
+      }
+      continue;
+    }
+    if (!node_type_is_deterministic(node->type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Identifies a value that is passed into a node group. Where possible, the value itself is not
+ * stored. For example, geometries are identified by the data they share with the original data.
+ */
+class ValueFingerprint {
+ public:
+  /**
+   * Sizes, flags and pointers that identify the value. Shared data is identified by the
+   * #ImplicitSharingInfo and its version.
+   */
+  Vector<uint64_t> data;
+  /** Single values are compared directly. */
+  Vector<bke::SocketValueVariant> values;
+  /** Attribute names, vertex group names, etc. */
+  Vector<std::string> names;
+  /**
+   * Weak users of all shared data in #data. They make sure that the address of an
+   * #ImplicitSharingInfo is not reused by other data while the fingerprint exists.
+   */
+  Vector<WeakImplicitSharingPtr> sharing_infos;
+
+  uint64_t hash() const
+  {
+    uint64_t hash = 0;
+    for (const uint64_t value : data) {
+      hash = hash * 33 ^ value;
+    }
+    for (const bke::SocketValueVariant &value : values) {
+      const GPointer ptr = value.get_single_ptr();
+      hash = hash * 33 ^ ptr.type()->hash_or_fallback(ptr.get(), 0);
+    }
+    for (const std::string &name : names) {
+      hash = hash * 33 ^ get_default_hash(name);
+    }
+    return hash;
+  }
+
+  friend bool operator==(const ValueFingerprint &a, const ValueFingerprint &b)
+  {
+    if (a.data != b.data || a.names != b.names || a.values.size() != b.values.size()) {
+      return false;
+    }
+    for (const int i : a.values.index_range()) {
+      const GPointer value_a = a.values[i].get_single_ptr();
+      const GPointer value_b = b.values[i].get_single_ptr();
+      if (value_a.type() != value_b.type() ||
+          !value_a.type()->is_equal_or_false(value_a.get(), value_b.get()))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void add_pointer(const void *ptr)
+  {
+    data.append(uint64_t(uintptr_t(ptr)));
+  }
+
+  void add_shared_data(const ImplicitSharingInfo *sharing_info)
+  {
+    this->add_pointer(sharing_info);
+    data.append(uint64_t(sharing_info->version()));
+    sharing_info->add_weak_user();
+    sharing_infos.append(WeakImplicitSharingPtr(sharing_info));
+  }
+};
+
+/**
+ * Identifies a node group evaluation by the node group, the compute context and the values of the
+ * inputs that have been used by the group.
+ */
+class GroupCallKey : public GenericKey {
+ public:
+  uint64_t graph_session_uid = 0;
+  ComputeContextHash context_hash;
+  /** Indices of the used inputs of the group lazy-function, in increasing order. */
+  Vector<int> input_indices;
+  Vector<ValueFingerprint> inputs;
+
+  uint64_t hash() const override
+  {
+    uint64_t hash = get_default_hash(graph_session_uid, context_hash);
+    for (const int i : input_indices.index_range()) {
+      hash = hash * 33 ^ get_default_hash(input_indices[i], inputs[i].hash());
+    }
+    return hash;
+  }
+
+  bool equal_to(const GenericKey &other) const override
+  {
+    const auto *other_typed = dynamic_cast<const GroupCallKey *>(&other);
+    if (other_typed == nullptr) {
+      return false;
+    }
+    const GroupCallKey &b = *other_typed;
+    return graph_session_uid == b.graph_session_uid && context_hash == b.context_hash &&
+           input_indices == b.input_indices && inputs == b.inputs;
+  }
+
+  std::unique_ptr<GenericKey> to_storable() const override
+  {
+    return std::make_unique<GroupCallKey>(*this);
+  }
+};
+
+/** Outputs of a node group evaluation. */
+class GroupCallValue : public memory_cache::CachedValue {
+ public:
+  LinearAllocator<> allocator;
+  /** Null for outputs that have not been computed. */
+  Array<GMutablePointer> outputs;
+  /** Data logged while evaluating the group. It is added to the log again when it is reused. */
+  Vector<geo_eval_log::CapturedTreeLog> logs;
+
+  ~GroupCallValue()
+  {
+    for (GMutablePointer &output : outputs) {
+      if (output.get()) {
+        output.destruct();
+      }
+    }
+  }
+
+  void count_memory(MemoryCounter &memory) const override
+  {
+    for (const GMutablePointer &output : outputs) {
+      if (output.get() == nullptr) {
+        continue;
+      }
+      if (output.type()->is<bke::GeometrySet>()) {
+        output.get<bke::GeometrySet>()->count_memory(memory);
+      }
+      else {
+        memory.add(output.type()->size());
+      }
+    }
+  }
+};
+
+static bool add_custom_data(ValueFingerprint &fingerprint, const CustomData &data, const int size)
+{
+  fingerprint.data.append(size);
+  fingerprint.data.append(data.totlayer);
+  for (const CustomDataLayer &layer : Span(data.layers, data.totlayer)) {
+    fingerprint.data.append(layer.type);
+    fingerprint.data.append(layer.flag);
+    /* Which layer is active is stored in every layer of the same type. */
+    fingerprint.data.append(layer.active);
+    fingerprint.data.append(layer.active_rnd);
+    fingerprint.data.append(layer.active_clone);
+    fingerprint.data.append(layer.active_mask);
+    fingerprint.names.append(layer.name);
+    if (layer.data == nullptr) {
+      fingerprint.add_pointer(nullptr);
+      continue;
+    }
+    if (layer.sharing_info == nullptr) {
+      /* The data can't be identified without comparing it. */
+      return false;
+    }
+    fingerprint.add_shared_data(layer.sharing_info);
+  }
+  return true;
+}
+
+static void add_vertex_group_names(ValueFingerprint &fingerprint,
+                                   const ListBase &vertex_group_names)
+{
+  fingerprint.data.append(BLI_listbase_count(&vertex_group_names));
+  LISTBASE_FOREACH (const bDeformGroup *, group, &vertex_group_names) {
+    fingerprint.names.append(group->name);
+  }
+}
+
+static void add_materials(ValueFingerprint &fingerprint, const Span<const Material *> materials)
+{
+  fingerprint.data.append(materials.size());
+  for (const Material *material : materials) {
+    fingerprint.add_pointer(material);
+  }
+}
+
+static void add_optional_name(ValueFingerprint &fingerprint, const char *name)
+{
+  fingerprint.names.append(name ? name : "");
+}
+
+static bool add_mesh(ValueFingerprint &fingerprint, const Mesh &mesh)
+{
+  if (!add_custom_data(fingerprint, mesh.vert_data, mesh.verts_num) ||
+      !add_custom_data(fingerprint, mesh.edge_data, mesh.edges_num) ||
+      !add_custom_data(fingerprint, mesh.face_data, mesh.faces_num) ||
+      !add_custom_data(fingerprint, mesh.corner_data, mesh.corners_num))
+  {
+    return false;
+  }
+  if (mesh.faces_num > 0) {
+    if (mesh.runtime->face_offsets_sharing_info == nullptr) {
+      return false;
+    }
+    fingerprint.add_shared_data(mesh.runtime->face_offsets_sharing_info);
+  }
+  add_vertex_group_names(fingerprint, mesh.vertex_group_names);
+  add_materials(fingerprint, {mesh.mat, mesh.totcol});
+  add_optional_name(fingerprint, mesh.active_color_attribute);
+  add_optional_name(fingerprint, mesh.default_color_attribute);
+  return true;
+}
+
+static bool add_curves(ValueFingerprint &fingerprint, const Curves &curves_id)
+{
+  const bke::CurvesGeometry &curves = curves_id.geometry.wrap();
+  if (!add_custom_data(fingerprint, curves.point_data, curves.points_num()) ||
+      !add_custom_data(fingerprint, curves.curve_data, curves.curves_num()))
+  {
+    return false;
+  }
+  if (curves.curves_num() > 0) {
+    if (curves.runtime->curve_offsets_sharing_info == nullptr) {
+      return false;
+    }
+    fingerprint.add_shared_data(curves.runtime->curve_offsets_sharing_info);
+  }
+  add_vertex_group_names(fingerprint, curves.vertex_group_names);
+  add_materials(fingerprint, {curves_id.mat, curves_id.totcol});
+  fingerprint.add_pointer(curves_id.surface);
+  add_optional_name(fingerprint, curves_id.surface_uv_map);
+  return true;
+}
+
+static bool add_pointcloud(ValueFingerprint &fingerprint, const PointCloud &pointcloud)
+{
+  if (!add_custom_data(fingerprint, pointcloud.pdata, pointcloud.totpoint)) {
+    return false;
+  }
+  add_materials(fingerprint, {pointcloud.mat, pointcloud.totcol});
+  return true;
+}
+
+static bool add_geometry(ValueFingerprint &fingerprint, const bke::GeometrySet &geometry);
+
+static bool add_instances(ValueFingerprint &fingerprint, const bke::Instances &instances)
+{
+  if (!add_custom_data(
+          fingerprint, instances.custom_data_attributes(), instances.instances_num()))
+  {
+    return false;
+  }
+  fingerprint.data.append(instances.references().size());
+  for (const bke::InstanceReference &reference : instances.references()) {
+    fingerprint.data.append(uint64_t(reference.type()));
+    switch (reference.type()) {
+      case bke::InstanceReference::Type::None:
+        break;
+      case bke::InstanceReference::Type::Object:
+      case bke::InstanceReference::Type::Collection:
+        /* The referenced data may be read by the group, e.g. when the instances are realized.
+         * Changes of that data can't be detected. */
+        return false;
+      case bke::InstanceReference::Type::GeometrySet:
+        if (!add_geometry(fingerprint, reference.geometry_set())) {
+          return false;
+        }
+        break;
+    }
+  }
+  return true;
+}
+
+static bool add_geometry(ValueFingerprint &fingerprint, const bke::GeometrySet &geometry)
+{
+  fingerprint.names.append(geometry.name);
+  const Vector<const bke::GeometryComponent *> components = geometry.get_components();
+  fingerprint.data.append(components.size());
+  for (const bke::GeometryComponent *component : components) {
+    fingerprint.data.append(uint64_t(component->type()));
+    switch (component->type()) {
+      case bke::GeometryComponent::Type::Mesh: {
+        if (!add_mesh(fingerprint, *geometry.get_mesh())) {
+          return false;
+        }
+        break;
+      }
+      case bke::GeometryComponent::Type::Curve: {
+        if (!add_curves(fingerprint, *geometry.get_curves())) {
+          return false;
+        }
+        break;
+      }
+      case bke::GeometryComponent::Type::PointCloud: {
+        if (!add_pointcloud(fingerprint, *geometry.get_pointcloud())) {
+          return false;
+        }
+        break;
+      }
+      case bke::GeometryComponent::Type::Instance: {
+        if (!add_instances(fingerprint, *geometry.get_instances())) {
+          return false;
+        }
+        break;
+      }
+      default: {
+        /* Volumes, Grease Pencil and edit data are not supported yet. */
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static bool add_input_value(ValueFingerprint &fingerprint, const CPPType &type, const void *value)
+{
+  if (value == nullptr) {
+    fingerprint.add_pointer(nullptr);
+    return true;
+  }
+  if (type.is<bke::SocketValueVariant>()) {
+    const bke::SocketValueVariant &value_variant = *static_cast<const bke::SocketValueVariant *>(
+        value);
+    if (value_variant.is_context_dependent_field() || value_variant.is_volume_grid()) {
+      /* Fields and grids can't be compared. */
+      return false;
+    }
+    bke::SocketValueVariant single_value = value_variant;
+    single_value.convert_to_single();
+    const GPointer single_ptr = single_value.get_single_ptr();
+    if (!single_ptr.type()->is_equality_comparable()) {
+      return false;
+    }
+    fingerprint.values.append(std::move(single_value));
+    return true;
+  }
+  if (type.is<bke::GeometrySet>()) {
+    return add_geometry(fingerprint, *static_cast<const bke::GeometrySet *>(value));
+  }
+  if (type.is<bke::AnonymousAttributeSet>()) {
+    const auto &attributes = *static_cast<const bke::AnonymousAttributeSet *>(value);
+    if (!attributes.names) {
+      fingerprint.add_pointer(nullptr);
+      return true;
+    }
+    Vector<std::string> names(attributes.names->begin(), attributes.names->end());
+    std::sort(names.begin(), names.end());
+    fingerprint.data.append(names.size());
+    fingerprint.names.extend(names);
+    return true;
+  }
+  if (type.is<bool>()) {
+    fingerprint.data.append(*static_cast<const bool *>(value));
+    return true;
+  }
+  if (type.is_any<Object *, Collection *, Tex *, Image *, Material *>()) {
+    /* Only the pointer can end up in the outputs, the data-blocks are not read by deterministic
+     * node groups. */
+    fingerprint.add_pointer(*static_cast<const void *const *>(value));
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Number of results that are kept for every node group and compute context. Keeping more than
+ * one result allows switching between a few input values without evaluating the group again.
+ * Inputs that change in every evaluation, e.g. because they are animated, only replace each other.
+ */
+static constexpr int cached_results_per_context_max = 2;
+
+/**
+ * Keys of the results that are cached for each node group and compute context, with the most
+ * recently used result first. The memory cache may free the values independently.
+ */
+struct CachedResults {
+  std::mutex mutex;
+  Map<uint64_t, Map<ComputeContextHash, Vector<std::shared_ptr<const GroupCallKey>>>>
+      keys_by_graph;
+};
+
+static CachedResults &get_cached_results()
+{
+  static CachedResults cached_results;
+  return cached_results;
+}
+
+/** The inputs that have been used by the most recent evaluation of the group in the context. */
+static std::optional<Vector<int>> find_recent_input_indices(const uint64_t graph_session_uid,
+                                                            const ComputeContextHash &context_hash)
+{
+  CachedResults &cached_results = get_cached_results();
+  std::lock_guard lock{cached_results.mutex};
+  const auto *keys_by_context = cached_results.keys_by_graph.lookup_ptr(graph_session_uid);
+  if (keys_by_context == nullptr) {
+    return std::nullopt;
+  }
+  const Vector<std::shared_ptr<const GroupCallKey>> *keys = keys_by_context->lookup_ptr(
+      context_hash);
+  if (keys == nullptr || keys->is_empty()) {
+    return std::nullopt;
+  }
+  return keys->first()->input_indices;
+}
+
+/**
+ * Make the key the most recently used one in its context. Keys that exceed the per-context limit
+ * are removed from the memory cache.
+ */
+static void use_cached_result(std::shared_ptr<const GroupCallKey> key)
+{
+  Vector<std::shared_ptr<const GroupCallKey>> keys_to_remove;
+  {
+    CachedResults &cached_results = get_cached_results();
+    std::lock_guard lock{cached_results.mutex};
+    Vector<std::shared_ptr<const GroupCallKey>> &keys =
+        cached_results.keys_by_graph.lookup_or_add_default(key->graph_session_uid)
+            .lookup_or_add_default(key->context_hash);
+    keys.remove_if([&](const std::shared_ptr<const GroupCallKey> &other) {
+      return *other == *key;
+    });
+    keys.insert(0, std::move(key));
+    while (keys.size() > cached_results_per_context_max) {
+      keys_to_remove.append(keys.pop_last());
+    }
+  }
+  /* Don't hold the lock while accessing the memory cache. */
+  for (const std::shared_ptr<const GroupCallKey> &key_to_remove : keys_to_remove) {
+    memory_cache::remove(*key_to_remove);
+  }
+}
+
+void remove_graph(const uint64_t graph_session_uid)
+{
+  Map<ComputeContextHash, Vector<std::shared_ptr<const GroupCallKey>>> keys_by_context;
+  {
+    CachedResults &cached_results = get_cached_results();
+    std::lock_guard lock{cached_results.mutex};
+    if (std::optional<Map<ComputeContextHash, Vector<std::shared_ptr<const GroupCallKey>>>>
+            keys = cached_results.keys_by_graph.pop_try(graph_session_uid))
+    {
+      keys_by_context = std::move(*keys);
+    }
+  }
+  for (const Span<std::shared_ptr<const GroupCallKey>> keys : keys_by_context.values()) {
+    for (const std::shared_ptr<const GroupCallKey> &key : keys) {
+      memory_cache::remove(*key);
+    }
+  }
+}
+
+enum class GroupCallMode {
+  /** The group has not been executed yet. */
+  None,
+  /**
+   * Wait for the inputs that have been used by the previous evaluation in the same context, to
+   * check whether its outputs can be reused.
+   */
+  Lookup,
+  /** The outputs are taken from the cache. */
+  Cached,
+  /** The group is evaluated, its outputs are added to the cache at the end. */
+  Lazy,
+};
+
+/** Data that is only needed when the group is actually evaluated. */
+struct LazyGroupCall {
+  /**
+   * Copy of the data of the caller. The logger is replaced so that everything that is logged in
+   * the group can be stored with the outputs. Socket values are not logged, see #can_use_cache.
+   */
+  GeoNodesCallData call_data;
+  geo_eval_log::GeoModifierLog log;
+  Set<ComputeContextHash> socket_log_contexts;
+  /** The logged data is added to this log in the end. */
+  geo_eval_log::GeoModifierLog *parent_log = nullptr;
+
+  /** Protects the data below, because inputs and outputs may be accessed from multiple threads. */
+  std::mutex mutex;
+  /** Identifies every input that has been used by the group. */
+  Array<std::optional<ValueFingerprint>> inputs;
+  /** False if some used input can't be identified, the outputs are not cached then. */
+  bool inputs_identified = true;
+  std::shared_ptr<GroupCallValue> value;
+  bool multi_threading_enabled = false;
+
+  void load_input(const CPPType &type, const int index, const void *input_value)
+  {
+    std::lock_guard lock{mutex};
+    if (inputs[index].has_value()) {
+      return;
+    }
+    ValueFingerprint &fingerprint = inputs[index].emplace();
+    if (inputs_identified) {
+      inputs_identified = add_input_value(fingerprint, type, input_value);
+    }
+  }
+
+  void store_output(const CPPType &type, const int main_index, const void *output_value)
+  {
+    std::lock_guard lock{mutex};
+    void *buffer = value->allocator.allocate(type.size(), type.alignment());
+    type.copy_construct(output_value, buffer);
+    value->outputs[main_index] = {type, buffer};
+  }
+};
+
+struct GroupCallStorage {
+  const GeometryNodesLazyFunctionGraphInfo &graph_info;
+  GroupCallMode mode = GroupCallMode::None;
+  ComputeContextHash context_hash;
+  /** Used in lookup mode. */
+  Vector<int> lookup_input_indices;
+  /** Used in cached mode. */
+  std::shared_ptr<const GroupCallValue> cached_value;
+  /** Used in lazy mode. */
+  std::unique_ptr<LazyGroupCall> lazy_call;
+
+  GroupCallStorage(const GeometryNodesLazyFunctionGraphInfo &graph_info) : graph_info(graph_info)
+  {
+  }
+};
+
+/**
+ * Passes the inputs and outputs of the group node to the group lazy-function, and keeps track
+ * of the inputs it uses and the outputs it computes.
+ */
+class LazyGroupCallParams final : public lf::Params {
+ private:
+  lf::Params &base_params_;
+  LazyGroupCall &call_;
+  IndexRange main_outputs_;
+
+ public:
+  LazyGroupCallParams(const lf::LazyFunction &fn,
+                      lf::Params &base_params,
+                      LazyGroupCall &call,
+                      const IndexRange main_outputs)
+      : lf::Params(fn, call.multi_threading_enabled),
+        base_params_(base_params),
+        call_(call),
+        main_outputs_(main_outputs)
+  {
+  }
+
+  void *try_get_input_data_ptr_impl(const int index) const override
+  {
+    void *value = base_params_.try_get_input_data_ptr(index);
+    if (value != nullptr) {
+      /* The value has to be identified now, because the group may move it. */
+      call_.load_input(*fn_.inputs()[index].type, index, value);
+    }
+    return value;
+  }
+
+  void *try_get_input_data_ptr_or_request_impl(const int index) override
+  {
+    void *value = base_params_.try_get_input_data_ptr_or_request(index);
+    if (value != nullptr) {
+      call_.load_input(*fn_.inputs()[index].type, index, value);
+    }
+    return value;
+  }
+
+  void *get_output_data_ptr_impl(const int index) override
+  {
+    return base_params_.get_output_data_ptr(index);
+  }
+
+  void output_set_impl(const int index) override
+  {
+    if (main_outputs_.contains(index)) {
+      call_.store_output(*fn_.outputs()[index].type,
+                         index - main_outputs_.start(),
+                         base_params_.get_output_data_ptr(index));
+    }
+    base_params_.output_set(index);
+  }
+
+  bool output_was_set_impl(const int index) const override
+  {
+    return base_params_.output_was_set(index);
+  }
+
+  lf::ValueUsage get_output_usage_impl(const int index) const override
+  {
+    /* Input usages may have been set before the group is evaluated. */
+    if (base_params_.output_was_set(index)) {
+      return lf::ValueUsage::Unused;
+    }
+    return base_params_.get_output_usage(index);
+  }
+
+  void set_input_unused_impl(const int index) override
+  {
+    base_params_.set_input_unused(index);
+  }
+
+  bool try_enable_multi_threading_impl() override
+  {
+    if (call_.multi_threading_enabled) {
+      return true;
+    }
+    if (base_params_.try_enable_multi_threading()) {
+      call_.multi_threading_enabled = true;
+      return true;
+    }
+    return false;
+  }
+};
+
+GroupCallStorage *init_group_call_storage(LinearAllocator<> &allocator,
+                                          const GeometryNodesLazyFunctionGraphInfo &graph_info)
+{
+  return allocator.construct<GroupCallStorage>(graph_info).release();
+}
+
+static void start_lazy_call(GroupCallStorage &storage, const GeoNodesLFUserData &user_data)
+{
+  const GeometryNodesGroupFunction &function = storage.graph_info.function;
+  storage.mode = GroupCallMode::Lazy;
+  storage.lazy_call = std::make_unique<LazyGroupCall>();
+  LazyGroupCall &call = *storage.lazy_call;
+  call.call_data = *user_data.call_data;
+  call.call_data.eval_log = &call.log;
+  call.call_data.socket_log_contexts = &call.socket_log_contexts;
+  call.parent_log = user_data.call_data->eval_log;
+  call.inputs.reinitialize(function.function->inputs().size());
+  call.value = std::make_shared<GroupCallValue>();
+  call.value->outputs.reinitialize(function.outputs.main.size());
+}
+
+static void execute_lazy_call(GroupCallStorage &storage,
+                              lf::Params &params,
+                              const lf::Context &group_context)
+{
+  const GeometryNodesGroupFunction &function = storage.graph_info.function;
+  LazyGroupCall &call = *storage.lazy_call;
+
+  GeoNodesLFUserData user_data = static_cast<const GeoNodesLFUserData &>(
+      *group_context.user_data);
+  user_data.call_data = &call.call_data;
+  user_data.log_socket_values = false;
+  GeoNodesLFLocalUserData local_user_data{user_data};
+  lf::Context context{group_context.storage, &user_data, &local_user_data};
+
+  LazyGroupCallParams call_params{*function.function, params, call, function.outputs.main};
+  function.function->execute(call_params, context);
+}
+
+void destruct_group_call_storage(GroupCallStorage *storage)
+{
+  if (LazyGroupCall *call = storage->lazy_call.get()) {
+    /* All nodes in the group are done when its storage is freed, so nothing is logged anymore. */
+    Vector<geo_eval_log::CapturedTreeLog> logs = call->log.capture_tree_logs();
+    if (call->parent_log) {
+      call->parent_log->add_captured_tree_logs(logs);
+    }
+    const bool any_output_computed = std::any_of(
+        call->value->outputs.begin(), call->value->outputs.end(), [](const GMutablePointer &ptr) {
+          return ptr.get() != nullptr;
+        });
+    if (call->inputs_identified && any_output_computed) {
+      auto key = std::make_shared<GroupCallKey>();
+      key->graph_session_uid = storage->graph_info.session_uid;
+      key->context_hash = storage->context_hash;
+      for (const int i : call->inputs.index_range()) {
+        if (call->inputs[i].has_value()) {
+          key->input_indices.append(i);
+          key->inputs.append(std::move(*call->inputs[i]));
+        }
+      }
+      call->value->logs = std::move(logs);
+      /* A result that has been cached before may contain fewer outputs. */
+      if (memory_cache::lookup<GroupCallValue>(*key)) {
+        memory_cache::remove(*key);
+      }
+      memory_cache::add(*key, std::move(call->value));
+      use_cached_result(std::move(key));
+    }
+  }
+  std::destroy_at(storage);
+}
+
+/**
+ * Decide whether the inputs are used based on static information only, because the group is not
+ * evaluated when its outputs are cached. This is conservative, i.e. inputs may be marked as used
+ * even if the group does not use them.
+ */
+static void set_input_usages_statically(const GeometryNodesLazyFunctionGraphInfo &graph_info,
+                                        lf::Params &params)
+{
+  const GeometryNodesGroupFunction &function = graph_info.function;
+  const Span<InputUsageHint> usage_hints = graph_info.mapping.group_input_usage_hints;
+  for (const int i : function.outputs.input_usages.index_range()) {
+    const int lf_index = function.outputs.input_usages[i];
+    if (params.output_was_set(lf_index) ||
+        params.get_output_usage(lf_index) == lf::ValueUsage::Unused)
+    {
+      continue;
+    }
+    const InputUsageHint &hint = usage_hints[i];
+    bool is_used = true;
+    if (hint.type == InputUsageHintType::Never) {
+      is_used = false;
+    }
+    else if (hint.type == InputUsageHintType::DependsOnOutput) {
+      is_used = std::any_of(
+          hint.output_dependencies.begin(), hint.output_dependencies.end(), [&](const int output) {
+            return params.get_output_usage(function.outputs.main[output]) !=
+                   lf::ValueUsage::Unused;
+          });
+    }
+    params.set_output(lf_index, is_used);
+  }
+}
+
+/**
+ * Copy the cached outputs that may be used. Returns false if a required output has not been
+ * computed when the outputs were cached.
+ */
+static bool set_cached_outputs(const GroupCallStorage &storage,
+                               lf::Params &params,
+                               const bool check_only)
+{
+  const GeometryNodesGroupFunction &function = storage.graph_info.function;
+  const GroupCallValue &value = *storage.cached_value;
+  for (const int i : function.outputs.main.index_range()) {
+    const int lf_index = function.outputs.main[i];
+    const lf::ValueUsage usage = params.get_output_usage(lf_index);
+    if (usage == lf::ValueUsage::Unused || params.output_was_set(lf_index)) {
+      continue;
+    }
+    const GMutablePointer &output = value.outputs[i];
+    if (output.get() == nullptr) {
+      if (usage == lf::ValueUsage::Used) {
+        return false;
+      }
+      continue;
+    }
+    if (!check_only) {
+      output.type()->copy_construct(output.get(), params.get_output_data_ptr(lf_index));
+      params.output_set(lf_index);
+    }
+  }
+  return true;
+}
+
+/**
+ * Try to find outputs in the cache, using the inputs that have been used by the previous
+ * evaluation. The mode stays unchanged while waiting for those inputs.
+ */
+static void lookup_cached_outputs(GroupCallStorage &storage,
+                                  lf::Params &params,
+                                  const GeoNodesLFUserData &user_data)
+{
+  const GeometryNodesGroupFunction &function = storage.graph_info.function;
+  set_input_usages_statically(storage.graph_info, params);
+
+  const bool any_output_required = std::any_of(
+      function.outputs.main.begin(), function.outputs.main.end(), [&](const int lf_index) {
+        return params.get_output_usage(lf_index) == lf::ValueUsage::Used &&
+               !params.output_was_set(lf_index);
+      });
+  if (!any_output_required) {
+    return;
+  }
+
+  bool all_inputs_available = true;
+  for (const int lf_index : storage.lookup_input_indices) {
+    all_inputs_available &= params.try_get_input_data_ptr_or_request(lf_index) != nullptr;
+  }
+  if (!all_inputs_available) {
+    return;
+  }
+
+  auto key = std::make_shared<GroupCallKey>();
+  key->graph_session_uid = storage.graph_info.session_uid;
+  key->context_hash = storage.context_hash;
+  for (const int lf_index : storage.lookup_input_indices) {
+    key->input_indices.append(lf_index);
+    key->inputs.append_as();
+    ValueFingerprint &fingerprint = key->inputs.last();
+    if (!add_input_value(fingerprint,
+                         *function.function->inputs()[lf_index].type,
+                         params.try_get_input_data_ptr(lf_index)))
+    {
+      start_lazy_call(storage, user_data);
+      return;
+    }
+  }
+
+  storage.cached_value = memory_cache::lookup<GroupCallValue>(*key);
+  if (!storage.cached_value || !set_cached_outputs(storage, params, true)) {
+    storage.cached_value.reset();
+    start_lazy_call(storage, user_data);
+    return;
+  }
+  storage.mode = GroupCallMode::Cached;
+  if (user_data.call_data->eval_log) {
+    user_data.call_data->eval_log->add_captured_tree_logs(storage.cached_value->logs);
+  }
+  use_cached_result(std::move(key));
+}
+
+void execute_group(GroupCallStorage &storage,
+                   lf::Params &params,
+                   const lf::Context &group_context)
+{
+  const auto &user_data = static_cast<const GeoNodesLFUserData &>(*group_context.user_data);
+  if (storage.mode == GroupCallMode::None) {
+    storage.context_hash = user_data.compute_context->hash();
+    if (std::optional<Vector<int>> input_indices = find_recent_input_indices(
+            storage.graph_info.session_uid, storage.context_hash))
+    {
+      storage.lookup_input_indices = std::move(*input_indices);
+      storage.mode = GroupCallMode::Lookup;
+    }
+    else {
+      start_lazy_call(storage, user_data);
+    }
+  }
+  if (storage.mode == GroupCallMode::Lookup) {
+    lookup_cached_outputs(storage, params, user_data);
+  }
+  if (storage.mode == GroupCallMode::Cached) {
+    if (set_cached_outputs(storage, params, false)) {
+      return;
+    }
+    /* An output is required that has not been computed when the outputs were cached. The inputs
+     * have not been moved, so the group can still be evaluated. */
+    storage.cached_value.reset();
+    start_lazy_call(storage, user_data);
+  }
+  if (storage.mode == GroupCallMode::Lazy) {
+    execute_lazy_call(storage, params, group_context);
+  }
+}
+
+}  // namespace blender::nodes::geo_eval_cache
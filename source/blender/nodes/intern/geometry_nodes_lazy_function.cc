@@ -21,6 +21,7 @@
  */
 
 #include "NOD_geometry_exec.hh"
+#include "NOD_geometry_nodes_cache.hh"
 #include "NOD_geometry_nodes_lazy_function.hh"
 #include "NOD_multi_function.hh"
 #include "NOD_node_declaration.hh"
@@ -56,6 +57,7 @@
 #include "GEO_extract_elements.hh"
 #include "GEO_join_geometries.hh"
 
+#include <atomic>
 #include <fmt/format.h>
 #include <sstream>
 
@@ -196,7 +198,7 @@ class LazyFunctionForGeometryNode : public LazyFunction {
 
   void execute_impl(lf::Params &params, const lf::Context &context) const override
   {
-    const ScopedNodeTimer node_timer{context, node_};
+    ScopedNodeTimer node_timer{context, node_};
 
     GeoNodesLFUserData *user_data = dynamic_cast<GeoNodesLFUserData *>(context.user_data);
     BLI_assert(user_data != nullptr);
@@ -243,6 +245,19 @@ class LazyFunctionForGeometryNode : public LazyFunction {
       return;
     }
 
+    if (node_timer.is_profiled()) {
+      /* Count before executing the node, because the inputs are moved into it. */
+      int64_t input_elements_num = 0;
+      for (const int lf_index : inputs_.index_range()) {
+        if (*inputs_[lf_index].type == CPPType::get<bke::GeometrySet>()) {
+          const auto &geometry = *static_cast<const bke::GeometrySet *>(
+              params.try_get_input_data_ptr(lf_index));
+          input_elements_num += geo_eval_profile::geometry_elements_num(geometry);
+        }
+      }
+      node_timer.set_input_elements_num(input_elements_num);
+    }
+
     auto get_anonymous_attribute_name = [&](const int i) {
       return this->anonymous_attribute_name_for_output(*user_data, i);
     };
@@ -328,6 +343,7 @@ class LazyFunctionForMultiInput : public LazyFunction {
   LazyFunctionForMultiInput(const bNodeSocket &socket)
   {
     debug_name_ = "Multi Input";
+    is_cheap_ = true;
     base_type_ = get_socket_cpp_type(socket);
     BLI_assert(base_type_ != nullptr);
     BLI_assert(socket.is_multi_input());
@@ -375,6 +391,7 @@ class LazyFunctionForRerouteNode : public LazyFunction {
   LazyFunctionForRerouteNode(const CPPType &type)
   {
     debug_name_ = "Reroute";
+    is_cheap_ = true;
     inputs_.append({"Input", type});
     outputs_.append({"Output", type});
   }
@@ -646,6 +663,7 @@ class LazyFunctionForMultiFunctionConversion : public LazyFunction {
   LazyFunctionForMultiFunctionConversion(const MultiFunction &fn) : fn_(fn)
   {
     debug_name_ = "Convert";
+    is_cheap_ = true;
     inputs_.append_as("From", CPPType::get<SocketValueVariant>());
     outputs_.append_as("To", CPPType::get<SocketValueVariant>());
   }
@@ -668,21 +686,26 @@ class LazyFunctionForMultiFunctionConversion : public LazyFunction {
  */
 class LazyFunctionForMultiFunctionNode : public LazyFunction {
  private:
+  const bNode &node_;
   const NodeMultiFunctions::Item fn_item_;
 
  public:
   LazyFunctionForMultiFunctionNode(const bNode &node,
                                    NodeMultiFunctions::Item fn_item,
                                    MutableSpan<int> r_lf_index_by_bsocket)
-      : fn_item_(std::move(fn_item))
+      : node_(node), fn_item_(std::move(fn_item))
   {
     BLI_assert(fn_item_.fn != nullptr);
     debug_name_ = node.name;
+    /* Multi-functions are evaluated on single values or just build up fields. */
+    is_cheap_ = true;
     lazy_function_interface_from_node(node, inputs_, outputs_, r_lf_index_by_bsocket);
   }
 
-  void execute_impl(lf::Params &params, const lf::Context & /*context*/) const override
+  void execute_impl(lf::Params &params, const lf::Context &context) const override
   {
+    const ScopedNodeTimer node_timer{context, node_};
+
     Vector<SocketValueVariant *> input_values(inputs_.size());
     Vector<SocketValueVariant *> output_values(outputs_.size());
     for (const int i : inputs_.index_range()) {
@@ -1079,20 +1102,27 @@ static bool should_log_socket_values_for_context(const GeoNodesLFUserData &user_
 class LazyFunctionForGroupNode : public LazyFunction {
  private:
   const bNode &group_node_;
+  const GeometryNodesLazyFunctionGraphInfo &group_lf_graph_info_;
   const LazyFunction &group_lazy_function_;
   bool has_many_nodes_ = false;
+  /** The outputs of the group only depend on its inputs, so they can be cached. */
+  bool use_cache_ = false;
 
   struct Storage {
     void *group_storage = nullptr;
     /* To avoid computing the hash more than once. */
     std::optional<ComputeContextHash> context_hash_cache;
+    /* Only used when the outputs of the group are cached. */
+    geo_eval_cache::GroupCallStorage *cache_storage = nullptr;
   };
 
  public:
   LazyFunctionForGroupNode(const bNode &group_node,
                            const GeometryNodesLazyFunctionGraphInfo &group_lf_graph_info,
                            GeometryNodesLazyFunctionGraphInfo &own_lf_graph_info)
-      : group_node_(group_node), group_lazy_function_(*group_lf_graph_info.function.function)
+      : group_node_(group_node),
+        group_lf_graph_info_(group_lf_graph_info),
+        group_lazy_function_(*group_lf_graph_info.function.function)
   {
     debug_name_ = group_node.name;
     allow_missing_requested_inputs_ = true;
@@ -1103,6 +1133,16 @@ class LazyFunctionForGroupNode : public LazyFunction {
 
     has_many_nodes_ = group_lf_graph_info.num_inline_nodes_approximate > 1000;
 
+    /* Only groups that output geometry are cached, computing other values is usually cheaper
+     * than comparing the inputs. */
+    const bNodeTree &group = *reinterpret_cast<const bNodeTree *>(group_node.id);
+    use_cache_ = std::any_of(group_node.output_sockets().begin(),
+                             group_node.output_sockets().end(),
+                             [](const bNodeSocket *socket) {
+                               return socket->type == SOCK_GEOMETRY;
+                             }) &&
+                 geo_eval_cache::node_tree_is_deterministic(group);
+
     /* Add a boolean input for every output bsocket that indicates whether that socket is used. */
     for (const int i : group_node.output_sockets().index_range()) {
       own_lf_graph_info.mapping.lf_input_index_for_output_bsocket_usage
@@ -1152,13 +1192,40 @@ class LazyFunctionForGroupNode : public LazyFunction {
     lf::Context group_context{storage->group_storage, &group_user_data, &group_local_user_data};
 
     ScopedComputeContextTimer timer(group_context);
+    if (use_cache_ && this->can_use_cache(group_user_data)) {
+      geo_eval_cache::execute_group(*storage->cache_storage, params, group_context);
+      return;
+    }
     group_lazy_function_.execute(params, group_context);
   }
 
+  bool can_use_cache(const GeoNodesLFUserData &group_user_data) const
+  {
+    const GeoNodesCallData &call_data = *group_user_data.call_data;
+    if (call_data.modifier_data == nullptr) {
+      /* Operators are evaluated only once. */
+      return false;
+    }
+    if (call_data.eval_log != nullptr && group_user_data.log_socket_values) {
+      /* Socket values in the group are inspected. */
+      return false;
+    }
+    if (call_data.side_effect_nodes != nullptr &&
+        call_data.side_effect_nodes->nodes_by_context.size() > 0)
+    {
+      /* Side effect nodes might be in the group. */
+      return false;
+    }
+    return true;
+  }
+
   void *init_storage(LinearAllocator<> &allocator) const override
   {
     Storage *s = allocator.construct<Storage>().release();
     s->group_storage = group_lazy_function_.init_storage(allocator);
+    if (use_cache_) {
+      s->cache_storage = geo_eval_cache::init_group_call_storage(allocator, group_lf_graph_info_);
+    }
     return s;
   }
 
@@ -1166,6 +1233,11 @@ class LazyFunctionForGroupNode : public LazyFunction {
   {
     Storage *s = static_cast<Storage *>(storage);
     group_lazy_function_.destruct_storage(s->group_storage);
+    if (s->cache_storage) {
+      /* Freed after the group storage, because cached nested groups add their logs when they are
+       * freed. */
+      geo_eval_cache::destruct_group_call_storage(s->cache_storage);
+    }
     std::destroy_at(s);
   }
 
@@ -5833,6 +5905,12 @@ struct GeometryNodesLazyFunctionBuilder {
   }
 };
 
+GeometryNodesLazyFunctionGraphInfo::~GeometryNodesLazyFunctionGraphInfo()
+{
+  /* Cached outputs of the group can't be found anymore when the graph is rebuilt. */
+  geo_eval_cache::remove_graph(session_uid);
+}
+
 const GeometryNodesLazyFunctionGraphInfo *ensure_geometry_nodes_lazy_function_graph(
     const bNodeTree &btree)
 {
@@ -5880,7 +5958,9 @@ const GeometryNodesLazyFunctionGraphInfo *ensure_geometry_nodes_lazy_function_gr
     return lf_graph_info_ptr.get();
   }
 
+  static std::atomic<uint64_t> next_session_uid = 1;
   auto lf_graph_info = std::make_unique<GeometryNodesLazyFunctionGraphInfo>();
+  lf_graph_info->session_uid = next_session_uid.fetch_add(1);
   GeometryNodesLazyFunctionBuilder builder{btree, *lf_graph_info};
   builder.build();
 
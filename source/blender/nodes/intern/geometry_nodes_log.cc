@@ -611,6 +611,70 @@ GeoTreeLogger &GeoModifierLog::get_local_tree_logger(const ComputeContext &compu
   return tree_logger;
 }
 
+Vector<CapturedTreeLog> GeoModifierLog::capture_tree_logs()
+{
+  Vector<CapturedTreeLog> tree_logs;
+  for (LocalData &local_data : data_per_thread_) {
+    for (const auto item : local_data.tree_logger_by_context.items()) {
+      const GeoTreeLogger &tree_logger = *item.value;
+      tree_logs.append_as();
+      CapturedTreeLog &tree_log = tree_logs.last();
+      tree_log.hash = item.key;
+      tree_log.parent_hash = tree_logger.parent_hash;
+      tree_log.parent_node_id = tree_logger.parent_node_id;
+      tree_log.execution_time = tree_logger.execution_time;
+      for (const GeoTreeLogger::WarningWithNode &warning : tree_logger.node_warnings) {
+        tree_log.node_warnings.append(warning);
+      }
+      for (const GeoTreeLogger::NodeExecutionTime &timings : tree_logger.node_execution_times) {
+        tree_log.node_execution_times.append(timings);
+      }
+      for (const GeoTreeLogger::AttributeUsageWithNode &usage : tree_logger.used_named_attributes)
+      {
+        tree_log.used_named_attributes.append({usage.node_id, usage.attribute_name, usage.usage});
+      }
+    }
+  }
+  return tree_logs;
+}
+
+void GeoModifierLog::add_captured_tree_logs(const Span<CapturedTreeLog> tree_logs)
+{
+  LocalData &local_data = data_per_thread_.local();
+  /* The compute contexts are not available anymore, so the loggers are linked to their parents
+   * with the captured hashes. The parents are part of the captured data as well. */
+  auto get_tree_logger = [&](const ComputeContextHash &hash) -> GeoTreeLogger & {
+    destruct_ptr<GeoTreeLogger> &tree_logger_ptr =
+        local_data.tree_logger_by_context.lookup_or_add_default(hash);
+    if (!tree_logger_ptr) {
+      tree_logger_ptr = local_data.allocator.construct<GeoTreeLogger>();
+      tree_logger_ptr->allocator = &local_data.allocator;
+    }
+    return *tree_logger_ptr;
+  };
+
+  for (const CapturedTreeLog &tree_log : tree_logs) {
+    GeoTreeLogger &tree_logger = get_tree_logger(tree_log.hash);
+    if (tree_log.parent_hash.has_value() && !tree_logger.parent_hash.has_value()) {
+      tree_logger.parent_hash = tree_log.parent_hash;
+      tree_logger.parent_node_id = tree_log.parent_node_id;
+      get_tree_logger(*tree_log.parent_hash).children_hashes.append(tree_log.hash);
+    }
+    tree_logger.execution_time += tree_log.execution_time;
+    for (const GeoTreeLogger::WarningWithNode &warning : tree_log.node_warnings) {
+      tree_logger.node_warnings.append(*tree_logger.allocator, warning);
+    }
+    for (const GeoTreeLogger::NodeExecutionTime &timings : tree_log.node_execution_times) {
+      tree_logger.node_execution_times.append(*tree_logger.allocator, timings);
+    }
+    for (const CapturedTreeLog::AttributeUsageWithNode &usage : tree_log.used_named_attributes) {
+      tree_logger.used_named_attributes.append(
+          *tree_logger.allocator,
+          {usage.node_id, tree_logger.allocator->copy_string(usage.attribute_name), usage.usage});
+    }
+  }
+}
+
 GeoTreeLog &GeoModifierLog::get_tree_log(const ComputeContextHash &compute_context_hash)
 {
   GeoTreeLog &reduced_tree_log = *tree_logs_.lookup_or_add_cb(compute_context_hash, [&]() {
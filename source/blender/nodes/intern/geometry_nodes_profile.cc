@@ -0,0 +1,264 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#include "BLI_compute_context.hh"
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_fileops.hh"
+#include "BLI_serialize.hh"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+
+#include "BKE_geometry_set.hh"
+
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+
+#include "NOD_geometry_nodes_profile.hh"
+
+namespace blender::nodes::geo_eval_profile {
+
+namespace {
+
+struct ProfileEvent {
+  std::string name;
+  /** Static string. */
+  const char *category;
+  std::string tree_name;
+  std::string object_name;
+  std::string context_path;
+  TimePoint start;
+  TimePoint end;
+  int64_t memory_delta = 0;
+  int64_t input_elements_num = -1;
+};
+
+/** Events recorded by a single thread, the lock is only contended when the profile ends. */
+struct ProfileThreadBuffer {
+  int thread_index;
+  bool is_main_thread;
+  std::unique_ptr<std::mutex> mutex;
+  Vector<ProfileEvent> events;
+};
+
+struct ProfileRecorder {
+  std::atomic<bool> is_active = false;
+  /** Protects against concurrent begin and end. */
+  std::mutex mutex;
+  TimePoint start_time;
+  std::atomic<int> threads_num = 0;
+  threading::EnumerableThreadSpecific<ProfileThreadBuffer> buffers;
+
+  ProfileRecorder()
+      : buffers([this]() {
+          ProfileThreadBuffer buffer;
+          buffer.thread_index = threads_num.fetch_add(1);
+          buffer.is_main_thread = BLI_thread_is_main();
+          buffer.mutex = std::make_unique<std::mutex>();
+          return buffer;
+        })
+  {
+  }
+};
+
+ProfileRecorder &profile_recorder_get()
+{
+  static ProfileRecorder recorder;
+  return recorder;
+}
+
+void profile_add_event(ProfileEvent &&event)
+{
+  ProfileRecorder &recorder = profile_recorder_get();
+  ProfileThreadBuffer &buffer = recorder.buffers.local();
+  std::lock_guard lock(*buffer.mutex);
+  /* Evaluation may have started before the profile ended. */
+  if (recorder.is_active) {
+    buffer.events.append(std::move(event));
+  }
+}
+
+/**
+ * Human readable path of nested compute contexts, starting at the root, e.g.
+ * `Modifier: GeometryNodes > Node: Group > Repeat Zone ID: 12`.
+ */
+std::string compute_context_path(const ComputeContext *compute_context)
+{
+  Vector<const ComputeContext *> stack;
+  for (const ComputeContext *context = compute_context; context; context = context->parent()) {
+    stack.append(context);
+  }
+  std::stringstream ss;
+  for (int i = stack.size() - 1; i >= 0; i--) {
+    stack[i]->print_current_in_line(ss);
+    if (i > 0) {
+      ss << " > ";
+    }
+  }
+  return ss.str();
+}
+
+/** Time in microseconds since the profile started, as expected by the trace format. */
+double profile_timestamp(const ProfileRecorder &recorder, const TimePoint time)
+{
+  return std::chrono::duration<double, std::micro>(time - recorder.start_time).count();
+}
+
+bool profile_write(ProfileRecorder &recorder, const char *filepath)
+{
+  using namespace io::serialize;
+
+  DictionaryValue root;
+  ArrayValue &trace_events = *root.append_array("traceEvents");
+
+  for (ProfileThreadBuffer &buffer : recorder.buffers) {
+    std::lock_guard lock(*buffer.mutex);
+    if (buffer.events.is_empty()) {
+      continue;
+    }
+    std::shared_ptr<DictionaryValue> thread_name = trace_events.append_dict();
+    thread_name->append_str("name", "thread_name");
+    thread_name->append_str("ph", "M");
+    thread_name->append_int("pid", 0);
+    thread_name->append_int("tid", buffer.thread_index);
+    thread_name->append_dict("args")->append_str(
+        "name",
+        buffer.is_main_thread ? std::string("Main") :
+                                "Worker " + std::to_string(buffer.thread_index));
+
+    for (const ProfileEvent &event : buffer.events) {
+      std::shared_ptr<DictionaryValue> value = trace_events.append_dict();
+      value->append_str("name", event.name);
+      value->append_str("cat", event.category);
+      value->append_str("ph", "X");
+      value->append_double("ts", profile_timestamp(recorder, event.start));
+      value->append_double(
+          "dur", std::chrono::duration<double, std::micro>(event.end - event.start).count());
+      value->append_int("pid", 0);
+      value->append_int("tid", buffer.thread_index);
+
+      DictionaryValue &args = *value->append_dict("args");
+      args.append_str("object", event.object_name);
+      args.append_str("context", event.context_path);
+      args.append_int("memory_delta", event.memory_delta);
+      if (!event.tree_name.empty()) {
+        args.append_str("tree", event.tree_name);
+      }
+      if (event.input_elements_num >= 0) {
+        args.append_int("input_elements", event.input_elements_num);
+      }
+    }
+  }
+  root.append_str("displayTimeUnit", "ms");
+
+  fstream stream(filepath, std::ios::out | std::ios::binary);
+  if (!stream.is_open()) {
+    return false;
+  }
+  JsonFormatter formatter;
+  formatter.serialize(stream, root);
+  return stream.good();
+}
+
+}  // namespace
+
+void begin()
+{
+  ProfileRecorder &recorder = profile_recorder_get();
+  std::lock_guard lock(recorder.mutex);
+  for (ProfileThreadBuffer &buffer : recorder.buffers) {
+    std::lock_guard buffer_lock(*buffer.mutex);
+    buffer.events.clear_and_shrink();
+  }
+  recorder.start_time = Clock::now();
+  recorder.is_active = true;
+}
+
+bool end(const char *filepath)
+{
+  ProfileRecorder &recorder = profile_recorder_get();
+  std::lock_guard lock(recorder.mutex);
+  if (!recorder.is_active) {
+    return false;
+  }
+  recorder.is_active = false;
+
+  const bool success = profile_write(recorder, filepath);
+  for (ProfileThreadBuffer &buffer : recorder.buffers) {
+    std::lock_guard buffer_lock(*buffer.mutex);
+    buffer.events.clear_and_shrink();
+  }
+  return success;
+}
+
+bool is_active()
+{
+  return profile_recorder_get().is_active.load(std::memory_order_relaxed);
+}
+
+void add_node_execution(const ComputeContext *compute_context,
+                        const Object *self_object,
+                        const bNode &node,
+                        const TimePoint start,
+                        const TimePoint end,
+                        const int64_t memory_delta,
+                        const int64_t input_elements_num)
+{
+  ProfileEvent event;
+  event.name = node.name;
+  event.category = "Node";
+  event.tree_name = node.owner_tree().id.name + 2;
+  event.object_name = self_object ? self_object->id.name + 2 : "";
+  event.context_path = compute_context_path(compute_context);
+  event.start = start;
+  event.end = end;
+  event.memory_delta = memory_delta;
+  event.input_elements_num = input_elements_num;
+  profile_add_event(std::move(event));
+}
+
+void add_compute_context_execution(const ComputeContext *compute_context,
+                                   const Object *self_object,
+                                   const TimePoint start,
+                                   const TimePoint end,
+                                   const int64_t memory_delta)
+{
+  ProfileEvent event;
+  std::stringstream ss;
+  if (compute_context) {
+    compute_context->print_current_in_line(ss);
+  }
+  event.name = ss.str();
+  event.category = "Compute Context";
+  event.object_name = self_object ? self_object->id.name + 2 : "";
+  event.context_path = compute_context_path(compute_context);
+  event.start = start;
+  event.end = end;
+  event.memory_delta = memory_delta;
+  profile_add_event(std::move(event));
+}
+
+int64_t geometry_elements_num(const bke::GeometrySet &geometry)
+{
+  int64_t elements_num = 0;
+  for (const bke::GeometryComponent *component : geometry.get_components()) {
+    const std::optional<bke::AttributeAccessor> attributes = component->attributes();
+    if (!attributes) {
+      continue;
+    }
+    for (const int domain_i : IndexRange(ATTR_DOMAIN_NUM)) {
+      const bke::AttrDomain domain = bke::AttrDomain(domain_i);
+      if (attributes->domain_supported(domain)) {
+        elements_num += attributes->domain_size(domain);
+      }
+    }
+  }
+  return elements_num;
+}
+
+}  // namespace blender::nodes::geo_eval_profile
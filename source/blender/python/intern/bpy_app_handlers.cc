@@ -28,6 +28,7 @@ void bpy_app_generic_callback(Main *main,
                               PointerRNA **pointers,
                               const int pointers_num,
                               void *arg);
+static bool bpy_app_generic_callback_is_active(void *arg);
 
 static PyTypeObject BlenderAppCbType;
 
@@ -283,6 +284,7 @@ PyObject *BPY_app_handlers_struct()
     for (pos = 0; pos < BKE_CB_EVT_TOT; pos++) {
       funcstore = &funcstore_array[pos];
       funcstore->func = bpy_app_generic_callback;
+      funcstore->is_active = bpy_app_generic_callback_is_active;
       funcstore->alloc = 0;
       funcstore->arg = POINTER_FROM_INT(pos);
       BKE_callback_add(funcstore, eCbEvent(pos));
@@ -356,6 +358,13 @@ static PyObject *choose_arguments(PyObject *func, PyObject *args_all, PyObject *
   return args_all;
 }
 
+static bool bpy_app_generic_callback_is_active(void *arg)
+{
+  /* Like #bpy_app_generic_callback, checking the size does not need the GIL. */
+  PyObject *cb_list = py_cb_array[POINTER_AS_INT(arg)];
+  return PyList_GET_SIZE(cb_list) > 0;
+}
+
 /* the actual callback - not necessarily called from py */
 void bpy_app_generic_callback(Main * /*main*/,
                               PointerRNA **pointers,
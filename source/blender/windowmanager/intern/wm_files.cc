@@ -40,6 +40,7 @@
 #include "BLI_math_time.h"
 #include "BLI_memory_cache.hh"
 #include "BLI_system.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_timer.h"
@@ -2308,18 +2309,68 @@ bool WM_autosave_is_scheduled(wmWindowManager *wm)
   return wm->autosave_scheduled;
 }
 
+/**
+ * Auto-save files are written to disk in the background, from a snapshot of the data taken on
+ * the main thread. Only one is written at a time.
+ */
+static TaskPool *wm_autosave_task_pool = nullptr;
+
+struct AutosaveWriteTask {
+  BlendFileSnapshot *snapshot;
+  char filepath[FILE_MAX];
+};
+
+static void wm_autosave_write_task_run(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  const AutosaveWriteTask *task = static_cast<const AutosaveWriteTask *>(taskdata);
+  /* Error reporting into console. */
+  BLO_write_snapshot_to_file(task->snapshot, task->filepath);
+}
+
+static void wm_autosave_write_task_free(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  AutosaveWriteTask *task = static_cast<AutosaveWriteTask *>(taskdata);
+  BLO_write_snapshot_free(task->snapshot);
+  MEM_freeN(task);
+}
+
+/** Wait for the auto-save file being written in the background, if any. */
+static void wm_autosave_write_wait()
+{
+  if (wm_autosave_task_pool) {
+    BLI_task_pool_work_and_wait(wm_autosave_task_pool);
+  }
+}
+
 void WM_autosave_write(wmWindowManager *wm, Main *bmain)
 {
   ED_editors_flush_edits(bmain);
 
   char filepath[FILE_MAX];
   wm_autosave_location(filepath);
-  /* Save as regular blend file with recovery information. */
-  const int fileflags = (G.fileflags & ~G_FILE_COMPRESS) | G_FILE_RECOVER_WRITE;
-
-  /* Error reporting into console. */
-  BlendFileWriteParams params{};
-  BLO_write_file(bmain, filepath, fileflags, &params, nullptr);
+  /* Save as regular blend file with recovery information. Compression is done in the
+   * background, so the user setting is kept. */
+  const int fileflags = G.fileflags | G_FILE_RECOVER_WRITE;
+
+  /* Previous auto-save still being written (e.g. very slow drive), don't queue up. */
+  wm_autosave_write_wait();
+
+  /* Only serialize the data here, to keep the interface responsive. */
+  BlendFileSnapshot *snapshot = BLO_write_snapshot_create(bmain, fileflags, nullptr);
+  if (snapshot) {
+    AutosaveWriteTask *task = MEM_cnew<AutosaveWriteTask>(__func__);
+    task->snapshot = snapshot;
+    STRNCPY(task->filepath, filepath);
+
+    if (wm_autosave_task_pool == nullptr) {
+      wm_autosave_task_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
+    }
+    BLI_task_pool_push(wm_autosave_task_pool,
+                       wm_autosave_write_task_run,
+                       task,
+                       true,
+                       wm_autosave_write_task_free);
+  }
 
   /* Restart auto-save timer. */
   wm_autosave_timer_end(wm);
@@ -2383,6 +2434,13 @@ void wm_autosave_timer(Main *bmain, wmWindowManager *wm, wmTimer * /*wt*/)
 
 void wm_autosave_delete()
 {
+  /* Make sure no auto-save is still being written. */
+  if (wm_autosave_task_pool) {
+    BLI_task_pool_work_and_wait(wm_autosave_task_pool);
+    BLI_task_pool_free(wm_autosave_task_pool);
+    wm_autosave_task_pool = nullptr;
+  }
+
   char filepath[FILE_MAX];
 
   wm_autosave_location(filepath);
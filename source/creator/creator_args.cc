@@ -35,6 +35,7 @@
 #  endif
 
 #  include "BKE_appdir.hh"
+#  include "BKE_blender.hh"
 #  include "BKE_blender_cli_command.hh"
 #  include "BKE_blender_version.h"
 #  include "BKE_blendfile.hh"
@@ -70,6 +71,9 @@
 #  endif
 
 #  include "DEG_depsgraph.hh"
+#  include "DEG_depsgraph_debug.hh"
+
+#  include "NOD_geometry_nodes_profile.hh"
 
 #  include "WM_types.hh"
 
@@ -748,6 +752,8 @@ static void print_help(bArgs *ba, bool all)
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-time");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-pretty");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-uid");
+  BLI_args_print_arg_doc(ba, "--debug-depsgraph-trace");
+  BLI_args_print_arg_doc(ba, "--debug-geometry-nodes-profile");
   BLI_args_print_arg_doc(ba, "--debug-ghost");
   BLI_args_print_arg_doc(ba, "--debug-wintab");
   BLI_args_print_arg_doc(ba, "--debug-gpu");
@@ -1311,6 +1317,66 @@ static const char arg_handle_debug_mode_generic_set_doc_depsgraph_pretty[] =
 static const char arg_handle_debug_mode_generic_set_doc_depsgraph_uid[] =
     "\n\t"
     "Verify validness of session-wide identifiers assigned to ID data-blocks.";
+static const char arg_handle_debug_depsgraph_trace_set_doc[] =
+    "<filepath>\n"
+    "\tRecord the timeline of all dependency graph evaluations,\n"
+    "\twritten on exit as a Chrome trace event file (can be opened in Perfetto).";
+static void arg_handle_debug_depsgraph_trace_atexit(void *user_data)
+{
+  const char *filepath = static_cast<const char *>(user_data);
+  if (!DEG_debug_trace_end(filepath)) {
+    fprintf(stderr, "Error: could not write dependency graph trace to '%s'.\n", filepath);
+  }
+}
+static int arg_handle_debug_depsgraph_trace_set(int argc, const char **argv, void * /*data*/)
+{
+  const char *arg_id = "--debug-depsgraph-trace";
+  if (argc > 1) {
+    static char filepath[FILE_MAX];
+    if (DEG_debug_trace_is_active()) {
+      BKE_blender_atexit_unregister(arg_handle_debug_depsgraph_trace_atexit, filepath);
+    }
+    STRNCPY(filepath, argv[1]);
+    BLI_path_abs_from_cwd(filepath, sizeof(filepath));
+    DEG_debug_trace_begin();
+    BKE_blender_atexit_register(arg_handle_debug_depsgraph_trace_atexit, filepath);
+    return 1;
+  }
+  fprintf(stderr, "\nError: '%s' no args given.\n", arg_id);
+  return 0;
+}
+
+static const char arg_handle_debug_geometry_nodes_profile_set_doc[] =
+    "<filepath>\n"
+    "\tRecord timing, memory usage and geometry sizes of all geometry nodes evaluations,\n"
+    "\twritten on exit as a Chrome trace event file (can be opened in Perfetto).";
+static void arg_handle_debug_geometry_nodes_profile_atexit(void *user_data)
+{
+  const char *filepath = static_cast<const char *>(user_data);
+  if (!blender::nodes::geo_eval_profile::end(filepath)) {
+    fprintf(stderr, "Error: could not write geometry nodes profile to '%s'.\n", filepath);
+  }
+}
+static int arg_handle_debug_geometry_nodes_profile_set(int argc,
+                                                       const char **argv,
+                                                       void * /*data*/)
+{
+  const char *arg_id = "--debug-geometry-nodes-profile";
+  if (argc > 1) {
+    static char filepath[FILE_MAX];
+    if (blender::nodes::geo_eval_profile::is_active()) {
+      BKE_blender_atexit_unregister(arg_handle_debug_geometry_nodes_profile_atexit, filepath);
+    }
+    STRNCPY(filepath, argv[1]);
+    BLI_path_abs_from_cwd(filepath, sizeof(filepath));
+    blender::nodes::geo_eval_profile::begin();
+    BKE_blender_atexit_register(arg_handle_debug_geometry_nodes_profile_atexit, filepath);
+    return 1;
+  }
+  fprintf(stderr, "\nError: '%s' no args given.\n", arg_id);
+  return 0;
+}
+
 static const char arg_handle_debug_mode_generic_set_doc_gpu_force_workarounds[] =
     "\n\t"
     "Enable workarounds for typical GPU issues and disable all GPU extensions.";
@@ -2803,6 +2869,16 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
                "--debug-depsgraph-uid",
                CB_EX(arg_handle_debug_mode_generic_set, depsgraph_uid),
                (void *)G_DEBUG_DEPSGRAPH_UID);
+  BLI_args_add(ba,
+               nullptr,
+               "--debug-depsgraph-trace",
+               CB(arg_handle_debug_depsgraph_trace_set),
+               nullptr);
+  BLI_args_add(ba,
+               nullptr,
+               "--debug-geometry-nodes-profile",
+               CB(arg_handle_debug_geometry_nodes_profile_set),
+               nullptr);
   BLI_args_add(ba,
                nullptr,
                "--debug-gpu-force-workarounds",
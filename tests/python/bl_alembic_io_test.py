@@ -340,6 +340,68 @@ class CameraExportImportTest(unittest.TestCase):
         self.assertAlmostEqual(1, actual_scale.z, delta=delta_scale)
 
 
+class AnimationExportTest(unittest.TestCase):
+    """Export animation of the default cube, where the X location is driven by the frame."""
+
+    def setUp(self):
+        self._tempdir = tempfile.TemporaryDirectory()
+        self.tempdir = pathlib.Path(self._tempdir.name)
+        bpy.ops.wm.read_homefile(use_factory_startup=True)
+
+    def tearDown(self):
+        bpy.app.handlers.frame_change_pre.clear()
+        bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+        self._tempdir.cleanup()
+
+    def export_driven_cube(self) -> pathlib.Path:
+        fcu = bpy.data.objects['Cube'].driver_add('location', 0)
+        driver = fcu.driver
+        driver.type = 'SCRIPTED'
+        # Expression that requires the full Python interpreter, the frames are evaluated in
+        # multiple threads at the same time.
+        driver.expression = '[frame][0] * 0.5'
+        self.assertFalse(driver.is_simple_expression)
+
+        abc_path = self.tempdir / "driven.abc"
+        self.assertIn('FINISHED', bpy.ops.wm.alembic_export(
+            filepath=str(abc_path),
+            start=1,
+            end=10,
+            as_background_job=False,
+        ))
+        return abc_path
+
+    def assert_driven_locations(self, abc_path: pathlib.Path):
+        bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+        self.assertIn('FINISHED', bpy.ops.wm.alembic_import(filepath=str(abc_path)))
+        cube = bpy.data.objects['Cube']
+        for frame in (1, 4, 10):
+            bpy.context.scene.frame_set(frame)
+            depsgraph = bpy.context.evaluated_depsgraph_get()
+            location = cube.evaluated_get(depsgraph).matrix_world.to_translation()
+            self.assertAlmostEqual(location.x, frame * 0.5, places=5)
+
+    def test_python_driver(self):
+        abc_path = self.export_driven_cube()
+        self.assert_driven_locations(abc_path)
+
+    def test_frame_change_handler(self):
+        handled_frames = []
+
+        def frame_change_pre(scene):
+            handled_frames.append(scene.frame_current)
+
+        bpy.app.handlers.frame_change_pre.append(frame_change_pre)
+        bpy.context.scene.frame_set(3)
+        handled_frames.clear()
+
+        abc_path = self.export_driven_cube()
+        # Handlers run for every exported frame, and when going back to the original frame.
+        self.assertEqual(handled_frames, list(range(1, 11)) + [3])
+        self.assertEqual(bpy.context.scene.frame_current, 3)
+        self.assert_driven_locations(abc_path)
+
+
 class OverrideLayersTest(AbstractAlembicTest):
     def test_import_layer(self):
         fname = 'cube-base-file.abc'
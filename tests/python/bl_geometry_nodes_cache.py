@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Test that the outputs of node groups are reused across evaluations of the modifier.
+# Node executions are counted with the profile written by `--debug-geometry-nodes-profile`.
+
+import argparse
+import json
+import pathlib
+import subprocess
+import sys
+import tempfile
+import textwrap
+import unittest
+
+# The "Inner" group subdivides the mesh on the default cube, the "Outer" tree of the modifier
+# transforms the result of the group. The subdivision level is an input of the modifier.
+SETUP_SCRIPT = """
+import bpy
+
+def new_tree(name):
+    tree = bpy.data.node_groups.new(name, "GeometryNodeTree")
+    tree.interface.new_socket("Geometry", in_out='INPUT', socket_type='NodeSocketGeometry')
+    tree.interface.new_socket("Geometry", in_out='OUTPUT', socket_type='NodeSocketGeometry')
+    return tree, tree.nodes.new("NodeGroupInput"), tree.nodes.new("NodeGroupOutput")
+
+def evaluate():
+    bpy.context.evaluated_depsgraph_get()
+
+inner, inner_input, inner_output = new_tree("Inner")
+inner.interface.new_socket("Level", in_out='INPUT', socket_type='NodeSocketInt')
+subdivide = inner.nodes.new("GeometryNodeSubdivideMesh")
+subdivide.name = "Subdivide"
+# Logs a warning, because the geometry does not contain curves.
+radius = inner.nodes.new("GeometryNodeSetCurveRadius")
+radius.name = "Radius"
+inner.links.new(inner_input.outputs["Geometry"], subdivide.inputs["Mesh"])
+inner.links.new(inner_input.outputs["Level"], subdivide.inputs["Level"])
+inner.links.new(subdivide.outputs["Mesh"], radius.inputs["Curve"])
+inner.links.new(radius.outputs["Curve"], inner_output.inputs["Geometry"])
+
+outer, outer_input, outer_output = new_tree("Outer")
+level_socket = outer.interface.new_socket("Level", in_out='INPUT', socket_type='NodeSocketInt')
+group = outer.nodes.new("GeometryNodeGroup")
+group.name = "Group"
+group.node_tree = inner
+transform = outer.nodes.new("GeometryNodeTransform")
+transform.name = "Transform"
+outer.links.new(outer_input.outputs["Geometry"], group.inputs["Geometry"])
+outer.links.new(outer_input.outputs["Level"], group.inputs["Level"])
+outer.links.new(group.outputs["Geometry"], transform.inputs["Geometry"])
+outer.links.new(transform.outputs["Geometry"], outer_output.inputs["Geometry"])
+
+cube = bpy.data.objects["Cube"]
+modifier = cube.modifiers.new("Cached", 'NODES')
+modifier.node_group = outer
+modifier[level_socket.identifier] = 1
+evaluate()
+
+def set_level(level):
+    modifier[level_socket.identifier] = level
+    cube.update_tag()
+    evaluate()
+"""
+
+# The "Switch" group only uses its second geometry input when the switch is off. That input
+# is computed by an expensive node in the tree of the modifier.
+SWITCH_SETUP_SCRIPT = """
+import bpy
+
+switch_tree = bpy.data.node_groups.new("Switch", "GeometryNodeTree")
+switch_tree.interface.new_socket("A", in_out='INPUT', socket_type='NodeSocketGeometry')
+switch_tree.interface.new_socket("B", in_out='INPUT', socket_type='NodeSocketGeometry')
+use_a = switch_tree.interface.new_socket("Use A", in_out='INPUT', socket_type='NodeSocketBool')
+use_a.default_value = True
+switch_tree.interface.new_socket("Geometry", in_out='OUTPUT', socket_type='NodeSocketGeometry')
+switch_input = switch_tree.nodes.new("NodeGroupInput")
+switch_output = switch_tree.nodes.new("NodeGroupOutput")
+switch = switch_tree.nodes.new("GeometryNodeSwitch")
+switch.input_type = 'GEOMETRY'
+switch_tree.links.new(switch_input.outputs["Use A"], switch.inputs["Switch"])
+switch_tree.links.new(switch_input.outputs["B"], switch.inputs["False"])
+switch_tree.links.new(switch_input.outputs["A"], switch.inputs["True"])
+switch_tree.links.new(switch.outputs["Output"], switch_output.inputs["Geometry"])
+
+tree = bpy.data.node_groups.new("Outer", "GeometryNodeTree")
+tree.interface.new_socket("Geometry", in_out='INPUT', socket_type='NodeSocketGeometry')
+tree.interface.new_socket("Geometry", in_out='OUTPUT', socket_type='NodeSocketGeometry')
+tree_input = tree.nodes.new("NodeGroupInput")
+tree_output = tree.nodes.new("NodeGroupOutput")
+unused = tree.nodes.new("GeometryNodeSubdivideMesh")
+unused.name = "Unused"
+group = tree.nodes.new("GeometryNodeGroup")
+group.node_tree = switch_tree
+transform = tree.nodes.new("GeometryNodeTransform")
+tree.links.new(tree_input.outputs["Geometry"], unused.inputs["Mesh"])
+tree.links.new(tree_input.outputs["Geometry"], group.inputs["A"])
+tree.links.new(unused.outputs["Mesh"], group.inputs["B"])
+tree.links.new(group.outputs["Geometry"], transform.inputs["Geometry"])
+tree.links.new(transform.outputs["Geometry"], tree_output.inputs["Geometry"])
+
+cube = bpy.data.objects["Cube"]
+modifier = cube.modifiers.new("Cached", 'NODES')
+modifier.node_group = tree
+bpy.context.evaluated_depsgraph_get()
+"""
+
+
+class GeometryNodesCacheTest(unittest.TestCase):
+    def setUp(self):
+        self.tempdir = tempfile.TemporaryDirectory()
+        self.profile_path = pathlib.Path(self.tempdir.name) / "profile.json"
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def run_script(self, script):
+        command = [
+            args.blender,
+            "--background",
+            "--factory-startup",
+            "--debug-geometry-nodes-profile", str(self.profile_path),
+            "--python-exit-code", "1",
+            "--python-expr", script,
+        ]
+        proc = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=300)
+        output = proc.stdout.decode("utf8")
+        self.assertEqual(proc.returncode, 0, output)
+        with open(self.profile_path, encoding="utf8") as fh:
+            return json.load(fh)
+
+    def executions_num(self, profile, node_name):
+        # Nodes may be executed more than once, the first time only to request their inputs.
+        return len([
+            event for event in profile["traceEvents"]
+            if event["ph"] == "X" and event["name"] == node_name and "input_elements" in event["args"]
+        ])
+
+    def run_with_setup(self, script):
+        return self.run_script(SETUP_SCRIPT + textwrap.dedent(script))
+
+    def test_hit_after_change_after_group(self):
+        profile = self.run_with_setup("""
+            transform.inputs["Translation"].default_value = (0.0, 0.0, 1.0)
+            evaluate()
+            transform.inputs["Translation"].default_value = (0.0, 0.0, 2.0)
+            evaluate()
+        """)
+        self.assertEqual(self.executions_num(profile, "Subdivide"), 1)
+        self.assertEqual(self.executions_num(profile, "Transform"), 3)
+
+    def test_warnings_on_hit(self):
+        profile = self.run_with_setup("""
+            transform.inputs["Translation"].default_value = (0.0, 0.0, 1.0)
+            evaluate()
+            messages = [warning.message for warning in modifier.node_warnings]
+            assert any("Mesh" in message for message in messages), messages
+        """)
+        self.assertEqual(self.executions_num(profile, "Subdivide"), 1)
+
+    def test_miss_after_group_change(self):
+        profile = self.run_with_setup("""
+            radius.inputs["Radius"].default_value = 0.5
+            evaluate()
+        """)
+        self.assertEqual(self.executions_num(profile, "Subdivide"), 2)
+
+    def test_miss_after_mesh_change(self):
+        profile = self.run_with_setup("""
+            cube.data.vertices[0].co.x += 1.0
+            cube.data.update()
+            evaluate()
+        """)
+        self.assertEqual(self.executions_num(profile, "Subdivide"), 2)
+
+    def test_miss_after_input_change(self):
+        profile = self.run_with_setup("""
+            set_level(2)
+            set_level(1)
+        """)
+        # The results of both levels are cached.
+        self.assertEqual(self.executions_num(profile, "Subdivide"), 2)
+
+    def test_eviction_of_changing_inputs(self):
+        profile = self.run_with_setup("""
+            set_level(2)
+            set_level(3)
+            set_level(1)
+            set_level(3)
+        """)
+        # Only the two most recent results are kept, so the first one has been removed when
+        # the third one was added.
+        self.assertEqual(self.executions_num(profile, "Subdivide"), 4)
+
+    def test_unused_inputs_are_not_computed(self):
+        profile = self.run_script(SWITCH_SETUP_SCRIPT + textwrap.dedent("""
+            transform.inputs["Translation"].default_value = (0.0, 0.0, 1.0)
+            bpy.context.evaluated_depsgraph_get()
+        """))
+        self.assertEqual(self.executions_num(profile, "Unused"), 0)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--blender", required=True)
+    args, remaining = parser.parse_known_args()
+
+    unittest.main(argv=sys.argv[0:1] + remaining)
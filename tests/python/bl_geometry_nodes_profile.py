@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Test the profile written with `--debug-geometry-nodes-profile`.
+
+import argparse
+import json
+import pathlib
+import subprocess
+import sys
+import tempfile
+import unittest
+
+# Evaluate a geometry nodes modifier on the default cube, with a nested node group. The
+# subdivision level is computed by a math node, which is implemented as multi-function.
+SETUP_SCRIPT = """
+import bpy
+
+def new_tree(name):
+    tree = bpy.data.node_groups.new(name, "GeometryNodeTree")
+    tree.interface.new_socket("Geometry", in_out='INPUT', socket_type='NodeSocketGeometry')
+    tree.interface.new_socket("Geometry", in_out='OUTPUT', socket_type='NodeSocketGeometry')
+    return tree, tree.nodes.new("NodeGroupInput"), tree.nodes.new("NodeGroupOutput")
+
+inner, inner_input, inner_output = new_tree("Inner")
+subdivide = inner.nodes.new("GeometryNodeSubdivideMesh")
+subdivide.name = "Subdivide"
+inner.links.new(inner_input.outputs[0], subdivide.inputs[0])
+inner.links.new(subdivide.outputs[0], inner_output.inputs[0])
+math = inner.nodes.new("ShaderNodeMath")
+math.name = "Math"
+math.operation = 'ADD'
+math.inputs[0].default_value = 0.5
+math.inputs[1].default_value = 0.5
+inner.links.new(math.outputs[0], subdivide.inputs["Level"])
+
+outer, outer_input, outer_output = new_tree("Outer")
+group = outer.nodes.new("GeometryNodeGroup")
+group.name = "Group"
+group.node_tree = inner
+outer.links.new(outer_input.outputs[0], group.inputs[0])
+outer.links.new(group.outputs[0], outer_output.inputs[0])
+
+cube = bpy.data.objects["Cube"]
+modifier = cube.modifiers.new("Profiled", 'NODES')
+modifier.node_group = outer
+bpy.context.evaluated_depsgraph_get()
+"""
+
+
+class GeometryNodesProfileTest(unittest.TestCase):
+    def setUp(self):
+        self.tempdir = tempfile.TemporaryDirectory()
+        self.profile_path = pathlib.Path(self.tempdir.name) / "profile.json"
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def run_profile(self):
+        command = [
+            args.blender,
+            "--background",
+            "--factory-startup",
+            "--debug-geometry-nodes-profile", str(self.profile_path),
+            "--python-exit-code", "1",
+            "--python-expr", SETUP_SCRIPT,
+        ]
+        proc = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=300)
+        output = proc.stdout.decode("utf8")
+        self.assertEqual(proc.returncode, 0, output)
+        self.assertTrue(self.profile_path.exists(), output)
+        with open(self.profile_path, encoding="utf8") as fh:
+            return json.load(fh)
+
+    def test_events(self):
+        profile = self.run_profile()
+        events = [event for event in profile["traceEvents"] if event["ph"] == "X"]
+        self.assertTrue(events)
+
+        # Every duration event has the fields expected by the trace format and the profile.
+        thread_ids = {event["tid"] for event in profile["traceEvents"] if event["ph"] == "M"}
+        for event in events:
+            self.assertGreaterEqual(event["dur"], 0.0)
+            self.assertIn(event["tid"], thread_ids)
+            self.assertIn(event["cat"], {"Node", "Compute Context"})
+            event_args = event["args"]
+            self.assertEqual(event_args["object"], "Cube")
+            self.assertIn("memory_delta", event_args)
+            self.assertIn("context", event_args)
+
+        # The node inside the nested group knows its tree, context and input size.
+        # The node may be executed more than once, the first time only to request its inputs.
+        subdivide_events = [
+            event for event in events
+            if event["name"] == "Subdivide" and "input_elements" in event["args"]
+        ]
+        self.assertEqual(len(subdivide_events), 1)
+        subdivide_args = subdivide_events[0]["args"]
+        self.assertEqual(subdivide_events[0]["cat"], "Node")
+        self.assertEqual(subdivide_args["tree"], "Inner")
+        self.assertEqual(subdivide_args["context"], "Modifier: Profiled > Node: Group")
+        # 8 points, 12 edges, 6 faces and 24 face corners.
+        self.assertEqual(subdivide_args["input_elements"], 50)
+
+        # Multi-function nodes are profiled as well.
+        math_events = [event for event in events if event["name"] == "Math"]
+        self.assertTrue(math_events)
+        for event in math_events:
+            self.assertEqual(event["cat"], "Node")
+            self.assertEqual(event["args"]["tree"], "Inner")
+            self.assertEqual(event["args"]["context"], "Modifier: Profiled > Node: Group")
+
+        # Subdividing allocates new mesh data, which is still alive when the group is left.
+        context_events = [event for event in events if event["cat"] == "Compute Context"]
+        self.assertTrue(context_events)
+        self.assertTrue(any(event["args"]["memory_delta"] > 0 for event in context_events))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--blender", required=True)
+    args, remaining = parser.parse_known_args()
+
+    unittest.main(argv=sys.argv[0:1] + remaining)
@@ -0,0 +1,87 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# ./blender.bin --background --python tests/python/bl_pyapi_shape_keys.py -- --verbose
+import bpy
+import unittest
+
+
+# -----------------------------------------------------------------------------
+# Tests
+
+class TestShapeKeyData(unittest.TestCase):
+    """
+    Shape key data is shared with the evaluated copies of the key, writing it through RNA has to
+    copy it first without losing writes through points that were accessed before.
+    """
+
+    def setUp(self):
+        self.mesh = bpy.data.meshes.new("test_shape_keys")
+        self.mesh.from_pydata([(0.0, 0.0, 0.0), (1.0, 0.0, 0.0), (0.0, 1.0, 0.0)], [], [(0, 1, 2)])
+        self.object = bpy.data.objects.new("test_shape_keys", self.mesh)
+        bpy.context.scene.collection.objects.link(self.object)
+        self.object.shape_key_add(name="Basis")
+        self.key_block = self.object.shape_key_add(name="Key")
+        self.evaluate()
+
+    def tearDown(self):
+        bpy.data.objects.remove(self.object)
+        bpy.data.meshes.remove(self.mesh)
+
+    def evaluate(self):
+        bpy.context.view_layer.update()
+        bpy.context.evaluated_depsgraph_get().update()
+
+    def positions(self, key_block):
+        values = [0.0] * (len(key_block.data) * 3)
+        key_block.points.foreach_get("co", values)
+        return values
+
+    def test_write_while_iterating(self):
+        for point in self.key_block.data:
+            point.co.x += 1.0
+            point.co.z += 2.0
+        self.assertEqual(
+            self.positions(self.key_block),
+            [1.0, 0.0, 2.0, 2.0, 0.0, 2.0, 1.0, 1.0, 2.0])
+
+    def test_write_through_old_point(self):
+        point = self.key_block.data[0]
+        self.key_block.data[1].co = (5.0, 5.0, 5.0)
+        point.co = (3.0, 3.0, 3.0)
+        self.assertEqual(tuple(point.co), (3.0, 3.0, 3.0))
+        self.assertEqual(tuple(self.key_block.data[0].co), (3.0, 3.0, 3.0))
+        self.assertEqual(tuple(self.key_block.data[1].co), (5.0, 5.0, 5.0))
+
+    def test_foreach_set(self):
+        values = [float(i) for i in range(9)]
+        self.key_block.points.foreach_set("co", values)
+        self.assertEqual(self.positions(self.key_block), values)
+        self.evaluate()
+        self.key_block.data.foreach_set("co", [-value for value in values])
+        self.assertEqual(self.positions(self.key_block), [-value for value in values])
+
+    def test_other_key_block_unchanged(self):
+        basis = self.mesh.shape_keys.key_blocks["Basis"]
+        for point in self.key_block.data:
+            point.co = (7.0, 7.0, 7.0)
+        self.assertEqual(
+            self.positions(basis),
+            [0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0])
+
+    def test_evaluated_mesh_updates(self):
+        self.key_block.value = 1.0
+        self.evaluate()
+        for point in self.key_block.data:
+            point.co.z = 4.0
+        self.evaluate()
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        mesh_eval = self.object.evaluated_get(depsgraph).data
+        self.assertEqual([vert.co.z for vert in mesh_eval.vertices], [4.0, 4.0, 4.0])
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()